@@ -0,0 +1,204 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IAUX_INDEXEDRLE__
+#define __IAUX_INDEXEDRLE__
+
+#include <iaux/system/iaConsole.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace iaux
+{
+
+    /*! one run in indexed rle
+     */
+    template <typename TValue, typename TIndex>
+    struct IAUX_API_EXPORT_ONLY iaIndexedRLERun
+    {
+        /*! position after the last value of this run (prefix sum of all run lengths so far)
+         */
+        TIndex _end = static_cast<TIndex>(0);
+
+        /*! value of this run
+         */
+        TValue _value = static_cast<TValue>(0);
+    };
+
+    /*! run length encoded buffer with random access in O(log n)
+
+    Same interface as iaRLE but instead of lengths every run stores where it ends. So a value can be found with a
+    binary search and edits only touch the runs that actually change. For scanning through the values in order use
+    a Cursor which steps in constant time.
+    */
+    template <typename TValue, typename TIndex>
+    class IAUX_API_EXPORT_ONLY iaIndexedRLE
+    {
+
+    public:
+        /*! sequential access to the values of an indexed rle
+
+        any change to the rle invalidates the cursor
+        */
+        class Cursor
+        {
+
+        public:
+            /*! init cursor at given position
+
+            \param rle the rle to iterate
+            \param index the position to start at
+            */
+            Cursor(const iaIndexedRLE<TValue, TIndex> &rle, TIndex index = 0);
+
+            /*! invalid cursor
+             */
+            Cursor() = default;
+
+            /*! moves cursor to given position
+
+            \param index the given position
+            */
+            void seek(TIndex index);
+
+            /*! moves cursor one position forward
+             */
+            void next();
+
+            /*! \returns true if the cursor points to a valid position
+             */
+            bool isValid() const;
+
+            /*! \returns current position
+             */
+            TIndex getIndex() const;
+
+            /*! \returns value at current position
+             */
+            TValue getValue() const;
+
+            /*! \returns position after the last value of the current run
+
+            handy to skip over runs of the same value
+            */
+            TIndex getRunEnd() const;
+
+        private:
+            /*! the rle to iterate
+             */
+            const iaIndexedRLE<TValue, TIndex> *_rle = nullptr;
+
+            /*! current position
+             */
+            int64 _index = 0;
+
+            /*! run of current position
+             */
+            uint32 _run = 0;
+        };
+
+        /*! init members
+
+        \param size the size of this buffer
+        */
+        iaIndexedRLE(TIndex size);
+
+        /*! init members
+         */
+        iaIndexedRLE() = default;
+
+        /*! sets size of rle buffer
+
+        \param size the size of this buffer
+        \param clearValue optional clear value
+        */
+        void setSize(TIndex size, TValue clearValue = 0);
+
+        /*! \returns size of RLE buffer
+         */
+        TIndex getSize() const;
+
+        /*! resets the memory to given value
+
+        \param clearValue the value to set
+        */
+        void clear(TValue clearValue = 0);
+
+        /*! sets value at given index
+
+        \param index index position in buffer
+        \param value the value to set
+        */
+        void setValue(TIndex index, TValue value);
+
+        /*! sets value in a range of indexes
+
+        \param index index to start from
+        \param length amount of values to set
+        \param value the value to set
+        */
+        void setValue(TIndex index, TIndex length, TValue value);
+
+        /*! \returns value at given index
+
+        \param index index position of value to return
+        */
+        TValue getValue(TIndex index) const;
+
+        /*! \returns amount of runs
+         */
+        uint32 getRunCount() const;
+
+        /*! \returns run at given run index
+
+        \param runIndex the given run index
+        */
+        const iaIndexedRLERun<TValue, TIndex> &getRun(uint32 runIndex) const;
+
+        /*! \returns index of the run containing given position
+
+        \param index the given position
+        */
+        uint32 findRun(TIndex index) const;
+
+    private:
+        /*! size of buffer
+         */
+        TIndex _size = 0;
+
+        /*! runs sorted by their end position
+         */
+        std::vector<iaIndexedRLERun<TValue, TIndex>> _runs;
+    };
+
+#include <iaux/data/iaIndexedRLE.inl>
+
+} // namespace iaux
+
+#endif // __IAUX_INDEXEDRLE__
@@ -0,0 +1,256 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename TValue, typename TIndex>
+iaIndexedRLE<TValue, TIndex>::Cursor::Cursor(const iaIndexedRLE<TValue, TIndex> &rle, TIndex index)
+    : _rle(&rle)
+{
+    seek(index);
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::Cursor::seek(TIndex index)
+{
+    con_assert(_rle != nullptr, "invalid cursor");
+
+    _index = static_cast<int64>(index);
+    if (_index < static_cast<int64>(_rle->_size))
+    {
+        _run = _rle->findRun(index);
+    }
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::Cursor::next()
+{
+    _index++;
+
+    if (_index < static_cast<int64>(_rle->_size) &&
+        _index >= static_cast<int64>(_rle->_runs[_run]._end))
+    {
+        _run++;
+    }
+}
+
+template <typename TValue, typename TIndex>
+bool iaIndexedRLE<TValue, TIndex>::Cursor::isValid() const
+{
+    return _rle != nullptr && _index < static_cast<int64>(_rle->_size);
+}
+
+template <typename TValue, typename TIndex>
+TIndex iaIndexedRLE<TValue, TIndex>::Cursor::getIndex() const
+{
+    return static_cast<TIndex>(_index);
+}
+
+template <typename TValue, typename TIndex>
+TValue iaIndexedRLE<TValue, TIndex>::Cursor::getValue() const
+{
+    con_assert(isValid(), "out of bounds");
+
+    if (!isValid())
+    {
+        return static_cast<TValue>(0);
+    }
+
+    return _rle->_runs[_run]._value;
+}
+
+template <typename TValue, typename TIndex>
+TIndex iaIndexedRLE<TValue, TIndex>::Cursor::getRunEnd() const
+{
+    con_assert(isValid(), "out of bounds");
+    return _rle->_runs[_run]._end;
+}
+
+template <typename TValue, typename TIndex>
+iaIndexedRLE<TValue, TIndex>::iaIndexedRLE(TIndex size)
+{
+    setSize(size);
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::setSize(TIndex size, TValue clearValue)
+{
+    con_assert(size > 0, "invalid size " << size);
+    _size = size;
+    clear(clearValue);
+}
+
+template <typename TValue, typename TIndex>
+TIndex iaIndexedRLE<TValue, TIndex>::getSize() const
+{
+    return _size;
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::clear(TValue clearValue)
+{
+    _runs.clear();
+
+    iaIndexedRLERun<TValue, TIndex> run;
+    run._end = _size;
+    run._value = clearValue;
+    _runs.push_back(run);
+}
+
+template <typename TValue, typename TIndex>
+uint32 iaIndexedRLE<TValue, TIndex>::getRunCount() const
+{
+    return static_cast<uint32>(_runs.size());
+}
+
+template <typename TValue, typename TIndex>
+const iaIndexedRLERun<TValue, TIndex> &iaIndexedRLE<TValue, TIndex>::getRun(uint32 runIndex) const
+{
+    con_assert(runIndex < _runs.size(), "out of bounds");
+    return _runs[runIndex];
+}
+
+template <typename TValue, typename TIndex>
+uint32 iaIndexedRLE<TValue, TIndex>::findRun(TIndex index) const
+{
+    con_assert(index < _size, "out of bounds");
+
+    // first run that ends after index
+    uint32 first = 0;
+    uint32 count = static_cast<uint32>(_runs.size());
+    while (count > 0)
+    {
+        const uint32 step = count >> 1;
+        if (_runs[first + step]._end <= index)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+template <typename TValue, typename TIndex>
+TValue iaIndexedRLE<TValue, TIndex>::getValue(TIndex index) const
+{
+    con_assert(index < _size, "out of bounds");
+
+    if (index >= _size)
+    {
+        con_err("out of bounds size:" << _size << " index:" << index);
+        return static_cast<TValue>(0);
+    }
+
+    return _runs[findRun(index)]._value;
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::setValue(TIndex index, TValue value)
+{
+    setValue(index, static_cast<TIndex>(1), value);
+}
+
+template <typename TValue, typename TIndex>
+void iaIndexedRLE<TValue, TIndex>::setValue(TIndex index, TIndex length, TValue value)
+{
+    con_assert(index < _size, "out of bounds");
+    con_assert(static_cast<int64>(index) + static_cast<int64>(length) <= static_cast<int64>(_size), "out of bounds");
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    if (index >= _size ||
+        static_cast<int64>(index) + static_cast<int64>(length) > static_cast<int64>(_size))
+    {
+        con_err("out of bounds size:" << _size << " index:" << index << " length:" << length);
+        return;
+    }
+
+    const TIndex end = static_cast<TIndex>(index + length);
+
+    // runs containing first and last position
+    uint32 firstRun = findRun(index);
+    uint32 lastRun = findRun(static_cast<TIndex>(end - 1));
+
+    if (firstRun == lastRun &&
+        _runs[firstRun]._value == value)
+    {
+        return;
+    }
+
+    const TIndex firstRunBegin = firstRun == 0 ? static_cast<TIndex>(0) : _runs[firstRun - 1]._end;
+
+    // up to three runs replace the runs from firstRun to lastRun
+    iaIndexedRLERun<TValue, TIndex> replacement[3];
+    uint32 replacementCount = 0;
+
+    if (firstRunBegin < index &&
+        _runs[firstRun]._value != value)
+    {
+        replacement[replacementCount++] = {index, _runs[firstRun]._value};
+    }
+    else if (firstRunBegin == index &&
+             firstRun > 0 &&
+             _runs[firstRun - 1]._value == value)
+    {
+        // merge with previous run
+        firstRun--;
+    }
+
+    iaIndexedRLERun<TValue, TIndex> &middle = replacement[replacementCount++];
+    middle = {end, value};
+
+    if (_runs[lastRun]._end > end)
+    {
+        if (_runs[lastRun]._value != value)
+        {
+            replacement[replacementCount++] = {_runs[lastRun]._end, _runs[lastRun]._value};
+        }
+        else
+        {
+            middle._end = _runs[lastRun]._end;
+        }
+    }
+    else if (lastRun + 1 < _runs.size() &&
+             _runs[lastRun + 1]._value == value)
+    {
+        // merge with next run
+        lastRun++;
+        middle._end = _runs[lastRun]._end;
+    }
+
+    // splice the replacement in place
+    const uint32 replacedCount = lastRun - firstRun + 1;
+    const uint32 sharedCount = std::min(replacedCount, replacementCount);
+
+    for (uint32 i = 0; i < sharedCount; ++i)
+    {
+        _runs[firstRun + i] = replacement[i];
+    }
+
+    if (replacedCount > replacementCount)
+    {
+        _runs.erase(_runs.begin() + firstRun + sharedCount, _runs.begin() + firstRun + replacedCount);
+    }
+    else if (replacementCount > replacedCount)
+    {
+        _runs.insert(_runs.begin() + firstRun + sharedCount, replacement + sharedCount, replacement + replacementCount);
+    }
+
+#ifdef IGOR_DEBUG
+    TIndex lastEnd = static_cast<TIndex>(0);
+    for (const auto &run : _runs)
+    {
+        con_assert(run._end > lastEnd, "invalid data");
+        lastEnd = run._end;
+    }
+
+    con_assert(lastEnd == _size, "invalid data");
+#endif
+}
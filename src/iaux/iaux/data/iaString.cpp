@@ -12,9 +12,11 @@
 #include <stdio.h>
 #include <math.h>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <memory>
 #include <regex>
+#include <algorithm>
 
 namespace iaux
 {
@@ -25,25 +27,72 @@ namespace iaux
 
 // this was already very helpful let's keep this!
 #ifdef IGOR_DEBUG
-#define CHECK_CONSISTENCY()                                               \
-    {                                                                     \
-        if (_data != nullptr)                                             \
-        {                                                                 \
-            con_assert(wcslen(_data) == _charCount, "inconsistant data"); \
-        }                                                                 \
-        else                                                              \
-        {                                                                 \
-            con_assert(0 == _charCount, "inconsistant data");             \
-        }                                                                 \
+#define CHECK_CONSISTENCY()                                                                 \
+    {                                                                                       \
+        con_assert(_data != nullptr, "no data");                                            \
+        con_assert(wcslen(_data) == _charCount, "inconsistant data");                       \
+        con_assert(_charCount <= getCapacity(), "inconsistant data");                       \
     }
 #else
 #define CHECK_CONSISTENCY()
 #endif
 
+    iaString::iaString()
+    {
+        _buffer[0] = 0;
+    }
+
     iaString::~iaString()
     {
-        clear();
-        CHECK_CONSISTENCY();
+        releaseData();
+    }
+
+    void iaString::releaseData()
+    {
+        if (_data != _buffer)
+        {
+            delete[] _data;
+            _data = _buffer;
+        }
+    }
+
+    int64 iaString::getCapacity() const
+    {
+        return _data == _buffer ? SSO_CAPACITY : _capacity;
+    }
+
+    void iaString::invalidateHash()
+    {
+        _hash.store(0, std::memory_order_relaxed);
+    }
+
+    void iaString::reserve(int64 charCount, bool keepContent)
+    {
+        invalidateHash();
+
+        const int64 currentCapacity = getCapacity();
+        if (charCount <= currentCapacity)
+        {
+            return;
+        }
+
+        // grow geometrically so appending characters one by one stays cheap
+        const int64 capacity = std::max(charCount, currentCapacity * 2);
+        wchar_t *data = new wchar_t[capacity + 1];
+
+        if (keepContent)
+        {
+            wmemcpy(data, _data, _charCount + 1);
+        }
+        else
+        {
+            data[0] = 0;
+        }
+
+        releaseData();
+
+        _data = data;
+        _capacity = capacity;
     }
 
     bool iaString::matchRegex(const iaString &text, const iaString &regex)
@@ -105,12 +154,21 @@ namespace iaux
 
     int64 iaString::getHashValue() const
     {
-        std::hash<std::wstring> hashFunc;
-        return static_cast<int64>(hashFunc(_data));
+        uint64 hash = _hash.load(std::memory_order_relaxed);
+        if (hash == 0)
+        {
+            // same result as hashing a std::wstring but without the copy
+            hash = static_cast<uint64>(std::hash<std::wstring_view>()(std::wstring_view(_data, _charCount)));
+            _hash.store(hash, std::memory_order_relaxed);
+        }
+
+        return static_cast<int64>(hash);
     }
 
     iaString::iaString(const char *text, const int64 length)
     {
+        _buffer[0] = 0;
+
         if (length != INVALID_POSITION)
         {
             con_assert(strlen(text) >= length, "inconsistent data");
@@ -120,6 +178,8 @@ namespace iaux
 
     iaString::iaString(const wchar_t *text, const int64 length)
     {
+        _buffer[0] = 0;
+
         if (length != INVALID_POSITION)
         {
             con_assert(wcslen(text) >= length, "inconsistent data");
@@ -129,23 +189,30 @@ namespace iaux
 
     iaString::iaString(const wchar_t character, int count)
     {
+        reserve(count, false);
         _charCount = count;
-        _data = new wchar_t[_charCount + 1];
         wmemset(_data, character, _charCount);
         _data[_charCount] = 0;
     }
 
     iaString::iaString(const char character, int count)
     {
+        reserve(count, false);
         _charCount = count;
-        _data = new wchar_t[_charCount + 1];
         wmemset(_data, (wchar_t)character, _charCount);
         _data[_charCount] = 0;
     }
 
     iaString::iaString(const iaString &data)
     {
-        setData(data.getData());
+        _buffer[0] = 0;
+        setData(data.getData(), data.getLength());
+        _hash.store(data._hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    iaString::iaString(iaString &&text) noexcept
+    {
+        *this = std::move(text);
     }
 
     void iaString::toLower()
@@ -171,15 +238,16 @@ namespace iaux
 
     const wchar_t &iaString::operator[](const int64 index) const
     {
-        con_assert(_data != nullptr, "no data");
         con_assert(index < _charCount, "invalid index");
         return _data[index];
     }
 
     wchar_t &iaString::operator[](const int64 index)
     {
-        con_assert(_data != nullptr, "no data");
         con_assert(index < _charCount, "invalid index");
+
+        // the caller might change the character
+        invalidateHash();
         return _data[index];
     }
 
@@ -372,8 +440,9 @@ namespace iaux
         clear();
 
 #ifdef IGOR_WINDOWS
-        _charCount = static_cast<int64>(MultiByteToWideChar(CP_UTF8, 0, buffer, static_cast<int>(size), nullptr, 0));
-        _data = new wchar_t[_charCount + 1];
+        const int64 charCount = static_cast<int64>(MultiByteToWideChar(CP_UTF8, 0, buffer, static_cast<int>(size), nullptr, 0));
+        reserve(charCount, false);
+        _charCount = charCount;
 
         MultiByteToWideChar(CP_UTF8, 0, buffer, static_cast<int>(size), _data, static_cast<int>(_charCount));
 
@@ -404,8 +473,9 @@ namespace iaux
             }
             else
             {
-                _charCount = (bufferSize - outLeft) / sizeof(wchar_t);
-                _data = new wchar_t[_charCount + 1];
+                const int64 charCount = (bufferSize - outLeft) / sizeof(wchar_t);
+                reserve(charCount, false);
+                _charCount = charCount;
 
                 memcpy(_data, tmpbuffer, (_charCount) * sizeof(wchar_t));
                 _data[_charCount] = 0;
@@ -419,25 +489,27 @@ namespace iaux
 
     void iaString::setData(const wchar_t *text, const int64 size)
     {
-        clear();
-
         if (text == nullptr)
         {
+            clear();
             return;
         }
 
+        int64 charCount = 0;
         if (size != INVALID_POSITION)
         {
             con_assert(wcslen(text) >= size, "inconsistant data");
-            _charCount = size;
+            charCount = size;
         }
         else
         {
-            _charCount = static_cast<int64>(wcslen(text));
+            charCount = static_cast<int64>(wcslen(text));
         }
 
-        _data = new wchar_t[_charCount + 1];
-        wmemcpy(_data, text, _charCount);
+        // text might be part of our own data in which case no reallocation happens
+        reserve(charCount, false);
+        _charCount = charCount;
+        wmemmove(_data, text, _charCount);
         _data[_charCount] = 0;
 
         CHECK_CONSISTENCY();
@@ -445,37 +517,38 @@ namespace iaux
 
     void iaString::setData(const char *text, const int64 size)
     {
-        clear();
+        if (text == nullptr)
+        {
+            clear();
+            return;
+        }
 
-        if (text != nullptr)
+        int64 charCount = 0;
+        if (size != INVALID_POSITION)
         {
-            if (size != INVALID_POSITION)
-            {
-                con_assert(strlen(text) >= size, "inconsistant data");
-                _charCount = size;
-            }
-            else
-            {
-                _charCount = static_cast<int64>(strlen(text));
-            }
+            con_assert(strlen(text) >= size, "inconsistant data");
+            charCount = size;
+        }
+        else
+        {
+            charCount = static_cast<int64>(strlen(text));
+        }
 
-            _data = new wchar_t[_charCount + 1];
-            mbstowcs(_data, text, _charCount);
-            _data[_charCount] = 0;
+        reserve(charCount, false);
+        _charCount = charCount;
+        mbstowcs(_data, text, _charCount);
+        _data[_charCount] = 0;
 
-            CHECK_CONSISTENCY();
-        }
+        CHECK_CONSISTENCY();
     }
 
     void iaString::clear()
     {
-        if (_data != nullptr)
-        {
-            delete[] _data;
-        }
+        releaseData();
+        invalidateHash();
 
-        _data = nullptr;
         _charCount = 0;
+        _data[0] = 0;
 
         CHECK_CONSISTENCY();
     }
@@ -484,13 +557,7 @@ namespace iaux
     {
         CHECK_CONSISTENCY();
 
-        if (_data == nullptr ||
-            _charCount == 0)
-        {
-            return true;
-        }
-
-        return false;
+        return _charCount == 0;
     }
 
     int64 iaString::getSize() const
@@ -526,23 +593,20 @@ namespace iaux
             return false;
         }
 
-        if (isEmpty())
+        if (_data == text._data)
         {
             return true;
         }
 
-        int64 i = _charCount;
-
-        do
+        // compare cached hashes first if available
+        const uint64 hash = _hash.load(std::memory_order_relaxed);
+        const uint64 textHash = text._hash.load(std::memory_order_relaxed);
+        if (hash != 0 && textHash != 0 && hash != textHash)
         {
-            i--;
-            if (text[i] != (*this)[i])
-            {
-                return false;
-            }
-        } while (i != 0);
+            return false;
+        }
 
-        return true;
+        return wmemcmp(_data, text._data, _charCount) == 0;
     }
 
     bool iaString::operator!=(const iaString &text) const
@@ -552,23 +616,7 @@ namespace iaux
             return true;
         }
 
-        if (isEmpty())
-        {
-            return false;
-        }
-
-        int64 i = _charCount;
-        do
-        {
-            con_assert(i > 0, "value underflow");
-            i--;
-            if (text[i] != (*this)[i])
-            {
-                return true;
-            }
-        } while (i != 0);
-
-        return false;
+        return !(*this == text);
     }
 
     iaString iaString::operator+(const iaString &text) const
@@ -586,16 +634,12 @@ namespace iaux
 
         if (!text.isEmpty())
         {
-            wchar_t *temp = new wchar_t[_charCount + text.getLength() + 1];
-            if (_charCount > 0)
-            {
-                wmemcpy(temp, _data, _charCount);
-            }
-            wmemcpy(temp + _charCount, text.getData(), text.getLength());
-            _charCount += text.getLength();
-            temp[_charCount] = 0;
-            delete[] _data;
-            _data = temp;
+            // text might be this string
+            const int64 textLength = text.getLength();
+            reserve(_charCount + textLength, true);
+            wmemmove(_data + _charCount, text.getData(), textLength);
+            _charCount += textLength;
+            _data[_charCount] = 0;
 
             CHECK_CONSISTENCY();
         }
@@ -614,47 +658,73 @@ namespace iaux
     {
         CHECK_CONSISTENCY();
 
-        wchar_t *temp = new wchar_t[_charCount + 2];
-        if (_charCount > 0)
-        {
-            wmemcpy(temp, _data, _charCount);
-        }
-        temp[_charCount++] = character;
-        temp[_charCount] = 0;
-        delete[] _data;
-        _data = temp;
+        reserve(_charCount + 1, true);
+        _data[_charCount++] = character;
+        _data[_charCount] = 0;
 
         CHECK_CONSISTENCY();
     }
 
-    iaString iaString::operator=(const iaString &text)
+    iaString &iaString::operator=(const iaString &text)
     {
         // skip if this is the same exact data
         if (getData() != text.getData())
         {
-            setData(text.getData());
+            setData(text.getData(), text.getLength());
+            _hash.store(text._hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    iaString &iaString::operator=(iaString &&text) noexcept
+    {
+        if (this == &text)
+        {
+            return *this;
+        }
+
+        releaseData();
+
+        if (text._data == text._buffer)
+        {
+            wmemcpy(_buffer, text._buffer, text._charCount + 1);
+        }
+        else
+        {
+            // take over the memory
+            _data = text._data;
+            _capacity = text._capacity;
+
+            text._data = text._buffer;
         }
+
+        _charCount = text._charCount;
+        _hash.store(text._hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        text._charCount = 0;
+        text._buffer[0] = 0;
+        text.invalidateHash();
+
         return *this;
     }
 
-    iaString iaString::operator=(const wchar_t *text)
+    iaString &iaString::operator=(const wchar_t *text)
     {
         setData(text);
         return *this;
     }
 
-    iaString iaString::operator=(const char *text)
+    iaString &iaString::operator=(const char *text)
     {
         setData(text);
         return *this;
     }
 
-    iaString iaString::operator=(const wchar_t character)
+    iaString &iaString::operator=(const wchar_t character)
     {
-        clear();
+        invalidateHash();
 
         _charCount = 1;
-        _data = new wchar_t[_charCount + 1];
         _data[0] = character;
         _data[1] = 0;
 
@@ -663,11 +733,11 @@ namespace iaux
         return *this;
     }
 
-    iaString iaString::operator=(const char character)
+    iaString &iaString::operator=(const char character)
     {
-        clear();
+        invalidateHash();
+
         _charCount = 1;
-        _data = new wchar_t[_charCount + 1];
         _data[0] = static_cast<wchar_t>(character);
         _data[1] = 0;
 
@@ -690,55 +760,44 @@ namespace iaux
     {
         CHECK_CONSISTENCY();
 
-        int64 from = 0;
-        int64 to = 0;
-
-        if (!isEmpty())
+        if (isEmpty())
         {
-            switch (splitMode)
-            {
-            case iaStringSplitMode::Normal:
-                do
-                {
-                    from = findFirstNotOf(delimiters.getData(), to);
-                    if (from == iaString::INVALID_POSITION)
-                    {
-                        return;
-                    }
-
-                    to = findFirstOf(delimiters.getData(), from);
-                    tokens.push_back(getSubString(from, to == iaString::INVALID_POSITION ? to : to - from));
-                } while (from < getLength() && to != iaString::INVALID_POSITION);
-                break;
-
-            case iaStringSplitMode::RetriveAllEmpties:
-                do
-                {
-                    to = findFirstOf(delimiters.getData(), from);
-                    if (to != from)
-                    {
-                        tokens.push_back(getSubString(from, to == iaString::INVALID_POSITION ? to : to - from));
+            return;
+        }
 
-                        if (to == iaString::INVALID_POSITION)
-                        {
-                            return;
-                        }
+        if (splitMode != iaStringSplitMode::Normal &&
+            splitMode != iaStringSplitMode::RetriveAllEmpties)
+        {
+            con_err("unknown split mode");
+            return;
+        }
 
-                        from = to;
-                    }
-                    else
-                    {
-                        tokens.push_back("");
-                    }
+        const wchar_t *delimiterData = delimiters.getData();
+        const int64 delimiterCount = delimiters.getLength();
 
-                    from++;
-                } while (from < getLength() && to != iaString::INVALID_POSITION);
-                break;
+        // single pass and tokens get constructed in place
+        int64 from = 0;
+        for (int64 index = 0; index <= _charCount; ++index)
+        {
+            if (index < _charCount &&
+                wmemchr(delimiterData, _data[index], delimiterCount) == nullptr)
+            {
+                continue;
+            }
 
-            default:
-                con_err("unknown split mode");
-                break;
+            const int64 length = index - from;
+            if (length > 0)
+            {
+                tokens.emplace_back(_data + from, length);
             }
+            // an empty token at the very end is not retrived
+            else if (splitMode == iaStringSplitMode::RetriveAllEmpties &&
+                     index < _charCount)
+            {
+                tokens.emplace_back();
+            }
+
+            from = index + 1;
         }
     }
 
@@ -1006,7 +1065,7 @@ namespace iaux
     {
         CHECK_CONSISTENCY();
 
-        if (len == 0 || _data == nullptr)
+        if (len == 0 || isEmpty())
         {
             return iaString();
         }
@@ -1026,6 +1085,8 @@ namespace iaux
 
     void iaString::reverse()
     {
+        invalidateHash();
+
         int64 i = 0;
         int64 j = _charCount - 1;
         wchar_t temp;
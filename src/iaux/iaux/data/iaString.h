@@ -37,6 +37,7 @@
 
 #include <ostream>
 #include <vector>
+#include <atomic>
 
 namespace iaux
 {
@@ -59,9 +60,15 @@ namespace iaux
          */
         static const int64 INVALID_POSITION = -1;
 
-        /*! default ctor does nothing
+        /*! strings up to this length are stored inside the string itself without allocating memory
+
+        the internal buffer shares it's memory with the heap capacity and is sized so the whole string takes 64 bytes
+         */
+        static const int64 SSO_CAPACITY = 40 / sizeof(wchar_t) - 1;
+
+        /*! default ctor creates empty string
          */
-        iaString() = default;
+        iaString();
 
         /*! ctor with byte string
 
@@ -97,6 +104,12 @@ namespace iaux
         */
         iaString(const iaString &text);
 
+        /*! move ctor
+
+        \param text the string to move from
+        */
+        iaString(iaString &&text) noexcept;
+
         /*! dtor releases allocated memory
          */
         ~iaString();
@@ -110,7 +123,9 @@ namespace iaux
         int64 getSize() const;
         
         /*! \returns hash value for current text
-         */
+
+        the hash is calculated only once until the string gets changed
+        */
         int64 getHashValue() const;
 
         /*! change string to lower case letters
@@ -179,35 +194,42 @@ namespace iaux
         \param text the new string
         \returns the new string
         */
-        iaString operator=(const iaString &text);
+        iaString &operator=(const iaString &text);
+
+        /*! = operator moves given string in to this string
+
+        \param text the string to move from
+        \returns this string
+        */
+        iaString &operator=(iaString &&text) noexcept;
 
         /*! = operator overwrites current string with new string
 
         \param text the new string
         \returns the new string
         */
-        iaString operator=(const wchar_t *text);
+        iaString &operator=(const wchar_t *text);
 
         /*! = operator overwrites current string with new string
 
         \param text the new string
         \returns the new string
         */
-        iaString operator=(const char *text);
+        iaString &operator=(const char *text);
 
         /*! = operator overwrites current string with one character
 
         \param character the character
         \returns the new string
         */
-        iaString operator=(const wchar_t character);
+        iaString &operator=(const wchar_t character);
 
         /*! = operator overwrites current string with one character
 
         \param character the character
         \returns the new string
         */
-        iaString operator=(const char character);
+        iaString &operator=(const char character);
 
         /*! compares two strings and returns true if the left hand side string is considered smaller
 
@@ -344,7 +366,7 @@ namespace iaux
          */
         bool isEmpty() const;
 
-        /*! \returns pointer to raw data
+        /*! \returns pointer to raw data (never nullptr)
          */
         const wchar_t *getData() const;
 
@@ -590,8 +612,44 @@ namespace iaux
         int64 _charCount = 0;
 
         /*! pointer to actual data
+
+        points to _buffer as long as the text fits in to it
+         */
+        wchar_t *_data = _buffer;
+
+        /*! cached hash value, zero if not calculated yet
+         */
+        mutable std::atomic<uint64> _hash = 0;
+
+        union
+        {
+            /*! capacity of heap buffer in characters without ending zero. only valid if data is on the heap
+             */
+            int64 _capacity;
+
+            /*! buffer for short strings
+             */
+            wchar_t _buffer[SSO_CAPACITY + 1];
+        };
+
+        /*! \returns capacity of current buffer in characters without ending zero
+         */
+        int64 getCapacity() const;
+
+        /*! makes sure the buffer can hold given amount of characters
+
+        \param charCount the amount of characters without ending zero
+        \param keepContent if true the current content is kept
+        */
+        void reserve(int64 charCount, bool keepContent);
+
+        /*! releases heap memory if any and switches back to the internal buffer
+         */
+        void releaseData();
+
+        /*! marks cached hash as invalid
          */
-        wchar_t *_data = nullptr;
+        void invalidateHash();
 
         /*! internal set data
 
@@ -0,0 +1,162 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <iaux/data/iaStringID.h>
+
+#include <iaux/system/iaMutex.h>
+
+#include <unordered_map>
+#include <atomic>
+
+namespace iaux
+{
+    /*! amount of strings per chunk
+     */
+    static const uint32 s_chunkSize = 1024;
+
+    /*! max amount of chunks
+     */
+    static const uint32 s_maxChunks = 4096;
+
+    /*! global table of interned strings
+
+    strings are stored in chunks that never move so lookups by id need no lock
+    */
+    struct iaInternTable
+    {
+        /*! the chunks
+         */
+        std::atomic<iaString *> _chunks[s_maxChunks] = {};
+
+        /*! maps text to id
+         */
+        std::unordered_map<iaString, uint32> _ids;
+
+        /*! amount of interned strings
+         */
+        std::atomic<uint32> _count = 0;
+
+        /*! protects interning
+         */
+        iaMutex _mutex;
+
+        /*! reserves the empty string
+         */
+        iaInternTable()
+        {
+            _chunks[0].store(new iaString[s_chunkSize], std::memory_order_release);
+            _ids[iaString()] = 0;
+            _count = 1;
+        }
+
+        /*! \returns interned string for given id
+
+        \param id the given id
+        */
+        const iaString &getString(uint32 id) const
+        {
+            return _chunks[id / s_chunkSize].load(std::memory_order_acquire)[id % s_chunkSize];
+        }
+
+        /*! \returns id of given text
+
+        \param text the given text
+        */
+        uint32 intern(const iaString &text)
+        {
+            if (text.isEmpty())
+            {
+                return 0;
+            }
+
+            _mutex.lock();
+            auto iter = _ids.find(text);
+            if (iter != _ids.end())
+            {
+                const uint32 result = iter->second;
+                _mutex.unlock();
+                return result;
+            }
+
+            const uint32 id = _count.load(std::memory_order_relaxed);
+            con_assert_sticky(id < s_chunkSize * s_maxChunks, "too many interned strings");
+
+            const uint32 chunk = id / s_chunkSize;
+            iaString *strings = _chunks[chunk].load(std::memory_order_relaxed);
+            if (strings == nullptr)
+            {
+                strings = new iaString[s_chunkSize];
+            }
+
+            strings[id % s_chunkSize] = text;
+            _chunks[chunk].store(strings, std::memory_order_release);
+            _ids[text] = id;
+            _count.store(id + 1, std::memory_order_release);
+            _mutex.unlock();
+
+            return id;
+        }
+    };
+
+    /*! \returns the intern table
+     */
+    static iaInternTable &getInternTable()
+    {
+        // intentionally never destroyed so interned strings stay valid during static destruction
+        static iaInternTable *table = new iaInternTable();
+        return *table;
+    }
+
+    iaStringID::iaStringID(const iaString &text)
+        : _id(getInternTable().intern(text))
+    {
+    }
+
+    iaStringID::iaStringID(const char *text)
+        : _id(getInternTable().intern(iaString(text)))
+    {
+    }
+
+    uint32 iaStringID::getID() const
+    {
+        return _id;
+    }
+
+    const iaString &iaStringID::getString() const
+    {
+        return getInternTable().getString(_id);
+    }
+
+    bool iaStringID::isEmpty() const
+    {
+        return _id == 0;
+    }
+
+    bool iaStringID::operator==(const iaStringID &other) const
+    {
+        return _id == other._id;
+    }
+
+    bool iaStringID::operator!=(const iaStringID &other) const
+    {
+        return _id != other._id;
+    }
+
+    bool iaStringID::operator<(const iaStringID &other) const
+    {
+        return _id < other._id;
+    }
+
+    uint32 iaStringID::getInternedCount()
+    {
+        return getInternTable()._count.load(std::memory_order_acquire);
+    }
+
+    std::wostream &operator<<(std::wostream &stream, const iaStringID &stringID)
+    {
+        stream << stringID.getString();
+        return stream;
+    }
+
+}
@@ -0,0 +1,124 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IAUX_STRINGID__
+#define __IAUX_STRINGID__
+
+#include <iaux/data/iaString.h>
+
+namespace iaux
+{
+
+    /*! interned string
+
+    Every distinct text is stored once in a global table and identified by a 32 bit id. Comparing, hashing and copying
+    is as cheap as for an integer which makes it a good key for maps. Interned strings live until the application ends.
+
+    Interning a string takes a lock, everything else is lock free.
+     */
+    class IAUX_API iaStringID
+    {
+    public:
+        /*! init with empty string
+         */
+        iaStringID() = default;
+
+        /*! interns given text
+
+        \param text the given text
+        */
+        iaStringID(const iaString &text);
+
+        /*! interns given text
+
+        \param text the given text
+        */
+        iaStringID(const char *text);
+
+        /*! \returns the id
+         */
+        uint32 getID() const;
+
+        /*! \returns the interned text
+         */
+        const iaString &getString() const;
+
+        /*! \returns true if this is the empty string
+         */
+        bool isEmpty() const;
+
+        /*! \returns true if both are the same text
+
+        \param other the other string id
+        */
+        bool operator==(const iaStringID &other) const;
+
+        /*! \returns true if the texts differ
+
+        \param other the other string id
+        */
+        bool operator!=(const iaStringID &other) const;
+
+        /*! \returns true if the id is smaller (this is not the alphabetical order)
+
+        \param other the other string id
+        */
+        bool operator<(const iaStringID &other) const;
+
+        /*! \returns amount of interned strings
+         */
+        static uint32 getInternedCount();
+
+    private:
+        /*! the id, zero is the empty string
+         */
+        uint32 _id = 0;
+    };
+
+    /*! print interned string in console
+
+    \param stream the stream to write to
+    \param stringID the interned string to write
+    \returns stream it self
+    */
+    IAUX_API std::wostream &operator<<(std::wostream &stream, const iaStringID &stringID);
+
+}
+
+/*! so can be used as key in a map
+ */
+template <>
+struct std::hash<iaux::iaStringID>
+{
+    std::size_t operator()(const iaux::iaStringID &stringID) const
+    {
+        return static_cast<std::size_t>(stringID.getID());
+    }
+};
+
+#endif // __IAUX_STRINGID__
@@ -34,10 +34,13 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 namespace iaux
 {
     /*! a delegate that wraps a function or method
+
+    the wrapped call is stored inline so creating and copying delegates never allocates
      */
     template <typename R, typename... Args>
     class iaDelegate
@@ -51,8 +54,7 @@ namespace iaux
          */
         iaDelegate(R (*function)(Args...))
         {
-            _internal = (InternalDefaultCall *)malloc(sizeof(InternalDefaultCall));
-            new (_internal) InternalDefaultCall(function);
+            _internal = new (_storage) InternalDefaultCall(function);
         }
 
         /*! initializes with a method and instance
@@ -60,8 +62,8 @@ namespace iaux
         template <typename T>
         iaDelegate(T *instance, R (T::*method)(Args...))
         {
-            _internal = (InternalThisCall<T> *)malloc(sizeof(InternalThisCall<T>));
-            new (_internal) InternalThisCall<T>(instance, method);
+            static_assert(sizeof(InternalThisCall<T>) <= STORAGE_SIZE, "method pointer does not fit in to delegate storage");
+            _internal = new (_storage) InternalThisCall<T>(instance, method);
         }
 
         /*! copy ctor
@@ -76,7 +78,7 @@ namespace iaux
                 return;
             }
 
-            _internal = other._internal->clone();
+            _internal = other._internal->clone(_storage);
         }
 
         /*! cleanup
@@ -93,7 +95,6 @@ namespace iaux
             if (_internal != nullptr)
             {
                 _internal->~InternalBase();
-                free(_internal);
                 _internal = nullptr;
             }
         }
@@ -122,11 +123,16 @@ namespace iaux
         */
         const iaDelegate &operator=(const iaDelegate &other)
         {
+            if (this == &other)
+            {
+                return *this;
+            }
+
             clear();
 
             if (other._internal != nullptr)
             {
-                _internal = other._internal->clone();
+                _internal = other._internal->clone(_storage);
             }
 
             return *this;
@@ -174,8 +180,9 @@ namespace iaux
         class InternalBase
         {
         public:
+            virtual ~InternalBase() = default;
             virtual R execute(Args... args) const = 0;
-            virtual InternalBase *clone() const = 0;
+            virtual InternalBase *clone(void *memory) const = 0;
             virtual bool compare(const InternalBase *delegate) const = 0;
             virtual int getType() const = 0;
             virtual bool isValid() const = 0;
@@ -194,11 +201,9 @@ namespace iaux
                 return _function(std::forward<Args>(args)...);
             }
 
-            InternalBase *clone() const override
+            InternalBase *clone(void *memory) const override
             {
-                InternalDefaultCall *result = (InternalDefaultCall *)malloc(sizeof(InternalDefaultCall));
-                new (result) InternalDefaultCall(_function);
-                return result;
+                return new (memory) InternalDefaultCall(_function);
             }
 
             bool compare(const InternalBase *delegate) const override
@@ -247,11 +252,9 @@ namespace iaux
                 return (_instance->*_method)(std::forward<Args>(args)...);
             }
 
-            InternalBase *clone() const override
+            InternalBase *clone(void *memory) const override
             {
-                InternalThisCall<T> *result = (InternalThisCall<T> *)malloc(sizeof(InternalThisCall<T>));
-                new (result) InternalThisCall<T>(this->_instance, this->_method);
-                return result;
+                return new (memory) InternalThisCall<T>(this->_instance, this->_method);
             }
 
             bool compare(const InternalBase *delegate) const override
@@ -292,6 +295,16 @@ namespace iaux
             (Args...);
         };
 
+        /*! size of inline storage. big enough for vtable, instance and any kind of method pointer
+        */
+        static constexpr size_t STORAGE_SIZE = sizeof(void *) * 6;
+
+        /*! inline storage for the wrapped call
+        */
+        alignas(void *) unsigned char _storage[STORAGE_SIZE] = {};
+
+        /*! the wrapped call. points in to _storage or is nullptr
+        */
         InternalBase *_internal = nullptr;
     };
 
@@ -316,11 +329,6 @@ namespace iaux
     {
     public:
         using ReturnType = std::vector<R>;
-
-        static ReturnType processDelegate(const iaDelegate<R, Args...> &delegate, Args... args)
-        {
-            return {delegate(std::forward<Args>(args)...)};
-        }
     };
 
     /*! helper class for void return type
@@ -330,14 +338,13 @@ namespace iaux
     {
     public:
         using ReturnType = void;
-
-        static void processDelegate(const iaDelegate<void, Args...> &delegate, Args... args)
-        {
-            delegate(std::forward<Args>(args)...);
-        }
     };
 
     /*! event container for delegates that executes delegates when triggered
+
+    the list of delegates is copy on write. adding or removing a delegate creates a new list while executing the
+    event only holds a reference to the current one. so executing does not allocate and delegates can be added or
+    removed from within a delegate that is currently executed
      */
     template <typename R, typename... Args>
     class iaEvent
@@ -353,10 +360,12 @@ namespace iaux
         void add(const iaDelegate<R, Args...> &delegate)
         {
             _mutex.lock();
-            auto iter = std::find(_delegates.begin(), _delegates.end(), delegate);
-            if (iter == _delegates.end())
+            if (_delegates == nullptr ||
+                std::find(_delegates->begin(), _delegates->end(), delegate) == _delegates->end())
             {
-                _delegates.push_back(delegate);
+                auto delegates = _delegates != nullptr ? std::make_shared<Delegates>(*_delegates) : std::make_shared<Delegates>();
+                delegates->push_back(delegate);
+                _delegates = delegates;
             }
             _mutex.unlock();
         }
@@ -368,10 +377,15 @@ namespace iaux
         void remove(const iaDelegate<R, Args...> &delegate)
         {
             _mutex.lock();
-            auto iter = std::find(_delegates.begin(), _delegates.end(), delegate);
-            if (iter != _delegates.end())
+            if (_delegates != nullptr)
             {
-                _delegates.erase(iter);
+                auto iter = std::find(_delegates->begin(), _delegates->end(), delegate);
+                if (iter != _delegates->end())
+                {
+                    auto delegates = std::make_shared<Delegates>(*_delegates);
+                    delegates->erase(delegates->begin() + (iter - _delegates->begin()));
+                    _delegates = delegates->empty() ? nullptr : delegates;
+                }
             }
             _mutex.unlock();
         }
@@ -415,25 +429,32 @@ namespace iaux
                 }
             }
 
+            // only takes a reference on the current list of delegates
             _mutex.lock();
-            auto delegates = _delegates;
+            const std::shared_ptr<const Delegates> delegates = _delegates;
             _mutex.unlock();
 
             if constexpr (!std::is_same_v<ReturnType, void>)
             {
                 ReturnType results;
-                for (auto &delegate : delegates)
+                if (delegates != nullptr)
                 {
-                    auto result = ReturnHandler::processDelegate(delegate, args...);
-                    results.insert(results.end(), result.begin(), result.end());
+                    results.reserve(delegates->size());
+                    for (const auto &delegate : *delegates)
+                    {
+                        results.push_back(delegate(args...));
+                    }
                 }
                 return results;
             }
             else
             {
-                for (auto &delegate : delegates)
+                if (delegates != nullptr)
                 {
-                    ReturnHandler::processDelegate(delegate, args...);
+                    for (const auto &delegate : *delegates)
+                    {
+                        delegate(args...);
+                    }
                 }
             }
         }
@@ -443,7 +464,7 @@ namespace iaux
         void clear()
         {
             _mutex.lock();
-            _delegates.clear();
+            _delegates = nullptr;
             _mutex.unlock();
         }
 
@@ -451,12 +472,23 @@ namespace iaux
          */
         bool hasDelegates()
         {
-            return _delegates.size() ? true : false;
+            _mutex.lock();
+            const bool result = _delegates != nullptr;
+            _mutex.unlock();
+
+            return result;
         }
 
     protected:
+        /*! list of delegates type
+        */
+        using Delegates = std::vector<iaDelegate<R, Args...>>;
+
         iaMutex _mutex;
-        std::vector<iaDelegate<R, Args...>> _delegates;
+
+        /*! current list of delegates. is never modified once shared and nullptr if empty
+        */
+        std::shared_ptr<const Delegates> _delegates;
         bool _blocked = false;
     };
 
@@ -12,6 +12,7 @@ namespace iaux
     bool iaTest::_useFilter = false;
     std::string iaTest::_filter;
     bool iaTest::_verbose = false;
+    bool iaTest::_benchmark = false;
 
     void iaTest::registerTest(iaTest *test)
     {
@@ -33,7 +34,11 @@ namespace iaux
             {
                 _verbose = true;
             }
-            if (value == "--stop-on-error")
+            if (value == "--benchmark")
+            {
+                _benchmark = true;
+            }
+            else if (value == "--stop-on-error")
             {
                 _stopOnError = true;
             }
@@ -59,6 +64,11 @@ namespace iaux
         {
             for (auto test : groupPair.second)
             {
+                if (test->isBenchmark() != _benchmark)
+                {
+                    continue;
+                }
+
                 std::stringstream testID;
                 testID << test->getGroupName() << "." << test->getName();
 
@@ -59,6 +59,13 @@ namespace iaux
          */
         virtual const char *getLocation() = 0;
 
+        /*! \returns true if this is a benchmark which only runs when requested via --benchmark
+         */
+        virtual bool isBenchmark()
+        {
+            return false;
+        }
+
         /*! initializes testing
 
         \param argc cli argc
@@ -104,12 +111,16 @@ namespace iaux
          */
         static bool _verbose;
 
+        /*! if true only benchmarks run, otherwise only tests
+         */
+        static bool _benchmark;
+
         /*! if true this test was successful
          */
         bool _ok = true;
     };
 
-#define IAUX_TEST(testGroup, testName)                                                        \
+#define IAUX_DEFINE_TEST(testGroup, testName, benchmark)                                      \
     class testGroup##_##testName : public iaTest                                              \
     {                                                                                         \
     public:                                                                                   \
@@ -126,11 +137,19 @@ namespace iaux
         {                                                                                     \
             return __IGOR_FILE_LINE__;                                                        \
         }                                                                                     \
+        bool isBenchmark() override                                                           \
+        {                                                                                     \
+            return benchmark;                                                                 \
+        }                                                                                     \
         void run() override;                                                                  \
     };                                                                                        \
     testGroup##_##testName *testGroup##_##testName##_instance = new testGroup##_##testName(); \
     void testGroup##_##testName::run()
 
+#define IAUX_TEST(testGroup, testName) IAUX_DEFINE_TEST(testGroup, testName, false)
+
+#define IAUX_BENCHMARK(testGroup, testName) IAUX_DEFINE_TEST(testGroup, testName, true)
+
 #define IAUX_EXPECT_EQUAL(a, b)                                                \
     if ((a) != (b))                                                            \
     {                                                                          \
@@ -0,0 +1,330 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_FLAT_QUADTREE__
+#define __IGOR_FLAT_QUADTREE__
+
+#include <igor/iDefines.h>
+#include <igor/data/iIntersection.h>
+
+#include <iaux/data/iaRectangle.h>
+#include <iaux/data/iaCircle.h>
+#include <iaux/system/iaConsole.h>
+
+#include <vector>
+#include <limits>
+
+namespace igor
+{
+    /*! object id of flat quadtree
+     */
+    typedef uint32 iQuadtreeObjectID;
+
+    /*! pool backed quadtree implementation
+
+    same semantics as iQuadtree but nodes and objects live in contiguous arrays and are referenced by index.
+    freed nodes and objects get recycled so after warming up insert, update and remove do not allocate.
+    the user data is stored by value so queries do not have to cast anything
+
+    \todo why do we have a max depth????
+    */
+    template <typename F, typename T>
+    class IGOR_API_EXPORT_ONLY iFlatQuadtree
+    {
+
+    public:
+        /*! invalid index of node or object
+         */
+        static constexpr uint32 INVALID_INDEX = std::numeric_limits<uint32>::max();
+
+        /*! flat quadtree object
+         */
+        struct iFlatQuadtreeObject
+        {
+            /*! the circle of this object
+             */
+            iaCircle<F> _circle;
+
+            /*! user data
+             */
+            T _userData;
+
+            /*! index of node the object is in. INVALID_INDEX if object slot is unused
+             */
+            uint32 _node = INVALID_INDEX;
+
+            /*! index of object within the node's object list
+             */
+            uint32 _indexInNode = INVALID_INDEX;
+        };
+
+        /*! flat quadtree node
+         */
+        struct iFlatQuadtreeNode
+        {
+            /*! node box
+             */
+            iaRectangle<F> _box;
+
+            /*! index of parent node
+             */
+            uint32 _parent = INVALID_INDEX;
+
+            /*! index of first child. all four children are stored next to each other. INVALID_INDEX if node is a leaf
+             */
+            uint32 _firstChild = INVALID_INDEX;
+
+            /*! indices of objects in this node
+             */
+            std::vector<iQuadtreeObjectID> _objects;
+        };
+
+        /*! creates the quadtree including the root node
+
+        \param box volume of the whole quadtree
+        \param splitThreshold threshold count of objects on a node before splitting the node
+        \param maxDepth the maximum depth of the tree
+        */
+        iFlatQuadtree(const iaRectangle<F> &box, const uint32 splitThreshold = 4, const uint32 maxDepth = 16);
+
+        /*! dtor
+         */
+        virtual ~iFlatQuadtree() = default;
+
+        /*! insert object
+
+        \param circle position and radius of the object
+        \param userData the user data
+        \returns id of new object or INVALID_INDEX if out of bounds
+        */
+        iQuadtreeObjectID insert(const iaCircle<F> &circle, const T &userData);
+
+        /*! remove given object
+
+        \param objectID id of object to remove
+        */
+        void remove(iQuadtreeObjectID objectID);
+
+        /*! updates position of given object
+
+        \param objectID id of the object to update
+        \param position the new position of the object
+        */
+        void update(iQuadtreeObjectID objectID, const iaVector2<F> &position);
+
+        /*! updates position and radius of given object
+
+        \param objectID id of the object to update
+        \param circle the new position and radius of the object
+        */
+        void update(iQuadtreeObjectID objectID, const iaCircle<F> &circle);
+
+        /*! calls callback for every object within given circle
+
+        \param circle the given circle
+        \param callback callable with signature void(iQuadtreeObjectID objectID, const iFlatQuadtreeObject &object)
+        */
+        template <typename Callback>
+        void query(const iaCircle<F> &circle, Callback callback) const;
+
+        /*! calls callback for every object within given rectangle
+
+        \param rectangle the given rectangle
+        \param callback callable with signature void(iQuadtreeObjectID objectID, const iFlatQuadtreeObject &object)
+        */
+        template <typename Callback>
+        void query(const iaRectangle<F> &rectangle, Callback callback) const;
+
+        /*! queries for objects within given circle
+
+        \param circle the given circle
+        \param objects the resulting found object ids
+        */
+        void query(const iaCircle<F> &circle, std::vector<iQuadtreeObjectID> &objects) const;
+
+        /*! queries for objects within given rectangle
+
+        \param rectangle the given rectangle
+        \param objects the resulting found object ids
+        */
+        void query(const iaRectangle<F> &rectangle, std::vector<iQuadtreeObjectID> &objects) const;
+
+        /*! \returns object for given id
+
+        \param objectID the given object id
+        */
+        const iFlatQuadtreeObject &getObject(iQuadtreeObjectID objectID) const;
+
+        /*! \returns user data of given object
+
+        \param objectID the given object id
+        */
+        T &getUserData(iQuadtreeObjectID objectID);
+
+        /*! \returns node for given index
+
+        \param index the given node index
+        */
+        const iFlatQuadtreeNode &getNode(uint32 index) const;
+
+        /*! \returns index of root node
+         */
+        uint32 getRoot() const;
+
+        /*! \returns true if given node has no children
+
+        \param index index of the node to test
+        */
+        bool isLeaf(uint32 index) const;
+
+        /*! \returns amount of objects in tree
+         */
+        uint32 getObjectCount() const;
+
+        /*! \returns amount of nodes in use
+         */
+        uint32 getNodeCount() const;
+
+        /*! clears the tree
+
+        keeps allocated memory for reuse
+        */
+        void clear();
+
+        /*! \returns dimensions of quadtree
+         */
+        const iaRectangle<F> &getRootBox() const;
+
+        using Object = iFlatQuadtreeObject;
+        using Node = iFlatQuadtreeNode;
+
+    private:
+        /*! all nodes. index 0 is the root
+         */
+        std::vector<iFlatQuadtreeNode> _nodes;
+
+        /*! first indices of unused blocks of four nodes
+         */
+        std::vector<uint32> _freeNodeBlocks;
+
+        /*! all objects
+         */
+        std::vector<iFlatQuadtreeObject> _objects;
+
+        /*! unused object indices
+         */
+        std::vector<iQuadtreeObjectID> _freeObjects;
+
+        /*! amount of objects in tree
+         */
+        uint32 _objectCount = 0;
+
+        /*! amount of nodes in use
+         */
+        uint32 _nodeCount = 1;
+
+        /*! max number of objects before splitting node
+         */
+        const uint32 _splitThreshold;
+
+        /*! max depth of tree
+         */
+        const uint32 _maxDepth;
+
+        /*! insert object starting at given node
+
+        \param nodeIndex the current node
+        \param objectID the object to insert
+        \param depth depth of current node
+        */
+        void insertInternal(uint32 nodeIndex, iQuadtreeObjectID objectID, uint32 depth);
+
+        /*! removes object from the node it is in without merging
+
+        \param objectID the object to unlink
+        \returns index of node the object was in
+        */
+        uint32 unlink(iQuadtreeObjectID objectID);
+
+        /*! merges empty nodes starting at given node upwards
+
+        \param nodeIndex the given node
+        */
+        void mergeUpwards(uint32 nodeIndex);
+
+        /*! adds object to given node
+
+        \param nodeIndex the given node
+        \param objectID the given object
+        */
+        void link(uint32 nodeIndex, iQuadtreeObjectID objectID);
+
+        /*! \returns index of child of given node that contains given position
+
+        \param node the given node
+        \param position the given position
+        */
+        uint32 getChildIndex(const iFlatQuadtreeNode &node, const iaVector2<F> &position) const;
+
+        /*! recursive circle query
+
+        \param nodeIndex the current node
+        \param circle the given circle
+        \param callback the callback to call per found object
+        */
+        template <typename Callback>
+        void queryInternal(uint32 nodeIndex, const iaCircle<F> &circle, Callback &callback) const;
+
+        /*! recursive rectangle query
+
+        \param nodeIndex the current node
+        \param rectangle the given rectangle
+        \param callback the callback to call per found object
+        */
+        template <typename Callback>
+        void queryInternal(uint32 nodeIndex, const iaRectangle<F> &rectangle, Callback &callback) const;
+
+        /*! split given node
+
+        \param nodeIndex the node to split
+        */
+        void split(uint32 nodeIndex);
+
+        /*! try to merge given node
+
+        \param nodeIndex the given node
+        \returns true if node was merged
+        */
+        bool tryMerge(uint32 nodeIndex);
+    };
+
+#include <igor/data/iFlatQuadtree.inl>
+
+} // namespace igor
+
+#endif // __IGOR_FLAT_QUADTREE__
@@ -0,0 +1,411 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename F, typename T>
+iFlatQuadtree<F, T>::iFlatQuadtree(const iaRectangle<F> &box, const uint32 splitThreshold, const uint32 maxDepth)
+    : _splitThreshold(splitThreshold), _maxDepth(maxDepth)
+{
+    _nodes.emplace_back();
+    _nodes[0]._box = box;
+}
+
+template <typename F, typename T>
+iQuadtreeObjectID iFlatQuadtree<F, T>::insert(const iaCircle<F> &circle, const T &userData)
+{
+    if (!iIntersection::intersects(circle._center, _nodes[0]._box))
+    {
+        con_err("position out of bounds ");
+        return INVALID_INDEX;
+    }
+
+    iQuadtreeObjectID objectID;
+    if (!_freeObjects.empty())
+    {
+        objectID = _freeObjects.back();
+        _freeObjects.pop_back();
+    }
+    else
+    {
+        objectID = static_cast<iQuadtreeObjectID>(_objects.size());
+        _objects.emplace_back();
+    }
+
+    iFlatQuadtreeObject &object = _objects[objectID];
+    object._circle = circle;
+    object._userData = userData;
+
+    _objectCount++;
+    insertInternal(0, objectID, 0);
+
+    return objectID;
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::remove(iQuadtreeObjectID objectID)
+{
+    con_assert(objectID < _objects.size() && _objects[objectID]._node != INVALID_INDEX, "invalid object id " << objectID);
+
+    const uint32 nodeIndex = unlink(objectID);
+
+    _objects[objectID]._userData = T();
+    _freeObjects.push_back(objectID);
+    _objectCount--;
+
+    mergeUpwards(_nodes[nodeIndex]._parent);
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::update(iQuadtreeObjectID objectID, const iaVector2<F> &position)
+{
+    iFlatQuadtreeObject &object = _objects[objectID];
+
+    if (iIntersection::intersects(position, _nodes[object._node]._box))
+    {
+        object._circle._center = position;
+        return;
+    }
+
+    const uint32 nodeIndex = unlink(objectID);
+    mergeUpwards(_nodes[nodeIndex]._parent);
+
+    _objects[objectID]._circle._center = position;
+    insertInternal(0, objectID, 0);
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::update(iQuadtreeObjectID objectID, const iaCircle<F> &circle)
+{
+    iFlatQuadtreeObject &object = _objects[objectID];
+
+    if (iIntersection::intersects(circle._center, _nodes[object._node]._box))
+    {
+        object._circle = circle;
+        return;
+    }
+
+    const uint32 nodeIndex = unlink(objectID);
+    mergeUpwards(_nodes[nodeIndex]._parent);
+
+    _objects[objectID]._circle = circle;
+    insertInternal(0, objectID, 0);
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iFlatQuadtree<F, T>::query(const iaCircle<F> &circle, Callback callback) const
+{
+    if (!iIntersection::intersects(circle, _nodes[0]._box))
+    {
+        return;
+    }
+
+    queryInternal(0, circle, callback);
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iFlatQuadtree<F, T>::query(const iaRectangle<F> &rectangle, Callback callback) const
+{
+    if (!iIntersection::intersects(rectangle, _nodes[0]._box))
+    {
+        return;
+    }
+
+    queryInternal(0, rectangle, callback);
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::query(const iaCircle<F> &circle, std::vector<iQuadtreeObjectID> &objects) const
+{
+    query(circle, [&objects](iQuadtreeObjectID objectID, const iFlatQuadtreeObject &object)
+          { objects.push_back(objectID); });
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::query(const iaRectangle<F> &rectangle, std::vector<iQuadtreeObjectID> &objects) const
+{
+    query(rectangle, [&objects](iQuadtreeObjectID objectID, const iFlatQuadtreeObject &object)
+          { objects.push_back(objectID); });
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iFlatQuadtree<F, T>::queryInternal(uint32 nodeIndex, const iaCircle<F> &circle, Callback &callback) const
+{
+    const iFlatQuadtreeNode &node = _nodes[nodeIndex];
+
+    if (node._firstChild == INVALID_INDEX)
+    {
+        for (const iQuadtreeObjectID objectID : node._objects)
+        {
+            const iFlatQuadtreeObject &object = _objects[objectID];
+            if (iIntersection::intersects(object._circle, circle))
+            {
+                callback(objectID, object);
+            }
+        }
+    }
+    else
+    {
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            const uint32 childIndex = node._firstChild + i;
+            if (iIntersection::intersects(circle, _nodes[childIndex]._box))
+            {
+                queryInternal(childIndex, circle, callback);
+            }
+        }
+    }
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iFlatQuadtree<F, T>::queryInternal(uint32 nodeIndex, const iaRectangle<F> &rectangle, Callback &callback) const
+{
+    const iFlatQuadtreeNode &node = _nodes[nodeIndex];
+
+    if (node._firstChild == INVALID_INDEX)
+    {
+        for (const iQuadtreeObjectID objectID : node._objects)
+        {
+            const iFlatQuadtreeObject &object = _objects[objectID];
+            if (iIntersection::intersects(object._circle, rectangle))
+            {
+                callback(objectID, object);
+            }
+        }
+    }
+    else
+    {
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            const uint32 childIndex = node._firstChild + i;
+            if (iIntersection::intersects(rectangle, _nodes[childIndex]._box))
+            {
+                queryInternal(childIndex, rectangle, callback);
+            }
+        }
+    }
+}
+
+template <typename F, typename T>
+uint32 iFlatQuadtree<F, T>::getChildIndex(const iFlatQuadtreeNode &node, const iaVector2<F> &position) const
+{
+    const iaVector2<F> center = node._box.getCenter();
+    uint32 childIndex = 0;
+
+    if (position._x > center._x)
+    {
+        childIndex |= 1;
+    }
+
+    if (position._y > center._y)
+    {
+        childIndex |= 2;
+    }
+
+    return node._firstChild + childIndex;
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::link(uint32 nodeIndex, iQuadtreeObjectID objectID)
+{
+    iFlatQuadtreeNode &node = _nodes[nodeIndex];
+    iFlatQuadtreeObject &object = _objects[objectID];
+
+    object._node = nodeIndex;
+    object._indexInNode = static_cast<uint32>(node._objects.size());
+    node._objects.push_back(objectID);
+}
+
+template <typename F, typename T>
+uint32 iFlatQuadtree<F, T>::unlink(iQuadtreeObjectID objectID)
+{
+    iFlatQuadtreeObject &object = _objects[objectID];
+    const uint32 nodeIndex = object._node;
+    iFlatQuadtreeNode &node = _nodes[nodeIndex];
+
+    // swap with last so removal does not have to search or shift
+    const iQuadtreeObjectID lastID = node._objects.back();
+    node._objects[object._indexInNode] = lastID;
+    _objects[lastID]._indexInNode = object._indexInNode;
+    node._objects.pop_back();
+
+    object._node = INVALID_INDEX;
+    object._indexInNode = INVALID_INDEX;
+
+    return nodeIndex;
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::insertInternal(uint32 nodeIndex, iQuadtreeObjectID objectID, uint32 depth)
+{
+    // check if node has children and follow that branch
+    while (_nodes[nodeIndex]._firstChild != INVALID_INDEX)
+    {
+        nodeIndex = getChildIndex(_nodes[nodeIndex], _objects[objectID]._circle._center);
+        ++depth;
+    }
+
+    // we reached a leaf node. insert data if not full yet
+    if (depth >= _maxDepth || _nodes[nodeIndex]._objects.size() < _splitThreshold)
+    {
+        link(nodeIndex, objectID);
+        return;
+    }
+
+    // leaf node was too full. Split node and try again
+    split(nodeIndex);
+    insertInternal(nodeIndex, objectID, depth + 1);
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::split(uint32 nodeIndex)
+{
+    uint32 firstChild;
+    if (!_freeNodeBlocks.empty())
+    {
+        firstChild = _freeNodeBlocks.back();
+        _freeNodeBlocks.pop_back();
+    }
+    else
+    {
+        // might reallocate so no references to nodes before this
+        firstChild = static_cast<uint32>(_nodes.size());
+        _nodes.resize(_nodes.size() + 4);
+    }
+
+    _nodeCount += 4;
+
+    iFlatQuadtreeNode &node = _nodes[nodeIndex];
+    const iaRectangle<F> &nodeBox = node._box;
+    const F halfWidth = nodeBox._width * 0.5;
+    const F halfHeight = nodeBox._height * 0.5;
+
+    _nodes[firstChild + 0]._box = iaRectangle<F>(nodeBox._x, nodeBox._y, halfWidth, halfHeight);
+    _nodes[firstChild + 1]._box = iaRectangle<F>(nodeBox._x + halfWidth, nodeBox._y, halfWidth, halfHeight);
+    _nodes[firstChild + 2]._box = iaRectangle<F>(nodeBox._x, nodeBox._y + halfHeight, halfWidth, halfHeight);
+    _nodes[firstChild + 3]._box = iaRectangle<F>(nodeBox._x + halfWidth, nodeBox._y + halfHeight, halfWidth, halfHeight);
+
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        iFlatQuadtreeNode &child = _nodes[firstChild + i];
+        child._parent = nodeIndex;
+        child._firstChild = INVALID_INDEX;
+        child._objects.clear();
+    }
+
+    node._firstChild = firstChild;
+
+    for (const iQuadtreeObjectID objectID : node._objects)
+    {
+        link(getChildIndex(node, _objects[objectID]._circle._center), objectID);
+    }
+
+    node._objects.clear();
+}
+
+template <typename F, typename T>
+bool iFlatQuadtree<F, T>::tryMerge(uint32 nodeIndex)
+{
+    iFlatQuadtreeNode &node = _nodes[nodeIndex];
+
+    if (node._firstChild == INVALID_INDEX)
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        const iFlatQuadtreeNode &child = _nodes[node._firstChild + i];
+
+        if (child._firstChild != INVALID_INDEX ||
+            !child._objects.empty())
+        {
+            return false;
+        }
+    }
+
+    _freeNodeBlocks.push_back(node._firstChild);
+    node._firstChild = INVALID_INDEX;
+    _nodeCount -= 4;
+
+    return true;
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::mergeUpwards(uint32 nodeIndex)
+{
+    bool merged = true;
+    while (merged && nodeIndex != INVALID_INDEX)
+    {
+        merged = tryMerge(nodeIndex);
+        nodeIndex = _nodes[nodeIndex]._parent;
+    }
+}
+
+template <typename F, typename T>
+const typename iFlatQuadtree<F, T>::iFlatQuadtreeObject &iFlatQuadtree<F, T>::getObject(iQuadtreeObjectID objectID) const
+{
+    return _objects[objectID];
+}
+
+template <typename F, typename T>
+T &iFlatQuadtree<F, T>::getUserData(iQuadtreeObjectID objectID)
+{
+    return _objects[objectID]._userData;
+}
+
+template <typename F, typename T>
+const typename iFlatQuadtree<F, T>::iFlatQuadtreeNode &iFlatQuadtree<F, T>::getNode(uint32 index) const
+{
+    return _nodes[index];
+}
+
+template <typename F, typename T>
+uint32 iFlatQuadtree<F, T>::getRoot() const
+{
+    return 0;
+}
+
+template <typename F, typename T>
+bool iFlatQuadtree<F, T>::isLeaf(uint32 index) const
+{
+    return _nodes[index]._firstChild == INVALID_INDEX;
+}
+
+template <typename F, typename T>
+uint32 iFlatQuadtree<F, T>::getObjectCount() const
+{
+    return _objectCount;
+}
+
+template <typename F, typename T>
+uint32 iFlatQuadtree<F, T>::getNodeCount() const
+{
+    return _nodeCount;
+}
+
+template <typename F, typename T>
+void iFlatQuadtree<F, T>::clear()
+{
+    const iaRectangle<F> box = _nodes[0]._box;
+
+    _nodes.resize(1);
+    _nodes[0]._box = box;
+    _nodes[0]._firstChild = INVALID_INDEX;
+    _nodes[0]._objects.clear();
+
+    _freeNodeBlocks.clear();
+    _objects.clear();
+    _freeObjects.clear();
+    _objectCount = 0;
+    _nodeCount = 1;
+}
+
+template <typename F, typename T>
+const iaRectangle<F> &iFlatQuadtree<F, T>::getRootBox() const
+{
+    return _nodes[0]._box;
+}
@@ -264,7 +264,8 @@ template <typename T>
 bool iIntersection::intersects(const iaCircle<T> &circleA, const iaCircle<T> &circleB)
 {
     const T diffSq = circleA._center.distance2(circleB._center);
-    return diffSq <= circleA._radius * circleA._radius + circleB._radius * circleB._radius;
+    const T radii = circleA._radius + circleB._radius;
+    return diffSq <= radii * radii;
 }
 
 template <typename T>
@@ -12,6 +12,16 @@
 #include <iaux/system/iaConsole.h>
 using namespace iaux;
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IGOR_OCTREE_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IGOR_OCTREE_SSE2
+#endif
+
+#include <cmath>
+
 namespace igor
 {
 
@@ -33,31 +43,16 @@ namespace igor
                        objectCountMaxThreashold > objectCountMinThreashold,
                    "invalid configuration");
 
-        _rootNode = createNode();
-        _nodes[_rootNode]->_box = box;
+        _nodes.resize(1);
+        _nodes[0]._box = box;
     }
 
     iOctree::~iOctree()
     {
         clearFilter();
-
-        for(auto object : _objects)
-        {
-            if(object.second != nullptr)
-            {
-                delete object.second;
-            }
-        }
         _objects.clear();
-
-        for(auto node : _nodes)
-        {
-            if(node.second != nullptr)
-            {
-                delete node.second;
-            }
-        }
         _nodes.clear();
+        _freeNodeBlocks.clear();
     }
 
     void iOctree::clearFilter()
@@ -82,206 +77,190 @@ namespace igor
         _spheresFilter.push_back(sphere);
     }
 
-    iOctree::OctreeObject *iOctree::createObject(void *userData, const iaSphered &sphere)
-    {
-        OctreeObject *object = new OctreeObject();
-        object->_octreeNode = 0;
-        object->_sphere = sphere;
-        _objects[userData] = object;
-        return object;
-    }
-
-    void iOctree::deleteObject(void *userData)
+    uint32 iOctree::allocateNodeBlock()
     {
-        auto iter = _objects.find(userData);
-        if (_objects.end() != iter)
+        if (!_freeNodeBlocks.empty())
         {
-            delete (*iter).second;
-            _objects.erase(iter);
+            const uint32 result = _freeNodeBlocks.back();
+            _freeNodeBlocks.pop_back();
+            return result;
         }
-    }
-
-    void iOctree::deleteNode(uint64 nodeID)
-    {
-        auto nodeIter = _nodes.find(nodeID);
 
-        con_assert(_nodes.end() != nodeIter, "node does not exist");
-        con_assert(nullptr == (*nodeIter).second->_children, "node still has children");
-        con_assert(0 == (*nodeIter).second->_objects.size(), "inconsistend data");
-
-        if (_nodes.end() != nodeIter)
-        {
-            _nodes.erase(nodeIter);
-        }
+        const uint32 result = static_cast<uint32>(_nodes.size());
+        _nodes.resize(_nodes.size() + 8);
+        return result;
     }
 
-    uint64 iOctree::createNode()
+    void iOctree::addObject(uint32 nodeIndex, void *userData, const iaVector3d &center, float64 radius)
     {
-        OctreeNode *node = new OctreeNode();
-        _nodes[_nextNodeID] = node;
-        return _nextNodeID++;
+        OctreeNode &node = _nodes[nodeIndex];
+
+        OctreeObject &object = _objects[userData];
+        object._node = nodeIndex;
+        object._indexInNode = static_cast<uint32>(node._userData.size());
+
+        node._maxRadius = std::max(node._maxRadius, radius);
+        node._userData.push_back(userData);
+        node._centerX.push_back(center._x);
+        node._centerY.push_back(center._y);
+        node._centerZ.push_back(center._z);
+        node._radius.push_back(radius);
     }
 
-    void iOctree::insert(uint64 nodeID, void *userData, const iaSphered &sphere)
+    void iOctree::removeObject(uint32 nodeIndex, uint32 indexInNode)
     {
-        OctreeNode *node = _nodes[nodeID];
-        con_assert(node != nullptr, "zero pointer");
+        OctreeNode &node = _nodes[nodeIndex];
+        const uint32 lastIndex = static_cast<uint32>(node._userData.size()) - 1;
 
-        if (nullptr != node->_children)
+        if (indexInNode != lastIndex)
         {
-            int index = 0;
+            node._userData[indexInNode] = node._userData[lastIndex];
+            node._centerX[indexInNode] = node._centerX[lastIndex];
+            node._centerY[indexInNode] = node._centerY[lastIndex];
+            node._centerZ[indexInNode] = node._centerZ[lastIndex];
+            node._radius[indexInNode] = node._radius[lastIndex];
 
-            if (sphere._center._x > node->_box._center._x)
-            {
-                index |= 1;
-            }
+            _objects[node._userData[indexInNode]]._indexInNode = indexInNode;
+        }
 
-            if (sphere._center._y > node->_box._center._y)
-            {
-                index |= 2;
-            }
+        node._userData.pop_back();
+        node._centerX.pop_back();
+        node._centerY.pop_back();
+        node._centerZ.pop_back();
+        node._radius.pop_back();
+    }
 
-            if (sphere._center._z > node->_box._center._z)
-            {
-                index |= 4;
-            }
+    uint32 iOctree::getChildIndex(const OctreeNode &node, const iaVector3d &position) const
+    {
+        uint32 index = 0;
 
-            insert(node->_children[index], userData, sphere);
-        }
-        else
+        if (position._x > node._box._center._x)
         {
-            OctreeObject *object = createObject(userData, sphere);
-            object->_octreeNode = nodeID;
-            node->_objects.push_back(userData);
-
-            trySplit(nodeID);
+            index |= 1;
         }
-    }
 
-    void iOctree::trySplit(uint64 nodeID)
-    {
-        OctreeNode *node = _nodes[nodeID];
-        con_assert(node != nullptr, "zero pointer");
+        if (position._y > node._box._center._y)
+        {
+            index |= 2;
+        }
 
-        if (node->_box._halfEdgeLength > _halfMinResolution &&
-            node->_objects.size() >= _objectCountMaxThreashold)
+        if (position._z > node._box._center._z)
         {
-            split(nodeID);
+            index |= 4;
         }
+
+        return index;
     }
 
     void iOctree::insert(void *userData, const iaSphered &sphere)
     {
-        OctreeNode *rootNode = _nodes[_rootNode];
-
-        if (!iIntersection::intersects(sphere._center, rootNode->_box))
+        if (!iIntersection::intersects(sphere._center, _nodes[0]._box))
         {
             con_err(" out of bounds " << sphere._center);
             return;
         }
 
-        insert(_rootNode, userData, sphere);
-    }
+        con_assert(_objects.find(userData) == _objects.end(), "object already registered");
 
-    void iOctree::split(uint64 nodeID)
-    {
-        con_assert(nullptr == _nodes[nodeID]->_children, "can't split because has no children");
+        uint32 nodeIndex = 0;
+        while (_nodes[nodeIndex]._firstChild != INVALID_NODE)
+        {
+            OctreeNode &node = _nodes[nodeIndex];
+            node._maxRadius = std::max(node._maxRadius, sphere._radius);
+            nodeIndex = node._firstChild + getChildIndex(node, sphere._center);
+        }
 
-        OctreeNode *node = _nodes[nodeID];
-        float64 halfSize = node->_box._halfEdgeLength * 0.5;
+        addObject(nodeIndex, userData, sphere._center, sphere._radius);
+        trySplit(nodeIndex);
+    }
 
-        node->_children = new uint64[8];
+    void iOctree::trySplit(uint32 nodeIndex)
+    {
+        const OctreeNode &node = _nodes[nodeIndex];
 
-        for (int i = 0; i < 8; ++i)
+        if (node._box._halfEdgeLength > _halfMinResolution &&
+            node._userData.size() >= _objectCountMaxThreashold)
         {
-            iaVector3d position = _splitTable[i];
-            position *= halfSize;
-            position += node->_box._center;
-
-            uint64 newNodeID = createNode();
-            OctreeNode *newNode = _nodes[newNodeID];
-            newNode->_box._center = position;
-            newNode->_box._halfEdgeLength = halfSize;
-            newNode->_parent = nodeID;
-            node->_children[i] = newNodeID;
+            split(nodeIndex);
         }
+    }
 
-        for (auto userData : node->_objects)
-        {
-            iaVector3d position = _objects[userData]->_sphere._center;
-
-            int index = 0;
-            if (position._x > node->_box._center._x)
-            {
-                index |= 1;
-            }
+    void iOctree::split(uint32 nodeIndex)
+    {
+        con_assert(_nodes[nodeIndex]._firstChild == INVALID_NODE, "node already has children");
 
-            if (position._y > node->_box._center._y)
-            {
-                index |= 2;
-            }
+        // allocating might move the nodes so we get references only afterwards
+        const uint32 firstChild = allocateNodeBlock();
 
-            if (position._z > node->_box._center._z)
-            {
-                index |= 4;
-            }
+        OctreeNode &node = _nodes[nodeIndex];
+        node._firstChild = firstChild;
+        const float64 halfSize = node._box._halfEdgeLength * 0.5;
 
-            uint64 destinationNodeID = node->_children[index];
-            OctreeNode *destination = _nodes[destinationNodeID];
-            destination->_objects.push_back(userData);
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            OctreeNode &child = _nodes[firstChild + i];
+            child._box._center = _splitTable[i] * halfSize + node._box._center;
+            child._box._halfEdgeLength = halfSize;
+            child._parent = nodeIndex;
+            child._firstChild = INVALID_NODE;
+            child._maxRadius = 0.0;
+        }
 
-            OctreeObject *object = _objects[userData];
-            object->_octreeNode = destinationNodeID;
+        for (uint32 i = 0; i < node._userData.size(); ++i)
+        {
+            const iaVector3d center(node._centerX[i], node._centerY[i], node._centerZ[i]);
+            addObject(firstChild + getChildIndex(node, center), node._userData[i], center, node._radius[i]);
         }
 
-        node->_objects.clear();
+        node._userData.clear();
+        node._centerX.clear();
+        node._centerY.clear();
+        node._centerZ.clear();
+        node._radius.clear();
 
-        for (int i = 0; i < 8; ++i)
+        for (uint32 i = 0; i < 8; ++i)
         {
-            trySplit(node->_children[i]);
+            trySplit(firstChild + i);
         }
     }
 
     void iOctree::remove(void *userData)
     {
-        con_assert(_objects.end() != _objects.find(userData), "object to remove is not registered");
+        auto iter = _objects.find(userData);
+        con_assert(_objects.end() != iter, "object to remove is not registered");
 
-        if (_objects.end() != _objects.find(userData))
+        if (_objects.end() == iter)
         {
-            uint64 nodeID = _objects[userData]->_octreeNode;
-            OctreeNode *node = _nodes[nodeID];
+            return;
+        }
 
-            auto iterObjectID = find(node->_objects.begin(), node->_objects.end(), userData);
-            if (node->_objects.end() != iterObjectID)
-            {
-                node->_objects.erase(iterObjectID);
-                deleteObject(userData);
-            }
+        const uint32 nodeIndex = iter->second._node;
+        const uint32 indexInNode = iter->second._indexInNode;
+        _objects.erase(iter);
 
-            if (node->_parent != 0)
-            {
-                tryMerge(node->_parent);
-            }
+        removeObject(nodeIndex, indexInNode);
+
+        const uint32 parent = _nodes[nodeIndex]._parent;
+        if (parent != INVALID_NODE)
+        {
+            tryMerge(parent);
         }
     }
 
-    void iOctree::tryMerge(uint64 nodeID)
+    void iOctree::tryMerge(uint32 nodeIndex)
     {
-        auto iter = _nodes.find(nodeID);
-        con_assert(_nodes.end() != iter, "inconsistend data");
-
-        OctreeNode *node = (*iter).second;
-        con_assert(nullptr != node->_children, "inconsistend data");
+        const OctreeNode &node = _nodes[nodeIndex];
+        con_assert(node._firstChild != INVALID_NODE, "inconsistent data");
 
         uint64 objectCount = 0;
         bool nested = false;
 
-        for (int i = 0; i < 8; ++i)
+        for (uint32 i = 0; i < 8; ++i)
         {
-            auto child = _nodes[node->_children[i]];
-            objectCount += static_cast<uint64>(child->_objects.size());
+            const OctreeNode &child = _nodes[node._firstChild + i];
+            objectCount += static_cast<uint64>(child._userData.size());
 
-            if (nullptr != child->_children)
+            if (child._firstChild != INVALID_NODE)
             {
                 nested = true;
             }
@@ -290,120 +269,282 @@ namespace igor
         if (objectCount <= _objectCountMinThreashold &&
             !nested)
         {
-            merge(nodeID);
+            merge(nodeIndex);
         }
     }
 
-    void iOctree::merge(uint64 nodeID)
+    void iOctree::merge(uint32 nodeIndex)
     {
-        con_assert(nullptr != _nodes[nodeID]->_children, "does not have children to merge");
+        con_assert(_nodes[nodeIndex]._firstChild != INVALID_NODE, "does not have children to merge");
 
-        OctreeNode *node = _nodes[nodeID];
+        const uint32 firstChild = _nodes[nodeIndex]._firstChild;
 
-        for (int i = 0; i < 8; ++i)
+        for (uint32 i = 0; i < 8; ++i)
         {
-            auto childID = node->_children[i];
-            auto child = _nodes[childID];
-            auto objects = child->_objects;
-            auto object = objects.begin();
+            OctreeNode &child = _nodes[firstChild + i];
 
-            while (objects.end() != object)
+            for (uint32 j = 0; j < child._userData.size(); ++j)
             {
-                node->_objects.push_back((*object));
-                _objects[(*object)]->_octreeNode = nodeID;
-                object++;
+                addObject(nodeIndex, child._userData[j], iaVector3d(child._centerX[j], child._centerY[j], child._centerZ[j]), child._radius[j]);
             }
 
-            child->_parent = 0;
-            child->_objects.clear();
-            deleteNode(childID);
+            // clear keeps the capacity so the block is cheap to reuse
+            child._userData.clear();
+            child._centerX.clear();
+            child._centerY.clear();
+            child._centerZ.clear();
+            child._radius.clear();
+            child._parent = INVALID_NODE;
         }
 
-        delete[] node->_children;
-        node->_children = 0;
+        _nodes[nodeIndex]._firstChild = INVALID_NODE;
+        _freeNodeBlocks.push_back(firstChild);
     }
 
     void iOctree::update(void *userData, const iaSphered &sphere)
     {
-        if (_objects.find(userData) != _objects.end())
+        if (!updateExisting(userData, sphere))
         {
-            auto object = _objects[userData];
-            con_assert_sticky(object != nullptr, "corrupt data");
+            insert(userData, sphere);
+        }
+    }
 
-            if (object->_sphere != sphere)
-            {
-                object->_sphere = sphere;
+    bool iOctree::updateExisting(void *userData, const iaSphered &sphere)
+    {
+        auto iter = _objects.find(userData);
+        if (iter == _objects.end())
+        {
+            return false;
+        }
 
-                auto node = _nodes[object->_octreeNode];
-                if (!iIntersection::intersects(sphere._center, node->_box))
-                {
-                    remove(userData);
-                    insert(userData, sphere);
-                }
+        OctreeNode &node = _nodes[iter->second._node];
+        const uint32 index = iter->second._indexInNode;
+
+        if (node._centerX[index] == sphere._center._x &&
+            node._centerY[index] == sphere._center._y &&
+            node._centerZ[index] == sphere._center._z &&
+            node._radius[index] == sphere._radius)
+        {
+            return true;
+        }
+
+        if (iIntersection::intersects(sphere._center, node._box))
+        {
+            node._centerX[index] = sphere._center._x;
+            node._centerY[index] = sphere._center._y;
+            node._centerZ[index] = sphere._center._z;
+            node._radius[index] = sphere._radius;
+
+            // the bounds only ever grow until the node gets merged
+            uint32 nodeIndex = iter->second._node;
+            while (nodeIndex != INVALID_NODE &&
+                   _nodes[nodeIndex]._maxRadius < sphere._radius)
+            {
+                _nodes[nodeIndex]._maxRadius = sphere._radius;
+                nodeIndex = _nodes[nodeIndex]._parent;
             }
         }
         else
         {
+            remove(userData);
             insert(userData, sphere);
         }
+
+        return true;
     }
 
     void iOctree::filter(const iFrustumd &frustum)
     {
-        _queryResult.clear();
-        filter(_rootNode, frustum);
+        filter(frustum, _queryResult);
+    }
+
+    void iOctree::filter(const iFrustumd &frustum, std::vector<void *> &result)
+    {
+        const iPlaned *planes[6] = {&frustum._nearPlane, &frustum._leftPlane, &frustum._rightPlane,
+                                    &frustum._bottomPlane, &frustum._topPlane, &frustum._farPlane};
+
+        for (int i = 0; i < 6; ++i)
+        {
+            const iPlaned &plane = *planes[i];
+            _cullPlanes._normalX[i] = plane._normal._x;
+            _cullPlanes._normalY[i] = plane._normal._y;
+            _cullPlanes._normalZ[i] = plane._normal._z;
+            _cullPlanes._distance[i] = plane._distance;
+            _cullPlanes._extent[i] = std::abs(plane._normal._x) + std::abs(plane._normal._y) + std::abs(plane._normal._z);
+        }
+
+        result.clear();
+        filterFrustum(0, false, result);
     }
 
-    void iOctree::filter(uint64 nodeID, const iFrustumd &frustum)
+    void iOctree::filterFrustum(uint32 nodeIndex, bool inside, std::vector<void *> &result)
     {
-        OctreeNode *node = _nodes[nodeID];
+        const OctreeNode &node = _nodes[nodeIndex];
 
-        if (iIntersection::intersects(node->_box, frustum))
+        if (!inside)
         {
-            for (const auto userData : node->_objects)
+            const iaVector3d &center = node._box._center;
+            const float64 halfEdgeLength = node._box._halfEdgeLength;
+            inside = true;
+
+            for (int i = 0; i < 6; ++i)
             {
-                if (iIntersection::intersects(_objects[userData]->_sphere, frustum))
+                const float64 distance = _cullPlanes._normalX[i] * center._x + _cullPlanes._normalY[i] * center._y + _cullPlanes._normalZ[i] * center._z - _cullPlanes._distance[i];
+
+                // same conservative test as iIntersection::inFrontOf(cube, plane) but grown by the objects reaching out of the node
+                if (distance <= -(halfEdgeLength + node._maxRadius) * 3)
+                {
+                    return;
+                }
+
+                // all corners of the cube are in front of the plane
+                if (distance <= halfEdgeLength * _cullPlanes._extent[i])
                 {
-                    _queryResult.push_back(userData);
+                    inside = false;
                 }
             }
+        }
 
-            if (nullptr != node->_children)
+        if (inside)
+        {
+            // object centers are always within their node so the objects can't be outside the frustum
+            result.insert(result.end(), node._userData.begin(), node._userData.end());
+        }
+        else
+        {
+            cullObjects(node, result);
+        }
+
+        if (node._firstChild != INVALID_NODE)
+        {
+            for (uint32 i = 0; i < 8; ++i)
             {
-                for (uint64 i = 0; i < 8; ++i)
+                filterFrustum(node._firstChild + i, inside, result);
+            }
+        }
+    }
+
+    void iOctree::cullObjects(const OctreeNode &node, std::vector<void *> &result)
+    {
+        const uint32 count = static_cast<uint32>(node._userData.size());
+        const float64 *centerX = node._centerX.data();
+        const float64 *centerY = node._centerY.data();
+        const float64 *centerZ = node._centerZ.data();
+        const float64 *radius = node._radius.data();
+        uint32 i = 0;
+
+#if defined(IGOR_OCTREE_AVX)
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m256d x = _mm256_loadu_pd(centerX + i);
+            const __m256d y = _mm256_loadu_pd(centerY + i);
+            const __m256d z = _mm256_loadu_pd(centerZ + i);
+            const __m256d negRadius = _mm256_sub_pd(_mm256_setzero_pd(), _mm256_loadu_pd(radius + i));
+            __m256d visible = _mm256_cmp_pd(negRadius, negRadius, _CMP_EQ_OQ);
+
+            for (int p = 0; p < 6; ++p)
+            {
+                const __m256d distance = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(_cullPlanes._normalX[p])),
+                                                                                   _mm256_mul_pd(y, _mm256_set1_pd(_cullPlanes._normalY[p]))),
+                                                                     _mm256_mul_pd(z, _mm256_set1_pd(_cullPlanes._normalZ[p]))),
+                                                       _mm256_set1_pd(_cullPlanes._distance[p]));
+                visible = _mm256_and_pd(visible, _mm256_cmp_pd(distance, negRadius, _CMP_GT_OQ));
+            }
+
+            const int mask = _mm256_movemask_pd(visible);
+            for (int j = 0; j < 4; ++j)
+            {
+                if (mask & (1 << j))
                 {
-                    filter(node->_children[i], frustum);
+                    result.push_back(node._userData[i + j]);
                 }
             }
         }
+#elif defined(IGOR_OCTREE_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            // two registers of two doubles each so we still test 4 spheres per iteration
+            const __m128d x0 = _mm_loadu_pd(centerX + i);
+            const __m128d x1 = _mm_loadu_pd(centerX + i + 2);
+            const __m128d y0 = _mm_loadu_pd(centerY + i);
+            const __m128d y1 = _mm_loadu_pd(centerY + i + 2);
+            const __m128d z0 = _mm_loadu_pd(centerZ + i);
+            const __m128d z1 = _mm_loadu_pd(centerZ + i + 2);
+            const __m128d negRadius0 = _mm_sub_pd(_mm_setzero_pd(), _mm_loadu_pd(radius + i));
+            const __m128d negRadius1 = _mm_sub_pd(_mm_setzero_pd(), _mm_loadu_pd(radius + i + 2));
+            __m128d visible0 = _mm_cmpeq_pd(negRadius0, negRadius0);
+            __m128d visible1 = _mm_cmpeq_pd(negRadius1, negRadius1);
+
+            for (int p = 0; p < 6; ++p)
+            {
+                const __m128d normalX = _mm_set1_pd(_cullPlanes._normalX[p]);
+                const __m128d normalY = _mm_set1_pd(_cullPlanes._normalY[p]);
+                const __m128d normalZ = _mm_set1_pd(_cullPlanes._normalZ[p]);
+                const __m128d distance = _mm_set1_pd(_cullPlanes._distance[p]);
+
+                const __m128d distance0 = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x0, normalX), _mm_mul_pd(y0, normalY)), _mm_mul_pd(z0, normalZ)), distance);
+                const __m128d distance1 = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x1, normalX), _mm_mul_pd(y1, normalY)), _mm_mul_pd(z1, normalZ)), distance);
+
+                visible0 = _mm_and_pd(visible0, _mm_cmpgt_pd(distance0, negRadius0));
+                visible1 = _mm_and_pd(visible1, _mm_cmpgt_pd(distance1, negRadius1));
+            }
+
+            const int mask = _mm_movemask_pd(visible0) | (_mm_movemask_pd(visible1) << 2);
+            for (int j = 0; j < 4; ++j)
+            {
+                if (mask & (1 << j))
+                {
+                    result.push_back(node._userData[i + j]);
+                }
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            bool visible = true;
+
+            for (int p = 0; p < 6; ++p)
+            {
+                const float64 distance = centerX[i] * _cullPlanes._normalX[p] + centerY[i] * _cullPlanes._normalY[p] + centerZ[i] * _cullPlanes._normalZ[p] - _cullPlanes._distance[p];
+                visible &= distance > -radius[i];
+            }
+
+            if (visible)
+            {
+                result.push_back(node._userData[i]);
+            }
+        }
     }
 
     void iOctree::filter()
     {
         _queryResult.clear();
-        filter(_rootNode);
+        filter(0);
     }
 
-    void iOctree::filter(uint64 nodeID)
+    void iOctree::filter(uint32 nodeIndex)
     {
-        OctreeNode *node = _nodes[nodeID];
+        const OctreeNode &node = _nodes[nodeIndex];
+
+        if (!testFilter(iAACubed(node._box._center, node._box._halfEdgeLength + node._maxRadius)))
+        {
+            return;
+        }
 
-        if (testFilter(node->_box))
+        for (uint32 i = 0; i < node._userData.size(); ++i)
         {
-            for (auto objectID : node->_objects)
+            if (testFilter(iaSphered(iaVector3d(node._centerX[i], node._centerY[i], node._centerZ[i]), node._radius[i])))
             {
-                if (testFilter(_objects[objectID]->_sphere))
-                {
-                    _queryResult.push_back(objectID);
-                }
+                _queryResult.push_back(node._userData[i]);
             }
+        }
 
-            if (nullptr != node->_children)
+        if (node._firstChild != INVALID_NODE)
+        {
+            for (uint32 i = 0; i < 8; ++i)
             {
-                for (uint64 i = 0; i < 8; ++i)
-                {
-                    filter(node->_children[i]);
-                }
+                filter(node._firstChild + i);
             }
         }
     }
@@ -455,9 +596,9 @@ namespace igor
             }
         }
 
-        for (auto sphere : _spheresFilter)
+        for (const auto &filterSphere : _spheresFilter)
         {
-            if (!iIntersection::intersects(sphere, sphere))
+            if (!iIntersection::intersects(sphere, filterSphere))
             {
                 return false;
             }
@@ -475,22 +616,22 @@ namespace igor
     {
         iaMatrixd matrix;
         iRenderer::getInstance().setModelMatrix(matrix);
-        draw(_rootNode);
+        draw(0);
     }
 
-    float32 iOctree::draw(uint64 nodeID)
+    float32 iOctree::draw(uint32 nodeIndex)
     {
-        OctreeNode *node = _nodes[nodeID];
+        const OctreeNode &node = _nodes[nodeIndex];
         float32 alpha = 0.4;
 
-        if (nullptr != node->_children)
+        if (node._firstChild != INVALID_NODE)
         {
-            for (int i = 0; i < 8; ++i)
+            for (uint32 i = 0; i < 8; ++i)
             {
-                alpha = std::min(alpha, draw(node->_children[i]));
+                alpha = std::min(alpha, draw(node._firstChild + i));
             }
 
-            iRenderer::getInstance().drawBox(node->_box, iaColor4f(0, 0, 1, alpha));
+            iRenderer::getInstance().drawBox(node._box, iaColor4f(0, 0, 1, alpha));
         }
 
         alpha *= 0.7;
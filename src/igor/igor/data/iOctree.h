@@ -34,8 +34,6 @@
 
 #include <iaux/data/iaSphere.h>
 
-#include <memory>
-#include <list>
 #include <unordered_map>
 #include <vector>
 
@@ -43,6 +41,9 @@ namespace igor
 {
 
     /*! \brief Octree implementation
+
+    nodes are kept in one contiguous array and the objects of each node are stored as structure of arrays
+    so culling against a frustum can test several bounding spheres at once
     */
     class IGOR_API iOctree
     {
@@ -62,12 +63,20 @@ namespace igor
 
         /*! update user data in octree
 
-        this is called usually if the user data changed it's position
+        this is called usually if the user data changed it's position. Unknown user data gets inserted
 
         \param userData pointer to user data
         */
         void update(void* userData, const iaSphered &sphere);
 
+        /*! update user data in octree only if it is in the octree
+
+        \param userData pointer to user data
+        \param sphere the new bounding sphere
+        \returns false if the user data is not in the octree
+        */
+        bool updateExisting(void* userData, const iaSphered &sphere);
+
         /*! adds frustum to filter set
 
         \param frustum the frustum
@@ -104,6 +113,15 @@ namespace igor
         */
         void filter(const iFrustumd &frustum);
 
+        /*! filters the octree with given frustum and writes the result in to given list
+
+        does not touch the result returned by getResult
+
+        \param frustum the given frustum
+        \param[out] result the filtered user data
+        */
+        void filter(const iFrustumd &frustum, std::vector<void *> &result);
+
         /*! returns the result of filtering
 
         \returns the filtered user data
@@ -120,7 +138,6 @@ namespace igor
         iOctree(const iAACubed &box, float64 halfMinResolution = 1.0, uint64 objectCountMaxThreashold = 8, uint64 objectCountMinThreashold = 2);
 
         /*! dtor
-        \bug not implemented
         */
         virtual ~iOctree();
 
@@ -131,22 +148,28 @@ namespace igor
         void draw();
 
     private:
+        /*! invalid node index
+         */
+        static constexpr uint32 INVALID_NODE = 0xffffffff;
+
         /*! represents an object within the octree
          */
         struct OctreeObject
         {
-            /*! id of paranting octree node
+            /*! index of parenting octree node
              */
-            uint64 _octreeNode;
+            uint32 _node = INVALID_NODE;
 
-            /*! sphere of object
+            /*! index of object within the parenting nodes object arrays
              */
-            iaSphered _sphere;
+            uint32 _indexInNode = 0;
         };
 
         /*! octree node of certain size
 
-        can contain other nodes and objects
+        the objects of a node are stored as structure of arrays so they can be culled in batches
+
+        children of a node are always allocated as a block of 8 consecutive nodes
         */
         struct OctreeNode
         {
@@ -154,31 +177,86 @@ namespace igor
              */
             iAACubed _box;
 
-            /*! octree nodes child nodes
+            /*! the parenting octree node
              */
-            uint64 *_children = nullptr;
+            uint32 _parent = INVALID_NODE;
 
-            /*! the parenting octree node
+            /*! index of first of 8 consecutive child nodes
+             */
+            uint32 _firstChild = INVALID_NODE;
+
+            /*! upper bound of the radius of all objects in this node and it's children
+
+            objects can reach out of their node so this is used to make the node tests conservative
+            */
+            float64 _maxRadius = 0.0;
+
+            /*! user data of objects in this node
+             */
+            std::vector<void *> _userData;
+
+            /*! x component of the objects sphere centers
+             */
+            std::vector<float64> _centerX;
+
+            /*! y component of the objects sphere centers
+             */
+            std::vector<float64> _centerY;
+
+            /*! z component of the objects sphere centers
+             */
+            std::vector<float64> _centerZ;
+
+            /*! radius of the objects spheres
              */
-            uint64 _parent = 0;
+            std::vector<float64> _radius;
+        };
+
+        /*! frustum planes prepared for batched culling
+         */
+        struct CullPlanes
+        {
+            /*! x component of plane normals
+             */
+            float64 _normalX[6];
+
+            /*! y component of plane normals
+             */
+            float64 _normalY[6];
 
-            /*! list of user data
+            /*! z component of plane normals
              */
-            std::vector<void*> _objects;
+            float64 _normalZ[6];
+
+            /*! plane distances
+             */
+            float64 _distance[6];
+
+            /*! sum of absolute normal components used to test if a cube lies completely in front of a plane
+             */
+            float64 _extent[6];
         };
 
-        /*! recursive method to filter the octree with a set of filters starting with specified node id
+        /*! recursive method to filter the octree with a set of filters starting with specified node
 
-        \param nodeID current octree node to check for filtering
+        \param nodeIndex current octree node to check for filtering
         */
-        void filter(uint64 nodeID);
+        void filter(uint32 nodeIndex);
 
-        /*! specialized version of filter function only filtering for given frustum
+        /*! specialized version of filter function only filtering for the prepared cull planes
 
-        \param nodeID current octree node to check for filtering
-        \param frustum the given frustum
+        \param nodeIndex current octree node to check for filtering
+        \param inside if true the node is known to be completely inside the frustum
+        \param[out] result the filtered user data
         */
-        void filter(uint64 nodeID, const iFrustumd &frustum);
+        void filterFrustum(uint32 nodeIndex, bool inside, std::vector<void *> &result);
+
+        /*! tests all objects of given node against the prepared cull planes and adds the visible ones to the result
+
+        \param node the node to cull the objects of
+        \param[out] result the filtered user data
+        */
+        void cullObjects(const OctreeNode &node, std::vector<void *> &result);
 
         /*! lookup table for faster split of octree node volumes
          */
@@ -188,33 +266,33 @@ namespace igor
          */
         float64 _halfMinResolution = 0;
 
-        /*! minimum amount of objects in the child nodes of a node before merging them together
-         */
-        uint64 _objectCountMinThreashold = 0;
-
         /*! maximum amount of objects before splitting the parenting octree node
          */
         uint64 _objectCountMaxThreashold = 0;
 
-        /*! the id of the next node created
+        /*! minimum amount of objects in the child nodes of a node before merging them together
          */
-        uint64 _nextNodeID = 1;
+        uint64 _objectCountMinThreashold = 0;
 
         /*! lookup table for all objects within the octree
          */
-        std::unordered_map<void*, OctreeObject *> _objects;
+        std::unordered_map<void *, OctreeObject> _objects;
 
-        /*! lookup table for all nodes within the octree
+        /*! all nodes of the octree. root node is at index 0
          */
-        std::unordered_map<uint64, OctreeNode *> _nodes;
+        std::vector<OctreeNode> _nodes;
 
-        /*! id of the root node
+        /*! indices of unused blocks of 8 nodes
          */
-        uint64 _rootNode;
+        std::vector<uint32> _freeNodeBlocks;
+
+        /*! planes used while filtering by frustum
+         */
+        CullPlanes _cullPlanes;
 
         /*! internal list for filtering
          */
-        std::vector<void*> _queryResult;
+        std::vector<void *> _queryResult;
 
         /*! spheres filter list
          */
@@ -228,39 +306,37 @@ namespace igor
          */
         std::vector<iFrustumd> _frustumFilter;
 
-        /*! recursive function to insert a scene node to the octree
-
-        if the right place is fount a octree object will be created the represents the scene node
+        /*! returns index of child node the given position belongs to
 
-        \param nodeID the current octree node in rucursion
-        \param userData the id of the scene node to bind to the octree object
-        \param position position of scene node volume
+        \param node the parent node
+        \param position the given position
+        \returns child index 0-7
         */
-        void insert(uint64 nodeID, void* userData, const iaSphered &sphere);
+        uint32 getChildIndex(const OctreeNode &node, const iaVector3d &position) const;
 
         /*! check if node has to be split and than split
 
-        \param nodeID node to be checked for splitting
+        \param nodeIndex node to be checked for splitting
         */
-        void trySplit(uint64 nodeID);
+        void trySplit(uint32 nodeIndex);
 
         /*! splits an octree node
 
-        \param nodeID node to be split
+        \param nodeIndex node to be split
         */
-        void split(uint64 nodeID);
+        void split(uint32 nodeIndex);
 
         /*! check if node should be merged with it's children and then merge
 
-        \param nodeID node to be checked for merging
+        \param nodeIndex node to be checked for merging
         */
-        void tryMerge(uint64 nodeID);
+        void tryMerge(uint32 nodeIndex);
 
         /*! merges node and it's children to one node
 
-        \param nodeID node to be merged with it's children
+        \param nodeIndex node to be merged with it's children
         */
-        void merge(uint64 nodeID);
+        void merge(uint32 nodeIndex);
 
         /*! text sphere against filter
 
@@ -276,38 +352,35 @@ namespace igor
         */
         bool testFilter(const iAACubed &cube);
 
-        /*! creates a node and returns the new node id
-
-        \returns node id
-        */
-        uint64 createNode();
-
-        /*! deletes a node by id
+        /*! allocates a block of 8 consecutive nodes
 
-        \param nodeID node to be deleted
+        \returns index of first node in block
         */
-        void deleteNode(uint64 nodeID);
+        uint32 allocateNodeBlock();
 
-        /*! creates an octree object
+        /*! adds object to given node
 
-        \param userData scene node to associate the octree object with
-        \returns pointer to new octree object
+        \param nodeIndex the node to add the object to
+        \param userData the user data of the object
+        \param center center of the objects sphere
+        \param radius radius of the objects sphere
         */
-        OctreeObject *createObject(void* userData, const iaSphered &sphere);
+        void addObject(uint32 nodeIndex, void *userData, const iaVector3d &center, float64 radius);
 
-        /*! deletes an octree object by scene node id
+        /*! removes object from given node by swapping it with the last object of that node
 
-        \param userData id of the corresponding scene node
+        \param nodeIndex the node to remove the object from
+        \param indexInNode index of object within node
         */
-        void deleteObject(void* userData);
+        void removeObject(uint32 nodeIndex, uint32 indexInNode);
 
         /*! recursive method to draw the octree structure
 
         only use for debugging!
 
-        \param nodeID id of the current octree node
+        \param nodeIndex index of the current octree node
         */
-        float32 draw(uint64 nodeID);
+        float32 draw(uint32 nodeIndex);
     };
 
     /*! octree pointer definition
@@ -38,6 +38,8 @@
 #include <algorithm>
 #include <memory>
 #include <any>
+#include <limits>
+#include <queue>
 
 namespace igor
 {
@@ -153,6 +155,59 @@ namespace igor
         */
         void query(const iaRectangle<F> &rectangle, std::vector<std::shared_ptr<iQuadtreeObject>> &objects);
 
+        /*! calls callback for every object within given rectangle
+
+        \param rectangle the given rectangle
+        \param callback callable with signature void(const ObjectPtr &object)
+        */
+        template <typename Callback>
+        void query(const iaRectangle<F> &rectangle, Callback callback) const;
+
+        /*! calls callback once for every pair of overlapping objects
+
+        two objects overlap if the distance of their centers is not bigger than the sum of their radii times radiusScale.
+        traverses the tree once per leaf instead of once per object.
+        only pairs whose first object lies in the given range of leaves are reported so the leaf range can be split up and processed in parallel
+
+        \param leafBegin first leaf index
+        \param leafEnd leaf index after the last leaf
+        \param callback callable with signature void(const ObjectPtr &objectA, const ObjectPtr &objectB)
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        template <typename Callback>
+        void queryPairs(uint32 leafBegin, uint32 leafEnd, Callback callback, F radiusScale = 1.0) const;
+
+        /*! calls callback once for every pair of overlapping objects
+
+        \param callback callable with signature void(const ObjectPtr &objectA, const ObjectPtr &objectB)
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        template <typename Callback>
+        void queryPairs(Callback callback, F radiusScale = 1.0) const;
+
+        /*! queries all pairs of overlapping objects
+
+        \param pairs the resulting pairs of objects
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        void queryPairs(std::vector<std::pair<std::shared_ptr<iQuadtreeObject>, std::shared_ptr<iQuadtreeObject>>> &pairs, F radiusScale = 1.0) const;
+
+        /*! \returns amount of leaves containing objects
+
+        that is the leaf range to use with queryPairs
+        */
+        uint32 getLeafCount() const;
+
+        /*! queries the k nearest objects to given position
+
+        distance is measured between the centers
+
+        \param position the given position
+        \param k the amount of objects to find
+        \param objects the resulting objects sorted by distance, closest first
+        */
+        void queryNearest(const iaVector2<F> &position, uint32 k, std::vector<std::shared_ptr<iQuadtreeObject>> &objects);
+
         /*! clears the tree
          */
         void clear();
@@ -166,6 +221,7 @@ namespace igor
         using ObjectPtr = std::shared_ptr<iQuadtreeObject>;
         using NodePtr = std::shared_ptr<iQuadtreeNode>;
         using Objects = std::vector<ObjectPtr>;
+        using ObjectPairs = std::vector<std::pair<ObjectPtr, ObjectPtr>>;
 
     private:
         /*! root node
@@ -211,6 +267,31 @@ namespace igor
         */
         void queryInternal(const std::shared_ptr<iQuadtreeNode> &node, const iaRectangle<F> &rectangle, std::vector<std::shared_ptr<iQuadtreeObject>> &objects);
 
+        /*! calls callback for every object within given rectangle
+
+        \param node the current node
+        \param rectangle the given rectangle
+        \param callback the callback
+        */
+        template <typename Callback>
+        void queryInternal(const iQuadtreeNode *node, const iaRectangle<F> &rectangle, Callback &callback) const;
+
+        /*! collects all leaves with objects and the biggest object radius
+
+        \param node the current node
+        \param leaves the resulting leaves
+        \param maxRadius the biggest radius found
+        */
+        void collectLeaves(iQuadtreeNode *node, std::vector<iQuadtreeNode *> &leaves, F &maxRadius) const;
+
+        /*! collects all leaves with objects that intersect with given rectangle
+
+        \param node the current node
+        \param rectangle the given rectangle
+        \param leaves the resulting leaves
+        */
+        void collectLeaves(iQuadtreeNode *node, const iaRectangle<F> &rectangle, std::vector<iQuadtreeNode *> &leaves) const;
+
         /*! split given node
 
         \param node the node to split
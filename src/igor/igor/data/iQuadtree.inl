@@ -58,6 +58,45 @@ void iQuadtree<F>::queryInternal(const std::shared_ptr<iQuadtreeNode> &node, con
     }
 }
 
+template <typename F>
+template <typename Callback>
+void iQuadtree<F>::query(const iaRectangle<F> &rectangle, Callback callback) const
+{
+    if (!iIntersection::intersects(rectangle, _root->_box))
+    {
+        return;
+    }
+
+    queryInternal(_root.get(), rectangle, callback);
+}
+
+template <typename F>
+template <typename Callback>
+void iQuadtree<F>::queryInternal(const iQuadtreeNode *node, const iaRectangle<F> &rectangle, Callback &callback) const
+{
+    if (node->_children[0] == nullptr)
+    {
+        for (const auto &object : node->_objects)
+        {
+            if (iIntersection::intersects(object->_circle, rectangle))
+            {
+                callback(object);
+            }
+        }
+
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const iQuadtreeNode *child = node->_children[i].get();
+        if (iIntersection::intersects(rectangle, child->_box))
+        {
+            queryInternal(child, rectangle, callback);
+        }
+    }
+}
+
 template <typename F>
 void iQuadtree<F>::queryInternal(const std::shared_ptr<iQuadtreeNode> &node, const iaCircle<F> &circle, std::vector<std::shared_ptr<iQuadtreeObject>> &objects)
 {
@@ -292,3 +331,202 @@ const iaRectangle<F> &iQuadtree<F>::getRootBox() const
 {
     return _root->_box;
 }
+
+template <typename F>
+void iQuadtree<F>::collectLeaves(iQuadtreeNode *node, std::vector<iQuadtreeNode *> &leaves, F &maxRadius) const
+{
+    if (node->_children[0] == nullptr)
+    {
+        if (node->_objects.empty())
+        {
+            return;
+        }
+
+        leaves.push_back(node);
+
+        for (const auto &object : node->_objects)
+        {
+            maxRadius = std::max(maxRadius, object->_circle._radius);
+        }
+
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        collectLeaves(node->_children[i].get(), leaves, maxRadius);
+    }
+}
+
+template <typename F>
+void iQuadtree<F>::collectLeaves(iQuadtreeNode *node, const iaRectangle<F> &rectangle, std::vector<iQuadtreeNode *> &leaves) const
+{
+    if (node->_children[0] == nullptr)
+    {
+        if (!node->_objects.empty())
+        {
+            leaves.push_back(node);
+        }
+
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        iQuadtreeNode *child = node->_children[i].get();
+        if (iIntersection::intersects(rectangle, child->_box))
+        {
+            collectLeaves(child, rectangle, leaves);
+        }
+    }
+}
+
+template <typename F>
+template <typename Callback>
+void iQuadtree<F>::queryPairs(uint32 leafBegin, uint32 leafEnd, Callback callback, F radiusScale) const
+{
+    std::vector<iQuadtreeNode *> leaves;
+    F maxRadius = 0;
+    collectLeaves(_root.get(), leaves, maxRadius);
+
+    leafEnd = std::min(leafEnd, static_cast<uint32>(leaves.size()));
+
+    // objects are sorted in to leaves by center only so neighbours might be in any leaf within this range
+    const F range = maxRadius * 2.0 * radiusScale;
+    std::vector<iQuadtreeNode *> neighbours;
+
+    for (uint32 leafIndex = leafBegin; leafIndex < leafEnd; ++leafIndex)
+    {
+        const iQuadtreeNode *leaf = leaves[leafIndex];
+        const iaRectangle<F> &box = leaf->_box;
+        const iaRectangle<F> area(box._x - range, box._y - range, box._width + range * 2.0, box._height + range * 2.0);
+
+        neighbours.clear();
+        collectLeaves(_root.get(), area, neighbours);
+
+        for (const auto &objectA : leaf->_objects)
+        {
+            const iaCircle<F> &circleA = objectA->_circle;
+
+            for (iQuadtreeNode *neighbour : neighbours)
+            {
+                for (const auto &objectB : neighbour->_objects)
+                {
+                    // every pair gets reported by the object with the lower address only
+                    if (objectB.get() <= objectA.get())
+                    {
+                        continue;
+                    }
+
+                    const iaCircle<F> &circleB = objectB->_circle;
+                    const F radii = (circleA._radius + circleB._radius) * radiusScale;
+
+                    if (circleA._center.distance2(circleB._center) <= radii * radii)
+                    {
+                        callback(objectA, objectB);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename F>
+template <typename Callback>
+void iQuadtree<F>::queryPairs(Callback callback, F radiusScale) const
+{
+    queryPairs(0, std::numeric_limits<uint32>::max(), callback, radiusScale);
+}
+
+template <typename F>
+void iQuadtree<F>::queryPairs(std::vector<std::pair<std::shared_ptr<iQuadtreeObject>, std::shared_ptr<iQuadtreeObject>>> &pairs, F radiusScale) const
+{
+    queryPairs([&pairs](const std::shared_ptr<iQuadtreeObject> &objectA, const std::shared_ptr<iQuadtreeObject> &objectB)
+               { pairs.emplace_back(objectA, objectB); },
+               radiusScale);
+}
+
+template <typename F>
+uint32 iQuadtree<F>::getLeafCount() const
+{
+    std::vector<iQuadtreeNode *> leaves;
+    F maxRadius = 0;
+    collectLeaves(_root.get(), leaves, maxRadius);
+
+    return static_cast<uint32>(leaves.size());
+}
+
+template <typename F>
+void iQuadtree<F>::queryNearest(const iaVector2<F> &position, uint32 k, std::vector<std::shared_ptr<iQuadtreeObject>> &objects)
+{
+    objects.clear();
+
+    if (k == 0)
+    {
+        return;
+    }
+
+    auto boxDistance = [&position](const iaRectangle<F> &box)
+    {
+        const F dx = std::max(std::max(box._x - position._x, static_cast<F>(0)), position._x - (box._x + box._width));
+        const F dy = std::max(std::max(box._y - position._y, static_cast<F>(0)), position._y - (box._y + box._height));
+        return dx * dx + dy * dy;
+    };
+
+    // nodes ordered by distance, closest first
+    typedef std::pair<F, iQuadtreeNode *> NodeEntry;
+    std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> nodes;
+    nodes.emplace(boxDistance(_root->_box), _root.get());
+
+    // max heap of the k closest objects so far
+    std::vector<std::pair<F, const std::shared_ptr<iQuadtreeObject> *>> heap;
+    heap.reserve(k + 1);
+
+    while (!nodes.empty())
+    {
+        const NodeEntry entry = nodes.top();
+        nodes.pop();
+
+        if (heap.size() == k && entry.first >= heap.front().first)
+        {
+            break;
+        }
+
+        iQuadtreeNode *node = entry.second;
+
+        if (node->_children[0] != nullptr)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                iQuadtreeNode *child = node->_children[i].get();
+                nodes.emplace(boxDistance(child->_box), child);
+            }
+
+            continue;
+        }
+
+        for (const auto &object : node->_objects)
+        {
+            const F distance = position.distance2(object->_circle._center);
+
+            if (heap.size() < k)
+            {
+                heap.emplace_back(distance, &object);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (distance < heap.front().first)
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = std::make_pair(distance, &object);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+
+    for (const auto &pair : heap)
+    {
+        objects.push_back(*pair.second);
+    }
+}
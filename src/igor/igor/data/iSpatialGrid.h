@@ -0,0 +1,245 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_SPATIAL_GRID__
+#define __IGOR_SPATIAL_GRID__
+
+#include <igor/iDefines.h>
+#include <igor/data/iIntersection.h>
+
+#include <iaux/data/iaRectangle.h>
+#include <iaux/data/iaCircle.h>
+#include <iaux/system/iaConsole.h>
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+namespace igor
+{
+    /*! uniform grid for 2D broad phase queries
+
+    meant to be rebuilt every frame. add all entries, call build and then query.
+    entries are sorted by the cell their center is in and stored contiguously per cell.
+    positions outside the grid get clamped to the border cells
+    */
+    template <typename F, typename T>
+    class IGOR_API_EXPORT_ONLY iSpatialGrid
+    {
+
+    public:
+        /*! grid entry
+         */
+        struct iSpatialGridEntry
+        {
+            /*! the circle of this entry
+             */
+            iaCircle<F> _circle;
+
+            /*! user data
+             */
+            T _userData;
+        };
+
+        /*! creates the grid
+
+        \param box volume of the whole grid
+        \param cellSize edge length of a cell. should be about the diameter of typical entries or the typical query radius
+        */
+        iSpatialGrid(const iaRectangle<F> &box, F cellSize);
+
+        /*! dtor
+         */
+        virtual ~iSpatialGrid() = default;
+
+        /*! removes all entries but keeps allocated memory
+         */
+        void clear();
+
+        /*! adds an entry
+
+        the entry is not visible to queries until build was called
+
+        \param circle position and radius of the entry
+        \param userData the user data
+        \returns index of new entry
+        */
+        uint32 add(const iaCircle<F> &circle, const T &userData);
+
+        /*! sorts all entries in to their cells
+         */
+        void build();
+
+        /*! calls callback for every entry within given circle
+
+        \param circle the given circle
+        \param callback callable with signature void(uint32 index, const iSpatialGridEntry &entry)
+        */
+        template <typename Callback>
+        void query(const iaCircle<F> &circle, Callback callback) const;
+
+        /*! calls callback for every entry within given rectangle
+
+        \param rectangle the given rectangle
+        \param callback callable with signature void(uint32 index, const iSpatialGridEntry &entry)
+        */
+        template <typename Callback>
+        void query(const iaRectangle<F> &rectangle, Callback callback) const;
+
+        /*! queries for entries within given circle
+
+        \param circle the given circle
+        \param entries the resulting entry indices
+        */
+        void query(const iaCircle<F> &circle, std::vector<uint32> &entries) const;
+
+        /*! calls callback once for every pair of overlapping entries
+
+        two entries overlap if the distance of their centers is not bigger than the sum of their radii times radiusScale.
+        only pairs whose first entry lies in the given cell range are reported so the cell range can be split up and processed in parallel
+
+        \param cellBegin first cell index
+        \param cellEnd cell index after the last cell
+        \param callback callable with signature void(uint32 indexA, uint32 indexB)
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        template <typename Callback>
+        void queryPairs(uint32 cellBegin, uint32 cellEnd, Callback callback, F radiusScale = 1.0) const;
+
+        /*! calls callback once for every pair of overlapping entries
+
+        \param callback callable with signature void(uint32 indexA, uint32 indexB)
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        template <typename Callback>
+        void queryPairs(Callback callback, F radiusScale = 1.0) const;
+
+        /*! queries all pairs of overlapping entries
+
+        \param pairs the resulting pairs of entry indices
+        \param radiusScale scale applied to the radii for the overlap test
+        */
+        void queryPairs(std::vector<std::pair<uint32, uint32>> &pairs, F radiusScale = 1.0) const;
+
+        /*! queries the k nearest entries to given position
+
+        distance is measured between the centers
+
+        \param position the given position
+        \param k the amount of entries to find
+        \param entries the resulting entry indices sorted by distance, closest first
+        */
+        void queryNearest(const iaVector2<F> &position, uint32 k, std::vector<uint32> &entries) const;
+
+        /*! \returns entry for given index
+
+        \param index the given index
+        */
+        const iSpatialGridEntry &getEntry(uint32 index) const;
+
+        /*! \returns amount of entries
+         */
+        uint32 getEntryCount() const;
+
+        /*! \returns amount of cells
+         */
+        uint32 getCellCount() const;
+
+        /*! \returns cell size
+         */
+        F getCellSize() const;
+
+        /*! \returns dimensions of grid
+         */
+        const iaRectangle<F> &getRootBox() const;
+
+        using Entry = iSpatialGridEntry;
+
+    private:
+        /*! dimensions of grid
+         */
+        iaRectangle<F> _box;
+
+        /*! edge length of cells
+         */
+        F _cellSize;
+
+        /*! amount of cells along x axis
+         */
+        int32 _cellsX;
+
+        /*! amount of cells along y axis
+         */
+        int32 _cellsY;
+
+        /*! all entries in order of adding
+         */
+        std::vector<iSpatialGridEntry> _entries;
+
+        /*! entry indices sorted by cell
+         */
+        std::vector<uint32> _sortedEntries;
+
+        /*! index in to _sortedEntries where each cell starts. has one extra element at the end
+         */
+        std::vector<uint32> _cellStart;
+
+        /*! cell index per entry
+         */
+        std::vector<uint32> _entryCells;
+
+        /*! the biggest radius of all entries
+         */
+        F _maxRadius = 0;
+
+        /*! \returns cell coordinate for given position along x axis
+         */
+        int32 getCellX(F x) const;
+
+        /*! \returns cell coordinate for given position along y axis
+         */
+        int32 getCellY(F y) const;
+
+        /*! calls callback for every entry in cells within given range
+
+        \param minX min cell x coordinate
+        \param minY min cell y coordinate
+        \param maxX max cell x coordinate
+        \param maxY max cell y coordinate
+        \param callback callable with signature void(uint32 index)
+        */
+        template <typename Callback>
+        void forEachInCells(int32 minX, int32 minY, int32 maxX, int32 maxY, Callback callback) const;
+    };
+
+#include <igor/data/iSpatialGrid.inl>
+
+} // namespace igor
+
+#endif // __IGOR_SPATIAL_GRID__
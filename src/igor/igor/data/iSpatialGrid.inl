@@ -0,0 +1,292 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename F, typename T>
+iSpatialGrid<F, T>::iSpatialGrid(const iaRectangle<F> &box, F cellSize)
+    : _box(box), _cellSize(cellSize)
+{
+    con_assert(cellSize > 0, "invalid cell size");
+
+    _cellsX = std::max(1, static_cast<int32>(std::ceil(box._width / cellSize)));
+    _cellsY = std::max(1, static_cast<int32>(std::ceil(box._height / cellSize)));
+    _cellStart.resize(_cellsX * _cellsY + 1, 0);
+}
+
+template <typename F, typename T>
+void iSpatialGrid<F, T>::clear()
+{
+    _entries.clear();
+    _sortedEntries.clear();
+    _entryCells.clear();
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+    _maxRadius = 0;
+}
+
+template <typename F, typename T>
+uint32 iSpatialGrid<F, T>::add(const iaCircle<F> &circle, const T &userData)
+{
+    _entries.push_back({circle, userData});
+    return static_cast<uint32>(_entries.size() - 1);
+}
+
+template <typename F, typename T>
+int32 iSpatialGrid<F, T>::getCellX(F x) const
+{
+    return std::clamp(static_cast<int32>(std::floor((x - _box._x) / _cellSize)), 0, _cellsX - 1);
+}
+
+template <typename F, typename T>
+int32 iSpatialGrid<F, T>::getCellY(F y) const
+{
+    return std::clamp(static_cast<int32>(std::floor((y - _box._y) / _cellSize)), 0, _cellsY - 1);
+}
+
+template <typename F, typename T>
+void iSpatialGrid<F, T>::build()
+{
+    const uint32 cellCount = getCellCount();
+    _maxRadius = 0;
+
+    // counting sort by cell
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+    _entryCells.resize(_entries.size());
+
+    for (uint32 i = 0; i < _entries.size(); ++i)
+    {
+        const iaCircle<F> &circle = _entries[i]._circle;
+        const uint32 cell = getCellY(circle._center._y) * _cellsX + getCellX(circle._center._x);
+
+        _entryCells[i] = cell;
+        _cellStart[cell + 1]++;
+        _maxRadius = std::max(_maxRadius, circle._radius);
+    }
+
+    for (uint32 cell = 0; cell < cellCount; ++cell)
+    {
+        _cellStart[cell + 1] += _cellStart[cell];
+    }
+
+    std::vector<uint32> fill(_cellStart.begin(), _cellStart.end() - 1);
+    _sortedEntries.resize(_entries.size());
+
+    for (uint32 i = 0; i < _entries.size(); ++i)
+    {
+        _sortedEntries[fill[_entryCells[i]]++] = i;
+    }
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iSpatialGrid<F, T>::forEachInCells(int32 minX, int32 minY, int32 maxX, int32 maxY, Callback callback) const
+{
+    for (int32 y = minY; y <= maxY; ++y)
+    {
+        const uint32 rowStart = y * _cellsX;
+        const uint32 begin = _cellStart[rowStart + minX];
+        const uint32 end = _cellStart[rowStart + maxX + 1];
+
+        // cells of a row are next to each other so the whole row is one range
+        for (uint32 i = begin; i < end; ++i)
+        {
+            callback(_sortedEntries[i]);
+        }
+    }
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iSpatialGrid<F, T>::query(const iaCircle<F> &circle, Callback callback) const
+{
+    const F range = circle._radius + _maxRadius;
+
+    forEachInCells(getCellX(circle._center._x - range), getCellY(circle._center._y - range),
+                   getCellX(circle._center._x + range), getCellY(circle._center._y + range),
+                   [&](uint32 index)
+                   {
+                       const iSpatialGridEntry &entry = _entries[index];
+                       if (iIntersection::intersects(entry._circle, circle))
+                       {
+                           callback(index, entry);
+                       }
+                   });
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iSpatialGrid<F, T>::query(const iaRectangle<F> &rectangle, Callback callback) const
+{
+    forEachInCells(getCellX(rectangle._x - _maxRadius), getCellY(rectangle._y - _maxRadius),
+                   getCellX(rectangle._x + rectangle._width + _maxRadius), getCellY(rectangle._y + rectangle._height + _maxRadius),
+                   [&](uint32 index)
+                   {
+                       const iSpatialGridEntry &entry = _entries[index];
+                       if (iIntersection::intersects(entry._circle, rectangle))
+                       {
+                           callback(index, entry);
+                       }
+                   });
+}
+
+template <typename F, typename T>
+void iSpatialGrid<F, T>::query(const iaCircle<F> &circle, std::vector<uint32> &entries) const
+{
+    query(circle, [&entries](uint32 index, const iSpatialGridEntry &entry)
+          { entries.push_back(index); });
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iSpatialGrid<F, T>::queryPairs(uint32 cellBegin, uint32 cellEnd, Callback callback, F radiusScale) const
+{
+    cellEnd = std::min(cellEnd, getCellCount());
+
+    for (uint32 cell = cellBegin; cell < cellEnd; ++cell)
+    {
+        for (uint32 i = _cellStart[cell]; i < _cellStart[cell + 1]; ++i)
+        {
+            const uint32 indexA = _sortedEntries[i];
+            const iaCircle<F> &circleA = _entries[indexA]._circle;
+            const F range = (circleA._radius + _maxRadius) * radiusScale;
+
+            forEachInCells(getCellX(circleA._center._x - range), getCellY(circleA._center._y - range),
+                           getCellX(circleA._center._x + range), getCellY(circleA._center._y + range),
+                           [&](uint32 indexB)
+                           {
+                               // every pair gets reported by the entry with the lower index only
+                               if (indexB <= indexA)
+                               {
+                                   return;
+                               }
+
+                               const iaCircle<F> &circleB = _entries[indexB]._circle;
+                               const F radii = (circleA._radius + circleB._radius) * radiusScale;
+
+                               if (circleA._center.distance2(circleB._center) <= radii * radii)
+                               {
+                                   callback(indexA, indexB);
+                               }
+                           });
+        }
+    }
+}
+
+template <typename F, typename T>
+template <typename Callback>
+void iSpatialGrid<F, T>::queryPairs(Callback callback, F radiusScale) const
+{
+    queryPairs(0, getCellCount(), callback, radiusScale);
+}
+
+template <typename F, typename T>
+void iSpatialGrid<F, T>::queryPairs(std::vector<std::pair<uint32, uint32>> &pairs, F radiusScale) const
+{
+    queryPairs([&pairs](uint32 indexA, uint32 indexB)
+               { pairs.emplace_back(indexA, indexB); },
+               radiusScale);
+}
+
+template <typename F, typename T>
+void iSpatialGrid<F, T>::queryNearest(const iaVector2<F> &position, uint32 k, std::vector<uint32> &entries) const
+{
+    entries.clear();
+
+    if (k == 0 || _entries.empty())
+    {
+        return;
+    }
+
+    // max heap of the k closest so far
+    std::vector<std::pair<F, uint32>> heap;
+    heap.reserve(k + 1);
+
+    const int32 centerX = getCellX(position._x);
+    const int32 centerY = getCellY(position._y);
+    const int32 maxRing = std::max(_cellsX, _cellsY);
+
+    for (int32 ring = 0; ring <= maxRing; ++ring)
+    {
+        const int32 minX = centerX - ring;
+        const int32 maxX = centerX + ring;
+        const int32 minY = centerY - ring;
+        const int32 maxY = centerY + ring;
+
+        for (int32 y = std::max(0, minY); y <= std::min(_cellsY - 1, maxY); ++y)
+        {
+            // inner rows only have the two border cells of the ring
+            const bool fullRow = (y == minY || y == maxY);
+            const int32 step = fullRow ? 1 : std::max(1, maxX - minX);
+
+            for (int32 x = minX; x <= maxX; x += step)
+            {
+                if (x < 0 || x >= _cellsX)
+                {
+                    continue;
+                }
+
+                const uint32 cell = y * _cellsX + x;
+                for (uint32 i = _cellStart[cell]; i < _cellStart[cell + 1]; ++i)
+                {
+                    const uint32 index = _sortedEntries[i];
+                    const F distance = position.distance2(_entries[index]._circle._center);
+
+                    if (heap.size() < k)
+                    {
+                        heap.emplace_back(distance, index);
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                    else if (distance < heap.front().first)
+                    {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = std::make_pair(distance, index);
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
+        }
+
+        // everything in the next ring is at least this far away
+        const F ringDistance = static_cast<F>(ring) * _cellSize;
+        if (heap.size() == k && heap.front().first <= ringDistance * ringDistance)
+        {
+            break;
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+
+    for (const auto &pair : heap)
+    {
+        entries.push_back(pair.second);
+    }
+}
+
+template <typename F, typename T>
+const typename iSpatialGrid<F, T>::iSpatialGridEntry &iSpatialGrid<F, T>::getEntry(uint32 index) const
+{
+    return _entries[index];
+}
+
+template <typename F, typename T>
+uint32 iSpatialGrid<F, T>::getEntryCount() const
+{
+    return static_cast<uint32>(_entries.size());
+}
+
+template <typename F, typename T>
+uint32 iSpatialGrid<F, T>::getCellCount() const
+{
+    return static_cast<uint32>(_cellsX * _cellsY);
+}
+
+template <typename F, typename T>
+F iSpatialGrid<F, T>::getCellSize() const
+{
+    return _cellSize;
+}
+
+template <typename F, typename T>
+const iaRectangle<F> &iSpatialGrid<F, T>::getRootBox() const
+{
+    return _box;
+}
@@ -143,6 +143,38 @@ namespace igor
         /*! the world matrix of this transform
          */
         iaMatrixd _worldMatrix;
+
+        /*! if true the transform gets recalculated during next update even if nothing changed
+         */
+        bool _dirty = true;
+
+        /*! true if local matrix changed but world matrix was not updated yet
+
+        only used by entities with parent
+        */
+        bool _localChanged = false;
+
+        /*! number of the update during which the world matrix changed last
+
+        unique over all transform hierarchy systems
+         */
+        uint64 _changedFrame = 0;
+
+        /*! matrix build from position, orientation and scale
+         */
+        iaMatrixd _localMatrix;
+
+        /*! position used to build the local matrix
+         */
+        iaVector3d _localPosition;
+
+        /*! orientation used to build the local matrix
+         */
+        iaVector3d _localOrientation;
+
+        /*! scale used to build the local matrix
+         */
+        iaVector3d _localScale;
     };
 
     /*! hierarchy component to create parent child relationships
@@ -157,9 +189,9 @@ namespace igor
          */
         int32 _childCount = 0;
 
-        /*! the higher the number the more generations are below it
+        /*! count of ancestors of this entity. zero for entities without parent
 
-        this is used for sorting entities by hierarchy
+        maintained by iEntity::setParent. Parents always have a lower generation than their children
         */
         int32 _generation = 0;
     };
@@ -8,9 +8,48 @@
 
 #include <entt.h>
 
+#include <algorithm>
+
 namespace igor
 {
 
+    /*! updates the generations of all descendants of given entity
+
+    \param registry the registry the entity lives in
+    \param entity the given entity
+    */
+    static void updateDescendantGenerations(entt::registry *registry, entt::entity entity)
+    {
+        std::vector<entt::entity> parents = {entity};
+        std::vector<entt::entity> children;
+        auto hierarchyView = registry->view<iHierarchyComponent>();
+
+        // one pass over all hierarchies per generation below the given entity. only happens if an entity that has children gets a new parent
+        while (!parents.empty())
+        {
+            for (auto entityID : hierarchyView)
+            {
+                auto &hierarchy = hierarchyView.get<iHierarchyComponent>(entityID);
+                const entt::entity parentID = static_cast<entt::entity>(hierarchy._parent);
+
+                if (std::find(parents.begin(), parents.end(), parentID) == parents.end())
+                {
+                    continue;
+                }
+
+                hierarchy._generation = hierarchyView.get<iHierarchyComponent>(parentID)._generation + 1;
+
+                if (hierarchy._childCount != 0)
+                {
+                    children.push_back(entityID);
+                }
+            }
+
+            parents.swap(children);
+            children.clear();
+        }
+    }
+
     iEntity::iEntity(const iEntityID entity, iEntityScenePtr scene)
         : _entity(entity), _scene(scene)
     {
@@ -153,6 +192,7 @@ namespace igor
             }
 
             component->_parent = IGOR_INVALID_ENTITY_ID;
+            component->_generation = 0;
         }
 
         if (parent != IGOR_INVALID_ENTITY_ID)
@@ -161,12 +201,23 @@ namespace igor
             if (parentComponent == nullptr)
             {
                 parentComponent = &(registry->emplace_or_replace<iHierarchyComponent>(static_cast<entt::entity>(parent)));
+
+                // emplacing might have moved the components around
+                component = &(registry->get<iHierarchyComponent>(static_cast<entt::entity>(_entity)));
             }
 
             parentComponent->_childCount++;
+            component->_generation = parentComponent->_generation + 1;
         }
 
         component->_parent = parent;
+
+        if (component->_childCount != 0)
+        {
+            updateDescendantGenerations(registry, static_cast<entt::entity>(_entity));
+        }
+
+        _scene->onHierarchyChanged();
     }
 
     iEntityID iEntity::getParent() const
@@ -219,4 +270,12 @@ namespace igor
         return component->_type;
     }
 
+    void iEntity::setZIndex(int32 zIndex)
+    {
+        auto *registry = static_cast<entt::registry *>(_scene->getRegistry());
+
+        registry->patch<iSpriteRendererComponent>(static_cast<entt::entity>(_entity), [zIndex](iSpriteRendererComponent &spriteRender)
+                                                  { spriteRender._zIndex = zIndex; });
+    }
+
 }
\ No newline at end of file
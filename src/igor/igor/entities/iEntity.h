@@ -116,6 +116,12 @@ namespace igor
          */
         iMotionInteractionType getMotionInteractionType() const;
 
+        /*! sets z index of the entity's sprite
+
+        \param zIndex the z index
+        */
+        void setZIndex(int32 zIndex);
+
         /*! adds component to entity
 
         \param component the component to add
@@ -12,6 +12,7 @@
 #include <igor/entities/systems/iQuadtreeSystem.h>
 #include <igor/entities/systems/iAnimationSystem.h>
 #include <igor/renderer/iRenderer.h>
+#include <igor/threading/iTaskManager.h>
 
 #include <utility>
 #include <tuple>
@@ -20,6 +21,9 @@
 
 namespace igor
 {
+    /*! below this amount of entities per chunk it's not worth splitting up a view
+     */
+    static const uint64 MIN_CHUNK_SIZE = 1024;
 
     // for debugging
     static void renderQuadtree(const iQuadtreed::NodePtr &node)
@@ -54,6 +58,36 @@ namespace igor
     {
         _registry = new iRegistry();
 
+        // create all storages up front so systems running concurrently never modify the registry's pool map
+        auto &registry = _registry->_registry;
+        registry.storage<iBaseEntityComponent>();
+        registry.storage<iActiveComponent>();
+        registry.storage<iDeleteComponent>();
+        registry.storage<iSpriteRendererComponent>();
+        registry.storage<iTransformComponent>();
+        registry.storage<iHierarchyComponent>();
+        registry.storage<iBody2DComponent>();
+        registry.storage<iCircleCollision2DComponent>();
+        registry.storage<iVelocityComponent>();
+        registry.storage<iBehaviourComponent>();
+        registry.storage<iGlobalBoundaryComponent>();
+        registry.storage<iMotionInteractionResolverComponent>();
+        registry.storage<iCameraComponent>();
+        registry.storage<iRenderDebugComponent>();
+        registry.storage<iPartyComponent>();
+        registry.storage<iAnimationComponent>();
+
+        // the sprite render system only sorts and collects its sprites again after one of these happened
+        registry.on_construct<iSpriteRendererComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_update<iSpriteRendererComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_destroy<iSpriteRendererComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_construct<iBody2DComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_destroy<iBody2DComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_construct<iTransformComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_destroy<iTransformComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_construct<iActiveComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+        registry.on_destroy<iActiveComponent>().connect<&iEntityScene::onSpritesChanged>(*this);
+
         _systems.push_back(std::make_shared<iAnimationSystem>());
         _systems.push_back(std::make_shared<iBehaviourSystem>());
 
@@ -63,6 +97,8 @@ namespace igor
         _systems.push_back(std::make_shared<iQuadtreeSystem>());
 
         _renderingSystems.push_back(std::make_shared<iSpriteRenderSystem>());
+
+        buildStages();
     }
 
     iEntityScene::~iEntityScene()
@@ -72,13 +108,20 @@ namespace igor
             delete _quadtree;
         }
 
+        if (_grid != nullptr)
+        {
+            delete _grid;
+        }
+
         delete _registry;
     }
 
     void iEntityScene::clear()
     {
         _systems.clear();
+        buildStages();
         _registry->_registry.clear();
+        onHierarchyChanged();
     }
 
     void iEntityScene::setBounds(const iAABoxd &box)
@@ -91,11 +134,18 @@ namespace igor
         return _velocitySystem->getBounds();
     }
 
-    void iEntityScene::initializeQuadtree(const iaRectangled &box, const uint32 splitThreshold, const uint32 maxDepth)
+    void iEntityScene::initializeQuadtree(const iaRectangled &box, const uint32 splitThreshold, const uint32 maxDepth, iSpatialPartitionType type, float64 cellSize)
     {
-        con_assert(_quadtree == nullptr, "Quadtree already initialized");
+        con_assert(_quadtree == nullptr && _grid == nullptr, "Quadtree already initialized");
 
-        _quadtree = new iQuadtreed(box, splitThreshold, maxDepth);
+        if (type == iSpatialPartitionType::Grid)
+        {
+            _grid = new iEntityGrid(box, cellSize);
+        }
+        else
+        {
+            _quadtree = new iQuadtreed(box, splitThreshold, maxDepth);
+        }
     }
 
     iQuadtreed &iEntityScene::getQuadtree() const
@@ -109,13 +159,171 @@ namespace igor
         return _quadtree != nullptr;
     }
 
+    iEntityGrid &iEntityScene::getGrid() const
+    {
+        con_assert(_grid != nullptr, "Grid not initialized");
+        return *_grid;
+    }
+
+    bool iEntityScene::hasGrid() const
+    {
+        return _grid != nullptr;
+    }
+
+    void iEntityScene::queryEntities(const iaCircled &circle, std::vector<iEntityID> &entities) const
+    {
+        if (_grid != nullptr)
+        {
+            _grid->query(circle, [&entities](uint32 index, const iEntityGrid::Entry &entry)
+                         { entities.push_back(entry._userData); });
+        }
+        else if (_quadtree != nullptr)
+        {
+            iQuadtreed::Objects objects;
+            _quadtree->query(circle, objects);
+
+            for (const auto &object : objects)
+            {
+                entities.push_back(std::any_cast<iEntityID>(object->_userData));
+            }
+        }
+    }
+
+    void iEntityScene::buildStages()
+    {
+        _stages.clear();
+        _systemTimings.clear();
+
+        for (uint32 index = 0; index < _systems.size(); ++index)
+        {
+            const iEntitySystemPtr &system = _systems[index];
+            bool joinStage = !_stages.empty();
+
+            if (joinStage)
+            {
+                for (const uint32 otherIndex : _stages.back())
+                {
+                    if (system->conflictsWith(*_systems[otherIndex]))
+                    {
+                        joinStage = false;
+                        break;
+                    }
+                }
+            }
+
+            if (!joinStage)
+            {
+                _stages.emplace_back();
+            }
+
+            _stages.back().push_back(index);
+
+            iEntitySystemTiming timing;
+            timing._name = system->getName();
+            timing._stage = static_cast<uint32>(_stages.size() - 1);
+            _systemTimings.push_back(timing);
+        }
+    }
+
+    void iEntityScene::setMultithreadingEnabled(bool enabled)
+    {
+        _multithreading = enabled;
+    }
+
+    bool iEntityScene::isMultithreadingEnabled() const
+    {
+        return _multithreading;
+    }
+
+    bool iEntityScene::canRunMultithreaded() const
+    {
+        return _multithreading &&
+               iTaskManager::isInstantiated() &&
+               iTaskManager::getInstance().getRegularThreadCount() > 0;
+    }
+
+    const std::vector<iEntitySystemTiming> &iEntityScene::getSystemTimings() const
+    {
+        return _systemTimings;
+    }
+
+    uint64 iEntityScene::getHierarchyVersion() const
+    {
+        return _hierarchyVersion;
+    }
+
+    void iEntityScene::onHierarchyChanged()
+    {
+        _hierarchyVersion++;
+    }
+
+    uint64 iEntityScene::getSpriteVersion() const
+    {
+        return _spriteVersion;
+    }
+
+    void iEntityScene::onSpritesChanged()
+    {
+        _spriteVersion++;
+    }
+
+    void iEntityScene::forEachChunk(uint64 count, const iParallelForFunction &function)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (count < MIN_CHUNK_SIZE * 2 || !canRunMultithreaded())
+        {
+            function(0, count);
+            return;
+        }
+
+        const uint64 chunkSize = std::max(MIN_CHUNK_SIZE, iTaskManager::getInstance().calcChunkSize(count));
+        iTaskManager::getInstance().parallelFor(0, count, function, chunkSize);
+    }
+
+    void iEntityScene::updateSystem(uint32 index, const iaTime &time, iEntityScenePtr scene)
+    {
+        const iaTime start = iaTime::getNow();
+
+        _systems[index]->update(time, scene);
+
+        iEntitySystemTiming &timing = _systemTimings[index];
+        timing._updateTime = iaTime::getNow() - start;
+        timing._totalTime += timing._updateTime;
+        timing._updateCount++;
+    }
+
     void iEntityScene::onUpdate(const iaTime &time)
     {
         destroyEntities();
 
-        for (iEntitySystemPtr &system : _systems)
+        iEntityScenePtr scene = shared_from_this();
+        const bool multithreaded = canRunMultithreaded();
+
+        for (const auto &stage : _stages)
         {
-            system->update(time, shared_from_this());
+            if (!multithreaded || stage.size() == 1)
+            {
+                for (const uint32 index : stage)
+                {
+                    updateSystem(index, time, scene);
+                }
+
+                continue;
+            }
+
+            // one system per chunk. the calling thread takes part so this returns once the whole stage is done
+            iTaskManager::getInstance().parallelFor(
+                0, stage.size(), [&](uint64 begin, uint64 end)
+                {
+                    for (uint64 i = begin; i < end; ++i)
+                    {
+                        updateSystem(stage[i], time, scene);
+                    } },
+                1);
         }
     }
 
@@ -209,13 +417,18 @@ namespace igor
             /*! cleanup quadtree
              */
             iBody2DComponent *component = _registry->_registry.try_get<iBody2DComponent>(static_cast<entt::entity>(entityID));
-            if (component != nullptr)
+            if (component != nullptr && _quadtree != nullptr)
             {
-                getQuadtree().remove(component->_object);
+                _quadtree->remove(component->_object);
             }
 
             // cleanup hierarchy
             iHierarchyComponent *hierarchy = _registry->_registry.try_get<iHierarchyComponent>(static_cast<entt::entity>(entityID));
+            if (hierarchy != nullptr)
+            {
+                onHierarchyChanged();
+            }
+
             if (hierarchy != nullptr &&
                 _registry->_registry.valid(static_cast<entt::entity>(hierarchy->_parent)))
             {
@@ -265,6 +478,7 @@ namespace igor
             const iHierarchyComponent &typedComponent = *static_cast<const iHierarchyComponent *>(component);
             iHierarchyComponent &result = _registry->_registry.emplace_or_replace<iHierarchyComponent>(static_cast<entt::entity>(entityID));
             result = typedComponent;
+            onHierarchyChanged();
             return static_cast<void *>(&result);
         }
         else if (typeInfo == typeid(iBody2DComponent))
@@ -272,14 +486,19 @@ namespace igor
             iTransformComponent *transform = _registry->_registry.try_get<iTransformComponent>(static_cast<entt::entity>(entityID));
             if (transform == nullptr)
             {
-                const iaVector2d center = getQuadtree().getRootBox().getCenter();
+                const iaVector2d center = (_grid != nullptr ? _grid->getRootBox() : getQuadtree().getRootBox()).getCenter();
                 transform = &(_registry->_registry.emplace_or_replace<iTransformComponent>(static_cast<entt::entity>(entityID), iaVector3d(center._x, center._y, 0.0)));
             }
 
             const iBody2DComponent &typedComponent = *static_cast<const iBody2DComponent *>(component);
             iBody2DComponent &result = _registry->_registry.emplace_or_replace<iBody2DComponent>(static_cast<entt::entity>(entityID));
             result._object = std::make_shared<iQuadtreed::Object>(iaCircled(transform->_position._x, transform->_position._y, 1.0), entityID);
-            getQuadtree().insert(result._object);
+
+            // with a grid the object only holds the circle. the grid gets rebuilt every update
+            if (_grid == nullptr)
+            {
+                getQuadtree().insert(result._object);
+            }
 
             return static_cast<void *>(&result);
         }
@@ -551,13 +770,17 @@ namespace igor
         else if (typeInfo == typeid(iHierarchyComponent))
         {
             _registry->_registry.remove<iHierarchyComponent>(static_cast<entt::entity>(entityID));
+            onHierarchyChanged();
         }
         else if (typeInfo == typeid(iBody2DComponent))
         {
             iBody2DComponent *component = _registry->_registry.try_get<iBody2DComponent>(static_cast<entt::entity>(entityID));
             if (component != nullptr)
             {
-                getQuadtree().remove(component->_object);
+                if (_quadtree != nullptr)
+                {
+                    _quadtree->remove(component->_object);
+                }
                 _registry->_registry.remove<iBody2DComponent>(static_cast<entt::entity>(entityID));
             }
         }
@@ -31,6 +31,8 @@
 
 #include <igor/entities/iEntitySystem.h>
 #include <igor/entities/systems/iVelocitySystem.h>
+#include <igor/threading/tasks/iTaskParallelFor.h>
+#include <igor/data/iSpatialGrid.h>
 
 #include <memory>
 #include <unordered_map>
@@ -44,6 +46,48 @@ namespace igor
 	 */
 	class iRegistry;
 
+	/*! spatial partitioning used for 2D bodies
+	 */
+	enum class iSpatialPartitionType
+	{
+		/*! bodies are kept in a quadtree that gets updated incrementally
+		 */
+		Quadtree,
+
+		/*! bodies are sorted in to a uniform grid that gets rebuilt every update. scales better with many moving bodies
+		 */
+		Grid
+	};
+
+	/*! uniform grid of entities
+	 */
+	typedef iSpatialGrid<float64, iEntityID> iEntityGrid;
+
+	/*! timing of one system during last scene update
+	 */
+	struct iEntitySystemTiming
+	{
+		/*! name of system
+		 */
+		iaString _name;
+
+		/*! index of stage the system runs in. systems within the same stage run concurrently
+		 */
+		uint32 _stage = 0;
+
+		/*! time the system took during last update
+		 */
+		iaTime _updateTime;
+
+		/*! time the system took during all updates so far
+		 */
+		iaTime _totalTime;
+
+		/*! amount of updates so far
+		 */
+		uint64 _updateCount = 0;
+	};
+
 	/*! entity scene
 	 */
 	class IGOR_API iEntityScene : public std::enable_shared_from_this<iEntityScene>
@@ -51,6 +95,7 @@ namespace igor
 
 		friend class iEntitySystemModule;
 		friend class iEntitySceneDeleter;
+		friend class iEntity;
 
 	public:
 		/*! creates an entity
@@ -127,8 +172,11 @@ namespace igor
 		\param box volume of the whole quadtree
 		\param splitThreshold threshold count of objects on a node before splitting the node
 		\param maxDepth the maximum depth of the tree
+		\param type the type of spatial partitioning to use. with Grid there is no quadtree and splitThreshold and maxDepth are ignored
+		\param cellSize edge length of grid cells. only used with Grid
 		*/
-		void initializeQuadtree(const iaRectangled &box, const uint32 splitThreshold = 4, const uint32 maxDepth = 16);
+		void initializeQuadtree(const iaRectangled &box, const uint32 splitThreshold = 4, const uint32 maxDepth = 16,
+								iSpatialPartitionType type = iSpatialPartitionType::Quadtree, float64 cellSize = 32.0);
 
 		/*! \returns internal quadtree
 		 */
@@ -138,6 +186,23 @@ namespace igor
 		 */
 		bool hasQuadtree() const;
 
+		/*! \returns internal grid
+		 */
+		iEntityGrid &getGrid() const;
+
+		/*! \returns true if grid present
+		 */
+		bool hasGrid() const;
+
+		/*! queries entities whose bodies intersect with given circle
+
+		uses the quadtree or grid depending on what was initialized
+
+		\param circle the given circle
+		\param entities the resulting entity ids
+		*/
+		void queryEntities(const iaCircled &circle, std::vector<iEntityID> &entities) const;
+
 		/*! \returns entt registry
 		 */
 		void *getRegistry() const;
@@ -150,6 +215,40 @@ namespace igor
 		 */
 		const iAABoxd &getBounds() const;
 
+		/*! calls function for chunks of given range
+
+		runs chunks on the task manager's threads if multithreading is enabled and the range is big enough.
+		otherwise the function gets called once with the whole range in the calling thread.
+		meant to be used by systems to split up their views
+
+		\param count the amount of indices to process
+		\param function the function to call for every chunk with the chunks range [begin, end)
+		*/
+		void forEachChunk(uint64 count, const iParallelForFunction &function);
+
+		/*! enables or disables multithreading for system updates
+
+		\param enabled if true non conflicting systems run concurrently and large views get split in chunks
+		*/
+		void setMultithreadingEnabled(bool enabled);
+
+		/*! \returns true if multithreading for system updates is enabled
+		 */
+		bool isMultithreadingEnabled() const;
+
+		/*! \returns timings of all systems in update order
+		 */
+		const std::vector<iEntitySystemTiming> &getSystemTimings() const;
+
+		/*! \returns version of the hierarchy. changes every time a parent child relationship changes
+		 */
+		uint64 getHierarchyVersion() const;
+
+		/*! \returns version of the sprites. changes every time a sprite component gets added, replaced, patched or
+		removed, a 2D body or transform gets added or removed or an entity gets activated or deactivated
+		 */
+		uint64 getSpriteVersion() const;
+
 	private:
 		/*! pimpl
 		 */
@@ -163,12 +262,28 @@ namespace igor
 		 */
 		iQuadtreed *_quadtree = nullptr;
 
+		/*! uniform grid
+		 */
+		iEntityGrid *_grid = nullptr;
+
 		std::shared_ptr<iVelocitySystem> _velocitySystem;
 
 		/*! systems to update
 		 */
 		std::vector<iEntitySystemPtr> _systems;
 
+		/*! system indices grouped in stages of systems that can run concurrently
+		 */
+		std::vector<std::vector<uint32>> _stages;
+
+		/*! timings per system
+		 */
+		std::vector<iEntitySystemTiming> _systemTimings;
+
+		/*! if true systems get updated multithreaded
+		 */
+		bool _multithreading = true;
+
 		/*! systems that render
 		 */
 		std::vector<iEntityRenderSystemPtr> _renderingSystems;
@@ -181,10 +296,45 @@ namespace igor
 		 */
 		std::deque<iEntityID> _deleteQueue;
 
+		/*! version of the hierarchy
+		 */
+		uint64 _hierarchyVersion = 0;
+
+		/*! to be called after a parent child relationship changed
+		 */
+		void onHierarchyChanged();
+
+		/*! version of the sprites
+		 */
+		uint64 _spriteVersion = 0;
+
+		/*! called by the registry when sprites or 2D bodies changed
+		 */
+		void onSpritesChanged();
+
 		/*! destroys entities in the delete queue
 		 */
 		void destroyEntities();
 
+		/*! groups systems in stages
+
+		a system joins the current stage if it does not conflict with any system in it, otherwise it starts a new one.
+		this way the order in which conflicting systems get updated stays the same
+		 */
+		void buildStages();
+
+		/*! \returns true if multithreading is enabled and there are threads to use
+		 */
+		bool canRunMultithreaded() const;
+
+		/*! updates system and measures the time it took
+
+		\param index index of system to update
+		\param time the simulation time
+		\param scene shared pointer of this scene
+		*/
+		void updateSystem(uint32 index, const iaTime &time, iEntityScenePtr scene);
+
 		/*! updates all non rendering systems
 		 */
 		void onUpdate(const iaTime &time);
@@ -0,0 +1,68 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/entities/iEntitySystem.h>
+
+#include <algorithm>
+
+namespace igor
+{
+    iEntitySystem::iEntitySystem(const iaString &name)
+        : _name(name)
+    {
+    }
+
+    const iaString &iEntitySystem::getName() const
+    {
+        return _name;
+    }
+
+    const std::vector<std::type_index> &iEntitySystem::getReadTypes() const
+    {
+        return _readTypes;
+    }
+
+    const std::vector<std::type_index> &iEntitySystem::getWriteTypes() const
+    {
+        return _writeTypes;
+    }
+
+    bool iEntitySystem::isExclusive() const
+    {
+        return _readTypes.empty() && _writeTypes.empty();
+    }
+
+    bool iEntitySystem::contains(const std::vector<std::type_index> &types, const std::type_index &type)
+    {
+        return std::find(types.begin(), types.end(), type) != types.end();
+    }
+
+    bool iEntitySystem::conflictsWith(const iEntitySystem &other) const
+    {
+        if (isExclusive() || other.isExclusive())
+        {
+            return true;
+        }
+
+        for (const auto &type : _writeTypes)
+        {
+            if (contains(other._readTypes, type) ||
+                contains(other._writeTypes, type))
+            {
+                return true;
+            }
+        }
+
+        for (const auto &type : other._writeTypes)
+        {
+            if (contains(_readTypes, type))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+} // igor
@@ -32,6 +32,8 @@
 #include <igor/entities/components/iComponentMap.h>
 
 #include <memory>
+#include <typeindex>
+#include <vector>
 
 namespace igor
 {
@@ -41,12 +43,20 @@ namespace igor
 	*/
 	typedef std::shared_ptr<iEntityScene> iEntityScenePtr;
 
-	class iEntitySystem
+	/*! entity system
+
+	systems declare which component types (or other shared resources like the quadtree) they read and write.
+	the scene uses this to run systems that do not conflict with each other concurrently.
+	a system that declares nothing is considered exclusive and always runs alone on the main thread
+	*/
+	class IGOR_API iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! init system
+
+		\param name name of system used in timing reports
 		 */
-		iEntitySystem() = default;
+		iEntitySystem(const iaString &name = "");
 
 		/*! does nothing
 		 */
@@ -56,6 +66,58 @@ namespace igor
 		 */
 		virtual void update(const iaTime &time, iEntityScenePtr scene) = 0;
 
+		/*! \returns name of system
+		 */
+		const iaString &getName() const;
+
+		/*! \returns types this system reads
+		 */
+		const std::vector<std::type_index> &getReadTypes() const;
+
+		/*! \returns types this system writes
+		 */
+		const std::vector<std::type_index> &getWriteTypes() const;
+
+		/*! \returns true if system did not declare any access and therefore has to run alone
+		 */
+		bool isExclusive() const;
+
+		/*! \returns true if this system can not run concurrently with given system
+
+		\param other the other system
+		 */
+		bool conflictsWith(const iEntitySystem &other) const;
+
+	protected:
+		/*! declares types this system reads
+		 */
+		template <typename... T>
+		void reads();
+
+		/*! declares types this system writes
+		 */
+		template <typename... T>
+		void writes();
+
+	private:
+		/*! name of system
+		 */
+		iaString _name;
+
+		/*! types this system reads
+		 */
+		std::vector<std::type_index> _readTypes;
+
+		/*! types this system writes
+		 */
+		std::vector<std::type_index> _writeTypes;
+
+		/*! \returns true if given type is part of given list
+
+		\param types the list to search
+		\param type the type to search for
+		 */
+		static bool contains(const std::vector<std::type_index> &types, const std::type_index &type);
 	};
 
 	/*! entity system pointer definition
@@ -83,6 +145,8 @@ namespace igor
 	*/
 	typedef std::shared_ptr<iEntityRenderSystem> iEntityRenderSystemPtr;
 
+#include <igor/entities/iEntitySystem.inl>
+
 } // igor
 
 #endif // __IGOR_ENTITY_SYSTEM__
\ No newline at end of file
@@ -0,0 +1,15 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename... T>
+void iEntitySystem::reads()
+{
+    (_readTypes.push_back(typeid(T)), ...);
+}
+
+template <typename... T>
+void iEntitySystem::writes()
+{
+    (_writeTypes.push_back(typeid(T)), ...);
+}
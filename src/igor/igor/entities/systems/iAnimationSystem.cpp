@@ -12,6 +12,11 @@
 
 namespace igor
 {
+	iAnimationSystem::iAnimationSystem()
+		: iEntitySystem("animation")
+	{
+	}
+
 	void iAnimationSystem::update(const iaTime &time, iEntityScenePtr scene)
 	{
 		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
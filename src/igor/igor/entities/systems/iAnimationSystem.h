@@ -39,9 +39,9 @@ namespace igor
 	class iAnimationSystem : public iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! runs user defined animation controllers and therefore is exclusive
 		*/
-		iAnimationSystem() = default;
+		iAnimationSystem();
 
 		/*! does nothing
 		*/
@@ -11,6 +11,11 @@
 
 namespace igor
 {
+	iBehaviourSystem::iBehaviourSystem()
+		: iEntitySystem("behaviour")
+	{
+	}
+
 	void iBehaviourSystem::update(const iaTime &time, iEntityScenePtr scene)
 	{
 		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
@@ -39,9 +39,9 @@ namespace igor
 	class iBehaviourSystem : public iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! runs user defined behaviours and therefore is exclusive
 		*/
-		iBehaviourSystem() = default;
+		iBehaviourSystem();
 
 		/*! does nothing
 		*/
@@ -14,8 +14,63 @@ using namespace iaux;
 
 namespace igor
 {
+	iQuadtreeSystem::iQuadtreeSystem()
+		: iEntitySystem("quadtree")
+	{
+		reads<iTransformComponent, iBody2DComponent, iCircleCollision2DComponent>();
+		writes<iQuadtreed, iEntityGrid>();
+	}
+
+	void iQuadtreeSystem::updateGrid(iEntityScenePtr scene)
+	{
+		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
+		auto &grid = scene->getGrid();
+
+		grid.clear();
+
+		auto viewNoCollision = registry->view<iTransformComponent, iBody2DComponent>(entt::exclude<iCircleCollision2DComponent>);
+
+		for (auto entityID : viewNoCollision)
+		{
+			auto [transform, body] = viewNoCollision.get<iTransformComponent, iBody2DComponent>(entityID);
+
+			if (body._object == nullptr)
+			{
+				continue;
+			}
+
+			body._object->_circle._center.set(transform._position._x, transform._position._y);
+			grid.add(body._object->_circle, static_cast<iEntityID>(entityID));
+		}
+
+		auto view = registry->view<iTransformComponent, iBody2DComponent, iCircleCollision2DComponent>();
+
+		for (auto entityID : view)
+		{
+			auto [transform, body, circleCollision] = view.get<iTransformComponent, iBody2DComponent, iCircleCollision2DComponent>(entityID);
+
+			if (body._object == nullptr)
+			{
+				continue;
+			}
+
+			body._object->_circle.set(transform._position._x + circleCollision._offset._x,
+									  transform._position._y + circleCollision._offset._y,
+									  circleCollision._radius);
+			grid.add(body._object->_circle, static_cast<iEntityID>(entityID));
+		}
+
+		grid.build();
+	}
+
 	void iQuadtreeSystem::update(const iaTime &time, iEntityScenePtr scene)
 	{
+		if (scene->hasGrid())
+		{
+			updateGrid(scene);
+			return;
+		}
+
 		if(!scene->hasQuadtree())
 		{
 			return;
@@ -42,9 +42,9 @@ namespace igor
 	class iQuadtreeSystem : public iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! declares component access
 		*/
-		iQuadtreeSystem() = default;
+		iQuadtreeSystem();
 
 		/*! does nothing
 		*/
@@ -55,6 +55,13 @@ namespace igor
 		\param scene the scene used for this update
 		 */
 		void update(const iaTime &time, iEntityScenePtr scene) override;
+
+	private:
+		/*! rebuilds the scene's grid from all bodies
+
+		\param scene the scene used for this update
+		 */
+		void updateGrid(iEntityScenePtr scene);
 	};
 
 } // igor
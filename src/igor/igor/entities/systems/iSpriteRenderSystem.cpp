@@ -12,26 +12,303 @@ using namespace iaux;
 
 #include <entt.h>
 
+#include <algorithm>
+#include <any>
+
 namespace igor
 {
+	/*! above this amount of out of order sprites a full sort is cheaper than an insertion sort
+	 */
+	static const uint32 s_insertionSortLimit = 64;
+
+	/*! \returns true if the sprite components are in order of their z index
+
+	\param spriteStorage the sprite component storage
+	 */
+	template <typename Storage>
+	static bool isInZOrder(const Storage &spriteStorage)
+	{
+		return std::is_sorted(spriteStorage.begin(), spriteStorage.end(), [](const iSpriteRendererComponent &lhs, const iSpriteRendererComponent &rhs)
+							  { return lhs._zIndex < rhs._zIndex; });
+	}
+
+	void iSpriteRenderSystem::collectSprites(iEntityScenePtr scene)
+	{
+		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
+		auto &spriteStorage = registry->storage<iSpriteRendererComponent>();
+		auto &transformStorage = registry->storage<iTransformComponent>();
+		auto &activeStorage = registry->storage<iActiveComponent>();
+		auto &bodyStorage = registry->storage<iBody2DComponent>();
+		auto &hierarchyStorage = registry->storage<iHierarchyComponent>();
+
+		uint32 outOfOrder = 0;
+		_margin = 0.0;
+		const iSpriteRendererComponent *previous = nullptr;
+
+		for (const auto &spriteRender : spriteStorage)
+		{
+			if (previous != nullptr &&
+				previous->_zIndex > spriteRender._zIndex)
+			{
+				outOfOrder++;
+			}
+
+			_margin = std::max(_margin, spriteRender._size.length() * 0.5);
+			previous = &spriteRender;
+		}
+
+		if (outOfOrder != 0)
+		{
+			auto compare = [](const iSpriteRendererComponent &lhs, const iSpriteRendererComponent &rhs)
+			{ return lhs._zIndex < rhs._zIndex; };
+
+			if (outOfOrder > s_insertionSortLimit)
+			{
+				registry->sort<iSpriteRendererComponent>(compare, entt::std_sort{});
+			}
+			else
+			{
+				registry->sort<iSpriteRendererComponent>(compare, entt::insertion_sort{});
+			}
+
+			// transforms in the same order make the culling access them in sequence
+			registry->sort<iTransformComponent, iSpriteRendererComponent>();
+
+			_sortCount++;
+		}
+
+		// the quadtree and grid only know root entities by their local position. everything else needs a bounds test
+		_unboundSprites.clear();
+		for (auto entity : registry->view<iSpriteRendererComponent>())
+		{
+			if (!activeStorage.contains(entity) ||
+				!transformStorage.contains(entity))
+			{
+				continue;
+			}
+
+			if (!bodyStorage.contains(entity) ||
+				(hierarchyStorage.contains(entity) && hierarchyStorage.get(entity)._parent != IGOR_INVALID_ENTITY_ID))
+			{
+				_unboundSprites.push_back({spriteStorage.index(entity), static_cast<iEntityID>(entity), &spriteStorage.get(entity), &transformStorage.get(entity)});
+			}
+		}
+
+		_spriteVersion = scene->getSpriteVersion();
+		_hierarchyVersion = scene->getHierarchyVersion();
+		_collectSprites = false;
+	}
+
+	void iSpriteRenderSystem::cull(iEntityScenePtr scene, const iaRectangled &viewRectangle, bool cull)
+	{
+		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
+		auto &spriteStorage = registry->storage<iSpriteRendererComponent>();
+		auto &transformStorage = registry->storage<iTransformComponent>();
+		auto &activeStorage = registry->storage<iActiveComponent>();
+		auto &hierarchyStorage = registry->storage<iHierarchyComponent>();
+
+		// z indices might have been changed directly on the components so the order gets checked every time
+		if (_collectSprites ||
+			_spriteVersion != scene->getSpriteVersion() ||
+			_hierarchyVersion != scene->getHierarchyVersion() ||
+			!isInZOrder(spriteStorage))
+		{
+			collectSprites(scene);
+		}
+
+		_visibleEntities.clear();
+
+		if (spriteStorage.size() < CULL_LIMIT)
+		{
+			cull = false;
+		}
+
+		const float64 left = viewRectangle._x;
+		const float64 right = viewRectangle.getRight();
+		const float64 top = viewRectangle._y;
+		const float64 bottom = viewRectangle.getBottom();
+
+		auto isVisible = [&](const iSpriteRendererComponent &spriteRender, const iTransformComponent &transform)
+		{
+			const iaMatrixd &matrix = transform._worldMatrix;
+
+			const float64 halfWidth = (std::abs(matrix._right._x) * std::abs(spriteRender._size._x) + std::abs(matrix._top._x) * std::abs(spriteRender._size._y)) * 0.5;
+			const float64 halfHeight = (std::abs(matrix._right._y) * std::abs(spriteRender._size._x) + std::abs(matrix._top._y) * std::abs(spriteRender._size._y)) * 0.5;
+
+			return matrix._pos._x + halfWidth >= left &&
+				   matrix._pos._x - halfWidth <= right &&
+				   matrix._pos._y + halfHeight >= top &&
+				   matrix._pos._y - halfHeight <= bottom;
+		};
+
+		if (!cull ||
+			(!scene->hasGrid() && !scene->hasQuadtree()))
+		{
+			for (auto entity : registry->view<iSpriteRendererComponent>())
+			{
+				if (!activeStorage.contains(entity) ||
+					!transformStorage.contains(entity) ||
+					(cull && !isVisible(spriteStorage.get(entity), transformStorage.get(entity))))
+				{
+					continue;
+				}
+
+				_visibleEntities.push_back(static_cast<iEntityID>(entity));
+			}
+
+			return;
+		}
+
+		_visibleSprites.clear();
+
+		auto addRoot = [&](iEntityID entityID)
+		{
+			const entt::entity entity = static_cast<entt::entity>(entityID);
+			if (!spriteStorage.contains(entity) ||
+				!activeStorage.contains(entity) ||
+				!transformStorage.contains(entity) ||
+				(hierarchyStorage.contains(entity) && hierarchyStorage.get(entity)._parent != IGOR_INVALID_ENTITY_ID))
+			{
+				return;
+			}
+
+			_visibleSprites.emplace_back(spriteStorage.index(entity), entityID);
+		};
+
+		const iaRectangled queryRectangle(viewRectangle._x - _margin, viewRectangle._y - _margin,
+										  viewRectangle._width + _margin * 2.0, viewRectangle._height + _margin * 2.0);
+
+		if (scene->hasGrid())
+		{
+			scene->getGrid().query(queryRectangle, [&](uint32 index, const iEntityGrid::Entry &entry)
+								   { addRoot(entry._userData); });
+		}
+		else
+		{
+			scene->getQuadtree().query(queryRectangle, [&](const iQuadtreed::ObjectPtr &object)
+									   {
+										   const iEntityID *entityID = std::any_cast<iEntityID>(&object->_userData);
+										   if (entityID != nullptr)
+										   {
+											   addRoot(*entityID);
+										   } });
+		}
+
+		// the bounds only get calculated again if the world matrix or the size changed since last time
+		for (auto &sprite : _unboundSprites)
+		{
+			if (sprite._changedFrame != sprite._transform->_changedFrame ||
+				sprite._size != sprite._spriteRender->_size)
+			{
+				const iaMatrixd &matrix = sprite._transform->_worldMatrix;
+				const iaVector2d &size = sprite._spriteRender->_size;
+
+				const float64 halfWidth = (std::abs(matrix._right._x) * std::abs(size._x) + std::abs(matrix._top._x) * std::abs(size._y)) * 0.5;
+				const float64 halfHeight = (std::abs(matrix._right._y) * std::abs(size._x) + std::abs(matrix._top._y) * std::abs(size._y)) * 0.5;
+
+				sprite._left = matrix._pos._x - halfWidth;
+				sprite._right = matrix._pos._x + halfWidth;
+				sprite._top = matrix._pos._y - halfHeight;
+				sprite._bottom = matrix._pos._y + halfHeight;
+				sprite._changedFrame = sprite._transform->_changedFrame;
+				sprite._size = size;
+			}
+
+			if (sprite._right >= left &&
+				sprite._left <= right &&
+				sprite._bottom >= top &&
+				sprite._top <= bottom)
+			{
+				_visibleSprites.emplace_back(sprite._index, sprite._entityID);
+			}
+		}
+
+		// the storage gets iterated from the back so the render order is the one of descending indices
+		std::sort(_visibleSprites.begin(), _visibleSprites.end(), [](const auto &lhs, const auto &rhs)
+				  { return lhs.first > rhs.first; });
+
+		for (const auto &sprite : _visibleSprites)
+		{
+			_visibleEntities.push_back(sprite.second);
+		}
+	}
+
+	bool iSpriteRenderSystem::calcViewRectangle(iaRectangled &viewRectangle) const
+	{
+		const iaMatrixd &projection = iRenderer::getInstance().getProjectionMatrix();
+
+		// only orthogonal projections map to a rectangle
+		if (projection._w3 != 1.0)
+		{
+			return false;
+		}
+
+		iaMatrixd inverse = projection;
+		inverse *= iRenderer::getInstance().getViewMatrix();
+		if (!inverse.invert())
+		{
+			return false;
+		}
+
+		const iaVector3d corners[4] = {iaVector3d(-1.0, -1.0, 0.0), iaVector3d(1.0, -1.0, 0.0),
+									   iaVector3d(1.0, 1.0, 0.0), iaVector3d(-1.0, 1.0, 0.0)};
+
+		iaVector3d minimum = inverse * corners[0];
+		iaVector3d maximum = minimum;
+
+		for (int i = 1; i < 4; ++i)
+		{
+			const iaVector3d corner = inverse * corners[i];
+			minimum.set(std::min(minimum._x, corner._x), std::min(minimum._y, corner._y), 0.0);
+			maximum.set(std::max(maximum._x, corner._x), std::max(maximum._y, corner._y), 0.0);
+		}
+
+		viewRectangle.set(minimum._x, minimum._y, maximum._x - minimum._x, maximum._y - minimum._y);
+		return true;
+	}
+
+	void iSpriteRenderSystem::flushInstances()
+	{
+		// only consecutive sprites using the same texture get drawn together so the render order stays the same
+		size_t begin = 0;
+		while (begin < _instances.size())
+		{
+			const iTexturePtr &texture = *_instances[begin].first;
+
+			_instanceStream.clear();
+			size_t end = begin;
+			while (end < _instances.size() &&
+				   _instances[end].first->get() == texture.get())
+			{
+				_instanceStream.push_back(_instances[end].second);
+				end++;
+			}
+
+			iRenderer::getInstance().drawSpriteInstances(texture, _instanceStream.data(), static_cast<uint32>(_instanceStream.size()), true);
+			begin = end;
+		}
+
+		_instances.clear();
+	}
+
 	void iSpriteRenderSystem::render(iEntityScenePtr scene)
 	{
 		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
-		registry->sort<iSpriteRendererComponent>([registry](const entt::entity lhs, const entt::entity rhs)
-												 {
-			const auto &clhs = registry->get<iSpriteRendererComponent>(lhs);
-			const auto &crhs = registry->get<iSpriteRendererComponent>(rhs);
-			return clhs._zIndex < crhs._zIndex; });
 
-		auto view = registry->view<iSpriteRendererComponent, iTransformComponent, iActiveComponent>();
+		iaRectangled viewRectangle;
+		const bool cullSprites = calcViewRectangle(viewRectangle);
+		cull(scene, viewRectangle, cullSprites);
 
-		for (auto entityID : view)
+		for (auto entityID : _visibleEntities)
 		{
-			auto [spriteRender, transform] = view.get<iSpriteRendererComponent, iTransformComponent>(entityID);
+			const entt::entity entity = static_cast<entt::entity>(entityID);
+			const auto &spriteRender = registry->get<iSpriteRendererComponent>(entity);
+			const auto &transform = registry->get<iTransformComponent>(entity);
 
 			switch (spriteRender._renderMode)
 			{
 			case iSpriteRenderMode::Tiled:
+				flushInstances();
 				iRenderer::getInstance().drawTexturedQuad(transform._worldMatrix._pos,
 														  transform._worldMatrix._right * spriteRender._size._x * 0.5,
 														  transform._worldMatrix._top * -spriteRender._size._y * 0.5,
@@ -40,12 +317,39 @@ namespace igor
 
 			case iSpriteRenderMode::Simple:
 			default:
-				iRenderer::getInstance().drawSprite(transform._worldMatrix,
-													spriteRender._sprite, spriteRender._frameIndex, spriteRender._size,
-													spriteRender._color, true);
-				break;
+			{
+				if (spriteRender._sprite == nullptr ||
+					!spriteRender._sprite->isValid())
+				{
+					break;
+				}
+
+				iSpriteInstance instance;
+				for (int i = 0; i < 16; ++i)
+				{
+					instance._matrix[i] = static_cast<float32>(transform._worldMatrix[i]);
+				}
+				instance._matrix.scale(spriteRender._size._x, spriteRender._size._y, 1.0);
+				instance._texRect = spriteRender._sprite->getFrame(spriteRender._frameIndex)._rect;
+				instance._color = spriteRender._color;
+
+				_instances.emplace_back(&spriteRender._sprite->getTexture(), instance);
+			}
+			break;
 			}
 		}
+
+		flushInstances();
+	}
+
+	const std::vector<iEntityID> &iSpriteRenderSystem::getVisibleEntities() const
+	{
+		return _visibleEntities;
+	}
+
+	uint64 iSpriteRenderSystem::getSortCount() const
+	{
+		return _sortCount;
 	}
 
-} // igor
\ No newline at end of file
+} // igor
@@ -30,15 +30,35 @@
 #define __IGOR_SPRITE_RENDER_SYSTEM__
 
 #include <igor/entities/iEntitySystem.h>
+#include <igor/renderer/iRenderer.h>
+#include <igor/data/iQuadtree.h>
+
+#include <iaux/data/iaRectangle.h>
+
+#include <vector>
 
 namespace igor
 {
 
 	/*! sprite render system
+
+	sprites get rendered in order of their z index. The sprite components only get collected again after the scene's
+	sprite or hierarchy version changed and only get sorted again if they are out of order.
+	Above CULL_LIMIT sprites the ones outside the current view are skipped. Sprites of root entities with a 2D body are
+	looked up in the scene's quadtree or grid, only the other ones get a bounds test. Their bounds are cached
+	until their world matrix or size changes. Consecutive visible sprites using the same texture get handed to the
+	renderer as one stream of instances.
+
+	The culling margin for entities with body only considers the size of the sprites not the scale of their transform.
+	Sprites of entities with body that are not part of the quadtree i.e. because they are out of its bounds are not rendered
 	*/
-	class iSpriteRenderSystem : public iEntityRenderSystem
+	class IGOR_API iSpriteRenderSystem : public iEntityRenderSystem
 	{
 	public:
+		/*! below this amount of sprites culling takes longer than it saves so all sprites get rendered
+		 */
+		static const uint32 CULL_LIMIT = 10000;
+
 		/*! does nothing
 		*/
 		iSpriteRenderSystem() = default;
@@ -52,6 +72,122 @@ namespace igor
 		\param scene the scene used for this update
 		 */
 		void render(iEntityScenePtr scene) override;
+
+		/*! sorts sprites by z index if needed and collects the ones visible in given rectangle
+
+		\param scene the scene to collect from
+		\param viewRectangle the visible area in world coordinates
+		\param cull if false or there are less than CULL_LIMIT sprites all sprites are visible
+		*/
+		void cull(iEntityScenePtr scene, const iaRectangled &viewRectangle, bool cull = true);
+
+		/*! \returns visible entities in render order collected by last cull
+		 */
+		const std::vector<iEntityID> &getVisibleEntities() const;
+
+		/*! \returns how often the sprites had to be sorted
+		 */
+		uint64 getSortCount() const;
+
+	private:
+		/*! number of current cull
+		 */
+		uint32 _frame = 0;
+
+		/*! how often the sprites had to be sorted
+		 */
+		uint64 _sortCount = 0;
+
+		/*! if true the sprites have to be collected
+		 */
+		bool _collectSprites = true;
+
+		/*! scene sprite version the sprites were collected with
+		 */
+		uint64 _spriteVersion = 0;
+
+		/*! scene hierarchy version the sprites were collected with
+		 */
+		uint64 _hierarchyVersion = 0;
+
+		/*! the biggest half diagonal of all sprites
+		 */
+		float64 _margin = 0.0;
+
+		/*! active sprite that is not in the quadtree or grid
+		 */
+		struct iUnboundSprite
+		{
+			/*! index in sprite storage
+			 */
+			uint64 _index;
+
+			/*! the entity
+			 */
+			iEntityID _entityID;
+
+			/*! the sprite component
+			 */
+			const iSpriteRendererComponent *_spriteRender;
+
+			/*! the transform component
+			 */
+			const iTransformComponent *_transform;
+
+			/*! changed frame of the transform the bounds were calculated with
+			 */
+			uint64 _changedFrame = 0;
+
+			/*! sprite size the bounds were calculated with
+			 */
+			iaVector2d _size;
+
+			/*! world bounds of the sprite
+			 */
+			float64 _left = 0.0;
+			float64 _right = 0.0;
+			float64 _top = 0.0;
+			float64 _bottom = 0.0;
+		};
+
+		/*! active sprites that are not in the quadtree or grid in render order
+
+		the component pointers stay valid until the scene's sprite version changes
+		 */
+		std::vector<iUnboundSprite> _unboundSprites;
+
+		/*! visible sprites with their sprite storage index
+		 */
+		std::vector<std::pair<uint64, iEntityID>> _visibleSprites;
+
+		/*! visible entities in render order
+		 */
+		std::vector<iEntityID> _visibleEntities;
+
+		/*! instances in render order with the texture they use
+		 */
+		std::vector<std::pair<const iTexturePtr *, iSpriteInstance>> _instances;
+
+		/*! instances of consecutive sprites using the same texture
+		 */
+		std::vector<iSpriteInstance> _instanceStream;
+
+		/*! sorts sprite components by z index if they are not in order and collects the sprites that need a bounds test
+
+		\param scene the scene to collect the sprites of
+		*/
+		void collectSprites(iEntityScenePtr scene);
+
+		/*! draws the collected instances and clears them
+		 */
+		void flushInstances();
+
+		/*! calculates the visible area from the renderer's current projection and view matrix
+
+		\param viewRectangle the resulting area
+		\returns false if it can not be calculated i.e. it's a perspective projection
+		*/
+		bool calcViewRectangle(iaRectangled &viewRectangle) const;
 	};
 
 } // igor
@@ -14,75 +14,148 @@ using namespace iaux;
 
 namespace igor
 {
-	void iTransformHierarchySystem::update(const iaTime &time, iEntityScenePtr scene)
+	iaIDGenerator64 iTransformHierarchySystem::_frameGenerator;
+
+	iTransformHierarchySystem::iTransformHierarchySystem()
+		: iEntitySystem("transform hierarchy")
 	{
-		// update matrices
-		auto *registry = static_cast<entt::registry*>(scene->getRegistry());
-		auto transformOnlyView = registry->view<iTransformComponent>();
+		// position, orientation and scale only get read. the matrices derived from them are not used by any other system during update
+		reads<iHierarchyComponent, iTransformComponent>();
+	}
 
-		for (auto entityID : transformOnlyView)
-		{
-			auto &transform = transformOnlyView.get<iTransformComponent>(entityID);
+	void iTransformHierarchySystem::collectGenerations(iEntityScenePtr scene)
+	{
+		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
+		auto hierarchyView = registry->view<iHierarchyComponent>();
 
-			transform._worldMatrix.identity();
-			transform._worldMatrix.translate(transform._position);
-			transform._worldMatrix.rotate(transform._orientation);
-			transform._worldMatrix.scale(transform._scale);
+		for (auto &generation : _generations)
+		{
+			generation.clear();
 		}
 
-		// update hierarchy generations
-		auto hierarchyView = registry->view<iHierarchyComponent>();
-
 		for (auto entityID : hierarchyView)
 		{
-			auto &hierarchy = hierarchyView.get<iHierarchyComponent>(entityID);
+			const auto &hierarchy = hierarchyView.get<iHierarchyComponent>(entityID);
 
-			if(hierarchy._childCount != 0)
+			// parents might have changed so everything in the hierarchy gets recalculated once
+			iTransformComponent *transform = registry->try_get<iTransformComponent>(entityID);
+			if (transform != nullptr)
 			{
-				continue;
+				transform->_dirty = true;
 			}
 
-			entt::entity parentID = static_cast<entt::entity>(hierarchy._parent);
-			int32 generation = 0;
-			hierarchy._generation = generation;
+			if (hierarchy._generation == 0)
+			{
+				continue;
+			}
 
-			while (registry->valid(parentID))
+			if (_generations.size() < static_cast<size_t>(hierarchy._generation))
 			{
-				generation++;
+				_generations.resize(hierarchy._generation);
+			}
+
+			_generations[hierarchy._generation - 1].push_back(static_cast<iEntityID>(entityID));
+		}
+
+		_hierarchyVersion = scene->getHierarchyVersion();
+		_collectGenerations = false;
+	}
+
+	void iTransformHierarchySystem::update(const iaTime &time, iEntityScenePtr scene)
+	{
+		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
+
+		_frame = _frameGenerator.getNextID();
+
+		if (_collectGenerations ||
+			_hierarchyVersion != scene->getHierarchyVersion())
+		{
+			collectGenerations(scene);
+		}
+
+		// update local matrices of changed transforms and world matrices of the ones without parent
+		auto transformOnlyView = registry->view<iTransformComponent>();
+		const auto &transformEntities = transformOnlyView.handle();
 
-				auto &parentHierarchy = hierarchyView.get<iHierarchyComponent>(parentID);
+		scene->forEachChunk(transformEntities.size(), [&](uint64 begin, uint64 end)
+							{
+			for (uint64 i = begin; i < end; ++i)
+			{
+				const entt::entity entityID = transformEntities[i];
+				auto &transform = transformOnlyView.get<iTransformComponent>(entityID);
 
-				if(parentHierarchy._generation < generation)
+				if (!transform._dirty &&
+					transform._position == transform._localPosition &&
+					transform._orientation == transform._localOrientation &&
+					transform._scale == transform._localScale)
 				{
-					parentHierarchy._generation = generation;
+					continue;
 				}
 
-				parentID = static_cast<entt::entity>(parentHierarchy._parent);
-			};
-		}
-		
-		registry->sort<iHierarchyComponent>([&registry](const entt::entity lhs, const entt::entity rhs)
-										   {
-											   const auto &clhs = registry->get<iHierarchyComponent>(lhs);
-											   const auto &crhs = registry->get<iHierarchyComponent>(rhs);
+				transform._dirty = false;
+				transform._localPosition = transform._position;
+				transform._localOrientation = transform._orientation;
+				transform._localScale = transform._scale;
 
-											   return clhs._generation > crhs._generation;
-										   });
+				transform._localMatrix.identity();
+				transform._localMatrix.translate(transform._position);
+				transform._localMatrix.rotate(transform._orientation);
+				transform._localMatrix.scale(transform._scale);
 
-		registry->sort<iTransformComponent, iHierarchyComponent>();
+				const iHierarchyComponent *hierarchy = registry->try_get<iHierarchyComponent>(entityID);
+				if (hierarchy != nullptr &&
+					hierarchy->_generation != 0)
+				{
+					transform._localChanged = true;
+					continue;
+				}
 
-		// update hierarchy generations
-		auto transformHierarchyView = registry->view<iTransformComponent, iHierarchyComponent>();
+				transform._worldMatrix = transform._localMatrix;
+				transform._changedFrame = _frame;
+			} });
 
-		for (auto entityID : transformHierarchyView)
+		// update world matrices generation by generation. parents are always done before their children
+		for (const auto &generation : _generations)
 		{
-			auto [transform, hierarchy] = transformHierarchyView.get<iTransformComponent, iHierarchyComponent>(entityID);
-
-			if (registry->valid(static_cast<entt::entity>(hierarchy._parent)))
-			{
-				iTransformComponent parentTransform = registry->get<iTransformComponent>(static_cast<entt::entity>(hierarchy._parent));
-				transform._worldMatrix = parentTransform._worldMatrix * transform._worldMatrix;
-			}
+			scene->forEachChunk(generation.size(), [&](uint64 begin, uint64 end)
+								{
+				for (uint64 i = begin; i < end; ++i)
+				{
+					const entt::entity entityID = static_cast<entt::entity>(generation[i]);
+
+					iTransformComponent *transform = registry->try_get<iTransformComponent>(entityID);
+					if (transform == nullptr)
+					{
+						continue;
+					}
+
+					const auto &hierarchy = registry->get<iHierarchyComponent>(entityID);
+					const entt::entity parentID = static_cast<entt::entity>(hierarchy._parent);
+					const iTransformComponent *parentTransform = registry->valid(parentID) ? registry->try_get<iTransformComponent>(parentID) : nullptr;
+
+					if (parentTransform == nullptr)
+					{
+						if (transform->_localChanged)
+						{
+							transform->_worldMatrix = transform->_localMatrix;
+							transform->_changedFrame = _frame;
+							transform->_localChanged = false;
+						}
+
+						continue;
+					}
+
+					if (!transform->_localChanged &&
+						parentTransform->_changedFrame != _frame)
+					{
+						continue;
+					}
+
+					transform->_worldMatrix = parentTransform->_worldMatrix;
+					transform->_worldMatrix *= transform->_localMatrix;
+					transform->_changedFrame = _frame;
+					transform->_localChanged = false;
+				} });
 		}
 	}
 
@@ -31,17 +31,26 @@
 
 #include <igor/entities/iEntitySystem.h>
 
+#include <iaux/data/iaIDGenerator.h>
+
+#include <vector>
+
 namespace igor
 {
 
-	/*! sprite render system
+	/*! transform hierarchy system
+
+	updates world matrices of transforms. Only transforms that changed since last update and their descendants get
+	recalculated. Changes are detected by comparing position, orientation and scale with what was used last time.
+	Entities with parent are processed generation by generation so every generation can be split in chunks
+	and run in parallel if the scene has multithreading enabled
 	*/
-	class iTransformHierarchySystem : public iEntitySystem
+	class IGOR_API iTransformHierarchySystem : public iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! declares component access
 		*/
-		iTransformHierarchySystem() = default;
+		iTransformHierarchySystem();
 
 		/*! does nothing
 		*/
@@ -52,6 +61,33 @@ namespace igor
 		\param scene the scene used for this update
 		 */
 		void update(const iaTime &time, iEntityScenePtr scene) override;
+
+	private:
+		/*! number of current update
+		 */
+		uint64 _frame = 0;
+
+		/*! numbers updates of all transform hierarchy systems so a changed frame is never reused by another instance
+		 */
+		static iaIDGenerator64 _frameGenerator;
+
+		/*! hierarchy version the generations were collected with
+		 */
+		uint64 _hierarchyVersion = 0;
+
+		/*! if true generations need to be collected
+		 */
+		bool _collectGenerations = true;
+
+		/*! entities with parent grouped by generation. index zero holds the first generation of children
+		 */
+		std::vector<std::vector<iEntityID>> _generations;
+
+		/*! collects entities with parent grouped by generation
+
+		\param scene the scene to collect from
+		*/
+		void collectGenerations(iEntityScenePtr scene);
 	};
 
 } // igor
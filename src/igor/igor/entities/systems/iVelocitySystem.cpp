@@ -7,135 +7,216 @@
 #include <igor/entities/iEntityScene.h>
 #include <igor/entities/iEntity.h>
 
+#include <iaux/system/iaMutex.h>
+
 #include <entt.h>
 
+#include <unordered_map>
+
 namespace igor
 {
+	iVelocitySystem::iVelocitySystem()
+		: iEntitySystem("velocity")
+	{
+		reads<iBody2DComponent, iMotionInteractionResolverComponent, iGlobalBoundaryComponent, iQuadtreed, iEntityGrid>();
+		writes<iVelocityComponent, iTransformComponent>();
+	}
+
 	void iVelocitySystem::update(const iaTime &time, iEntityScenePtr scene)
 	{
 		auto *registry = static_cast<entt::registry *>(scene->getRegistry());
 
-		if (scene->hasQuadtree())
+		if (scene->hasQuadtree() || scene->hasGrid())
 		{
-			auto &quadtree = scene->getQuadtree();
+			const iQuadtreed *quadtree = scene->hasQuadtree() ? &scene->getQuadtree() : nullptr;
+			const iEntityGrid *grid = scene->hasGrid() ? &scene->getGrid() : nullptr;
 
 			auto viewInteractionResolver = registry->view<iVelocityComponent, iBody2DComponent, iMotionInteractionResolverComponent>();
+			const auto &motionResolvers = viewInteractionResolver.storage<iMotionInteractionResolverComponent>();
+			const auto &interactionEntities = viewInteractionResolver.handle();
 
-			for (auto entityID : viewInteractionResolver)
+			struct Interaction
 			{
-				auto [velocity, quadComp, motionResolver] = viewInteractionResolver.get<iVelocityComponent, iBody2DComponent, iMotionInteractionResolverComponent>(entityID);
+				entt::entity _entityA;
+				entt::entity _entityB;
+				iaVector2d _diversion;
+			};
+
+			// quadtree and grid are read only here so the pair query can run in parallel.
+			// every pair gets reported once only so the pairs get collected first and applied to both entities afterwards
+			std::vector<Interaction> interactions;
+			iaMutex interactionsMutex;
+
+			auto addInteraction = [&](std::vector<Interaction> &result, iEntityID idA, const iaCircled &circleA, iEntityID idB, const iaCircled &circleB)
+			{
+				const entt::entity entityA = static_cast<entt::entity>(idA);
+				const entt::entity entityB = static_cast<entt::entity>(idB);
+
+				// skip everything that does not interact
+				if (!motionResolvers.contains(entityA) ||
+					!motionResolvers.contains(entityB))
+				{
+					return;
+				}
+
+				result.push_back({entityA, entityB, circleA._center - circleB._center});
+			};
+
+			const uint64 rangeSize = grid != nullptr ? grid->getCellCount() : quadtree->getLeafCount();
 
-				switch (motionResolver._type)
+			scene->forEachChunk(rangeSize, [&](uint64 begin, uint64 end)
+								{
+				std::vector<Interaction> result;
+
+				if (grid != nullptr)
 				{
-				case iMotionInteractionType::Divert:
+					grid->queryPairs(begin, end, [&](uint32 indexA, uint32 indexB)
+									 {
+						const iEntityGrid::Entry &entryA = grid->getEntry(indexA);
+						const iEntityGrid::Entry &entryB = grid->getEntry(indexB);
+						addInteraction(result, entryA._userData, entryA._circle, entryB._userData, entryB._circle); },
+									 1.1);
+				}
+				else
 				{
-					iaCircled circle = quadComp._object->_circle;
-					circle._radius *= 1.1;
-					iQuadtreed::Objects objects;
-					quadtree.query(circle, objects);
+					quadtree->queryPairs(begin, end, [&](const iQuadtreed::ObjectPtr &objectA, const iQuadtreed::ObjectPtr &objectB)
+										 { addInteraction(result, std::any_cast<iEntityID>(objectA->_userData), objectA->_circle,
+														  std::any_cast<iEntityID>(objectB->_userData), objectB->_circle); },
+										 1.1);
+				}
 
-					float64 speed = velocity._velocity.length();
-					iaVector2d diversion;
+				interactionsMutex.lock();
+				interactions.insert(interactions.end(), result.begin(), result.end());
+				interactionsMutex.unlock(); });
 
-					for (const auto &object : objects)
+			std::unordered_map<entt::entity, iaVector2d> diversions;
+			for (const auto &interaction : interactions)
+			{
+				diversions[interaction._entityA] += interaction._diversion;
+				diversions[interaction._entityB] -= interaction._diversion;
+			}
+
+			// every entity only writes its own velocity
+			scene->forEachChunk(interactionEntities.size(), [&](uint64 begin, uint64 end)
+								{
+				for (uint64 i = begin; i < end; ++i)
+				{
+					const entt::entity entityID = interactionEntities[i];
+					if (!viewInteractionResolver.contains(entityID))
 					{
-						const entt::entity otherEntityID = static_cast<entt::entity>(std::any_cast<iEntityID>(object->_userData));
+						continue;
+					}
 
-						// skip self
-						if (otherEntityID == entityID)
-						{
-							continue;
-						}
+					auto [velocity, motionResolver] = viewInteractionResolver.get<iVelocityComponent, iMotionInteractionResolverComponent>(entityID);
 
-						auto *hasMotionInteraction = registry->try_get<iMotionInteractionResolverComponent>(otherEntityID);
-						if (hasMotionInteraction == nullptr)
+					switch (motionResolver._type)
+					{
+					case iMotionInteractionType::Divert:
+					{
+						auto iter = diversions.find(entityID);
+						if (iter == diversions.end())
 						{
-							continue;
+							break;
 						}
 
-						// calc diversion
-						diversion += circle._center - object->_circle._center;
-					}
-
-					diversion.normalize();
-					diversion *= speed;
+						iaVector2d diversion = iter->second;
+						diversion.normalize();
+						diversion *= velocity._velocity.length();
 
-					velocity._velocity._x += diversion._x;
-					velocity._velocity._y += diversion._y;
-				}
-				break;
-
-				case iMotionInteractionType::None:
-				default:
+						velocity._velocity._x += diversion._x;
+						velocity._velocity._y += diversion._y;
+					}
 					break;
-				}
-			}
+
+					case iMotionInteractionType::None:
+					default:
+						break;
+					}
+				} });
 		}
 
 		auto viewNoBounds = registry->view<iVelocityComponent, iTransformComponent>(entt::exclude<iGlobalBoundaryComponent>);
+		const auto &noBoundsEntities = viewNoBounds.handle();
 
-		for (auto entityID : viewNoBounds)
-		{
-			auto [velocity, transform] = viewNoBounds.get<iVelocityComponent, iTransformComponent>(entityID);
+		scene->forEachChunk(noBoundsEntities.size(), [&](uint64 begin, uint64 end)
+							{
+			for (uint64 i = begin; i < end; ++i)
+			{
+				const entt::entity entityID = noBoundsEntities[i];
+				if (!viewNoBounds.contains(entityID))
+				{
+					continue;
+				}
 
-			transform._position += velocity._velocity;
-			transform._orientation += velocity._angularVelocity;
-		}
+				auto [velocity, transform] = viewNoBounds.get<iVelocityComponent, iTransformComponent>(entityID);
+
+				transform._position += velocity._velocity;
+				transform._orientation += velocity._angularVelocity;
+			} });
 
 		auto viewWithBounds = registry->view<iVelocityComponent, iTransformComponent, iGlobalBoundaryComponent>();
+		const auto &withBoundsEntities = viewWithBounds.handle();
 		iaVector3d min;
 		iaVector3d max;
 		_bounds.getMinMax(min, max);
 		const iaVector3d dimensions = _bounds._halfWidths * 2.0;
 
-		for (auto entityID : viewWithBounds)
-		{
-			auto [velocity, transform, bounds] = viewWithBounds.get<iVelocityComponent, iTransformComponent, iGlobalBoundaryComponent>(entityID);
-
-			auto &position = transform._position;
+		scene->forEachChunk(withBoundsEntities.size(), [&](uint64 begin, uint64 end)
+							{
+			for (uint64 i = begin; i < end; ++i)
+			{
+				const entt::entity entityID = withBoundsEntities[i];
+				if (!viewWithBounds.contains(entityID))
+				{
+					continue;
+				}
 
-			transform._orientation += velocity._angularVelocity;
+				auto [velocity, transform, bounds] = viewWithBounds.get<iVelocityComponent, iTransformComponent, iGlobalBoundaryComponent>(entityID);
 
-			switch (bounds._type)
-			{
-			case iGlobalBoundaryType::Repeat:
+				auto &position = transform._position;
 
-				position += velocity._velocity;
+				transform._orientation += velocity._angularVelocity;
 
-				if (position._x > max._x)
-				{
-					position._x -= dimensions._x;
-				}
-				if (position._x < min._x)
+				switch (bounds._type)
 				{
-					position._x += dimensions._x;
-				}
+				case iGlobalBoundaryType::Repeat:
 
-				if (position._y > max._y)
-				{
-					position._y -= dimensions._y;
-				}
-				if (position._y < min._y)
-				{
-					position._y += dimensions._y;
-				}
+					position += velocity._velocity;
 
-				if (position._z > max._z)
-				{
-					position._z -= dimensions._z;
-				}
-				if (position._z < min._z)
-				{
-					position._z += dimensions._z;
-				}
-				break;
+					if (position._x > max._x)
+					{
+						position._x -= dimensions._x;
+					}
+					if (position._x < min._x)
+					{
+						position._x += dimensions._x;
+					}
 
-			case iGlobalBoundaryType::None:
-			default:
-				position += velocity._velocity;
-				break;
-			}
-		}
+					if (position._y > max._y)
+					{
+						position._y -= dimensions._y;
+					}
+					if (position._y < min._y)
+					{
+						position._y += dimensions._y;
+					}
+
+					if (position._z > max._z)
+					{
+						position._z -= dimensions._z;
+					}
+					if (position._z < min._z)
+					{
+						position._z += dimensions._z;
+					}
+					break;
+
+				case iGlobalBoundaryType::None:
+				default:
+					position += velocity._velocity;
+					break;
+				}
+			} });
 	}
 
 	void iVelocitySystem::setBounds(const iAABoxd &box)
@@ -41,9 +41,9 @@ namespace igor
 	class iVelocitySystem : public iEntitySystem
 	{
 	public:
-		/*! does nothing
+		/*! declares component access
 		 */
-		iVelocitySystem() = default;
+		iVelocitySystem();
 
 		/*! does nothing
 		 */
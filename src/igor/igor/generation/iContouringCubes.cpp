@@ -59,12 +59,6 @@ namespace igor
     iContouringCubes::iContouringCubes()
         : _voxelData(0)
     {
-        for (int i = 0; i < 9; ++i)
-        {
-            DensityPole pole;
-            _currentPoles.push_back(pole);
-        }
-
         _meshBuilder.setJoinVertexes(true);
 
         for (int i = 0; i < 27; ++i)
@@ -88,7 +82,7 @@ namespace igor
 
             if (keep)
             {
-                _trianglesToKeep[0].push_back(triangleIndex);
+                _trianglesToKeep.push_back(triangleIndex);
             }
         }
     }
@@ -3347,7 +3341,8 @@ namespace igor
         {
             _density[i + 0] = _density[i + 9];
             _density[i + 9] = _density[i + 18];
-            _density[i + 18] = _currentPoles[i]._currentDensityPole->getValue(_cubePosition._y);
+            _currentPoles[i]._cursor.next();
+            _density[i + 18] = _currentPoles[i]._cursor.getValue();
         }
     }
 
@@ -3355,17 +3350,17 @@ namespace igor
     {
         _cubePosition = startPosition;
 
-        _currentPoles[0]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x, _cubePosition._z);
-        _currentPoles[1]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 1, _cubePosition._z);
-        _currentPoles[2]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 2, _cubePosition._z);
+        _currentPoles[0]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x, _cubePosition._z, _cubePosition._y);
+        _currentPoles[1]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 1, _cubePosition._z, _cubePosition._y);
+        _currentPoles[2]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 2, _cubePosition._z, _cubePosition._y);
 
-        _currentPoles[3]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x, _cubePosition._z + 1);
-        _currentPoles[4]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 1, _cubePosition._z + 1);
-        _currentPoles[5]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 2, _cubePosition._z + 1);
+        _currentPoles[3]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x, _cubePosition._z + 1, _cubePosition._y);
+        _currentPoles[4]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 1, _cubePosition._z + 1, _cubePosition._y);
+        _currentPoles[5]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 2, _cubePosition._z + 1, _cubePosition._y);
 
-        _currentPoles[6]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x, _cubePosition._z + 2);
-        _currentPoles[7]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 1, _cubePosition._z + 2);
-        _currentPoles[8]._currentDensityPole = &_voxelData->getDensityPole(_cubePosition._x + 2, _cubePosition._z + 2);
+        _currentPoles[6]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x, _cubePosition._z + 2, _cubePosition._y);
+        _currentPoles[7]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 1, _cubePosition._z + 2, _cubePosition._y);
+        _currentPoles[8]._cursor = iVoxelPoleCursor(*_voxelData, _cubePosition._x + 2, _cubePosition._z + 2, _cubePosition._y);
 
         for (int i = 0; i < 27; ++i)
         {
@@ -3374,7 +3369,7 @@ namespace igor
 
         for (int i = 0; i < 9; ++i)
         {
-            _density[i + 18] = _currentPoles[i]._currentDensityPole->getValue(_cubePosition._y);
+            _density[i + 18] = _currentPoles[i]._cursor.getValue();
         }
     }
 
@@ -3550,10 +3545,9 @@ namespace igor
         {
             _meshBuilder.normalizeNormals();
 
-            for (auto iter : _trianglesToKeep)
+            if (!_trianglesToKeep.empty())
             {
-                result = _meshBuilder.createMesh(iter.second);
-                break;
+                result = _meshBuilder.createMesh(_trianglesToKeep);
             }
         }
 
@@ -33,7 +33,6 @@
 #include <igor/resources/mesh/iMeshBuilder.h>
 
 #include <iaux/math/iaVector3.h>
-#include <iaux/data/iaRLE.h>
 using namespace iaux;
 
 #include <vector>
@@ -50,9 +49,9 @@ namespace igor
         */
         struct DensityPole
         {
-            /*! current density pole
+            /*! cursor in current density pole
             */
-            iaRLE<uint8, uint8> *_currentDensityPole = nullptr;
+            iVoxelPoleCursor _cursor;
         };
 
     public:
@@ -115,7 +114,7 @@ namespace igor
 
         /*! current poles (3 times 3) for iterating through the voxel data
         */
-        std::vector<DensityPole> _currentPoles;
+        DensityPole _currentPoles[9];
 
         /*! density cache
         */
@@ -149,9 +148,11 @@ namespace igor
         */
         iaVector3I _cubeStartPosition;
 
-        /*! keeps a list of all triangles to the corresponding material id
+        /*! keeps a list of all triangles to keep
+
+        the capacity is kept between compile calls so reusing an instance does not allocate
         */
-        std::map<uint32, std::vector<uint32>> _trianglesToKeep;
+        std::vector<uint32> _trianglesToKeep;
 
         /*! meshbuilder to work with
         */
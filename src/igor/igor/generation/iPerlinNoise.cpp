@@ -6,9 +6,507 @@
 
 #include <stdlib.h>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IGOR_NOISE_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IGOR_NOISE_SSE2
+#endif
+
+#include <algorithm>
+
 namespace igor
 {
 
+    /*! max lanes of all SIMD variants
+     */
+    static const int32 s_maxLanes = 8;
+
+    /*! gradients selected by the lower four bits of a hash. same as iPerlinNoise::grad
+     */
+    static const int8 s_perlinGradients[16][3] = {{1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+                                                  {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+                                                  {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1},
+                                                  {1, 1, 0}, {0, -1, 1}, {-1, 1, 0}, {0, -1, -1}};
+
+    /*! gradients used by simplex noise
+     */
+    static const int8 s_simplexGradients[12][3] = {{1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+                                                   {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+                                                   {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1}};
+
+    /*! one value per lane. used for the remaining grid points and if there is no SIMD support
+     */
+    template <typename T>
+    struct iNoiseLanes
+    {
+        using Vec = T;
+        static const int32 COUNT = 1;
+
+        static Vec set(T value) { return value; }
+        static Vec load(const T *src) { return *src; }
+        static void store(T *dst, Vec value) { *dst = value; }
+        static Vec add(Vec a, Vec b) { return a + b; }
+        static Vec sub(Vec a, Vec b) { return a - b; }
+        static Vec mul(Vec a, Vec b) { return a * b; }
+    };
+
+    /*! as many lanes as the SIMD registers of the target can hold
+     */
+    template <typename T>
+    struct iNoiseSIMDLanes : public iNoiseLanes<T>
+    {
+    };
+
+#if defined(IGOR_NOISE_AVX)
+    template <>
+    struct iNoiseSIMDLanes<float64>
+    {
+        using Vec = __m256d;
+        static const int32 COUNT = 4;
+
+        static Vec set(float64 value) { return _mm256_set1_pd(value); }
+        static Vec load(const float64 *src) { return _mm256_loadu_pd(src); }
+        static void store(float64 *dst, Vec value) { _mm256_storeu_pd(dst, value); }
+        static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    };
+
+    template <>
+    struct iNoiseSIMDLanes<float32>
+    {
+        using Vec = __m256;
+        static const int32 COUNT = 8;
+
+        static Vec set(float32 value) { return _mm256_set1_ps(value); }
+        static Vec load(const float32 *src) { return _mm256_loadu_ps(src); }
+        static void store(float32 *dst, Vec value) { _mm256_storeu_ps(dst, value); }
+        static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    };
+#elif defined(IGOR_NOISE_SSE2)
+    template <>
+    struct iNoiseSIMDLanes<float64>
+    {
+        using Vec = __m128d;
+        static const int32 COUNT = 2;
+
+        static Vec set(float64 value) { return _mm_set1_pd(value); }
+        static Vec load(const float64 *src) { return _mm_loadu_pd(src); }
+        static void store(float64 *dst, Vec value) { _mm_storeu_pd(dst, value); }
+        static Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    };
+
+    template <>
+    struct iNoiseSIMDLanes<float32>
+    {
+        using Vec = __m128;
+        static const int32 COUNT = 4;
+
+        static Vec set(float32 value) { return _mm_set1_ps(value); }
+        static Vec load(const float32 *src) { return _mm_loadu_ps(src); }
+        static void store(float32 *dst, Vec value) { _mm_storeu_ps(dst, value); }
+        static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    };
+#endif
+
+    /*! splits a coordinate in to lattice cell and position within the cell the same way iPerlinNoise::getValue does
+
+    \param value the coordinate
+    \param cell the resulting lattice cell 0-255
+    \param fraction the resulting position within the cell
+    */
+    template <typename T>
+    static IGOR_INLINE void splitCoordinate(T value, int64 &cell, T &fraction)
+    {
+        // same as fmod with 256. dividing and multiplying by a power of two is exact
+        value -= static_cast<T>(static_cast<int64>(value * static_cast<T>(1.0 / iPerlinNoise::RANDOM_NUMBERS_COUNT))) * static_cast<T>(iPerlinNoise::RANDOM_NUMBERS_COUNT);
+
+        const int64 truncated = static_cast<int64>(value);
+        cell = truncated & 255;
+        fraction = value - static_cast<T>(truncated);
+    }
+
+    template <typename L>
+    static IGOR_INLINE typename L::Vec fadeLanes(typename L::Vec t)
+    {
+        // 6t^5 - 15t^4 + 10t^3 in the same order as iPerlinNoise::fade
+        const typename L::Vec t3 = L::mul(L::mul(t, t), t);
+        return L::mul(t3, L::add(L::mul(t, L::sub(L::mul(t, L::set(6.0)), L::set(15.0))), L::set(10.0)));
+    }
+
+    template <typename L>
+    static IGOR_INLINE typename L::Vec lerpLanes(typename L::Vec a, typename L::Vec b, typename L::Vec x)
+    {
+        return L::add(a, L::mul(x, L::sub(b, a)));
+    }
+
+    /*! lattice data of a row of grid points that share y and z
+     */
+    template <typename T>
+    struct iLatticeRow
+    {
+        /*! cells and positions within cell along y and z
+         */
+        int64 _yi;
+        int64 _yi1;
+        int64 _zi;
+        int64 _zi1;
+        T _yf;
+        T _zf;
+
+        /*! faded positions within cell along y and z
+         */
+        T _v;
+        T _w;
+
+        /*! the cell along x the corners below belong to
+         */
+        int64 _cell = -1;
+
+        /*! per corner of current cell the x component of the gradient. zero for value noise
+         */
+        T _cellGradient[8];
+
+        /*! per corner of current cell the part of the gradient dot product that only depends on y and z or the value for value noise
+         */
+        T _cellOffset[8];
+
+        /*! position within cell along x per lane
+         */
+        alignas(32) T _xf[s_maxLanes];
+
+        /*! per corner and lane the x component of the gradient
+         */
+        alignas(32) T _gradient[8][s_maxLanes];
+
+        /*! per corner and lane the y and z part of the gradient dot product
+         */
+        alignas(32) T _offset[8][s_maxLanes];
+    };
+
+    template <typename T>
+    static void initLatticeRow(iLatticeRow<T> &row, T y, T z)
+    {
+        splitCoordinate(y, row._yi, row._yf);
+        splitCoordinate(z, row._zi, row._zf);
+        row._yi1 = (row._yi + 1) % iPerlinNoise::RANDOM_NUMBERS_COUNT;
+        row._zi1 = (row._zi + 1) % iPerlinNoise::RANDOM_NUMBERS_COUNT;
+
+        row._v = fadeLanes<iNoiseLanes<T>>(row._yf);
+        row._w = fadeLanes<iNoiseLanes<T>>(row._zf);
+    }
+
+    /*! hashes the corners of given cell along x
+
+    neighbouring grid points mostly share a cell so this only happens when the cell changes
+    */
+    template <typename T>
+    static void updateLatticeCell(const uint8 *p, iLatticeRow<T> &row, int64 xi, bool valueNoise)
+    {
+        row._cell = xi;
+
+        const int64 xi1 = (xi + 1) % iPerlinNoise::RANDOM_NUMBERS_COUNT;
+        const int64 a = p[xi];
+        const int64 b = p[xi1];
+        const int64 aa = p[a + row._yi];
+        const int64 ab = p[a + row._yi1];
+        const int64 ba = p[b + row._yi];
+        const int64 bb = p[b + row._yi1];
+
+        // even corners are at xi, odd corners at xi + 1
+        const int64 hashes[8] = {p[aa + row._zi], p[ba + row._zi], p[ab + row._zi], p[bb + row._zi],
+                                 p[aa + row._zi1], p[ba + row._zi1], p[ab + row._zi1], p[bb + row._zi1]};
+
+        for (int32 corner = 0; corner < 8; ++corner)
+        {
+            if (valueNoise)
+            {
+                row._cellGradient[corner] = 0;
+                row._cellOffset[corner] = static_cast<T>(hashes[corner]) / static_cast<T>(255.0);
+                continue;
+            }
+
+            const int8 *gradient = s_perlinGradients[hashes[corner] & 0xF];
+            const T y = (corner & 2) ? row._yf - 1 : row._yf;
+            const T z = (corner & 4) ? row._zf - 1 : row._zf;
+
+            row._cellGradient[corner] = static_cast<T>(gradient[0]);
+            row._cellOffset[corner] = static_cast<T>(gradient[1]) * y + static_cast<T>(gradient[2]) * z;
+        }
+    }
+
+    /*! copies the corners of the current cell to given lane
+     */
+    template <typename T>
+    static IGOR_INLINE void copyCellToLane(iLatticeRow<T> &row, int32 lane)
+    {
+        for (int32 corner = 0; corner < 8; ++corner)
+        {
+            row._gradient[corner][lane] = row._cellGradient[corner];
+            row._offset[corner][lane] = row._cellOffset[corner];
+        }
+    }
+
+    /*! interpolates L::COUNT lanes and adds the result times amplitude to dst
+
+    \param uniformCell if true all lanes are in the current cell. otherwise every lane has its corners copied
+    */
+    template <typename T, typename L>
+    static IGOR_INLINE void interpolateLanes(const iLatticeRow<T> &row, bool uniformCell, bool valueNoise, T amplitude, T *dst)
+    {
+        using Vec = typename L::Vec;
+
+        const Vec xf = L::load(row._xf);
+        const Vec xf1 = L::sub(xf, L::set(1.0));
+
+        Vec corners[8];
+        for (int32 corner = 0; corner < 8; ++corner)
+        {
+            const Vec gradient = uniformCell ? L::set(row._cellGradient[corner]) : L::load(row._gradient[corner]);
+            const Vec offset = uniformCell ? L::set(row._cellOffset[corner]) : L::load(row._offset[corner]);
+            corners[corner] = L::add(L::mul(gradient, (corner & 1) ? xf1 : xf), offset);
+        }
+
+        const Vec u = fadeLanes<L>(xf);
+        const Vec v = L::set(row._v);
+
+        Vec x1 = lerpLanes<L>(corners[0], corners[1], u);
+        Vec x2 = lerpLanes<L>(corners[2], corners[3], u);
+        const Vec y1 = lerpLanes<L>(x1, x2, v);
+
+        x1 = lerpLanes<L>(corners[4], corners[5], u);
+        x2 = lerpLanes<L>(corners[6], corners[7], u);
+        const Vec y2 = lerpLanes<L>(x1, x2, v);
+
+        Vec result = lerpLanes<L>(y1, y2, L::set(row._w));
+        if (!valueNoise)
+        {
+            // perlin noise is in a range of -1.0 to 1.0
+            result = L::mul(L::add(result, L::set(1.0)), L::set(0.5));
+        }
+
+        L::store(dst, L::add(L::load(dst), L::mul(result, L::set(amplitude))));
+    }
+
+    /*! adds one octave of perlin or value noise to a row of grid points
+     */
+    template <typename T>
+    static void addLatticeNoiseRow(const uint8 *p, T *dst, int64 count, T originX, T stepX, T frequency, T y, T z, T amplitude, bool valueNoise)
+    {
+        using L = iNoiseSIMDLanes<T>;
+
+        iLatticeRow<T> row;
+        initLatticeRow(row, y, z);
+
+        int64 cells[s_maxLanes];
+
+        int64 i = 0;
+        for (; i + L::COUNT <= count; i += L::COUNT)
+        {
+            bool uniformCell = true;
+            for (int32 lane = 0; lane < L::COUNT; ++lane)
+            {
+                splitCoordinate((originX + static_cast<T>(i + lane) * stepX) * frequency, cells[lane], row._xf[lane]);
+                uniformCell = uniformCell && cells[lane] == cells[0];
+            }
+
+            if (uniformCell)
+            {
+                if (cells[0] != row._cell)
+                {
+                    updateLatticeCell(p, row, cells[0], valueNoise);
+                }
+            }
+            else
+            {
+                for (int32 lane = 0; lane < L::COUNT; ++lane)
+                {
+                    if (cells[lane] != row._cell)
+                    {
+                        updateLatticeCell(p, row, cells[lane], valueNoise);
+                    }
+
+                    copyCellToLane(row, lane);
+                }
+            }
+
+            interpolateLanes<T, L>(row, uniformCell, valueNoise, amplitude, dst + i);
+        }
+
+        for (; i < count; ++i)
+        {
+            splitCoordinate((originX + static_cast<T>(i) * stepX) * frequency, cells[0], row._xf[0]);
+            if (cells[0] != row._cell)
+            {
+                updateLatticeCell(p, row, cells[0], valueNoise);
+            }
+
+            interpolateLanes<T, iNoiseLanes<T>>(row, true, valueNoise, amplitude, dst + i);
+        }
+    }
+
+    template <typename T>
+    static IGOR_INLINE int64 fastFloor(T value)
+    {
+        const int64 truncated = static_cast<int64>(value);
+        return value < static_cast<T>(truncated) ? truncated - 1 : truncated;
+    }
+
+    template <typename T>
+    static IGOR_INLINE T simplexCorner(int64 gradientIndex, T x, T y, T z)
+    {
+        T t = static_cast<T>(0.6) - x * x - y * y - z * z;
+        if (t < 0)
+        {
+            return 0;
+        }
+
+        const int8 *gradient = s_simplexGradients[gradientIndex];
+        t *= t;
+        return t * t * (static_cast<T>(gradient[0]) * x + static_cast<T>(gradient[1]) * y + static_cast<T>(gradient[2]) * z);
+    }
+
+    /*! 3d simplex noise
+
+    based on "Simplex noise demystified" by Stefan Gustavson
+
+    \returns noise value in a range of 0.0-1.0
+    */
+    template <typename T>
+    static T simplexNoise(const uint8 *p, T x, T y, T z)
+    {
+        const T F3 = static_cast<T>(1.0 / 3.0);
+        const T G3 = static_cast<T>(1.0 / 6.0);
+
+        // skew the input space to determine which simplex cell we're in
+        const T s = (x + y + z) * F3;
+        const int64 i = fastFloor(x + s);
+        const int64 j = fastFloor(y + s);
+        const int64 k = fastFloor(z + s);
+
+        const T t = static_cast<T>(i + j + k) * G3;
+        const T x0 = x - (static_cast<T>(i) - t);
+        const T y0 = y - (static_cast<T>(j) - t);
+        const T z0 = z - (static_cast<T>(k) - t);
+
+        // find out which of the six simplices we're in
+        int64 i1, j1, k1, i2, j2, k2;
+        if (x0 >= y0)
+        {
+            if (y0 >= z0)
+            {
+                i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+            }
+            else if (x0 >= z0)
+            {
+                i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 0, k2 = 1;
+            }
+            else
+            {
+                i1 = 0, j1 = 0, k1 = 1, i2 = 1, j2 = 0, k2 = 1;
+            }
+        }
+        else
+        {
+            if (y0 < z0)
+            {
+                i1 = 0, j1 = 0, k1 = 1, i2 = 0, j2 = 1, k2 = 1;
+            }
+            else if (x0 < z0)
+            {
+                i1 = 0, j1 = 1, k1 = 0, i2 = 0, j2 = 1, k2 = 1;
+            }
+            else
+            {
+                i1 = 0, j1 = 1, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+            }
+        }
+
+        const T x1 = x0 - static_cast<T>(i1) + G3;
+        const T y1 = y0 - static_cast<T>(j1) + G3;
+        const T z1 = z0 - static_cast<T>(k1) + G3;
+        const T x2 = x0 - static_cast<T>(i2) + static_cast<T>(2.0) * G3;
+        const T y2 = y0 - static_cast<T>(j2) + static_cast<T>(2.0) * G3;
+        const T z2 = z0 - static_cast<T>(k2) + static_cast<T>(2.0) * G3;
+        const T x3 = x0 - static_cast<T>(1.0) + static_cast<T>(3.0) * G3;
+        const T y3 = y0 - static_cast<T>(1.0) + static_cast<T>(3.0) * G3;
+        const T z3 = z0 - static_cast<T>(1.0) + static_cast<T>(3.0) * G3;
+
+        const int64 ii = i & 255;
+        const int64 jj = j & 255;
+        const int64 kk = k & 255;
+
+        const T n0 = simplexCorner(p[ii + p[jj + p[kk]]] % 12, x0, y0, z0);
+        const T n1 = simplexCorner(p[ii + i1 + p[jj + j1 + p[kk + k1]]] % 12, x1, y1, z1);
+        const T n2 = simplexCorner(p[ii + i2 + p[jj + j2 + p[kk + k2]]] % 12, x2, y2, z2);
+        const T n3 = simplexCorner(p[ii + 1 + p[jj + 1 + p[kk + 1]]] % 12, x3, y3, z3);
+
+        // scaled to stay within -1.0 to 1.0
+        const T result = (static_cast<T>(32.0) * (n0 + n1 + n2 + n3) + static_cast<T>(1.0)) * static_cast<T>(0.5);
+        return std::min(std::max(result, static_cast<T>(0.0)), static_cast<T>(1.0));
+    }
+
+    template <typename T>
+    static void generateValues(const uint8 *p, T *values, const iaVector3<T> &origin, const iaVector3<T> &step, const iaVector3I &size,
+                               int64 octaves, float64 persistence, iNoiseType type)
+    {
+        if (size._x <= 0 || size._y <= 0 || size._z <= 0)
+        {
+            return;
+        }
+
+        const int64 count = size._x * size._y * size._z;
+        std::fill(values, values + count, static_cast<T>(0.0));
+
+        T frequency = 1;
+        T amplitude = 1;
+        T maxValue = 0;
+
+        for (int64 octave = 0; octave < octaves; ++octave)
+        {
+            for (int64 z = 0; z < size._z; ++z)
+            {
+                const T posZ = (origin._z + static_cast<T>(z) * step._z) * frequency;
+
+                for (int64 y = 0; y < size._y; ++y)
+                {
+                    const T posY = (origin._y + static_cast<T>(y) * step._y) * frequency;
+                    T *dst = values + (z * size._y + y) * size._x;
+
+                    if (type == iNoiseType::Simplex)
+                    {
+                        for (int64 x = 0; x < size._x; ++x)
+                        {
+                            dst[x] += simplexNoise(p, (origin._x + static_cast<T>(x) * step._x) * frequency, posY, posZ) * amplitude;
+                        }
+                    }
+                    else
+                    {
+                        addLatticeNoiseRow(p, dst, size._x, origin._x, step._x, frequency, posY, posZ, amplitude, type == iNoiseType::Value);
+                    }
+                }
+            }
+
+            maxValue += amplitude;
+
+            amplitude *= static_cast<T>(persistence);
+            frequency *= 2;
+        }
+
+        for (int64 i = 0; i < count; ++i)
+        {
+            values[i] /= maxValue;
+        }
+    }
+
     iPerlinNoise::iPerlinNoise()
     {
         generateBase(1337);
@@ -63,6 +561,11 @@ namespace igor
     }
 
     float64 iPerlinNoise::getValue(const iaVector3d &pos, int64 octaves, float64 persistence)
+    {
+        return getValue(pos, octaves, persistence, iNoiseType::Perlin);
+    }
+
+    float64 iPerlinNoise::getValue(const iaVector3d &pos, int64 octaves, float64 persistence, iNoiseType type)
     {
         float64 total = 0;
         float64 frequency = 1;
@@ -74,7 +577,7 @@ namespace igor
             iaVector3d temp = pos;
             temp *= frequency;
 
-            total += getValue(temp) * amplitude;
+            total += getValue(temp, type) * amplitude;
 
             maxValue += amplitude;
 
@@ -85,6 +588,38 @@ namespace igor
         return total / maxValue;
     }
 
+    float64 iPerlinNoise::getValue(const iaVector3d &pos, iNoiseType type)
+    {
+        switch (type)
+        {
+        case iNoiseType::Simplex:
+            return simplexNoise(p, pos._x, pos._y, pos._z);
+
+        case iNoiseType::Value:
+        {
+            float64 result = 0.0;
+            addLatticeNoiseRow(p, &result, 1, pos._x, 0.0, 1.0, pos._y, pos._z, 1.0, true);
+            return result;
+        }
+
+        case iNoiseType::Perlin:
+        default:
+            return getValue(pos);
+        }
+    }
+
+    void iPerlinNoise::getValues(float64 *values, const iaVector3d &origin, const iaVector3d &step, const iaVector3I &size,
+                                 int64 octaves, float64 persistence, iNoiseType type) const
+    {
+        generateValues(p, values, origin, step, size, octaves, persistence, type);
+    }
+
+    void iPerlinNoise::getValues(float32 *values, const iaVector3f &origin, const iaVector3f &step, const iaVector3I &size,
+                                 int64 octaves, float64 persistence, iNoiseType type) const
+    {
+        generateValues(p, values, origin, step, size, octaves, persistence, type);
+    }
+
     float64 iPerlinNoise::getValue(const float64 pos)
     {
         float64 x = pos;
@@ -38,6 +38,23 @@ using namespace iaux;
 namespace igor
 {
 
+    /*! noise algorithms provided by iPerlinNoise
+     */
+    enum class iNoiseType
+    {
+        /*! classic perlin noise
+         */
+        Perlin,
+
+        /*! simplex noise. less directional artifacts than perlin noise
+         */
+        Simplex,
+
+        /*! smoothly interpolated random values on an integer lattice
+         */
+        Value
+    };
+
     /*! perlin noise
 
     most of the implementation comes from the folowing sources
@@ -91,6 +108,54 @@ namespace igor
         */
         float64 getValue(const float64 pos, int64 octaves, float64 persistence = 0.5);
 
+        /*! \returns noise value of given type at specified position in a range of 0.0-1.0
+
+        \param pos specified position
+        \param type the noise algorithm to use
+        */
+        float64 getValue(const iaVector3d &pos, iNoiseType type);
+
+        /*! \returns noise value of given type and multiple octaves at specified position in a range of 0.0-1.0
+
+        \param pos specified position
+        \param octaves octaves count
+        \param persistence multiplicator of amplitude between each octave
+        \param type the noise algorithm to use
+        */
+        float64 getValue(const iaVector3d &pos, int64 octaves, float64 persistence, iNoiseType type);
+
+        /*! fills a grid with noise values
+
+        the value at index x + y * size._x + z * size._x * size._y is the same getValue returns for position
+        origin + (x, y, z) * step. For a 2D grid set one dimension of size to 1.
+        Perlin and value noise get evaluated with multiple grid points per SIMD register
+
+        \param values destination with space for size._x * size._y * size._z values
+        \param origin position of first grid point
+        \param step distance between grid points
+        \param size number of grid points per axis
+        \param octaves octaves count
+        \param persistence multiplicator of amplitude between each octave
+        \param type the noise algorithm to use
+        */
+        void getValues(float64 *values, const iaVector3d &origin, const iaVector3d &step, const iaVector3I &size,
+                       int64 octaves = 1, float64 persistence = 0.5, iNoiseType type = iNoiseType::Perlin) const;
+
+        /*! fills a grid with noise values using single precision
+
+        same as the float64 version with twice the lanes per SIMD register at the cost of precision
+
+        \param values destination with space for size._x * size._y * size._z values
+        \param origin position of first grid point
+        \param step distance between grid points
+        \param size number of grid points per axis
+        \param octaves octaves count
+        \param persistence multiplicator of amplitude between each octave
+        \param type the noise algorithm to use
+        */
+        void getValues(float32 *values, const iaVector3f &origin, const iaVector3f &step, const iaVector3I &size,
+                       int64 octaves = 1, float64 persistence = 0.5, iNoiseType type = iNoiseType::Perlin) const;
+
         /*! generates random numbers
         */
         iPerlinNoise();
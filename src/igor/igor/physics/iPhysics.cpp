@@ -24,9 +24,18 @@
 
 #include <dgNewton/Newton.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace igor
 {
 
+    /*! true while this thread runs a force and torque or constraint callback of a simulation step
+
+    the step already holds the simulation mutex so calls from within those callbacks must not lock it again
+    */
+    static thread_local bool s_insideSimulationCallback = false;
+
     /*! callback for physics body destruction
 
     \param body pointer to body that got destroyed
@@ -76,7 +85,9 @@ namespace igor
         iPhysicsBody *physicsBody = static_cast<iPhysicsBody *>(NewtonBodyGetUserData(static_cast<const NewtonBody *>(body)));
         if (nullptr != physicsBody)
         {
+            s_insideSimulationCallback = true;
             physicsBody->applyForceAndTorque(timestep);
+            s_insideSimulationCallback = false;
         }
     }
 
@@ -91,7 +102,9 @@ namespace igor
         iPhysicsJoint *physicsJoint = static_cast<iPhysicsJoint *>(NewtonJointGetUserData(static_cast<const NewtonJoint *>(joint)));
         if (physicsJoint != nullptr)
         {
+            s_insideSimulationCallback = true;
             physicsJoint->submitConstraints(timestep);
+            s_insideSimulationCallback = false;
         }
     }
 
@@ -141,6 +154,11 @@ namespace igor
     {
         createDefaultWorld();
         createDefaultMaterial();
+
+        if (iConfigReader::getInstance().hasSetting("collisionCache"))
+        {
+            setCollisionCacheDirectory(iConfigReader::getInstance().getValue("collisionCache"));
+        }
     }
 
     iPhysics::~iPhysics()
@@ -169,6 +187,11 @@ namespace igor
             }
         }
 
+        _collisionCacheMutex.lock();
+        _collisionCache.setMaxShapeCount(0);
+        _collisionCacheMutex.unlock();
+        evictCollisionCache();
+
         destroyMaterials();
         NewtonMaterialDestroyAllGroupID(static_cast<const NewtonWorld *>(_defaultWorld));
 
@@ -254,7 +277,14 @@ namespace igor
     void iPhysics::queueTransformation(iPhysicsBody *body, const iaMatrixd &matrix)
     {
         _mutexBodiesToTransform.lock();
-        _bodiesToTransform.push_back(std::pair<iPhysicsBody *, iaMatrixd>(body, matrix));
+        if (_simulationThreadEnabled)
+        {
+            _stateBuffer.getBackState()._bodies.push_back({body->getID(), matrix});
+        }
+        else
+        {
+            _bodiesToTransform.push_back(std::pair<iPhysicsBody *, iaMatrixd>(body, matrix));
+        }
         _mutexBodiesToTransform.unlock();
     }
 
@@ -388,32 +418,44 @@ namespace igor
 
     void iPhysics::setAngularDamping(void *newtonBody, const iaVector3d &angularDamp)
     {
+        lockSimulation();
         NewtonBodySetAngularDamping(static_cast<const NewtonBody *>(newtonBody), angularDamp.getData());
+        unlockSimulation();
     }
 
     void iPhysics::setLinearDamping(void *newtonBody, float64 linearDamp)
     {
+        lockSimulation();
         NewtonBodySetLinearDamping(static_cast<const NewtonBody *>(newtonBody), linearDamp);
+        unlockSimulation();
     }
 
     void iPhysics::getVelocity(void *newtonBody, iaVector3d &velocity)
     {
+        lockSimulation();
         NewtonBodyGetVelocity(static_cast<const NewtonBody *>(newtonBody), velocity.getData());
+        unlockSimulation();
     }
 
     void iPhysics::setForce(void *newtonBody, const iaVector3d &force)
     {
+        lockSimulation();
         NewtonBodySetForce(static_cast<const NewtonBody *>(newtonBody), force.getData());
+        unlockSimulation();
     }
 
     void iPhysics::setTorque(void *newtonBody, const iaVector3d &torque)
     {
+        lockSimulation();
         NewtonBodySetTorque(static_cast<const NewtonBody *>(newtonBody), torque.getData());
+        unlockSimulation();
     }
 
     void iPhysics::getMassMatrix(void *newtonBody, float64 &mass, float64 &Ixx, float64 &Iyy, float64 &Izz)
     {
+        lockSimulation();
         NewtonBodyGetMass(static_cast<const NewtonBody *>(newtonBody), &mass, &Ixx, &Iyy, &Izz);
+        unlockSimulation();
     }
 
     void *iPhysics::getUserDataFromBody(void *newtonBody)
@@ -431,11 +473,158 @@ namespace igor
 
         _lastTime = iTimer::getInstance().getTime();
         _running = true;
+
+        startSimulationThread();
     }
 
     void iPhysics::stop()
     {
         _running = false;
+
+        stopSimulationThread();
+    }
+
+    void iPhysics::setSimulationThreadEnabled(bool enabled)
+    {
+        if (_simulationThreadEnabled == enabled)
+        {
+            return;
+        }
+
+        stopSimulationThread();
+
+        // a step of the main thread might still be in progress
+        NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>(_defaultWorld));
+
+        _mutexBodiesToTransform.lock();
+        _simulationThreadEnabled = enabled;
+        _mutexBodiesToTransform.unlock();
+
+        if (_running)
+        {
+            _lastTime = iTimer::getInstance().getTime();
+            startSimulationThread();
+        }
+    }
+
+    bool iPhysics::isSimulationThreadEnabled() const
+    {
+        return _simulationThreadEnabled;
+    }
+
+    void iPhysics::startSimulationThread()
+    {
+        if (!_simulationThreadEnabled ||
+            _simulationThread != nullptr)
+        {
+            return;
+        }
+
+        _simulationThread = new iFixedStepThread(iFixedStepDelegate(this, &iPhysics::onSimulationStep), _simulationRate);
+        _simulationThread->start();
+    }
+
+    void iPhysics::stopSimulationThread()
+    {
+        if (_simulationThread == nullptr)
+        {
+            return;
+        }
+
+        _simulationThread->stop();
+        delete _simulationThread;
+        _simulationThread = nullptr;
+    }
+
+    void iPhysics::onSimulationStep(const iaTime &time, const iaTime &timeDelta)
+    {
+        _simulationMutex.lock();
+
+        // the async update and wait keep the existing waits for updates to finish working
+        NewtonUpdateAsync(static_cast<const NewtonWorld *>(_defaultWorld), timeDelta.getSeconds());
+        NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>(_defaultWorld));
+
+        _mutexBodiesToTransform.lock();
+        iPhysicsState &state = _stateBuffer.getBackState();
+        state._time = time + timeDelta;
+        state._step = ++_simulationStep;
+        _stateBuffer.publish();
+        _mutexBodiesToTransform.unlock();
+
+        _simulationMutex.unlock();
+    }
+
+    void iPhysics::lockSimulation()
+    {
+        if (!s_insideSimulationCallback)
+        {
+            _simulationMutex.lock();
+        }
+    }
+
+    void iPhysics::unlockSimulation()
+    {
+        if (!s_insideSimulationCallback)
+        {
+            _simulationMutex.unlock();
+        }
+    }
+
+    void iPhysics::applySimulationStates()
+    {
+        _stateBuffer.fetch();
+
+        const iPhysicsState &previous = _stateBuffer.getPreviousState();
+        const iPhysicsState &current = _stateBuffer.getCurrentState();
+
+        // rendering one step behind the simulation so there are always two states to interpolate between
+        const float64 t = _stateBuffer.getInterpolation(iaTime::getNow() - iaTime::fromSeconds(1.0 / _simulationRate));
+
+        auto previousIter = previous._bodies.begin();
+
+        for (const auto &bodyState : current._bodies)
+        {
+            // bodies that did not move in the current step stay where the previous step left them
+            while (previousIter != previous._bodies.end() &&
+                   previousIter->_bodyID < bodyState._bodyID)
+            {
+                iPhysicsBody *body = getBody(previousIter->_bodyID);
+                if (body != nullptr)
+                {
+                    body->setTransformNodeMatrix(previousIter->_matrix);
+                }
+                previousIter++;
+            }
+
+            const bool moved = previousIter != previous._bodies.end() && previousIter->_bodyID == bodyState._bodyID;
+
+            iPhysicsBody *body = getBody(bodyState._bodyID);
+            if (body != nullptr)
+            {
+                if (moved)
+                {
+                    body->setTransformNodeMatrix(previousIter->_matrix, bodyState._matrix, t);
+                }
+                else
+                {
+                    body->setTransformNodeMatrix(bodyState._matrix);
+                }
+            }
+
+            if (moved)
+            {
+                previousIter++;
+            }
+        }
+
+        for (; previousIter != previous._bodies.end(); ++previousIter)
+        {
+            iPhysicsBody *body = getBody(previousIter->_bodyID);
+            if (body != nullptr)
+            {
+                body->setTransformNodeMatrix(previousIter->_matrix);
+            }
+        }
     }
 
     void iPhysics::destroyNewtonCollision(void *collision, uint64 worldID)
@@ -443,8 +632,10 @@ namespace igor
         const NewtonWorld *world = static_cast<const NewtonWorld *>(getWorld(worldID)->getNewtonWorld());
         if (world != nullptr)
         {
+            _simulationMutex.lock();
             NewtonWaitForUpdateToFinish(world);
             NewtonDestroyCollision(static_cast<const NewtonCollision *>(collision));
+            _simulationMutex.unlock();
         }
     }
 
@@ -511,6 +702,12 @@ namespace igor
         {
             handleQueues();
 
+            if (_simulationThread != nullptr)
+            {
+                applySimulationStates();
+                return;
+            }
+
             const uint32 maxUpdateCount = 3;
             const iaTime timeDelta = iaTime::fromSeconds(1.0 / _simulationRate);
 
@@ -530,6 +727,13 @@ namespace igor
     void iPhysics::setSimulationRate(float64 simulationRate)
     {
         _simulationRate = simulationRate;
+
+        // the simulation thread runs at a fixed rate
+        if (_simulationThread != nullptr)
+        {
+            stopSimulationThread();
+            startSimulationThread();
+        }
     }
 
     float64 iPhysics::getSimulationRate()
@@ -648,6 +852,7 @@ namespace igor
         if (collisionVolume != nullptr &&
             collisionVolume->_collision != nullptr)
         {
+            _simulationMutex.lock();
             NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>(_defaultWorld));
             NewtonBody *newtonBody = NewtonCreateDynamicBody(static_cast<const NewtonWorld *>(_defaultWorld), static_cast<const NewtonCollision *>(collisionVolume->_collision), matrix.getData());
 
@@ -658,6 +863,7 @@ namespace igor
 
             NewtonBodySetMassMatrix(newtonBody, 0, 0, 0, 0);
             NewtonBodySetMatrix(newtonBody, matrix.getData());
+            _simulationMutex.unlock();
 
             result = new iPhysicsBody(newtonBody);
 
@@ -695,12 +901,14 @@ namespace igor
 
         if (body0 != nullptr)
         {
+            _simulationMutex.lock();
             NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>(_defaultWorld));
 
             NewtonJoint *joint = NewtonConstraintCreateUserJoint(static_cast<NewtonWorld *>(_defaultWorld), maxDOF,
                                                                  reinterpret_cast<NewtonUserBilateralCallback>(SubmitConstraints), 
                                                                  static_cast<NewtonBody *>(body0->getNewtonBody()),
                                                                  body1 != nullptr ? static_cast<NewtonBody *>(body1->getNewtonBody()) : nullptr);
+            _simulationMutex.unlock();
 
             result = new iPhysicsJoint(joint, body0->getID(), body1 != nullptr ? body1->getID() : 0);
 
@@ -759,7 +967,10 @@ namespace igor
             }
 
             body->bindTransformNode(transformNode);
+
+            lockSimulation();
             NewtonBodySetUserData(static_cast<const NewtonBody *>(body->_newtonBody), body);
+            unlockSimulation();
         }
     }
 
@@ -769,7 +980,9 @@ namespace igor
 
         if (body != nullptr)
         {
+            lockSimulation();
             NewtonBodySetMaterialGroupID(static_cast<const NewtonBody *>(body->_newtonBody), materialID);
+            unlockSimulation();
         }
     }
 
@@ -840,9 +1053,11 @@ namespace igor
 
     void iPhysics::destroyNewtonBody(void *newtonBody)
     {
+        _simulationMutex.lock();
         NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>(_defaultWorld));
         NewtonBodySetUserData(static_cast<const NewtonBody *>(newtonBody), nullptr);
         NewtonDestroyBody(static_cast<const NewtonBody *>(newtonBody));
+        _simulationMutex.unlock();
     }
 
     void iPhysics::destroyCollision(uint64 collisionID)
@@ -979,8 +1194,27 @@ namespace igor
             auto iter = _worlds.find(world->getID());
             if (iter != _worlds.end())
             {
+                _simulationMutex.lock();
                 NewtonWaitForUpdateToFinish(static_cast<const NewtonWorld *>((*iter).second->getNewtonWorld()));
+
+                // cached shapes can't outlive their world
+                std::vector<NewtonCollision *> shapes;
+                _collisionCacheMutex.lock();
+                void *shape = nullptr;
+                while ((shape = _collisionCache.evictShape(world->getID())) != nullptr)
+                {
+                    shapes.push_back(static_cast<NewtonCollision *>(shape));
+                }
+                _collisionCacheMutex.unlock();
+
+                for (auto shape : shapes)
+                {
+                    NewtonDestroyCollision(shape);
+                }
+
                 NewtonDestroy(static_cast<const NewtonWorld *>((*iter).second->getNewtonWorld()));
+                _simulationMutex.unlock();
+
                 delete (*iter).second;
                 _worlds.erase(iter);
             }
@@ -1164,16 +1398,21 @@ namespace igor
 
     void iPhysics::updateMatrix(void *newtonBody, const iaMatrixd &matrix)
     {
+        lockSimulation();
         NewtonBodySetMatrix(static_cast<const NewtonBody *>(newtonBody), matrix.getData());
+        unlockSimulation();
     }
 
     void iPhysics::getMatrix(void *newtonBody, iaMatrixd &matrix)
     {
+        lockSimulation();
         NewtonBodyGetMatrix(static_cast<const NewtonBody *>(newtonBody), matrix.getData());
+        unlockSimulation();
     }
 
     void iPhysics::setMassMatrix(void *newtonBody, float64 mass, float64 Ixx, float64 Iyy, float64 Izz)
     {
+        lockSimulation();
         if (mass >= IGOR_GRAM)
         {
             NewtonBodySetMassMatrix(static_cast<const NewtonBody *>(newtonBody), mass, Ixx, Iyy, Izz);
@@ -1182,18 +1421,47 @@ namespace igor
         {
             NewtonBodySetMassMatrix(static_cast<const NewtonBody *>(newtonBody), 0, 0, 0, 0);
         }
+        unlockSimulation();
     }
 
-    iPhysicsCollision *iPhysics::createMesh(iMeshPtr mesh, int64 faceAttribute, const iaMatrixd &offset, uint64 worldID)
+    /*! appends serialized newton collision to a byte vector
+
+    \param serializeHandle the byte vector
+    \param buffer the serialized data
+    \param size size of serialized data
+    */
+    static void SerializeCollision(void *const serializeHandle, const void *const buffer, int size)
     {
-        con_assert(mesh != nullptr, "zero pointer");
+        std::vector<uint8> *data = static_cast<std::vector<uint8> *>(serializeHandle);
+        const uint8 *bytes = static_cast<const uint8 *>(buffer);
+        data->insert(data->end(), bytes, bytes + size);
+    }
 
-        const NewtonWorld *world = static_cast<const NewtonWorld *>(getWorld(worldID)->getNewtonWorld());
-        con_assert(world != nullptr, "zero pointer");
+    /*! read position in serialized newton collision
+    */
+    struct iCollisionReader
+    {
+        const std::vector<uint8> *_data;
+        size_t _position;
+    };
 
-        con_assert(mesh->hasRawData() != 0, "empty mesh");
+    /*! reads serialized newton collision from a byte vector
 
-        NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
+    \param serializeHandle the collision reader
+    \param buffer the destination
+    \param size size to read
+    */
+    static void DeserializeCollision(void *const serializeHandle, void *const buffer, int size)
+    {
+        iCollisionReader *reader = static_cast<iCollisionReader *>(serializeHandle);
+        const size_t count = std::min(static_cast<size_t>(size), reader->_data->size() - reader->_position);
+
+        memcpy(buffer, reader->_data->data() + reader->_position, count);
+        reader->_position += count;
+    }
+
+    void *iPhysics::buildMeshCollision(iMeshPtr mesh, int64 faceAttribute, const void *world)
+    {
         NewtonCollision *collision = NewtonCreateTreeCollision(static_cast<const NewtonWorld *>(world), 0);
         NewtonTreeCollisionBeginBuild(collision);
 
@@ -1232,10 +1500,95 @@ namespace igor
 
         NewtonTreeCollisionEndBuild(collision, 1);
 
+        return collision;
+    }
+
+    iPhysicsCollision *iPhysics::createMesh(iMeshPtr mesh, int64 faceAttribute, const iaMatrixd &offset, uint64 worldID)
+    {
+        con_assert(mesh != nullptr, "zero pointer");
+
+        const NewtonWorld *world = static_cast<const NewtonWorld *>(getWorld(worldID)->getNewtonWorld());
+        con_assert(world != nullptr, "zero pointer");
+
+        con_assert(mesh->hasRawData() != 0, "empty mesh");
+
+        const iPhysicsCollisionCacheKey key = iPhysicsCollisionCache::calcKey(mesh, faceAttribute);
+        NewtonCollision *collision = nullptr;
+
+        // identical meshes share one shape per world
+        _collisionCacheMutex.lock();
+        const NewtonCollision *shape = static_cast<const NewtonCollision *>(_collisionCache.getShape(key, worldID));
+        if (shape != nullptr)
+        {
+            NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
+            collision = NewtonCollisionCreateInstance(shape);
+            NewtonWorldCriticalSectionUnlock(world);
+        }
+        _collisionCacheMutex.unlock();
+
+        if (collision == nullptr)
+        {
+            std::vector<uint8> data;
+
+            _collisionCacheMutex.lock();
+            const bool serialize = !_collisionCache.getDirectory().isEmpty();
+            const bool found = _collisionCache.read(key, data);
+            _collisionCacheMutex.unlock();
+
+            if (found)
+            {
+                iCollisionReader reader = {&data, 0};
+
+                NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
+                collision = NewtonCreateCollisionFromSerialization(world, DeserializeCollision, &reader);
+                NewtonWorldCriticalSectionUnlock(world);
+
+                if (collision == nullptr)
+                {
+                    _collisionCacheMutex.lock();
+                    con_warn("can't deserialize \"" << _collisionCache.getFilename(key) << "\"");
+                    _collisionCacheMutex.unlock();
+                }
+            }
+
+            if (collision == nullptr)
+            {
+                data.clear();
+
+                NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
+                collision = static_cast<NewtonCollision *>(buildMeshCollision(mesh, faceAttribute, world));
+                if (serialize)
+                {
+                    NewtonCollisionSerialize(world, collision, SerializeCollision, &data);
+                }
+                NewtonWorldCriticalSectionUnlock(world);
+
+                _collisionCacheMutex.lock();
+                _collisionCache.write(key, data);
+                _collisionCacheMutex.unlock();
+            }
+
+            NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
+            NewtonCollision *newShape = NewtonCollisionCreateInstance(collision);
+            NewtonWorldCriticalSectionUnlock(world);
+
+            _collisionCacheMutex.lock();
+            const bool added = _collisionCache.addShape(key, worldID, newShape);
+            _collisionCacheMutex.unlock();
+
+            // another thread added the same shape first
+            if (!added)
+            {
+                NewtonDestroyCollision(newShape);
+            }
+
+            evictCollisionCache();
+        }
+
+        NewtonWorldCriticalSectionLock(world, iaThread::getThisThreadID());
         iPhysicsCollision *result = new iPhysicsCollision(collision, worldID);
         NewtonCollisionSetUserID(static_cast<const NewtonCollision *>(collision), result->getID());
         NewtonCollisionSetUserData(static_cast<const NewtonCollision *>(collision), static_cast<void *const>(result));
-
         NewtonWorldCriticalSectionUnlock(world);
 
         _collisionsListMutex.lock();
@@ -1245,4 +1598,64 @@ namespace igor
         return result;
     }
 
+    void iPhysics::evictCollisionCache()
+    {
+        std::vector<NewtonCollision *> shapes;
+
+        _collisionCacheMutex.lock();
+        void *shape = nullptr;
+        while ((shape = _collisionCache.evictShape()) != nullptr)
+        {
+            shapes.push_back(static_cast<NewtonCollision *>(shape));
+        }
+        _collisionCacheMutex.unlock();
+
+        // bodies using the same shape keep their own reference
+        _simulationMutex.lock();
+        for (auto shape : shapes)
+        {
+            NewtonDestroyCollision(shape);
+        }
+        _simulationMutex.unlock();
+    }
+
+    void iPhysics::setCollisionCacheDirectory(const iaString &directory)
+    {
+        _collisionCacheMutex.lock();
+        _collisionCache.setDirectory(directory);
+        _collisionCacheMutex.unlock();
+    }
+
+    iaString iPhysics::getCollisionCacheDirectory() const
+    {
+        _collisionCacheMutex.lock();
+        const iaString result = _collisionCache.getDirectory();
+        _collisionCacheMutex.unlock();
+
+        return result;
+    }
+
+    void iPhysics::setCollisionCacheSize(uint32 count)
+    {
+        _collisionCacheMutex.lock();
+        _collisionCache.setMaxShapeCount(count);
+        _collisionCacheMutex.unlock();
+
+        evictCollisionCache();
+    }
+
+    uint32 iPhysics::getCollisionCacheSize() const
+    {
+        _collisionCacheMutex.lock();
+        const uint32 result = _collisionCache.getMaxShapeCount();
+        _collisionCacheMutex.unlock();
+
+        return result;
+    }
+
+    const iPhysicsCollisionCache &iPhysics::getCollisionCache() const
+    {
+        return _collisionCache;
+    }
+
 } // namespace igor
\ No newline at end of file
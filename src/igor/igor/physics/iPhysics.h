@@ -31,6 +31,9 @@
 
 #include <igor/physics/iPhysicsBody.h>
 #include <igor/physics/iPhysicsWorld.h>
+#include <igor/physics/iPhysicsStateBuffer.h>
+#include <igor/physics/iPhysicsCollisionCache.h>
+#include <igor/threading/iFixedStepThread.h>
 #include <igor/resources/mesh/iMesh.h>
 #include <igor/resources/module/iModule.h>
 
@@ -95,6 +98,21 @@ namespace igor
         */
         float64 getSimulationRate();
 
+        /*! enables or disables stepping the simulation in it's own thread
+
+        default is disabled. The simulation then gets stepped by the main thread every frame.
+
+        if enabled the simulation runs at the simulation rate independent of the frame rate. Bound transform nodes
+        get interpolated between the last two simulation states every frame and therefore lag one step behind.
+
+        \param enabled if true the simulation runs in it's own thread
+        */
+        void setSimulationThreadEnabled(bool enabled);
+
+        /*! \returns true if the simulation runs in it's own thread
+        */
+        bool isSimulationThreadEnabled() const;
+
         /*! registers handle to application handle event
         */
         void start();
@@ -290,6 +308,35 @@ namespace igor
         */
         iPhysicsCollision *createMesh(iMeshPtr mesh, int64 faceAttribute, const iaMatrixd &offset);
 
+        /*! sets the directory mesh collisions get serialized to
+
+        mesh collisions found there are loaded instead of build from scratch. They are named by the content hash of the mesh.
+        Default is empty which disables the serialization. Can also be set with the "collisionCache" setting
+
+        \param directory the cache directory
+        */
+        void setCollisionCacheDirectory(const iaString &directory);
+
+        /*! \returns the directory mesh collisions get serialized to
+        */
+        iaString getCollisionCacheDirectory() const;
+
+        /*! sets how many mesh collisions are kept in memory to be shared by identical meshes of the same world
+
+        default is 32
+
+        \param count the maximum mesh collisions kept in memory
+        */
+        void setCollisionCacheSize(uint32 count);
+
+        /*! \returns how many mesh collisions are kept in memory
+        */
+        uint32 getCollisionCacheSize() const;
+
+        /*! \returns the mesh collision cache for statistics
+        */
+        const iPhysicsCollisionCache &getCollisionCache() const;
+
         /*! creates newton collision in shape of a sphere
 
         \param radius radius of sphere
@@ -445,6 +492,34 @@ namespace igor
         */
         iaMutex _mutexBodiesToTransform;
 
+        /*! cache of mesh collisions
+        */
+        iPhysicsCollisionCache _collisionCache;
+
+        /*! mutex to protect the collision cache
+        */
+        mutable iaMutex _collisionCacheMutex;
+
+        /*! if true the simulation runs in it's own thread
+        */
+        bool _simulationThreadEnabled = false;
+
+        /*! thread stepping the simulation
+        */
+        iFixedStepThread *_simulationThread = nullptr;
+
+        /*! mutex held while the simulation thread does a step and while newton bodies get accessed from outside the step
+        */
+        iaMutex _simulationMutex;
+
+        /*! body transformations handed from the simulation thread to the main thread
+        */
+        iPhysicsStateBuffer _stateBuffer;
+
+        /*! amount of steps done by the simulation thread
+        */
+        uint64 _simulationStep = 0;
+
         struct Contact
         {
             iPhysicsMaterialCombo *_material;
@@ -484,6 +559,33 @@ namespace igor
         */
         float64 _simulationRate = 120.0;
 
+        /*! starts simulation thread if enabled
+        */
+        void startSimulationThread();
+
+        /*! stops simulation thread if running
+        */
+        void stopSimulationThread();
+
+        /*! does one simulation step. called by simulation thread
+
+        \param time the time the step was scheduled for
+        \param timeDelta the time delta of one step
+        */
+        void onSimulationStep(const iaTime &time, const iaTime &timeDelta);
+
+        /*! interpolates bound transform nodes between the last two states of the simulation thread
+        */
+        void applySimulationStates();
+
+        /*! locks the simulation mutex before accessing newton bodies unless called from within a simulation step callback
+        */
+        void lockSimulation();
+
+        /*! unlocks what lockSimulation locked
+        */
+        void unlockSimulation();
+
         /*! queues transformation on body
 
         \param body the body to transform
@@ -520,6 +622,19 @@ namespace igor
         */
         iPhysicsCollision *createMesh(iMeshPtr mesh, int64 faceAttribute, const iaMatrixd &offset, uint64 worldID);
 
+        /*! builds newton tree collision from mesh
+
+        \param mesh the mesh
+        \param faceAttribute an integer attribute associated with the faces
+        \param world the newton world
+        \returns newton collision
+        */
+        void *buildMeshCollision(iMeshPtr mesh, int64 faceAttribute, const void *world);
+
+        /*! destroys all mesh collisions above the cache size
+        */
+        void evictCollisionCache();
+
         /*! creates a user mesh collision
 
         \todo this is not done yet
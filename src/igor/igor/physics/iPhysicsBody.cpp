@@ -98,6 +98,17 @@ namespace igor
         }
     }
 
+    void iPhysicsBody::setTransformNodeMatrix(const iaMatrixd &from, const iaMatrixd &to, float64 t)
+    {
+        iNodeTransform *transformNode = static_cast<iNodeTransform *>(iNodeManager::getInstance().getNode(_transformNodeID));
+        con_assert(transformNode != nullptr, "body " << _id << " is not bound to a node");
+
+        if (transformNode != nullptr)
+        {
+            transformNode->setMatrix(from, to, t);
+        }
+    }
+
     void iPhysicsBody::getTransformNodeMatrix(iaMatrixd &matrix) const
     {
         iNodeTransform *transformNode = static_cast<iNodeTransform *>(iNodeManager::getInstance().getNode(_transformNodeID));
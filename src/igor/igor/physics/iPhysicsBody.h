@@ -257,6 +257,16 @@ namespace igor
         */
         void setTransformNodeMatrix(const iaMatrixd &matrix);
 
+        /*! updates the transform node matrix interpolated between two physics states
+
+        is called by iPhysics when the simulation runs in it's own thread
+
+        \param from matrix of the previous state
+        \param to matrix of the current state
+        \param t interpolation factor 0-1
+        */
+        void setTransformNodeMatrix(const iaMatrixd &from, const iaMatrixd &to, float64 t);
+
         /*! updates the omega by physics event
 
         is called by iPhysics after the body changed it's position
@@ -0,0 +1,373 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/physics/iPhysicsCollisionCache.h>
+
+#include <iaux/system/iaConsole.h>
+#include <iaux/system/iaDirectory.h>
+#include <iaux/system/iaFile.h>
+#include <iaux/system/iaThread.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace igor
+{
+
+    /*! identifies a serialized shape file
+    */
+    static const uint32 s_fileMagic = 0x43434749; // IGCC
+
+    /*! has to change whenever the serialization changes. For example with a new version of newton
+    */
+    static const uint32 s_fileVersion = 2;
+
+    /*! header of a serialized shape file
+    */
+    struct iCollisionCacheHeader
+    {
+        uint32 _magic;
+        uint32 _version;
+        uint64 _hash;
+        uint64 _hash2;
+        uint32 _indexDataSize;
+        uint32 _vertexDataSize;
+        uint64 _size;
+    };
+
+    static const uint64 s_hashPrime1 = 0x9e3779b185ebca87ull;
+    static const uint64 s_hashPrime2 = 0xc2b2ae3d27d4eb4full;
+    static const uint64 s_hashPrime3 = 0x165667b19e3779f9ull;
+    static const uint64 s_hashPrime4 = 0x85ebca77c2b2ae63ull;
+
+    static const uint64 s_hashSeed = 0;
+    static const uint64 s_hashSeed2 = 0x2545f4914f6cdd1dull;
+
+    static uint64 rotateLeft(uint64 value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    /*! mixes one word in to the hash the way xxhash64 does it
+
+    every input bit affects many bits of the hash so flipping bits in several words does not cancel out
+    */
+    static uint64 mixWord(uint64 hash, uint64 word)
+    {
+        word *= s_hashPrime2;
+        word = rotateLeft(word, 31);
+        word *= s_hashPrime1;
+
+        hash ^= word;
+        return rotateLeft(hash, 27) * s_hashPrime1 + s_hashPrime4;
+    }
+
+    /*! hashes 8 bytes at a time. the remaining bytes get padded with zeros
+    */
+    static uint64 mixData(const void *data, uint64 size, uint64 hash)
+    {
+        const uint8 *bytes = static_cast<const uint8 *>(data);
+        const uint64 wordCount = size / sizeof(uint64);
+
+        for (uint64 i = 0; i < wordCount; ++i)
+        {
+            uint64 word;
+            memcpy(&word, bytes + i * sizeof(uint64), sizeof(uint64));
+            hash = mixWord(hash, word);
+        }
+
+        const uint64 rest = size - wordCount * sizeof(uint64);
+        if (rest != 0)
+        {
+            uint64 word = 0;
+            memcpy(&word, bytes + wordCount * sizeof(uint64), rest);
+            hash = mixWord(hash, word);
+        }
+
+        return hash;
+    }
+
+    /*! final avalanche of xxhash64
+    */
+    static uint64 finalizeHash(uint64 hash)
+    {
+        hash ^= hash >> 33;
+        hash *= s_hashPrime2;
+        hash ^= hash >> 29;
+        hash *= s_hashPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    /*! \returns hash of mesh content
+
+    the sizes are part of the header so the zero padding can not make different data look the same
+    */
+    static uint64 calcHash(const uint64 *header, uint64 headerSize, const void *indexData, uint32 indexDataSize, const void *vertexData, uint32 vertexDataSize, uint64 seed)
+    {
+        uint64 hash = seed + s_hashPrime3;
+        hash = mixData(header, headerSize, hash);
+        hash = mixData(indexData, indexDataSize, hash);
+        hash = mixData(vertexData, vertexDataSize, hash);
+        return finalizeHash(hash);
+    }
+
+    bool iPhysicsCollisionCacheKey::operator==(const iPhysicsCollisionCacheKey &other) const
+    {
+        return _hash == other._hash &&
+               _hash2 == other._hash2 &&
+               _indexDataSize == other._indexDataSize &&
+               _vertexDataSize == other._vertexDataSize;
+    }
+
+    iPhysicsCollisionCacheKey iPhysicsCollisionCache::calcKey(iMeshPtr mesh, int64 faceAttribute)
+    {
+        con_assert(mesh != nullptr && mesh->hasRawData(), "no mesh data");
+
+        void *indexData;
+        uint32 indexDataSize;
+        void *vertexData;
+        uint32 vertexDataSize;
+        mesh->getRawData(indexData, indexDataSize, vertexData, vertexDataSize);
+
+        const uint64 header[] = {static_cast<uint64>(faceAttribute), mesh->getLayout().getStride(), mesh->getIndexCount(), indexDataSize, vertexDataSize};
+
+        iPhysicsCollisionCacheKey key;
+        key._hash = calcHash(header, sizeof(header), indexData, indexDataSize, vertexData, vertexDataSize, s_hashSeed);
+        key._hash2 = calcHash(header, sizeof(header), indexData, indexDataSize, vertexData, vertexDataSize, s_hashSeed2);
+        key._indexDataSize = indexDataSize;
+        key._vertexDataSize = vertexDataSize;
+        return key;
+    }
+
+    void iPhysicsCollisionCache::setDirectory(const iaString &directory)
+    {
+        _directory = directory;
+
+        if (!_directory.isEmpty() &&
+            !iaDirectory::exists(_directory))
+        {
+            iaDirectory::makeDirectory(_directory);
+        }
+    }
+
+    const iaString &iPhysicsCollisionCache::getDirectory() const
+    {
+        return _directory;
+    }
+
+    iaString iPhysicsCollisionCache::getFilename(const iPhysicsCollisionCacheKey &key) const
+    {
+        return _directory + IGOR_PATHSEPARATOR + iaString::toString(key._hash, 16) + ".collision";
+    }
+
+    bool iPhysicsCollisionCache::write(const iPhysicsCollisionCacheKey &key, const std::vector<uint8> &data)
+    {
+        if (_directory.isEmpty() ||
+            data.empty())
+        {
+            return false;
+        }
+
+        // other threads might write the same shape at the same time
+        const iaString filename = getFilename(key);
+        const iaString tempFilename = filename + "." + iaString::toString(iaThread::getThisThreadID()) + ".tmp";
+
+        char temp[1024];
+        tempFilename.getData(temp, 1024);
+
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            con_err("can't open to write \"" << tempFilename << "\"");
+            return false;
+        }
+
+        const iCollisionCacheHeader header = {s_fileMagic, s_fileVersion, key._hash, key._hash2, key._indexDataSize, key._vertexDataSize, data.size()};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(data.data()), data.size());
+        stream.close();
+
+        if (stream.fail())
+        {
+            con_err("can't write \"" << tempFilename << "\"");
+            iaFile::remove(tempFilename);
+            return false;
+        }
+
+        iaFile(tempFilename).rename(filename, true);
+        return true;
+    }
+
+    bool iPhysicsCollisionCache::read(const iPhysicsCollisionCacheKey &key, std::vector<uint8> &data)
+    {
+        data.clear();
+
+        if (_directory.isEmpty())
+        {
+            _misses++;
+            return false;
+        }
+
+        char temp[1024];
+        getFilename(key).getData(temp, 1024);
+
+        std::ifstream stream(temp, std::ios::binary);
+        if (!stream.is_open())
+        {
+            _misses++;
+            return false;
+        }
+
+        iCollisionCacheHeader header;
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+        if (stream.fail() ||
+            header._magic != s_fileMagic ||
+            header._version != s_fileVersion ||
+            header._hash != key._hash)
+        {
+            con_warn("ignoring invalid collision cache file \"" << temp << "\"");
+            _misses++;
+            return false;
+        }
+
+        // same hash but different content
+        if (header._hash2 != key._hash2 ||
+            header._indexDataSize != key._indexDataSize ||
+            header._vertexDataSize != key._vertexDataSize)
+        {
+            con_warn("ignoring collision cache file \"" << temp << "\" of different mesh with same hash");
+            _misses++;
+            return false;
+        }
+
+        data.resize(header._size);
+        stream.read(reinterpret_cast<char *>(data.data()), data.size());
+
+        // also fails if the file is shorter than it claims to be
+        if (stream.fail())
+        {
+            con_warn("ignoring invalid collision cache file \"" << temp << "\"");
+            data.clear();
+            _misses++;
+            return false;
+        }
+
+        _directoryHits++;
+        return true;
+    }
+
+    void iPhysicsCollisionCache::setMaxShapeCount(uint32 count)
+    {
+        _maxShapeCount = count;
+    }
+
+    uint32 iPhysicsCollisionCache::getMaxShapeCount() const
+    {
+        return _maxShapeCount;
+    }
+
+    uint32 iPhysicsCollisionCache::getShapeCount() const
+    {
+        return static_cast<uint32>(_shapes.size());
+    }
+
+    std::unordered_multimap<uint64, std::list<iPhysicsCollisionCache::iShape>::iterator>::iterator iPhysicsCollisionCache::findShape(const iPhysicsCollisionCacheKey &key, uint64 worldID)
+    {
+        auto range = _shapeLookup.equal_range(key._hash);
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second->_worldID == worldID &&
+                iter->second->_key == key)
+            {
+                return iter;
+            }
+        }
+
+        return _shapeLookup.end();
+    }
+
+    void *iPhysicsCollisionCache::getShape(const iPhysicsCollisionCacheKey &key, uint64 worldID)
+    {
+        auto iter = findShape(key, worldID);
+        if (iter == _shapeLookup.end())
+        {
+            return nullptr;
+        }
+
+        // most recently used first
+        _shapes.splice(_shapes.begin(), _shapes, iter->second);
+
+        _memoryHits++;
+        return iter->second->_shape;
+    }
+
+    bool iPhysicsCollisionCache::addShape(const iPhysicsCollisionCacheKey &key, uint64 worldID, void *shape)
+    {
+        con_assert(shape != nullptr, "zero pointer");
+
+        if (findShape(key, worldID) != _shapeLookup.end())
+        {
+            return false;
+        }
+
+        _shapes.push_front({key, worldID, shape});
+        _shapeLookup.emplace(key._hash, _shapes.begin());
+
+        return true;
+    }
+
+    void *iPhysicsCollisionCache::removeShape(std::list<iShape>::iterator iter)
+    {
+        auto lookup = findShape(iter->_key, iter->_worldID);
+        con_assert(lookup != _shapeLookup.end(), "inconsistent lookup");
+        _shapeLookup.erase(lookup);
+
+        void *result = iter->_shape;
+        _shapes.erase(iter);
+
+        return result;
+    }
+
+    void *iPhysicsCollisionCache::evictShape()
+    {
+        if (_shapes.size() <= _maxShapeCount)
+        {
+            return nullptr;
+        }
+
+        return removeShape(std::prev(_shapes.end()));
+    }
+
+    void *iPhysicsCollisionCache::evictShape(uint64 worldID)
+    {
+        for (auto iter = _shapes.begin(); iter != _shapes.end(); ++iter)
+        {
+            if (iter->_worldID == worldID)
+            {
+                return removeShape(iter);
+            }
+        }
+
+        return nullptr;
+    }
+
+    uint64 iPhysicsCollisionCache::getMemoryHits() const
+    {
+        return _memoryHits;
+    }
+
+    uint64 iPhysicsCollisionCache::getDirectoryHits() const
+    {
+        return _directoryHits;
+    }
+
+    uint64 iPhysicsCollisionCache::getMisses() const
+    {
+        return _misses;
+    }
+
+}; // namespace igor
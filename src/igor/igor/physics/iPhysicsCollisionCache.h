@@ -0,0 +1,247 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_PHYSICSCOLLISIONCACHE__
+#define __IGOR_PHYSICSCOLLISIONCACHE__
+
+#include <igor/resources/mesh/iMesh.h>
+
+#include <iaux/data/iaString.h>
+using namespace iaux;
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace igor
+{
+
+    /*! identifies the mesh data a collision shape was built from
+    */
+    struct IGOR_API iPhysicsCollisionCacheKey
+    {
+        /*! content hash. names the file of the serialized shape
+        */
+        uint64 _hash = 0;
+
+        /*! second content hash calculated with a different seed
+        */
+        uint64 _hash2 = 0;
+
+        /*! size of index data in bytes
+        */
+        uint32 _indexDataSize = 0;
+
+        /*! size of vertex data in bytes
+        */
+        uint32 _vertexDataSize = 0;
+
+        /*! \returns true if both keys are equal
+
+        \param other the other key
+        */
+        bool operator==(const iPhysicsCollisionCacheKey &other) const;
+    };
+
+    /*! cache for collision shapes built from meshes
+
+    serialized shapes get stored in a cache directory and are named after the content hash of the mesh they where built from.
+    A serialized shape is only used if the second hash and the data sizes stored with it match too.
+    In addition the most recently used shapes are kept in memory per world so bodies with identical meshes share one shape.
+
+    the cache does not know about newton. Shapes are handles owned by the cache until they get evicted.
+    The cache is not thread safe. iPhysics guards it
+    */
+    class IGOR_API iPhysicsCollisionCache
+    {
+
+    public:
+        /*! \returns key of mesh content
+
+        \param mesh the mesh with raw data
+        \param faceAttribute the face attribute the collision gets build with
+        */
+        static iPhysicsCollisionCacheKey calcKey(iMeshPtr mesh, int64 faceAttribute);
+
+        /*! sets the directory serialized shapes are stored in
+
+        an empty directory disables storing shapes
+
+        \param directory the cache directory
+        */
+        void setDirectory(const iaString &directory);
+
+        /*! \returns the cache directory
+        */
+        const iaString &getDirectory() const;
+
+        /*! \returns file name of serialized shape
+
+        \param key the key of the mesh content
+        */
+        iaString getFilename(const iPhysicsCollisionCacheKey &key) const;
+
+        /*! writes serialized shape in to the cache directory
+
+        \param key the key of the mesh content
+        \param data the serialized shape
+        \returns true if successful
+        */
+        bool write(const iPhysicsCollisionCacheKey &key, const std::vector<uint8> &data);
+
+        /*! reads serialized shape from cache directory
+
+        \param key the key of the mesh content
+        \param[out] data the serialized shape
+        \returns true if the shape was found and was stored with the same key
+        */
+        bool read(const iPhysicsCollisionCacheKey &key, std::vector<uint8> &data);
+
+        /*! sets maximum amount of shapes kept in memory
+
+        shapes above the maximum have to be evicted using evictShape
+
+        \param count the maximum shape count
+        */
+        void setMaxShapeCount(uint32 count);
+
+        /*! \returns maximum amount of shapes kept in memory
+        */
+        uint32 getMaxShapeCount() const;
+
+        /*! \returns amount of shapes kept in memory
+        */
+        uint32 getShapeCount() const;
+
+        /*! \returns shape for given key and world or nullptr if not in memory
+
+        \param key the key of the mesh content
+        \param worldID the world the shape belongs to
+        */
+        void *getShape(const iPhysicsCollisionCacheKey &key, uint64 worldID);
+
+        /*! adds shape to memory
+
+        \param key the key of the mesh content
+        \param worldID the world the shape belongs to
+        \param shape the shape
+        \returns false if there already was a shape with that key and world. The cache does not take ownership in that case
+        */
+        bool addShape(const iPhysicsCollisionCacheKey &key, uint64 worldID, void *shape);
+
+        /*! \returns least recently used shape if there are more shapes than the maximum or nullptr otherwise
+
+        the caller takes ownership of the returned shape
+        */
+        void *evictShape();
+
+        /*! \returns a shape of given world or nullptr if there is none left
+
+        the caller takes ownership of the returned shape
+
+        \param worldID the world the shape belongs to
+        */
+        void *evictShape(uint64 worldID);
+
+        /*! \returns amount of shapes found in memory
+        */
+        uint64 getMemoryHits() const;
+
+        /*! \returns amount of shapes read from the cache directory
+        */
+        uint64 getDirectoryHits() const;
+
+        /*! \returns amount of shapes that where neither in memory nor in the cache directory
+        */
+        uint64 getMisses() const;
+
+    private:
+        /*! shape kept in memory
+        */
+        struct iShape
+        {
+            /*! the key of the mesh content
+            */
+            iPhysicsCollisionCacheKey _key;
+
+            /*! the world the shape belongs to
+            */
+            uint64 _worldID;
+
+            /*! the shape
+            */
+            void *_shape;
+        };
+
+        /*! the cache directory
+        */
+        iaString _directory;
+
+        /*! maximum amount of shapes kept in memory
+        */
+        uint32 _maxShapeCount = 32;
+
+        /*! shapes in memory. most recently used first
+        */
+        std::list<iShape> _shapes;
+
+        /*! lookup of shapes in memory by content hash
+        */
+        std::unordered_multimap<uint64, std::list<iShape>::iterator> _shapeLookup;
+
+        /*! amount of shapes found in memory
+        */
+        std::atomic<uint64> _memoryHits = 0;
+
+        /*! amount of shapes read from the cache directory
+        */
+        std::atomic<uint64> _directoryHits = 0;
+
+        /*! amount of shapes neither in memory nor in the cache directory
+        */
+        std::atomic<uint64> _misses = 0;
+
+        /*! \returns position of shape in lookup or end of lookup if not in memory
+
+        \param key the key of the mesh content
+        \param worldID the world the shape belongs to
+        */
+        std::unordered_multimap<uint64, std::list<iShape>::iterator>::iterator findShape(const iPhysicsCollisionCacheKey &key, uint64 worldID);
+
+        /*! removes shape from memory
+
+        \param iter position of the shape in the shape list
+        \returns the shape
+        */
+        void *removeShape(std::list<iShape>::iterator iter);
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_PHYSICSCOLLISIONCACHE__
@@ -0,0 +1,91 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/physics/iPhysicsStateBuffer.h>
+
+#include <algorithm>
+
+namespace igor
+{
+
+    iPhysicsState &iPhysicsStateBuffer::getBackState()
+    {
+        return _states[_back];
+    }
+
+    void iPhysicsStateBuffer::publish()
+    {
+        auto &bodies = _states[_back]._bodies;
+
+        // if the reader did not fetch the last published state yet it might never do so. So we carry over the bodies
+        // that moved in it. It does not get written to before it comes back to us so reading it here is safe
+        const uint32 published = _shared.load(std::memory_order_acquire);
+        if (published & NEW_STATE)
+        {
+            const auto &unfetched = _states[published & ~NEW_STATE]._bodies;
+            bodies.insert(bodies.begin(), unfetched.begin(), unfetched.end());
+        }
+
+        std::stable_sort(bodies.begin(), bodies.end(), [](const iPhysicsBodyState &a, const iPhysicsBodyState &b)
+                         { return a._bodyID < b._bodyID; });
+
+        // carried over bodies can show up twice. the latest one wins
+        auto target = bodies.begin();
+        for (auto iter = bodies.begin(); iter != bodies.end(); ++iter)
+        {
+            if (target != bodies.begin() &&
+                (target - 1)->_bodyID == iter->_bodyID)
+            {
+                *(target - 1) = *iter;
+            }
+            else
+            {
+                *target++ = *iter;
+            }
+        }
+        bodies.erase(target, bodies.end());
+
+        // we get back either the reader's oldest state or a state it never fetched
+        _back = _shared.exchange(_back | NEW_STATE, std::memory_order_acq_rel) & ~NEW_STATE;
+        _states[_back]._bodies.clear();
+    }
+
+    bool iPhysicsStateBuffer::fetch()
+    {
+        if (!(_shared.load(std::memory_order_acquire) & NEW_STATE))
+        {
+            return false;
+        }
+
+        const uint32 shared = _shared.exchange(_previous, std::memory_order_acq_rel);
+        _previous = _current;
+        _current = shared & ~NEW_STATE;
+
+        return true;
+    }
+
+    const iPhysicsState &iPhysicsStateBuffer::getCurrentState() const
+    {
+        return _states[_current];
+    }
+
+    const iPhysicsState &iPhysicsStateBuffer::getPreviousState() const
+    {
+        return _states[_previous];
+    }
+
+    float64 iPhysicsStateBuffer::getInterpolation(const iaTime &time) const
+    {
+        const int64 previousTime = _states[_previous]._time.getMicroseconds();
+        const int64 span = _states[_current]._time.getMicroseconds() - previousTime;
+
+        if (span <= 0)
+        {
+            return 1.0;
+        }
+
+        return std::clamp(static_cast<float64>(time.getMicroseconds() - previousTime) / static_cast<float64>(span), 0.0, 1.0);
+    }
+
+}; // namespace igor
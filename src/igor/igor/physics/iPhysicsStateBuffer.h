@@ -0,0 +1,153 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_PHYSICSSTATEBUFFER__
+#define __IGOR_PHYSICSSTATEBUFFER__
+
+#include <igor/iDefines.h>
+
+#include <iaux/math/iaMatrix.h>
+#include <iaux/system/iaTime.h>
+using namespace iaux;
+
+#include <atomic>
+#include <vector>
+
+namespace igor
+{
+
+    /*! transformation of one body at the end of a simulation step
+    */
+    struct IGOR_API iPhysicsBodyState
+    {
+        /*! the body's id
+        */
+        uint64 _bodyID;
+
+        /*! the body's matrix
+        */
+        iaMatrixd _matrix;
+    };
+
+    /*! transformations of all bodies that moved since the last state the reader fetched
+    */
+    struct IGOR_API iPhysicsState
+    {
+        /*! time the simulation step was scheduled for
+        */
+        iaTime _time;
+
+        /*! the simulation step
+        */
+        uint64 _step = 0;
+
+        /*! body states sorted by body id
+        */
+        std::vector<iPhysicsBodyState> _bodies;
+    };
+
+    /*! hands physics states from the simulation thread over to the main thread without locking
+
+    the simulation thread writes in to the back state and publishes it. The main thread fetches the latest published state
+    and keeps the one before so it can interpolate between the two. There is exactly one writer and one reader.
+    */
+    class IGOR_API iPhysicsStateBuffer
+    {
+
+    public:
+        /*! \returns the state to write the next simulation step in to
+
+        writer only
+        */
+        iPhysicsState &getBackState();
+
+        /*! sorts the back state and makes it available to the reader
+
+        if the reader did not fetch the previously published state yet it's bodies get carried over so no movement gets lost
+
+        writer only
+        */
+        void publish();
+
+        /*! fetches the latest published state
+
+        reader only
+
+        \returns true if there was a new state
+        */
+        bool fetch();
+
+        /*! \returns latest fetched state
+
+        reader only
+        */
+        const iPhysicsState &getCurrentState() const;
+
+        /*! \returns state fetched before the current one
+
+        reader only
+        */
+        const iPhysicsState &getPreviousState() const;
+
+        /*! \returns interpolation factor between previous and current state for given time clamped to 0-1
+
+        reader only
+
+        \param time the time to interpolate for
+        */
+        float64 getInterpolation(const iaTime &time) const;
+
+    private:
+        /*! flag marking the shared state as not fetched yet
+        */
+        static const uint32 NEW_STATE = 4;
+
+        /*! the states. back, shared, current and previous
+        */
+        iPhysicsState _states[4];
+
+        /*! index of state the writer works on
+        */
+        uint32 _back = 0;
+
+        /*! index of the shared state ored with NEW_STATE if published but not fetched yet
+        */
+        std::atomic<uint32> _shared = 1;
+
+        /*! index of the latest fetched state
+        */
+        uint32 _current = 2;
+
+        /*! index of the state fetched before the current one
+        */
+        uint32 _previous = 3;
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_PHYSICSSTATEBUFFER__
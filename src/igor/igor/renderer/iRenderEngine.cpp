@@ -106,7 +106,7 @@ namespace igor
         }
 
         cullScene(_currentCamera);
-        updateMaterialGroups();
+        updateRenderQueue();
 
         iaMatrixd camMatrix;
         _currentCamera->getWorldMatrix(camMatrix);
@@ -135,7 +135,7 @@ namespace igor
         _scene->setFrustum(frustum);
     }
 
-    void iRenderEngine::addNodeToMaterialGroups(iNodeRenderPtr renderNode)
+    void iRenderEngine::addToRenderQueue(iNodeRenderPtr renderNode)
     {
         if (!renderNode->isVisible())
         {
@@ -156,75 +156,49 @@ namespace igor
             return;
         }
 
-        auto iter = std::find_if(_materialGroups.begin(), _materialGroups.end(),
-                                 [&shaderMaterial](const iMaterialGroup &materialGroup)
-                                 { return materialGroup._material == shaderMaterial; });
-
-        if (iter != _materialGroups.end())
+        const void *mesh = nullptr;
+        if (renderNode->getType() == iNodeType::iNodeMesh)
         {
-            iter->_renderNodes.push_back(renderNode);
-        }
-        else
-        {
-            if (shaderMaterial->getRenderState(iRenderState::Instanced) == iRenderStateValue::Off)
-            {
-                _materialGroups.push_back({shaderMaterial, {renderNode}, std::unordered_map<iMeshPtr, iInstaningPackage>()});
-            }
-            else
-            {
-                _materialGroups.push_back({shaderMaterial, {renderNode}, std::unordered_map<iMeshPtr, iInstaningPackage>()});
-            }
+            mesh = static_cast<iNodeMeshPtr>(renderNode)->getMesh().get();
         }
-    }
 
-    void iRenderEngine::updateMaterialGroups()
-    {
-        auto iter = _materialGroups.begin();
-        while (iter != _materialGroups.end())
-        {
-            // remove unused materials
-            if (iter->_renderNodes.empty())
-            {
-                iter = _materialGroups.erase(iter);
-                continue;
-            }
+        const auto &textures = material->getTextures();
+        const void *texture = textures.empty() ? nullptr : textures.begin()->second.get();
 
-            iter++;
-        }
+        _renderQueue.submit(renderNode, shaderMaterial->getOrder(), shaderMaterial.get(), mesh, texture);
+    }
 
-        std::vector<void *> cullResult;
-        _scene->getCullResult(cullResult);
+    void iRenderEngine::updateRenderQueue()
+    {
+        _renderQueue.beginFrame();
 
-        for (void *ptr : cullResult)
+        for (void *ptr : _scene->getCullResult())
         {
-            addNodeToMaterialGroups(static_cast<iNodeRenderPtr>(ptr));
+            addToRenderQueue(static_cast<iNodeRenderPtr>(ptr));
         }
 
         for (const auto renderNode : _scene->getRenderables())
         {
-            addNodeToMaterialGroups(renderNode);
+            addToRenderQueue(renderNode);
         }
 
-        std::sort(_materialGroups.begin(), _materialGroups.end(), [](const iMaterialGroup a, const iMaterialGroup b) -> bool
-                  { return a._material->getOrder() < b._material->getOrder(); });
+        _renderQueue.endFrame();
     }
 
     void iRenderEngine::drawColorIDs()
     {
         iRenderer::getInstance().setShaderMaterial(iRenderer::getInstance().getColorIDMaterial());
 
-        for (const auto &materialGroup : _materialGroups)
+        for (uint32 i = 0; i < _renderQueue.size(); ++i)
         {
-            for (iNodeRenderPtr renderNode : materialGroup._renderNodes)
+            iNodeRenderPtr renderNode = _renderQueue.getItem(i);
+            if (renderNode->getType() != iNodeType::iNodeMesh)
             {
-                if (renderNode->getType() != iNodeType::iNodeMesh)
-                {
-                    continue;
-                }
-
-                iRenderer::getInstance().setColorID(renderNode->getID());
-                renderNode->draw();
+                continue;
             }
+
+            iRenderer::getInstance().setColorID(renderNode->getID());
+            renderNode->draw();
         }
     }
 
@@ -252,62 +226,69 @@ namespace igor
             ++lightNum;
         }
 
-        for (auto &materialGroup : _materialGroups)
+        for (auto &pair : _instancing)
+        {
+            for (auto &package : pair.second)
+            {
+                package.second._used = false;
+            }
+        }
+
+        const uint32 count = _renderQueue.size();
+        uint32 begin = 0;
+        while (begin < count)
         {
-            iRenderer::getInstance().setShaderMaterial(materialGroup._material);
+            // the queue is sorted so all nodes using the same shader material are next to each other
+            const iShaderMaterialPtr shaderMaterial = _renderQueue.getItem(begin)->getMaterial()->getShaderMaterial();
+            uint32 end = begin + 1;
+            while (end < count &&
+                   _renderQueue.getItem(end)->getMaterial()->getShaderMaterial() == shaderMaterial)
+            {
+                end++;
+            }
+
+            iRenderer::getInstance().setShaderMaterial(shaderMaterial);
 
-            if (materialGroup._material->getRenderState(iRenderState::Instanced) == iRenderStateValue::Off)
+            if (shaderMaterial->getRenderState(iRenderState::Instanced) == iRenderStateValue::Off)
             {
-                for (iNodeRenderPtr renderNode : materialGroup._renderNodes)
+                for (uint32 i = begin; i < end; ++i)
                 {
-                    renderNode->draw();
+                    _renderQueue.getItem(i)->draw();
                 }
             }
             else
             {
-                for (iNodeRenderPtr renderNode : materialGroup._renderNodes)
+                drawInstanced(shaderMaterial, begin, end);
+            }
+
+            begin = end;
+        }
+
+        // release instancing buffers that are no longer in use
+        auto iter = _instancing.begin();
+        while (iter != _instancing.end())
+        {
+            auto &packages = iter->second;
+            for (auto packageIter = packages.begin(); packageIter != packages.end();)
+            {
+                if (packageIter->second._used)
                 {
-                    if (renderNode->getType() != iNodeType::iNodeMesh)
-                    {
-                        continue;
-                    }
-
-                    iNodeMeshPtr nodeMesh = static_cast<iNodeMeshPtr>(renderNode);
-
-                    if (nodeMesh == nullptr ||
-                        nodeMesh->getMesh() == nullptr ||
-                        !nodeMesh->getMesh()->isValid())
-                    {
-                        continue;
-                    }
-
-                    iMeshPtr mesh = nodeMesh->getMesh();
-
-                    iaMatrixd src = renderNode->getWorldMatrix();
-                    iaMatrixf dst;
-                    for (int i = 0; i < 16; ++i)
-                    {
-                        dst[i] = src[i];
-                    }
-
-                    if (materialGroup._instancing[mesh]._buffer == nullptr)
-                    {
-                        materialGroup._instancing[mesh]._buffer = iInstancingBuffer::create(std::vector<iBufferLayoutEntry>{{iShaderDataType::Matrix4x4}}, materialGroup._renderNodes.size());
-                    }
-
-                    materialGroup._instancing[mesh]._buffer->addInstance(sizeof(iaMatrixf), dst.getData());
-                    // TODO using random target material we find for now
-                    materialGroup._instancing[mesh]._targetMaterial = nodeMesh->getMaterial();
+                    packageIter++;
                 }
-
-                for (const auto &pair : materialGroup._instancing)
+                else
                 {
-                    iRenderer::getInstance().drawMeshInstanced(pair.first, pair.second._buffer, pair.second._targetMaterial);
-                    pair.second._buffer->clear();
+                    packageIter = packages.erase(packageIter);
                 }
             }
 
-            materialGroup._renderNodes.clear();
+            if (packages.empty())
+            {
+                iter = _instancing.erase(iter);
+            }
+            else
+            {
+                iter++;
+            }
         }
 
         if (_showBoundingBoxes)
@@ -322,4 +303,55 @@ namespace igor
         }
     }
 
+    void iRenderEngine::drawInstanced(const iShaderMaterialPtr &shaderMaterial, uint32 begin, uint32 end)
+    {
+        auto &packages = _instancing[shaderMaterial];
+
+        for (uint32 i = begin; i < end; ++i)
+        {
+            iNodeRenderPtr renderNode = _renderQueue.getItem(i);
+            if (renderNode->getType() != iNodeType::iNodeMesh)
+            {
+                continue;
+            }
+
+            iNodeMeshPtr nodeMesh = static_cast<iNodeMeshPtr>(renderNode);
+            iMeshPtr mesh = nodeMesh->getMesh();
+
+            if (mesh == nullptr ||
+                !mesh->isValid())
+            {
+                continue;
+            }
+
+            iaMatrixd src = renderNode->getWorldMatrix();
+            iaMatrixf dst;
+            for (int j = 0; j < 16; ++j)
+            {
+                dst[j] = src[j];
+            }
+
+            // nodes sharing a mesh but not the target material can not be drawn in one go
+            const iMaterialPtr targetMaterial = nodeMesh->getMaterial();
+            iInstaningPackage &package = packages[std::make_pair(mesh, targetMaterial)];
+            if (package._buffer == nullptr)
+            {
+                package._buffer = iInstancingBuffer::create(std::vector<iBufferLayoutEntry>{{iShaderDataType::Matrix4x4}}, end - begin);
+                package._targetMaterial = targetMaterial;
+            }
+
+            package._buffer->addInstance(sizeof(iaMatrixf), dst.getData());
+            package._used = true;
+        }
+
+        for (const auto &pair : packages)
+        {
+            if (pair.second._used)
+            {
+                iRenderer::getInstance().drawMeshInstanced(pair.first.first, pair.second._buffer, pair.second._targetMaterial);
+                pair.second._buffer->clear();
+            }
+        }
+    }
+
 } // namespace igor
\ No newline at end of file
@@ -36,9 +36,11 @@
 #include <igor/resources/mesh/iMesh.h>
 #include <igor/scene/nodes/iNodeCamera.h>
 #include <igor/renderer/buffers/iInstancingBuffer.h>
+#include <igor/renderer/iRenderQueue.h>
 
 #include <vector>
 #include <unordered_map>
+#include <map>
 
 namespace igor
 {
@@ -143,28 +145,19 @@ namespace igor
         {
             iInstancingBufferPtr _buffer;
             iMaterialPtr _targetMaterial;
-        };
-
-        /*! bringing all nodes using the same material together for more efficient rendering
-        */
-        struct iMaterialGroup
-        {
-            /*! the material used
-            */
-            iShaderMaterialPtr _material;
-
-            /*! the nodes rendered with this material
-            */
-            std::vector<iNodeRenderPtr> _renderNodes;
 
-            /*! optional instancing buffers per mesh that is using the same material
+            /*! if false the package was not used in the last frame
             */
-            std::unordered_map<iMeshPtr, iInstaningPackage> _instancing;
+            bool _used = false;
         };
 
-        /*! render nodes
-         */
-        std::vector<iMaterialGroup> _materialGroups;    
+        /*! optional instancing buffers per shader material, mesh and target material
+        */
+        std::unordered_map<iShaderMaterialPtr, std::map<std::pair<iMeshPtr, iMaterialPtr>, iInstaningPackage>> _instancing;
+
+        /*! all visible render nodes sorted by render order, shader material, mesh and texture
+        */
+        iRenderQueue<iNodeRenderPtr> _renderQueue;
 
         /*! cull scene relative to specified camera
 
@@ -172,21 +165,23 @@ namespace igor
         */
         void cullScene(iNodeCameraPtr camera);
 
-        /*! updates material groups
+        /*! submits all visible nodes to the render queue
          */
-        void updateMaterialGroups();
+        void updateRenderQueue();
 
-        /*! adds node to material groups
+        /*! submits node to render queue if it can be rendered
 
         \param renderNode the node to add
         */
-        void addNodeToMaterialGroups(iNodeRenderPtr renderNode);
+        void addToRenderQueue(iNodeRenderPtr renderNode);
 
-        /*! adds node to corresponding material group
+        /*! draws nodes of render queue from begin to end with given shader material using instancing
 
-        \param renderNode the node to add
+        \param shaderMaterial the shader material all given nodes use
+        \param begin index of first node
+        \param end index after last node
         */
-        void addToMaterialGroup(const iNodeRenderPtr renderNode);
+        void drawInstanced(const iShaderMaterialPtr &shaderMaterial, uint32 begin, uint32 end);
 
         /*! draw scene relative to specified camera
 
@@ -0,0 +1,324 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_RENDERQUEUE__
+#define __IGOR_RENDERQUEUE__
+
+#include <igor/iDefines.h>
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+namespace igor
+{
+
+    /*! compact key to sort render items by
+
+    from most to least significant bits: order (9 bits), shader material (15 bits), mesh (20 bits), texture (20 bits)
+    */
+    typedef uint64 iRenderSortKey;
+
+    /*! creates render sort keys by mapping resources to compact ids
+
+    ids are reference counted. every key made has to be released with the same resources once it is no longer used
+    so the ids of resources that are gone can be reused
+    */
+    class IGOR_API_EXPORT_ONLY iRenderSortKeyGenerator
+    {
+    public:
+        /*! \returns sort key for given render order and resources
+
+        resources are only used to identify them. nullptr is a valid value
+
+        \param order the render order
+        \param shaderMaterial the shader material
+        \param mesh the mesh
+        \param texture the texture
+        */
+        iRenderSortKey makeKey(int32 order, const void *shaderMaterial, const void *mesh, const void *texture);
+
+        /*! releases the ids of a key made with given resources
+
+        \param shaderMaterial the shader material
+        \param mesh the mesh
+        \param texture the texture
+        */
+        void release(const void *shaderMaterial, const void *mesh, const void *texture);
+
+        /*! \returns amount of ids in use
+        */
+        uint32 getIDCount() const;
+
+        /*! clears all ids
+        */
+        void clear();
+
+    private:
+        /*! id of a resource and how many keys use it
+        */
+        struct ID
+        {
+            /*! the id
+            */
+            uint32 _id;
+
+            /*! reference counter
+            */
+            uint32 _references;
+        };
+
+        /*! ids of one kind of resources
+        */
+        struct IDTable
+        {
+            /*! ids by resource
+            */
+            std::unordered_map<const void *, ID> _ids;
+
+            /*! released ids
+            */
+            std::vector<uint32> _freeIDs;
+
+            /*! highest id handed out so far
+            */
+            uint32 _lastID = 0;
+        };
+
+        /*! ids of shader materials
+        */
+        IDTable _shaderMaterialIDs;
+
+        /*! ids of meshes
+        */
+        IDTable _meshIDs;
+
+        /*! ids of textures
+        */
+        IDTable _textureIDs;
+
+        /*! \returns id of given resource and increases its reference counter. creates one if there is none yet
+
+        \param table the id table to use
+        \param resource the resource
+        */
+        uint32 acquireID(IDTable &table, const void *resource);
+
+        /*! decreases reference counter of given resource and frees its id once unused
+
+        \param table the id table to use
+        \param resource the resource
+        */
+        void releaseID(IDTable &table, const void *resource);
+    };
+
+    /*! persistent render queue that keeps its items sorted by render sort key
+
+    every frame all visible items get submitted between beginFrame and endFrame. items that where not submitted
+    get removed, new items and items with changed keys get merged in. only if a big part of the queue is new or changed
+    the whole queue gets sorted again
+
+    items are expected to be submitted in roughly the same sequence every frame. as long as they are, finding an
+    item costs a single compare instead of a hash lookup
+    */
+    template <typename T>
+    class IGOR_API_EXPORT_ONLY iRenderQueue
+    {
+    public:
+        /*! starts collecting the items of a new frame
+        */
+        void beginFrame();
+
+        /*! submits item for current frame
+
+        submitting the same item twice within a frame has no effect. the sort key only gets generated again if one of
+        the parameters changed
+
+        \param item the item to submit
+        \param order the render order
+        \param shaderMaterial the shader material
+        \param mesh the mesh
+        \param texture the texture
+        */
+        void submit(const T &item, int32 order, const void *shaderMaterial, const void *mesh, const void *texture);
+
+        /*! removes items that where not submitted and sorts in the new and changed ones
+        */
+        void endFrame();
+
+        /*! \returns amount of items in queue
+        */
+        uint32 size() const;
+
+        /*! \returns item at given index in sort order
+
+        \param index the given index
+        */
+        const T &getItem(uint32 index) const;
+
+        /*! \returns sort key at given index in sort order
+
+        \param index the given index
+        */
+        iRenderSortKey getKey(uint32 index) const;
+
+        /*! \returns the key generator
+        */
+        const iRenderSortKeyGenerator &getKeyGenerator() const;
+
+        /*! \returns how often the whole queue was sorted
+        */
+        uint64 getFullSortCount() const;
+
+        /*! removes all items
+        */
+        void clear();
+
+    private:
+        /*! if more than one in this many entries are new or changed the whole queue gets sorted instead of merging them in
+        */
+        static constexpr uint32 FULL_SORT_RATIO = 4;
+
+        /*! storage of an item
+        */
+        struct Slot
+        {
+            /*! the item
+            */
+            T _item;
+
+            /*! sort key of item
+            */
+            iRenderSortKey _key = 0;
+
+            /*! position in submit sequence of the frame the item was last submitted
+            */
+            uint32 _sequence = 0;
+
+            /*! render order the key was made with
+            */
+            int32 _order = 0;
+
+            /*! shader material the key was made with
+            */
+            const void *_shaderMaterial = nullptr;
+
+            /*! mesh the key was made with
+            */
+            const void *_mesh = nullptr;
+
+            /*! texture the key was made with
+            */
+            const void *_texture = nullptr;
+        };
+
+        /*! entry of the sorted queue
+
+        carries copies of key and item so iterating and sorting the queue does not need to touch the slots
+        */
+        struct Entry
+        {
+            /*! sort key of item
+            */
+            iRenderSortKey _key;
+
+            /*! the item
+            */
+            T _item;
+
+            /*! slot of item
+            */
+            uint32 _slot;
+        };
+
+        /*! generates the sort keys
+        */
+        iRenderSortKeyGenerator _keyGenerator;
+
+        /*! all slots. slots don't move so their index stays valid
+        */
+        std::vector<Slot> _slots;
+
+        /*! frame every slot was last submitted. kept separate from the slots so finding removed items stays cache friendly
+        */
+        std::vector<uint32> _slotFrames;
+
+        /*! unused slots
+        */
+        std::vector<uint32> _freeSlots;
+
+        /*! slot per item
+        */
+        std::unordered_map<T, uint32> _lookup;
+
+        /*! entries in sort order
+        */
+        std::vector<Entry> _order;
+
+        /*! entries added in current frame
+        */
+        std::vector<Entry> _added;
+
+        /*! slots in sequence they where submitted this frame
+        */
+        std::vector<uint32> _sequence;
+
+        /*! slots in sequence they where submitted last frame
+        */
+        std::vector<uint32> _previousSequence;
+
+        /*! position in previous sequence where the next submitted item is expected
+        */
+        uint32 _cursor = 0;
+
+        /*! current frame
+        */
+        uint32 _frame = 0;
+
+        /*! amount of items in _order that got submitted this frame
+        */
+        uint32 _touched = 0;
+
+        /*! amount of items in _order whose key changed this frame
+        */
+        uint32 _changed = 0;
+
+        /*! full sort counter
+        */
+        uint64 _fullSortCount = 0;
+
+        /*! \returns true if entry a goes before entry b
+        */
+        static bool compare(const Entry &a, const Entry &b);
+    };
+
+#include <igor/renderer/iRenderQueue.inl>
+
+} // namespace igor
+
+#endif // __IGOR_RENDERQUEUE__
@@ -0,0 +1,314 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+inline uint32 iRenderSortKeyGenerator::acquireID(IDTable &table, const void *resource)
+{
+    if (resource == nullptr)
+    {
+        return 0;
+    }
+
+    auto iter = table._ids.find(resource);
+    if (iter != table._ids.end())
+    {
+        iter->second._references++;
+        return iter->second._id;
+    }
+
+    uint32 id = 0;
+    if (!table._freeIDs.empty())
+    {
+        id = table._freeIDs.back();
+        table._freeIDs.pop_back();
+    }
+    else
+    {
+        id = ++table._lastID;
+    }
+
+    table._ids[resource] = {id, 1};
+    return id;
+}
+
+inline void iRenderSortKeyGenerator::releaseID(IDTable &table, const void *resource)
+{
+    if (resource == nullptr)
+    {
+        return;
+    }
+
+    auto iter = table._ids.find(resource);
+    if (iter == table._ids.end())
+    {
+        return;
+    }
+
+    if (--iter->second._references == 0)
+    {
+        table._freeIDs.push_back(iter->second._id);
+        table._ids.erase(iter);
+    }
+}
+
+inline iRenderSortKey iRenderSortKeyGenerator::makeKey(int32 order, const void *shaderMaterial, const void *mesh, const void *texture)
+{
+    // ids that don't fit only lead to less optimal batching but never to wrong results
+    const uint64 orderBits = static_cast<uint64>(std::clamp(order, 0, 0x1ff));
+    const uint64 shaderMaterialBits = acquireID(_shaderMaterialIDs, shaderMaterial) & 0x7fff;
+    const uint64 meshBits = acquireID(_meshIDs, mesh) & 0xfffff;
+    const uint64 textureBits = acquireID(_textureIDs, texture) & 0xfffff;
+
+    return (orderBits << 55) | (shaderMaterialBits << 40) | (meshBits << 20) | textureBits;
+}
+
+inline void iRenderSortKeyGenerator::release(const void *shaderMaterial, const void *mesh, const void *texture)
+{
+    releaseID(_shaderMaterialIDs, shaderMaterial);
+    releaseID(_meshIDs, mesh);
+    releaseID(_textureIDs, texture);
+}
+
+inline uint32 iRenderSortKeyGenerator::getIDCount() const
+{
+    return static_cast<uint32>(_shaderMaterialIDs._ids.size() + _meshIDs._ids.size() + _textureIDs._ids.size());
+}
+
+inline void iRenderSortKeyGenerator::clear()
+{
+    _shaderMaterialIDs = IDTable();
+    _meshIDs = IDTable();
+    _textureIDs = IDTable();
+}
+
+template <typename T>
+void iRenderQueue<T>::beginFrame()
+{
+    _frame++;
+    _touched = 0;
+    _cursor = 0;
+    std::swap(_sequence, _previousSequence);
+    _sequence.clear();
+}
+
+template <typename T>
+void iRenderQueue<T>::submit(const T &item, int32 order, const void *shaderMaterial, const void *mesh, const void *texture)
+{
+    uint32 slotIndex = 0;
+    bool found = false;
+
+    if (_cursor < _previousSequence.size() &&
+        _slots[_previousSequence[_cursor]]._item == item)
+    {
+        slotIndex = _previousSequence[_cursor];
+        found = true;
+    }
+    else
+    {
+        auto iter = _lookup.find(item);
+        if (iter != _lookup.end())
+        {
+            slotIndex = iter->second;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        if (_slotFrames[slotIndex] == _frame)
+        {
+            return;
+        }
+
+        Slot &slot = _slots[slotIndex];
+        _cursor = slot._sequence + 1;
+
+        _slotFrames[slotIndex] = _frame;
+        slot._sequence = static_cast<uint32>(_sequence.size());
+        _sequence.push_back(slotIndex);
+        _touched++;
+
+        if (slot._order != order ||
+            slot._shaderMaterial != shaderMaterial ||
+            slot._mesh != mesh ||
+            slot._texture != texture)
+        {
+            const iRenderSortKey key = _keyGenerator.makeKey(order, shaderMaterial, mesh, texture);
+            _keyGenerator.release(slot._shaderMaterial, slot._mesh, slot._texture);
+
+            slot._order = order;
+            slot._shaderMaterial = shaderMaterial;
+            slot._mesh = mesh;
+            slot._texture = texture;
+
+            if (slot._key != key)
+            {
+                slot._key = key;
+                _changed++;
+            }
+        }
+
+        return;
+    }
+
+    if (!_freeSlots.empty())
+    {
+        slotIndex = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<uint32>(_slots.size());
+        _slots.emplace_back();
+        _slotFrames.push_back(0);
+    }
+
+    Slot &slot = _slots[slotIndex];
+    slot._item = item;
+    slot._key = _keyGenerator.makeKey(order, shaderMaterial, mesh, texture);
+    slot._sequence = static_cast<uint32>(_sequence.size());
+    slot._order = order;
+    slot._shaderMaterial = shaderMaterial;
+    slot._mesh = mesh;
+    slot._texture = texture;
+    _slotFrames[slotIndex] = _frame;
+
+    _sequence.push_back(slotIndex);
+    _lookup[item] = slotIndex;
+    _added.push_back({slot._key, item, slotIndex});
+}
+
+template <typename T>
+bool iRenderQueue<T>::compare(const Entry &a, const Entry &b)
+{
+    if (a._key != b._key)
+    {
+        return a._key < b._key;
+    }
+
+    return a._slot < b._slot;
+}
+
+template <typename T>
+void iRenderQueue<T>::endFrame()
+{
+    // with many new or changed entries sorting everything is cheaper than merging them in
+    const bool fullSort = _changed + _added.size() > _order.size() / FULL_SORT_RATIO;
+
+    // remove what was not submitted this frame and take out entries with changed keys to merge them in again
+    const bool takeOutChanged = _changed != 0 && !fullSort;
+    if (_touched != _order.size() ||
+        takeOutChanged)
+    {
+        auto end = std::remove_if(_order.begin(), _order.end(), [this, takeOutChanged](const Entry &entry)
+                                  {
+                                      if (_slotFrames[entry._slot] == _frame)
+                                      {
+                                          if (!takeOutChanged ||
+                                              entry._key == _slots[entry._slot]._key)
+                                          {
+                                              return false;
+                                          }
+
+                                          _added.push_back({_slots[entry._slot]._key, entry._item, entry._slot});
+                                          return true;
+                                      }
+
+                                      Slot &slot = _slots[entry._slot];
+                                      _keyGenerator.release(slot._shaderMaterial, slot._mesh, slot._texture);
+                                      slot = Slot();
+
+                                      _lookup.erase(entry._item);
+                                      _freeSlots.push_back(entry._slot);
+                                      return true; });
+        _order.erase(end, _order.end());
+    }
+
+    if (fullSort)
+    {
+        if (_changed != 0)
+        {
+            for (auto &entry : _order)
+            {
+                entry._key = _slots[entry._slot]._key;
+            }
+        }
+
+        _order.insert(_order.end(), _added.begin(), _added.end());
+        std::sort(_order.begin(), _order.end(), compare);
+        _fullSortCount++;
+    }
+    else if (!_added.empty())
+    {
+        std::sort(_added.begin(), _added.end(), compare);
+
+        // merge from the back so everything in front of the first new entry stays untouched
+        int64 orderIndex = static_cast<int64>(_order.size()) - 1;
+        int64 addedIndex = static_cast<int64>(_added.size()) - 1;
+        int64 target = static_cast<int64>(_order.size() + _added.size()) - 1;
+        _order.resize(_order.size() + _added.size());
+
+        while (addedIndex >= 0)
+        {
+            if (orderIndex >= 0 &&
+                compare(_added[addedIndex], _order[orderIndex]))
+            {
+                _order[target--] = _order[orderIndex--];
+            }
+            else
+            {
+                _order[target--] = _added[addedIndex--];
+            }
+        }
+    }
+
+    _added.clear();
+    _changed = 0;
+}
+
+template <typename T>
+uint32 iRenderQueue<T>::size() const
+{
+    return static_cast<uint32>(_order.size());
+}
+
+template <typename T>
+const T &iRenderQueue<T>::getItem(uint32 index) const
+{
+    return _order[index]._item;
+}
+
+template <typename T>
+iRenderSortKey iRenderQueue<T>::getKey(uint32 index) const
+{
+    return _order[index]._key;
+}
+
+template <typename T>
+const iRenderSortKeyGenerator &iRenderQueue<T>::getKeyGenerator() const
+{
+    return _keyGenerator;
+}
+
+template <typename T>
+uint64 iRenderQueue<T>::getFullSortCount() const
+{
+    return _fullSortCount;
+}
+
+template <typename T>
+void iRenderQueue<T>::clear()
+{
+    _slots.clear();
+    _slotFrames.clear();
+    _freeSlots.clear();
+    _lookup.clear();
+    _order.clear();
+    _added.clear();
+    _sequence.clear();
+    _previousSequence.clear();
+    _keyGenerator.clear();
+    _cursor = 0;
+    _touched = 0;
+    _changed = 0;
+}
@@ -778,6 +778,68 @@ namespace igor
         endTexturedQuad();
     }
 
+    void iRenderer::drawSpriteInstances(const iTexturePtr &texture, const iSpriteInstance *instances, uint32 count, bool blend)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (!blend)
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if (instances[i]._color._a != 1.0)
+                {
+                    blend = true;
+                    break;
+                }
+            }
+        }
+
+        blend ? setShaderMaterial(_data->_textureShaderBlend) : setShaderMaterial(_data->_textureShader);
+
+        auto &texQuads = _data->_texQuads;
+        int32 textureIndex = beginTexturedQuad(texture);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // only look up the texture again if the buffer got flushed
+            if (texQuads._vertexCount >= MAX_QUAD_VERTICES)
+            {
+                textureIndex = beginTexturedQuad(texture);
+            }
+
+            const iSpriteInstance &instance = instances[i];
+
+            texQuads._vertexDataPtr->_pos = instance._matrix * QUAD_VERTEX_POSITIONS[0];
+            texQuads._vertexDataPtr->_color = instance._color;
+            texQuads._vertexDataPtr->_texCoord0 = instance._texRect.getTopLeft();
+            texQuads._vertexDataPtr->_texIndex0 = textureIndex;
+            texQuads._vertexDataPtr++;
+
+            texQuads._vertexDataPtr->_pos = instance._matrix * QUAD_VERTEX_POSITIONS[1];
+            texQuads._vertexDataPtr->_color = instance._color;
+            texQuads._vertexDataPtr->_texCoord0 = instance._texRect.getBottomLeft();
+            texQuads._vertexDataPtr->_texIndex0 = textureIndex;
+            texQuads._vertexDataPtr++;
+
+            texQuads._vertexDataPtr->_pos = instance._matrix * QUAD_VERTEX_POSITIONS[2];
+            texQuads._vertexDataPtr->_color = instance._color;
+            texQuads._vertexDataPtr->_texCoord0 = instance._texRect.getBottomRight();
+            texQuads._vertexDataPtr->_texIndex0 = textureIndex;
+            texQuads._vertexDataPtr++;
+
+            texQuads._vertexDataPtr->_pos = instance._matrix * QUAD_VERTEX_POSITIONS[3];
+            texQuads._vertexDataPtr->_color = instance._color;
+            texQuads._vertexDataPtr->_texCoord0 = instance._texRect.getTopRight();
+            texQuads._vertexDataPtr->_texIndex0 = textureIndex;
+            texQuads._vertexDataPtr++;
+
+            endTexturedQuad();
+        }
+    }
+
     void iRenderer::drawPointInternal(const iaVector3f &v, const iaColor4f &color)
     {
         auto &points = _data->_points;
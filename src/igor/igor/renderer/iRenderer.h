@@ -53,6 +53,23 @@ namespace igor
 
     class iRendererData;
 
+    /*! one sprite frame to draw with drawSpriteInstances
+     */
+    struct IGOR_API iSpriteInstance
+    {
+        /*! matrix to position the frame. already scaled by the size of the sprite
+         */
+        iaMatrixf _matrix;
+
+        /*! area of the frame in texture coordinates
+         */
+        iaRectanglef _texRect;
+
+        /*! color to draw with
+         */
+        iaColor4f _color;
+    };
+
     /*! renderer interface
      */
     class IGOR_API iRenderer : public iModule<iRenderer>
@@ -402,6 +419,17 @@ namespace igor
         template <typename T>
         void drawSprite(const iaMatrix<T> &matrix, const iSpritePtr &sprite, uint32 frameIndex = 0, const iaVector2<T> &size = iaVector2<T>(1.0f, 1.0f), const iaColor4f &color = iaColor4f::white, bool blend = false);
 
+        /*! draws many sprite frames using the same texture
+
+        the texture is looked up once for all instances instead of once per sprite
+
+        \param texture the texture all instances use
+        \param instances the instances to draw
+        \param count the amount of instances
+        \param blend if true blending is used to draw the instances
+        */
+        void drawSpriteInstances(const iTexturePtr &texture, const iSpriteInstance *instances, uint32 count, bool blend = false);
+
         /*! draw string
 
         \param x horizontal position
@@ -21,6 +21,8 @@ namespace igor
         set("maxPhysicsThreads", "Max");
         set("minThreads", "0");
         set("maxThreads", "0");
+        set("threadIdlePolicy", "SpinThenPark");
+        set("threadSpinTime", "50");
         set("loadMode", "App");
         set("searchPaths", {"../../../data", "../../data", "../data", "data"}); // TODO finish #396
     }
@@ -58,6 +60,9 @@ namespace igor
         stream << "        <!-- only useful if there is no render context -->\n";
         stream << "        <Setting name=\"minThreads\" value=\"" << getValue("minThreads") << "\" />\n";
         stream << "        <Setting name=\"maxThreads\" value=\"" << getValue("maxThreads") << "\" />\n";
+        stream << "        <!-- what idle threads do while waiting for tasks. threadIdlePolicy: Spin, Park, SpinThenPark (default). threadSpinTime: spin time in microseconds before parking -->\n";
+        stream << "        <Setting name=\"threadIdlePolicy\" value=\"" << getValue("threadIdlePolicy") << "\" />\n";
+        stream << "        <Setting name=\"threadSpinTime\" value=\"" << getValue("threadSpinTime") << "\" />\n";
 
         stream << "        <!-- load mode of resource manager. loadMode: App (application decides), Sync (all synchronous) -->\n";
         stream << "        <Setting name=\"loadMode\" value=\"" << getValue("loadMode") << "\" />\n";
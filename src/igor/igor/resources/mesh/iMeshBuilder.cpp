@@ -421,17 +421,18 @@ namespace igor
             return;
         }
 
-        const uint32 indexCount = _triangles.size() * 3;
-        uint32 *indexBufferData = new uint32[indexCount];
-
+        const uint32 indexCount = static_cast<uint32>(triangles.size() * 3);
         const uint32 vertexSize = (3 + (hasNormals() ? 3 : 0) + (hasColors() ? 4 : 0) + (getTextureUnitCount() * 2)) * sizeof(float32);
         const uint32 vertexCountTotal = _vertexes.size();
-        const uint32 vertexBufferSizeTotal = vertexCountTotal * vertexSize;
+
+        // scratch buffers keep their capacity so a builder that gets reused does not allocate again
+        _indexScratch.resize(indexCount);
         // allocating potentially too much on purpose to have space for all filter scenarios
-        float32 *vertexBufferData = new float32[vertexBufferSizeTotal / sizeof(float32)];
+        _vertexScratch.resize(vertexCountTotal * vertexSize / sizeof(float32));
+        _vertexRemap.assign(vertexCountTotal, INVALID_VERTEX_INDEX);
 
-        std::map<uint32, uint32> indexMap;
-        std::map<uint32, uint32>::iterator foundIndex;
+        uint32 *indexBufferData = _indexScratch.data();
+        float32 *vertexBufferData = _vertexScratch.data();
 
         uint32 indexDataIndex = 0;
         uint32 vertexDataIndex = 0;
@@ -451,16 +452,15 @@ namespace igor
             {
                 oldVertexIndex = oldIndex[i];
 
-                foundIndex = indexMap.find(oldVertexIndex);
-                if (foundIndex != indexMap.end())
+                if (_vertexRemap[oldVertexIndex] != INVALID_VERTEX_INDEX)
                 {
-                    newVertexIndex = (*foundIndex).second;
+                    newVertexIndex = _vertexRemap[oldVertexIndex];
                     indexBufferData[indexDataIndex++] = newVertexIndex;
                 }
                 else
                 {
                     newVertexIndex = nextNewVertexIndex++;
-                    indexMap[oldVertexIndex] = newVertexIndex;
+                    _vertexRemap[oldVertexIndex] = newVertexIndex;
                     indexBufferData[indexDataIndex++] = newVertexIndex;
 
                     vertexBufferData[vertexDataIndex++] = _vertexes[oldVertexIndex]._x;
@@ -491,14 +491,11 @@ namespace igor
             }
         }
 
-        const uint32 vertexCount = vertexDataIndex;
+        const uint32 vertexCount = nextNewVertexIndex;
         const uint32 vertexBufferSize = vertexCount * vertexSize;
 
         mesh->setData(indexBufferData, indexCount * sizeof(uint32), vertexBufferData, vertexBufferSize, generateLayout());
 
-        delete[] indexBufferData;
-        delete[] vertexBufferData;
-
         mesh->setTrianglesCount(static_cast<uint32>(triangles.size()));
         mesh->setIndexCount(static_cast<uint32>(triangles.size() * 3));
         mesh->setVertexCount(vertexCount);
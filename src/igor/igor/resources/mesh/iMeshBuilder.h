@@ -323,6 +323,22 @@ namespace igor
         */
         iaMatrixf _matrix;
 
+        /*! marks vertices not yet remapped in _vertexRemap
+        */
+        static constexpr uint32 INVALID_VERTEX_INDEX = 0xffffffff;
+
+        /*! scratch buffer for index data while compiling a filtered mesh
+        */
+        std::vector<uint32> _indexScratch;
+
+        /*! scratch buffer for vertex data while compiling a filtered mesh
+        */
+        std::vector<float32> _vertexScratch;
+
+        /*! scratch buffer for remapping vertex indices while compiling a filtered mesh
+        */
+        std::vector<uint32> _vertexRemap;
+
         /*! actually adds the vertex to internal structures
 
         \param vertex the vertex to add
@@ -4,20 +4,209 @@
 
 #include <igor/resources/profiler/iProfiler.h>
 
-#include <cstring>
+#include <iaux/system/iaConsole.h>
+#include <iaux/system/iaClock.h>
+
+#include <atomic>
+#include <fstream>
 #include <algorithm>
 
 namespace igor
 {
-    
+    /*! a section that has begun but not ended yet
+     */
+    struct iProfilerOpenSection
+    {
+        /*! id of section
+         */
+        iProfilerSectionID _sectionID;
+
+        /*! name of section
+         */
+        const char *_name;
+
+        /*! begin of section in microseconds
+         */
+        int64 _beginTime;
+    };
+
+    /*! single producer single consumer ring buffer of finished sections
+
+    only the owning thread writes, only nextFrame reads
+    */
+    struct iProfilerThreadBuffer
+    {
+        /*! the recorded events
+         */
+        std::array<iProfilerEvent, PROFILER_THREAD_BUFFER_SIZE> _events;
+
+        /*! next position to write to
+         */
+        std::atomic<uint64> _writeIndex = 0;
+
+        /*! next position to read from
+         */
+        std::atomic<uint64> _readIndex = 0;
+
+        /*! amount of events dropped because the buffer was full
+         */
+        std::atomic<uint64> _droppedCount = 0;
+
+        /*! stack of open sections
+         */
+        std::array<iProfilerOpenSection, PROFILER_MAX_DEPTH> _openSections;
+
+        /*! current nesting depth
+         */
+        uint32 _depth = 0;
+
+        /*! index of thread
+         */
+        uint32 _threadIndex = 0;
+    };
+
+    /*! buffer of the current thread
+     */
+    static thread_local iProfilerThreadBuffer *_threadBuffer = nullptr;
+
     int32 iProfiler::_frame = 0;
+    uint32 iProfiler::_frameThreadIndex = 0;
     std::array<iaTime, PROFILER_MAX_FRAMES_COUNT> iProfiler::_frameTime;
-    std::unordered_map<int64, iProfilerSectionDataPtr> iProfiler::_sections;
+    std::array<int64, PROFILER_MAX_FRAMES_COUNT> iProfiler::_frameBeginTime;
+    std::array<std::vector<iProfilerEvent>, PROFILER_MAX_FRAMES_COUNT> iProfiler::_frameEvents;
+    std::unordered_map<iProfilerSectionID, iProfilerSectionDataPtr> iProfiler::_sections;
+    std::vector<iProfilerThreadBuffer *> iProfiler::_threadBuffers;
+    iaMutex iProfiler::_mutexThreadBuffers;
+
+    iProfilerThreadBuffer *iProfiler::getThreadBuffer()
+    {
+        if (_threadBuffer == nullptr)
+        {
+            // buffers are never released so events of threads that already ended can still be merged
+            _threadBuffer = new iProfilerThreadBuffer();
+
+            _mutexThreadBuffers.lock();
+            _threadBuffer->_threadIndex = static_cast<uint32>(_threadBuffers.size());
+            _threadBuffers.push_back(_threadBuffer);
+            _mutexThreadBuffers.unlock();
+        }
+
+        return _threadBuffer;
+    }
+
+    void iProfiler::beginSection(iProfilerSectionID sectionID, const char *sectionName)
+    {
+        iProfilerThreadBuffer *buffer = getThreadBuffer();
+
+        if (buffer->_depth < PROFILER_MAX_DEPTH)
+        {
+            buffer->_openSections[buffer->_depth] = {sectionID, sectionName, iaClock::getTimeMicroseconds()};
+        }
+
+        buffer->_depth++;
+    }
+
+    void iProfiler::endSection(iProfilerSectionID sectionID)
+    {
+        const int64 now = iaClock::getTimeMicroseconds();
+        iProfilerThreadBuffer *buffer = getThreadBuffer();
+
+        if (buffer->_depth == 0)
+        {
+            con_err("section ended that never began");
+            return;
+        }
+
+        buffer->_depth--;
+
+        // too deep to be recorded
+        if (buffer->_depth >= PROFILER_MAX_DEPTH)
+        {
+            return;
+        }
+
+        const iProfilerOpenSection &openSection = buffer->_openSections[buffer->_depth];
+        con_assert(openSection._sectionID == sectionID, "section \"" << openSection._name << "\" is not the innermost open section");
+
+        const uint64 writeIndex = buffer->_writeIndex.load(std::memory_order_relaxed);
+        if (writeIndex - buffer->_readIndex.load(std::memory_order_acquire) >= PROFILER_THREAD_BUFFER_SIZE)
+        {
+            buffer->_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        iProfilerEvent &event = buffer->_events[writeIndex % PROFILER_THREAD_BUFFER_SIZE];
+        event._name = openSection._name;
+        event._sectionID = openSection._sectionID;
+        event._threadIndex = buffer->_threadIndex;
+        event._depth = buffer->_depth;
+        event._beginTime = openSection._beginTime;
+        event._duration = now - openSection._beginTime;
+
+        buffer->_writeIndex.store(writeIndex + 1, std::memory_order_release);
+    }
+
+    void iProfiler::mergeEvent(const iProfilerEvent &event)
+    {
+        iProfilerSectionDataPtr sectionData;
+
+        auto iter = _sections.find(event._sectionID);
+        if (iter == _sections.end())
+        {
+            sectionData = std::make_shared<iProfilerSectionData>();
+            sectionData->_name = event._name;
+            _sections[event._sectionID] = sectionData;
+        }
+        else
+        {
+            sectionData = iter->second;
+        }
+
+        const iaTime duration = iaTime::fromMicroseconds(event._duration);
+
+        sectionData->_values[_frame] += duration;
+        sectionData->_beginTime = iaTime::fromMicroseconds(event._beginTime);
+        sectionData->_threadIndex = event._threadIndex;
+        sectionData->_depth = event._depth;
+
+        // only top level sections of the frame thread add up to the frame time
+        if (event._threadIndex == _frameThreadIndex &&
+            event._depth == 0)
+        {
+            _frameTime[_frame] += duration;
+        }
+
+        _frameEvents[_frame].push_back(event);
+    }
 
     void iProfiler::nextFrame()
     {
+        _frameThreadIndex = getThreadBuffer()->_threadIndex;
+
+        _mutexThreadBuffers.lock();
+        for (auto buffer : _threadBuffers)
+        {
+            const uint64 writeIndex = buffer->_writeIndex.load(std::memory_order_acquire);
+            uint64 readIndex = buffer->_readIndex.load(std::memory_order_relaxed);
+
+            for (; readIndex < writeIndex; ++readIndex)
+            {
+                mergeEvent(buffer->_events[readIndex % PROFILER_THREAD_BUFFER_SIZE]);
+            }
+
+            buffer->_readIndex.store(readIndex, std::memory_order_release);
+        }
+        _mutexThreadBuffers.unlock();
+
         _frame = (_frame + 1) % PROFILER_MAX_FRAMES_COUNT;
         _frameTime[_frame] = iaTime::fromMilliseconds(0);
+        _frameBeginTime[_frame] = iaClock::getTimeMicroseconds();
+        _frameEvents[_frame].clear();
+
+        for (const auto &pair : _sections)
+        {
+            pair.second->_values[_frame] = iaTime::fromMilliseconds(0);
+        }
     }
 
     const std::vector<iProfilerSectionDataPtr> iProfiler::getSections()
@@ -42,71 +231,120 @@ namespace igor
         return _frame;
     }
 
-    iProfilerSectionDataPtr iProfiler::getSectionData(const iaString &sectionName)
+    uint32 iProfiler::getFrameThreadIndex()
     {
-        iProfilerSectionDataPtr sectionData;
-        int64 hash = sectionName.getHashValue();
-        auto iter = _sections.find(hash);
+        return _frameThreadIndex;
+    }
+
+    iProfilerSectionDataPtr iProfiler::getSectionData(iProfilerSectionID sectionID)
+    {
+        auto iter = _sections.find(sectionID);
         if (iter == _sections.end())
         {
-            sectionData = iProfilerSectionDataPtr(new iProfilerSectionData());
-            sectionData->_name = sectionName;
-            memset(&sectionData->_values, 0, sizeof(iaTime) * PROFILER_MAX_FRAMES_COUNT);
-
-            _sections[hash] = sectionData;
+            return nullptr;
         }
-        else
+
+        return iter->second;
+    }
+
+    iaTime iProfiler::getPeakFrame()
+    {
+        iaTime result;
+
+        for(auto time : _frameTime)
         {
-            sectionData = iter->second;
+            if(time > result)
+            {
+                result = time;
+            }
         }
 
-        return sectionData;
+        return result;
     }
 
-    void iProfiler::beginSection(const iaString &sectionName)
+    uint64 iProfiler::getDroppedEventCount()
     {
-        iProfilerSectionDataPtr sectionData = getSectionData(sectionName);
+        uint64 result = 0;
+
+        _mutexThreadBuffers.lock();
+        for (auto buffer : _threadBuffers)
+        {
+            result += buffer->_droppedCount.load(std::memory_order_relaxed);
+        }
+        _mutexThreadBuffers.unlock();
 
-        sectionData->_values[_frame] = 0;
-        sectionData->_beginTime = iaTime::getNow();
+        return result;
     }
 
-    void iProfiler::endSection(const iaString &sectionName)
+    bool iProfiler::exportChromeTrace(const iaString &filename)
     {
-        iaTime now = iaTime::getNow();
+        char temp[2048];
+        filename.getData(temp, 2048);
 
-        iProfilerSectionDataPtr sectionData = getSectionData(sectionName);
+        std::ofstream stream;
+        stream.open(temp);
 
-        iaTime delta = now - sectionData->_beginTime;
+        if (!stream.is_open())
+        {
+            con_err("can't open to write \"" << temp << "\"");
+            return false;
+        }
 
-        sectionData->_values[_frame] += delta;
-        _frameTime[_frame] += delta;
-    }
+        _mutexThreadBuffers.lock();
+        const uint32 threadCount = static_cast<uint32>(_threadBuffers.size());
+        _mutexThreadBuffers.unlock();
 
-    iaTime iProfiler::getPeakFrame()
-    {
-        iaTime result;
+        stream << "{\"traceEvents\":[\n";
 
-        for(auto time : _frameTime)
+        for (uint32 threadIndex = 0; threadIndex < threadCount; ++threadIndex)
         {
-            if(time > result)
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadIndex << ",\"args\":{\"name\":\"";
+            if (threadIndex == _frameThreadIndex)
             {
-                result = time;
+                stream << "frame thread";
+            }
+            else
+            {
+                stream << "thread " << threadIndex;
             }
+            stream << "\"}},\n";
         }
 
-        return result;
+        // oldest frame first
+        for (int32 i = 1; i <= PROFILER_MAX_FRAMES_COUNT; ++i)
+        {
+            const int32 frame = (_frame + i) % PROFILER_MAX_FRAMES_COUNT;
+
+            if (_frameBeginTime[frame] != 0)
+            {
+                stream << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":" << _frameThreadIndex << ",\"ts\":" << _frameBeginTime[frame] << "},\n";
+            }
+
+            for (const auto &event : _frameEvents[frame])
+            {
+                stream << "{\"name\":\"" << event._name << "\",\"cat\":\"igor\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event._threadIndex
+                       << ",\"ts\":" << event._beginTime << ",\"dur\":" << event._duration << "},\n";
+            }
+        }
+
+        // closing element so we don't have to care about the last comma
+        stream << "{\"name\":\"end\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":" << _frameThreadIndex << ",\"ts\":" << iaClock::getTimeMicroseconds() << "}\n";
+        stream << "]}\n";
+
+        con_info("exported profiler trace to \"" << filename << "\"");
+
+        return true;
     }
 
-    iProfilerSectionScoped::iProfilerSectionScoped(const iaString &sectionName)
-    : _sectionName(sectionName)
+    iProfilerSectionScoped::iProfilerSectionScoped(iProfilerSectionID sectionID, const char *sectionName)
+        : _sectionID(sectionID)
     {
-        iProfiler::beginSection(_sectionName);
+        iProfiler::beginSection(sectionID, sectionName);
     }
 
     iProfilerSectionScoped::~iProfilerSectionScoped()
     {
-        iProfiler::endSection(_sectionName);
+        iProfiler::endSection(_sectionID);
     }
 
-} // namespace igor
\ No newline at end of file
+} // namespace igor
@@ -37,7 +37,9 @@ using namespace iaux;
 
 #include <unordered_map>
 #include <array>
+#include <vector>
 #include <memory>
+#include <type_traits>
 
 namespace igor
 {
@@ -45,6 +47,49 @@ namespace igor
         */
     #define PROFILER_MAX_FRAMES_COUNT 2000
 
+    /*! amount of events a thread can record between two merges before events get dropped
+     */
+    #define PROFILER_THREAD_BUFFER_SIZE 4096
+
+    /*! max nesting depth of sections per thread
+     */
+    #define PROFILER_MAX_DEPTH 64
+
+    /*! section id
+
+    calculated at compile time from the section name
+    */
+    typedef uint32 iProfilerSectionID;
+
+    /*! a finished section recorded by one of the threads
+     */
+    struct IGOR_API iProfilerEvent
+    {
+        /*! name of section (string literal)
+         */
+        const char *_name = nullptr;
+
+        /*! id of section
+         */
+        iProfilerSectionID _sectionID = 0;
+
+        /*! index of thread the section was recorded on
+         */
+        uint32 _threadIndex = 0;
+
+        /*! nesting depth of section
+         */
+        uint32 _depth = 0;
+
+        /*! begin of section in microseconds
+         */
+        int64 _beginTime = 0;
+
+        /*! duration of section in microseconds
+         */
+        int64 _duration = 0;
+    };
+
     struct IGOR_API iProfilerSectionData
     {
         /*! name of section
@@ -58,6 +103,14 @@ namespace igor
         /*! time at beginning of section
          */
         iaTime _beginTime;
+
+        /*! index of thread the section was last recorded on
+         */
+        uint32 _threadIndex = 0;
+
+        /*! nesting depth the section was last recorded with
+         */
+        uint32 _depth = 0;
     };
 
     typedef std::shared_ptr<iProfilerSectionData> iProfilerSectionDataPtr;
@@ -66,29 +119,57 @@ namespace igor
     {
         /*! begins measuring section
 
-        \param sectionName name of section
+        \param sectionID id of section
+        \param sectionName name of section (must be a string literal)
          */
-        iProfilerSectionScoped(const iaString &sectionName);
+        iProfilerSectionScoped(iProfilerSectionID sectionID, const char *sectionName);
 
         /*! stops measuring section
          */
         ~iProfilerSectionScoped();
 
     private:
-        /*! the section name
+        /*! the section id
          */
-        iaString _sectionName;
+        iProfilerSectionID _sectionID;
     };
 
-    /*! render statistics
+    /*! per thread event buffer
      */
+    struct iProfilerThreadBuffer;
+
+    /*! hierarchical profiler
+
+    Every thread records begin and end of sections in it's own lock free ring buffer. Once per frame nextFrame merges
+    those buffers in to the per section data used by the iProfilerVisualizer and in to a history of events that can
+    be exported as Chrome trace event JSON (chrome://tracing or https://ui.perfetto.dev).
+
+    nextFrame, getSections, getSectionData and exportChromeTrace must be called from the same thread
+    */
     class IGOR_API iProfiler
     {
 
         friend class iProfilerSectionScoped;
 
     public:
-        /*! steps to next frame
+        /*! \returns section id for given section name
+
+        \param sectionName the given section name
+        */
+        static constexpr iProfilerSectionID calcSectionID(const char *sectionName)
+        {
+            // FNV-1a
+            iProfilerSectionID result = 2166136261u;
+            while (*sectionName != 0)
+            {
+                result ^= static_cast<uint8>(*sectionName++);
+                result *= 16777619u;
+            }
+
+            return result;
+        }
+
+        /*! merges all recorded sections and steps to next frame
          */
         static void nextFrame();
 
@@ -102,47 +183,96 @@ namespace igor
          */
         static int32 getCurrentFrameIndex();
 
-        /*! \returns section data for given section name
+        /*! \returns index of the thread that calls nextFrame
+         */
+        static uint32 getFrameThreadIndex();
 
-        \param sectionName the given section name
+        /*! \returns section data for given section id or nullptr if it was never recorded
+
+        \param sectionID the given section id
         */
-        static iProfilerSectionDataPtr getSectionData(const iaString &sectionName);
+        static iProfilerSectionDataPtr getSectionData(iProfilerSectionID sectionID);
 
-        /*! begins section with given name
+        /*! begins section on the calling thread
 
-        \param sectionName the given name
-        \returns pointer to given section data
+        \param sectionID id of section
+        \param sectionName name of section (must be a string literal)
         */
-        static void beginSection(const iaString &sectionName);
+        static void beginSection(iProfilerSectionID sectionID, const char *sectionName);
 
-        /*! ends section with given name
+        /*! ends section on the calling thread
 
-        \param sectionName the given name
+        \param sectionID id of section
         */
-        static void endSection(const iaString &sectionName);
+        static void endSection(iProfilerSectionID sectionID);
 
         /*! \returns peak frame over collected data
         */
         static iaTime getPeakFrame();
 
+        /*! \returns amount of events dropped because a thread buffer was full
+         */
+        static uint64 getDroppedEventCount();
+
+        /*! exports the collected frames as Chrome trace event JSON
+
+        \param filename the file to write to
+        \returns true if successful
+        */
+        static bool exportChromeTrace(const iaString &filename);
+
     private:
         /*! current frame
          */
         static int32 _frame;
 
+        /*! index of thread that calls nextFrame
+         */
+        static uint32 _frameThreadIndex;
+
         /*! accumulated frame time
         */
         static std::array<iaTime, PROFILER_MAX_FRAMES_COUNT> _frameTime;
 
+        /*! begin of frames in microseconds
+         */
+        static std::array<int64, PROFILER_MAX_FRAMES_COUNT> _frameBeginTime;
+
+        /*! merged events per frame
+         */
+        static std::array<std::vector<iProfilerEvent>, PROFILER_MAX_FRAMES_COUNT> _frameEvents;
+
         /*! list of sections
          */
-        static std::unordered_map<int64, iProfilerSectionDataPtr> _sections;
+        static std::unordered_map<iProfilerSectionID, iProfilerSectionDataPtr> _sections;
+
+        /*! all thread buffers ever created
+         */
+        static std::vector<iProfilerThreadBuffer *> _threadBuffers;
+
+        /*! protects the list of thread buffers
+         */
+        static iaMutex _mutexThreadBuffers;
+
+        /*! \returns the calling thread's buffer
+         */
+        static iProfilerThreadBuffer *getThreadBuffer();
+
+        /*! merges given event in to section data and frame history
+
+        \param event the event to merge
+        */
+        static void mergeEvent(const iProfilerEvent &event);
     };
 
-#define IGOR_PROFILER_SCOPED(sectionName) iProfilerSectionScoped sectionName(#sectionName)
-#define IGOR_PROFILER_BEGIN(sectionName) iProfiler::beginSection(#sectionName)
-#define IGOR_PROFILER_END(sectionName) iProfiler::endSection(#sectionName)
+/*! \returns section id of given section name evaluated at compile time
+ */
+#define IGOR_PROFILER_SECTION_ID(sectionName) std::integral_constant<iProfilerSectionID, iProfiler::calcSectionID(#sectionName)>::value
+
+#define IGOR_PROFILER_SCOPED(sectionName) iProfilerSectionScoped sectionName(IGOR_PROFILER_SECTION_ID(sectionName), #sectionName)
+#define IGOR_PROFILER_BEGIN(sectionName) iProfiler::beginSection(IGOR_PROFILER_SECTION_ID(sectionName), #sectionName)
+#define IGOR_PROFILER_END(sectionName) iProfiler::endSection(IGOR_PROFILER_SECTION_ID(sectionName))
 
 } // namespace igor
 
-#endif // __IGOR_PROFILER__
\ No newline at end of file
+#endif // __IGOR_PROFILER__
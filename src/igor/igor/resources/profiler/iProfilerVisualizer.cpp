@@ -95,6 +95,7 @@ namespace igor
                 _lastRunningRenderContextTaskCount = iTaskManager::getInstance().getRunningRenderContextTaskCount();
 
                 _lastDoneTaskCount = iTaskManager::getInstance().getTaskDoneCount();
+                _lastWakeupCount = iTaskManager::getInstance().getWakeupCount();
             }
         }
 
@@ -129,7 +130,8 @@ namespace igor
             threads += iaString::toString(_lastRunningTaskCount + _lastRunningRenderContextTaskCount);
             threads += ":";
             threads += iaString::toString(_lastQueuedTaskCount + _lastQueuedRenderContextTaskCount);
-            threads += "]";
+            threads += "] wakeups:";
+            threads += iaString::toStringUnits(_lastWakeupCount);
 
             iRenderer::getInstance().drawString(10.0f, static_cast<float32>(window->getClientHeight() - 10), threads, iHorizontalAlignment::Left, iVerticalAlignment::Bottom, iaColor4f::magenta);
         }
@@ -145,7 +147,16 @@ namespace igor
             const int32 currentFrame = (iProfiler::getCurrentFrameIndex() + 1 - lineCount) % PROFILER_MAX_FRAMES_COUNT;
 
             memset(&_accumulationBuffer, 0, sizeof(float32) * PROFILER_MAX_FRAMES_COUNT);
-            const auto sections = iProfiler::getSections();
+            // sections of other threads and nested sections would not add up to the frame time
+            std::vector<iProfilerSectionDataPtr> sections;
+            for (const auto &section : iProfiler::getSections())
+            {
+                if (section->_threadIndex == iProfiler::getFrameThreadIndex() &&
+                    section->_depth == 0)
+                {
+                    sections.push_back(section);
+                }
+            }
 
             const float32 peakFrameTime = iProfiler::getPeakFrame().getMilliseconds();
             const float32 verticalScale = rect._height / (peakFrameTime + 5.0);
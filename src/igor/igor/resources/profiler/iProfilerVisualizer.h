@@ -122,6 +122,10 @@ namespace igor
          */
         uint64 _lastDoneTaskCount = 0;
 
+        /*! amount of times parked threads where woken up by now
+         */
+        uint64 _lastWakeupCount = 0;
+
         /*! amount of tasks in queue that need render context threads
          */
         uint32 _lastQueuedRenderContextTaskCount = 0;
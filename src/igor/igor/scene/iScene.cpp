@@ -216,6 +216,12 @@ namespace igor
         auto iter = find(_volumes.begin(), _volumes.end(), volume);
         if (iter != _volumes.end())
         {
+            // the volume might also be in the middle of getting updated
+            _mutexVolumeUpdateQueue.lock();
+            _volumeUpdateQueue.erase(std::remove(_volumeUpdateQueue.begin(), _volumeUpdateQueue.end(), volume), _volumeUpdateQueue.end());
+            _volumeUpdateProcessing.erase(std::remove(_volumeUpdateProcessing.begin(), _volumeUpdateProcessing.end(), volume), _volumeUpdateProcessing.end());
+            _mutexVolumeUpdateQueue.unlock();
+
             _mutexOctree.lock();
             _octree->remove(volume);
             _mutexOctree.unlock();
@@ -228,15 +234,37 @@ namespace igor
 
     void iScene::updateVolume(iNodeVolume *volume)
     {
-        iaSphered sphere;
-        sphere._center._x = volume->getCenter()._x;
-        sphere._center._y = volume->getCenter()._y;
-        sphere._center._z = volume->getCenter()._z;
-        sphere._radius = volume->getBoundingSphere()._radius;
+        _mutexVolumeUpdateQueue.lock();
+        _volumeUpdateQueue.push_back(volume);
+        _mutexVolumeUpdateQueue.unlock();
+    }
+
+    void iScene::applyVolumeUpdates()
+    {
+        // holding the queue lock while processing so unregistered volumes can't be processed any more
+        _mutexVolumeUpdateQueue.lock();
+        std::swap(_volumeUpdateQueue, _volumeUpdateProcessing);
+
+        if (_volumeUpdateProcessing.empty())
+        {
+            _mutexVolumeUpdateQueue.unlock();
+            return;
+        }
 
         _mutexOctree.lock();
-        _octree->update(volume, sphere);
+        for (auto volume : _volumeUpdateProcessing)
+        {
+            // a volume can be queued multiple times but the octree skips unchanged spheres
+            iaSphered sphere;
+            sphere._center = volume->getCenter();
+            sphere._radius = volume->getBoundingSphere()._radius;
+
+            _octree->updateExisting(volume, sphere);
+        }
         _mutexOctree.unlock();
+
+        _volumeUpdateProcessing.clear();
+        _mutexVolumeUpdateQueue.unlock();
     }
 
     void iScene::registerCamera(iNodeCamera *camera)
@@ -336,18 +364,22 @@ namespace igor
         }
     }
 
-    void iScene::getCullResult(std::vector<void *> &cullResult)
+    const std::vector<void *> &iScene::getCullResult() const
     {
-        _mutexOctree.lock();
-        cullResult = _octree->getResult();
-        _mutexOctree.unlock();
+        return _cullResults[_cullResultIndex.load(std::memory_order_acquire)];
     }
 
     void iScene::setFrustum(const iFrustumd &frustum)
     {
+        applyVolumeUpdates();
+
+        const uint32 backIndex = _cullResultIndex.load(std::memory_order_relaxed) ^ 1;
+
         _mutexOctree.lock();
-        _octree->filter(frustum);
+        _octree->filter(frustum, _cullResults[backIndex]);
         _mutexOctree.unlock();
+
+        _cullResultIndex.store(backIndex, std::memory_order_release);
     }
 
     void iScene::drawOctree()
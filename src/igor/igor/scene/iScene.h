@@ -40,6 +40,7 @@ using namespace iaux;
 #include <memory>
 #include <vector>
 #include <set>
+#include <atomic>
 
 namespace igor
 {
@@ -162,6 +163,28 @@ namespace igor
         */
         iaMutex _mutexOctree;
 
+        /*! volumes that changed since the last cull
+        */
+        std::vector<iNodeVolume *> _volumeUpdateQueue;
+
+        /*! volumes that get applied to the octree right now
+        */
+        std::vector<iNodeVolume *> _volumeUpdateProcessing;
+
+        /*! mutex for the volume update queue and the volumes getting processed
+        */
+        iaMutex _mutexVolumeUpdateQueue;
+
+        /*! double buffered cull results
+
+        culling writes in to the back buffer and than flips the index
+        */
+        std::vector<void *> _cullResults[2];
+
+        /*! index of the cull result that can be read
+        */
+        std::atomic<uint32> _cullResultIndex = 0;
+
         /*! list of registered cameras to the scene
 		*/
         std::vector<iNodeID> _cameras;
@@ -206,7 +229,9 @@ namespace igor
         */
         bool _blockSignals = false;
 
-        /*! sets frustum on octree
+        /*! applies pending volume updates and culls the octree with given frustum
+
+        the result goes in to the back buffer which becomes readable afterwards
 
         \param frustum the frustum to cull the scene with
         */
@@ -214,9 +239,16 @@ namespace igor
 
         /*! returns cull result of scene
 
-        \param[out] cullResult the result after culling the scene
+        the result stays valid until setFrustum was called twice more, so no copy or lock is needed
+        as long as the reader does not fall behind by more than one cull
+
+        \returns the result of the last cull
+        */
+        const std::vector<void *> &getCullResult() const;
+
+        /*! applies all queued volume updates to the octree
         */
-        void getCullResult(std::vector<void *> &cullResult);
+        void applyVolumeUpdates();
 
         /*! draws the octree for debugging
         */
@@ -306,7 +338,9 @@ namespace igor
 		*/
         void unregisterVolume(iNodeVolume *volume);
 
-        /*! updates volume position in octree
+        /*! queues volume to be updated in octree
+
+        the octree gets updated once before the next cull
 
 		\param volume node to be updated in octree
 		*/
@@ -32,6 +32,7 @@ namespace igor
 
         setName(node->getName());
 
+        node->_particleSystem.waitForUpdate();
         _particleSystem = node->_particleSystem;
 
         setMaterial(node->getMaterial());
@@ -85,10 +86,13 @@ namespace igor
 
     void iNodeParticleSystem::handle()
     {
+        // apply last frame's result and kick off the next one so the simulation runs while the frame is rendered
+        _particleSystem.finishUpdate();
+
         iNodeEmitter *emitter = static_cast<iNodeEmitter *>(iNodeManager::getInstance().getNode(_emitterID));
         if (emitter != nullptr)
         {
-            _particleSystem.onUpdate(emitter->getParticleEmitter());
+            _particleSystem.startUpdate(emitter->getParticleEmitter());
             setBoundingBox(_particleSystem.getBoundingBox());
         }
 
@@ -102,6 +106,8 @@ namespace igor
     {
         handle();
 
+        _particleSystem.updateVertexArray();
+
         if(_particleSystem.getVertexArray() == nullptr)
         {
             return;
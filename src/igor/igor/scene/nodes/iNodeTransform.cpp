@@ -84,6 +84,37 @@ namespace igor
         }
     }
 
+    void iNodeTransform::setMatrix(const iaMatrixd &from, const iaMatrixd &to, float64 t)
+    {
+        if (t <= 0.0)
+        {
+            setMatrix(from);
+            return;
+        }
+
+        if (t >= 1.0 || from == to)
+        {
+            setMatrix(to);
+            return;
+        }
+
+        iaVector3d depth = lerp(from._depth, to._depth, t);
+        iaVector3d top = lerp(from._top, to._top, t);
+
+        // more than a half turn between the two. nothing to interpolate in a meaningful way
+        if (depth.length2() < 0.0001 || top.length2() < 0.0001)
+        {
+            setMatrix(to);
+            return;
+        }
+
+        iaMatrixd matrix;
+        matrix.grammSchmidt(depth, top);
+        matrix._pos = lerp(from._pos, to._pos, t);
+
+        setMatrix(matrix);
+    }
+
     void iNodeTransform::identity()
     {
         _transform.identity();
@@ -50,6 +50,16 @@ namespace igor
         */
         virtual void setMatrix(const iaMatrixd &matrix);
 
+        /*! sets transformation matrix interpolated between two rigid transformations
+
+        interpolates position and orientation. Scale and shear get lost
+
+        \param from the transformation at t = 0
+        \param to the transformation at t = 1
+        \param t interpolation factor 0-1
+        */
+        virtual void setMatrix(const iaMatrixd &from, const iaMatrixd &to, float64 t);
+
         /*! returns the transformation matrix
 
         \param[out] matrix the returned transformation matrix
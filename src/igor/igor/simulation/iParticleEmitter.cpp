@@ -69,6 +69,14 @@ namespace igor
         }
     }
 
+    void iParticleEmitter::copyShape(const iParticleEmitter &emitter)
+    {
+        _type = emitter._type;
+        _size = emitter._size;
+        _worldMatrix = emitter._worldMatrix;
+        _emitterTriangles = emitter._emitterTriangles;
+    }
+
     void iParticleEmitter::setSize(float32 size)
     {
         _size = size;
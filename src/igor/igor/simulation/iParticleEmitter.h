@@ -132,6 +132,15 @@ namespace igor
         */
         void clearTriangles();
 
+        /*! copies type, size, world matrix and triangles of given emitter
+
+        keeps its own random number generator. Used to give a particle system a snapshot of an emitter it can
+        work with while the original emitter changes
+
+        \param emitter the emitter to copy the shape from
+        */
+        void copyShape(const iParticleEmitter &emitter);
+
         /*! calculates a random start position and velocity from emitter
 
         \param[out] position random position on emitter in world coordinates
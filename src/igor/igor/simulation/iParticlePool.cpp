@@ -0,0 +1,421 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/simulation/iParticlePool.h>
+
+#include <iaux/system/iaConsole.h>
+using namespace iaux;
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IGOR_PARTICLES_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IGOR_PARTICLES_SSE2
+#endif
+
+#include <cmath>
+
+namespace igor
+{
+
+    /*! scales the push of a vortex down to the velocity change it causes per simulation frame
+    */
+    static const float32 s_vortexVelocityScale = 0.001f;
+
+    iParticlePool::iParticlePool()
+    {
+        iaKeyFrameGraphf sizeScaleGradient;
+        sizeScaleGradient.setValue(0.0f, 1.0f);
+        _sizeScaleTable.bake(sizeScaleGradient);
+
+        iaKeyFrameGraphf torqueFactorGradient;
+        torqueFactorGradient.setValue(0.0f, 1.0f);
+        _torqueFactorTable.bake(torqueFactorGradient);
+    }
+
+    void iParticlePool::resize(uint32 count)
+    {
+        _positionX.resize(count, 0.0f);
+        _positionY.resize(count, 0.0f);
+        _positionZ.resize(count, 0.0f);
+        _velocityX.resize(count, 0.0f);
+        _velocityY.resize(count, 0.0f);
+        _velocityZ.resize(count, 0.0f);
+        _lifeLeft.resize(count, 0.0f);
+        _maxAge.resize(count, 0.0f);
+        _lift.resize(count, 0.0f);
+        _size.resize(count, 1.0f);
+        _sizeScale.resize(count, 1.0f);
+        _orientation.resize(count, 0.0f);
+        _orientationRate.resize(count, 0.0f);
+        _tilingIndex.resize(count, 0.0f);
+
+        _vortices.erase(std::remove_if(_vortices.begin(), _vortices.end(), [count](const Vortex &vortex)
+                                       { return vortex._index >= count; }),
+                        _vortices.end());
+    }
+
+    uint32 iParticlePool::getParticleCount() const
+    {
+        return static_cast<uint32>(_lifeLeft.size());
+    }
+
+    void iParticlePool::setParticle(uint32 index, const iParticle &particle)
+    {
+        con_assert(index < getParticleCount(), "out of range");
+
+        _positionX[index] = particle._position._x;
+        _positionY[index] = particle._position._y;
+        _positionZ[index] = particle._position._z;
+        _velocityX[index] = particle._velocity._x;
+        _velocityY[index] = particle._velocity._y;
+        _velocityZ[index] = particle._velocity._z;
+        _lifeLeft[index] = particle._lifeLeft;
+        _maxAge[index] = particle._maxAge;
+        _lift[index] = particle._lift;
+        _size[index] = particle._size;
+        _sizeScale[index] = particle._sizeScale;
+        _orientation[index] = particle._orientation;
+        _orientationRate[index] = particle._orientationRate;
+        _tilingIndex[index] = particle._tilingIndex;
+
+        // vortices are kept sorted by index
+        auto iter = std::lower_bound(_vortices.begin(), _vortices.end(), index, [](const Vortex &vortex, uint32 index)
+                                     { return vortex._index < index; });
+        const bool isVortex = iter != _vortices.end() && iter->_index == index;
+
+        if (particle._torque != 0.0f)
+        {
+            const Vortex vortex = {index, particle._normal, particle._torque, particle._vortexRange};
+
+            if (isVortex)
+            {
+                *iter = vortex;
+            }
+            else
+            {
+                _vortices.insert(iter, vortex);
+            }
+        }
+        else if (isVortex)
+        {
+            _vortices.erase(iter);
+        }
+    }
+
+    void iParticlePool::getParticle(uint32 index, iParticle &particle) const
+    {
+        con_assert(index < getParticleCount(), "out of range");
+
+        particle._position.set(_positionX[index], _positionY[index], _positionZ[index]);
+        particle._velocity.set(_velocityX[index], _velocityY[index], _velocityZ[index]);
+        particle._lifeLeft = _lifeLeft[index];
+        particle._maxAge = _maxAge[index];
+        particle._lift = _lift[index];
+        particle._size = _size[index];
+        particle._sizeScale = _sizeScale[index];
+        particle._orientation = _orientation[index];
+        particle._orientationRate = _orientationRate[index];
+        particle._visible = isAlive(index);
+        particle._tilingIndex = _tilingIndex[index];
+        particle._normal.set(0.0f, 0.0f, 0.0f);
+        particle._torque = 0.0f;
+        particle._vortexRange = 0.0f;
+
+        auto iter = std::lower_bound(_vortices.begin(), _vortices.end(), index, [](const Vortex &vortex, uint32 index)
+                                     { return vortex._index < index; });
+        if (iter != _vortices.end() && iter->_index == index)
+        {
+            particle._normal = iter->_normal;
+            particle._torque = iter->_torque;
+            particle._vortexRange = iter->_range;
+        }
+    }
+
+    void iParticlePool::setSizeScaleGradient(const iaKeyFrameGraphf &sizeScaleGradient)
+    {
+        _sizeScaleTable.bake(sizeScaleGradient, 1.0f);
+    }
+
+    void iParticlePool::setTorqueFactorGradient(const iaKeyFrameGraphf &torqueFactorGradient)
+    {
+        _torqueFactorTable.bake(torqueFactorGradient, 1.0f);
+    }
+
+    void iParticlePool::setAirDrag(float32 airDrag)
+    {
+        _airDrag = airDrag;
+    }
+
+    void iParticlePool::setTileIncrement(float32 tileIncrement)
+    {
+        _tileIncrement = tileIncrement;
+    }
+
+    void iParticlePool::setVorticityConfinement(float32 vorticityConfinement)
+    {
+        _vorticityConfinement = vorticityConfinement;
+    }
+
+    void iParticlePool::setVortexCheckRange(uint8 particles)
+    {
+        _vortexCheckRange = particles;
+    }
+
+    void iParticlePool::setTimeStep(float32 timeStep)
+    {
+        _timeStep = timeStep;
+    }
+
+    void iParticlePool::iterate()
+    {
+        // particles get processed in index order. A vortex pushes the neighbours with lower indices after and the ones
+        // with higher indices before they got integrated. The ranges in between vortices get integrated in one go
+        uint32 begin = 0;
+
+        for (const auto &vortex : _vortices)
+        {
+            integrate(begin, vortex._index);
+            applyVortex(vortex);
+            begin = vortex._index;
+        }
+
+        integrate(begin, getParticleCount());
+    }
+
+    void iParticlePool::applyVortex(const Vortex &vortex)
+    {
+        const int32 count = static_cast<int32>(getParticleCount());
+        const int32 checkRange = std::min(static_cast<int32>(_vortexCheckRange), count);
+        const int32 index = static_cast<int32>(vortex._index);
+
+        if (!isAlive(index))
+        {
+            return;
+        }
+
+        const float32 torque = vortex._torque * _torqueFactorTable.getValue(_lifeLeft[index] / _maxAge[index]);
+        const float32 rangeSquared = vortex._range * vortex._range;
+        const float32 inverseRange = 1.0f / vortex._range;
+
+        for (int32 i = index - checkRange; i < index + checkRange; ++i)
+        {
+            int32 other = i;
+            if (other < 0)
+            {
+                other += count;
+            }
+            else if (other >= count)
+            {
+                other -= count;
+            }
+
+            // ignore your self
+            if (other == index)
+            {
+                continue;
+            }
+
+            iaVector3f vortexAxis(_positionX[index] - _positionX[other],
+                                  _positionY[index] - _positionY[other],
+                                  _positionZ[index] - _positionZ[other]);
+
+            // also skip particles at the exact same position since there is no axis to rotate around
+            const float32 distanceSquared = vortexAxis._x * vortexAxis._x + vortexAxis._y * vortexAxis._y + vortexAxis._z * vortexAxis._z;
+            if (distanceSquared > rangeSquared ||
+                distanceSquared == 0.0f)
+            {
+                continue;
+            }
+
+            const float32 distance = std::sqrt(distanceSquared);
+
+            iaVector3f vortexTangent = vortexAxis % vortex._normal;
+            const float32 tangentLength = vortexTangent.length();
+            if (tangentLength > 0.0f)
+            {
+                vortexTangent *= (vortex._range - distance) * inverseRange * torque / tangentLength;
+            }
+
+            vortexAxis *= _vorticityConfinement / distance;
+            vortexTangent += vortexAxis;
+
+            _velocityX[other] += vortexTangent._x * s_vortexVelocityScale;
+            _velocityY[other] += vortexTangent._y * s_vortexVelocityScale;
+            _velocityZ[other] += vortexTangent._z * s_vortexVelocityScale;
+        }
+    }
+
+    void iParticlePool::integrate(uint32 begin, uint32 end)
+    {
+        float32 *positionX = _positionX.data();
+        float32 *positionY = _positionY.data();
+        float32 *positionZ = _positionZ.data();
+        float32 *velocityX = _velocityX.data();
+        float32 *velocityY = _velocityY.data();
+        float32 *velocityZ = _velocityZ.data();
+        float32 *lifeLeft = _lifeLeft.data();
+        float32 *orientation = _orientation.data();
+        float32 *tilingIndex = _tilingIndex.data();
+        float32 *sizeScale = _sizeScale.data();
+        const float32 *maxAge = _maxAge.data();
+        const float32 *lift = _lift.data();
+        const float32 *orientationRate = _orientationRate.data();
+        uint32 i = begin;
+
+#if defined(IGOR_PARTICLES_AVX)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 tableScale = _mm256_set1_ps(static_cast<float32>(iParticleLookupTable<float32>::SAMPLES - 1));
+        const __m256 airDrag = _mm256_set1_ps(_airDrag);
+        const __m256 tileIncrement = _mm256_set1_ps(_tileIncrement);
+        const __m256 timeStep = _mm256_set1_ps(_timeStep);
+        alignas(32) int32 tableIndex[8];
+        alignas(32) float32 tableFraction[8];
+
+        for (; i + 8 <= end; i += 8)
+        {
+            const __m256 life = _mm256_loadu_ps(lifeLeft + i);
+            const __m256 alive = _mm256_cmp_ps(life, zero, _CMP_GT_OQ);
+            const int mask = _mm256_movemask_ps(alive);
+            if (mask == 0)
+            {
+                continue;
+            }
+
+            // dead lanes divide by a zero max age. max returns zero for the resulting NaN and the lanes get masked out anyway
+            const __m256 normalizedAge = _mm256_div_ps(life, _mm256_loadu_ps(maxAge + i));
+            const __m256 tablePosition = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(normalizedAge, zero), one), tableScale);
+            const __m256i index = _mm256_cvttps_epi32(tablePosition);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(tableIndex), index);
+            _mm256_store_ps(tableFraction, _mm256_sub_ps(tablePosition, _mm256_cvtepi32_ps(index)));
+
+            const __m256 vx = _mm256_loadu_ps(velocityX + i);
+            const __m256 vy = _mm256_loadu_ps(velocityY + i);
+            const __m256 vz = _mm256_loadu_ps(velocityZ + i);
+            const __m256 newVX = _mm256_mul_ps(vx, airDrag);
+            const __m256 newVY = _mm256_mul_ps(_mm256_add_ps(vy, _mm256_loadu_ps(lift + i)), airDrag);
+            const __m256 newVZ = _mm256_mul_ps(vz, airDrag);
+
+            _mm256_storeu_ps(velocityX + i, _mm256_blendv_ps(vx, newVX, alive));
+            _mm256_storeu_ps(velocityY + i, _mm256_blendv_ps(vy, newVY, alive));
+            _mm256_storeu_ps(velocityZ + i, _mm256_blendv_ps(vz, newVZ, alive));
+
+            const __m256 px = _mm256_loadu_ps(positionX + i);
+            const __m256 py = _mm256_loadu_ps(positionY + i);
+            const __m256 pz = _mm256_loadu_ps(positionZ + i);
+            _mm256_storeu_ps(positionX + i, _mm256_blendv_ps(px, _mm256_add_ps(px, newVX), alive));
+            _mm256_storeu_ps(positionY + i, _mm256_blendv_ps(py, _mm256_add_ps(py, newVY), alive));
+            _mm256_storeu_ps(positionZ + i, _mm256_blendv_ps(pz, _mm256_add_ps(pz, newVZ), alive));
+
+            const __m256 angle = _mm256_loadu_ps(orientation + i);
+            _mm256_storeu_ps(orientation + i, _mm256_blendv_ps(angle, _mm256_add_ps(angle, _mm256_loadu_ps(orientationRate + i)), alive));
+
+            const __m256 tile = _mm256_loadu_ps(tilingIndex + i);
+            _mm256_storeu_ps(tilingIndex + i, _mm256_blendv_ps(tile, _mm256_add_ps(tile, tileIncrement), alive));
+
+            _mm256_storeu_ps(lifeLeft + i, _mm256_blendv_ps(life, _mm256_sub_ps(life, timeStep), alive));
+
+            for (int j = 0; j < 8; ++j)
+            {
+                if (mask & (1 << j))
+                {
+                    sizeScale[i + j] = _sizeScaleTable.getValue(tableIndex[j], tableFraction[j]);
+                }
+            }
+        }
+#elif defined(IGOR_PARTICLES_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 tableScale = _mm_set1_ps(static_cast<float32>(iParticleLookupTable<float32>::SAMPLES - 1));
+        const __m128 airDrag = _mm_set1_ps(_airDrag);
+        const __m128 tileIncrement = _mm_set1_ps(_tileIncrement);
+        const __m128 timeStep = _mm_set1_ps(_timeStep);
+        alignas(16) int32 tableIndex[4];
+        alignas(16) float32 tableFraction[4];
+
+        // SSE2 has no blend so masked values get combined by and, andnot and or
+        auto select = [](__m128 mask, __m128 oldValue, __m128 newValue)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, newValue), _mm_andnot_ps(mask, oldValue));
+        };
+
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 life = _mm_loadu_ps(lifeLeft + i);
+            const __m128 alive = _mm_cmpgt_ps(life, zero);
+            const int mask = _mm_movemask_ps(alive);
+            if (mask == 0)
+            {
+                continue;
+            }
+
+            // dead lanes divide by a zero max age. max returns zero for the resulting NaN and the lanes get masked out anyway
+            const __m128 normalizedAge = _mm_div_ps(life, _mm_loadu_ps(maxAge + i));
+            const __m128 tablePosition = _mm_mul_ps(_mm_min_ps(_mm_max_ps(normalizedAge, zero), one), tableScale);
+            const __m128i index = _mm_cvttps_epi32(tablePosition);
+            _mm_store_si128(reinterpret_cast<__m128i *>(tableIndex), index);
+            _mm_store_ps(tableFraction, _mm_sub_ps(tablePosition, _mm_cvtepi32_ps(index)));
+
+            const __m128 vx = _mm_loadu_ps(velocityX + i);
+            const __m128 vy = _mm_loadu_ps(velocityY + i);
+            const __m128 vz = _mm_loadu_ps(velocityZ + i);
+            const __m128 newVX = _mm_mul_ps(vx, airDrag);
+            const __m128 newVY = _mm_mul_ps(_mm_add_ps(vy, _mm_loadu_ps(lift + i)), airDrag);
+            const __m128 newVZ = _mm_mul_ps(vz, airDrag);
+
+            _mm_storeu_ps(velocityX + i, select(alive, vx, newVX));
+            _mm_storeu_ps(velocityY + i, select(alive, vy, newVY));
+            _mm_storeu_ps(velocityZ + i, select(alive, vz, newVZ));
+
+            const __m128 px = _mm_loadu_ps(positionX + i);
+            const __m128 py = _mm_loadu_ps(positionY + i);
+            const __m128 pz = _mm_loadu_ps(positionZ + i);
+            _mm_storeu_ps(positionX + i, select(alive, px, _mm_add_ps(px, newVX)));
+            _mm_storeu_ps(positionY + i, select(alive, py, _mm_add_ps(py, newVY)));
+            _mm_storeu_ps(positionZ + i, select(alive, pz, _mm_add_ps(pz, newVZ)));
+
+            const __m128 angle = _mm_loadu_ps(orientation + i);
+            _mm_storeu_ps(orientation + i, select(alive, angle, _mm_add_ps(angle, _mm_loadu_ps(orientationRate + i))));
+
+            const __m128 tile = _mm_loadu_ps(tilingIndex + i);
+            _mm_storeu_ps(tilingIndex + i, select(alive, tile, _mm_add_ps(tile, tileIncrement)));
+
+            _mm_storeu_ps(lifeLeft + i, select(alive, life, _mm_sub_ps(life, timeStep)));
+
+            for (int j = 0; j < 4; ++j)
+            {
+                if (mask & (1 << j))
+                {
+                    sizeScale[i + j] = _sizeScaleTable.getValue(tableIndex[j], tableFraction[j]);
+                }
+            }
+        }
+#endif
+
+        for (; i < end; ++i)
+        {
+            if (lifeLeft[i] <= 0.0f)
+            {
+                continue;
+            }
+
+            sizeScale[i] = _sizeScaleTable.getValue(lifeLeft[i] / maxAge[i]);
+
+            velocityX[i] *= _airDrag;
+            velocityY[i] = (velocityY[i] + lift[i]) * _airDrag;
+            velocityZ[i] *= _airDrag;
+
+            positionX[i] += velocityX[i];
+            positionY[i] += velocityY[i];
+            positionZ[i] += velocityZ[i];
+
+            orientation[i] += orientationRate[i];
+            tilingIndex[i] += _tileIncrement;
+            lifeLeft[i] -= _timeStep;
+        }
+    }
+
+} // namespace igor
@@ -0,0 +1,415 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_PARTICLEPOOL__
+#define __IGOR_PARTICLEPOOL__
+
+#include <igor/iDefines.h>
+
+#include <iaux/data/iaKeyFrameGraph.h>
+#include <iaux/math/iaVector3.h>
+using namespace iaux;
+
+#include <vector>
+#include <algorithm>
+
+namespace igor
+{
+
+    /*! single particle
+     */
+    struct IGOR_API iParticle
+    {
+        /*! position of particle
+         */
+        iaVector3f _position;
+
+        /*! velocity of particle
+         */
+        iaVector3f _velocity;
+
+        /*! life left of particle in seconds
+         */
+        float32 _lifeLeft = 0.0;
+
+        /*! max age of particle
+        */
+        float32 _maxAge = 0.0;        
+
+        /*! current lift value
+
+        depending on the coordinate system this is used in 
+        a positive value can be interpreted as lift or weight
+        */
+        float32 _lift = 0.0;
+
+        /*! size of the particle given at birth
+         */
+        float32 _size = 1.0;
+
+        /*! size scale changes during life time of particle
+         */
+        float32 _sizeScale = 1.0;
+
+        /*! orientation angle of particle in rad
+         */
+        float32 _orientation = 0.0;
+
+        /*! orientation / rotation rate in rad per frame
+         */
+        float32 _orientationRate = 0.0;
+
+        /*! if particle is actually visible
+         */
+        bool _visible = true;
+
+        /*! tiling index of this particle
+        */
+        float32 _tilingIndex = 0;
+
+        /*! if particle is a vortex particle it will rotate around this axis
+         */
+        iaVector3f _normal;
+
+        /*! the torque the vortex particle is rotating the other particles with
+
+        if value is zero it's not a vortex particle
+        */
+        float32 _torque = 0;
+
+        /*! the range the vortex has an effect on other particles
+         */
+        float32 _vortexRange = 0;
+    };
+
+    /*! gradient baked in to a table for normalized ages from 0.0 to 1.0
+
+    values in between samples get interpolated linearly. Steps of none interpolated gradients get smoothed over one sample
+    */
+    template <typename T>
+    class IGOR_API_EXPORT_ONLY iParticleLookupTable
+    {
+
+    public:
+        /*! count of samples in table
+        */
+        static const uint32 SAMPLES = 1024;
+
+        /*! samples given gradient
+
+        \param gradient the gradient to sample
+        \param defaultValue value to use if gradient is empty
+        */
+        void bake(const iaKeyFrameGraph<T> &gradient, const T &defaultValue = T());
+
+        /*! \returns value for given normalized age
+
+        \param normalizedAge the normalized age (0.0 - 1.0)
+        */
+        IGOR_INLINE T getValue(float32 normalizedAge) const;
+
+        /*! \returns value in between given sample and the next one
+
+        \param index the sample index (0 - SAMPLES - 1)
+        \param t interpolation factor to the next sample (0.0 - 1.0)
+        */
+        IGOR_INLINE T getValue(uint32 index, float32 t) const;
+
+    private:
+        /*! the samples
+        */
+        std::vector<T> _values;
+    };
+
+    /*! particles stored as structure of arrays and the kernel to simulate them
+
+    a particle is alive as long as it has life left. Vortex particles are kept in a separate sorted list. An iteration
+    integrates the ranges of particles in between vortices and applies the vortices in index order. Integration uses
+    AVX or SSE if available and falls back to scalar code otherwise.
+    */
+    class IGOR_API iParticlePool
+    {
+
+    public:
+        /*! init lookup tables
+        */
+        iParticlePool();
+
+        /*! resizes pool and kills all particles
+
+        \param count the new particle count
+        */
+        void resize(uint32 count);
+
+        /*! \returns particle count (dead or alive)
+        */
+        uint32 getParticleCount() const;
+
+        /*! sets particle at given index
+
+        \param index the particle index
+        \param particle the particle data
+        */
+        void setParticle(uint32 index, const iParticle &particle);
+
+        /*! returns particle at given index
+
+        \param index the particle index
+        \param[out] particle the particle data
+        */
+        void getParticle(uint32 index, iParticle &particle) const;
+
+        /*! \returns true if particle at given index is alive
+
+        \param index the particle index
+        */
+        IGOR_INLINE bool isAlive(uint32 index) const;
+
+        /*! sets the size scale gradient and bakes it in to a lookup table
+
+        \param sizeScaleGradient the size scale gradient
+        */
+        void setSizeScaleGradient(const iaKeyFrameGraphf &sizeScaleGradient);
+
+        /*! sets the torque factor gradient and bakes it in to a lookup table
+
+        \param torqueFactorGradient the torque factor gradient
+        */
+        void setTorqueFactorGradient(const iaKeyFrameGraphf &torqueFactorGradient);
+
+        /*! sets the air drag factor
+
+        \param airDrag the air drag factor (0.0 - 1.0)
+        */
+        void setAirDrag(float32 airDrag);
+
+        /*! sets the increment the tile index is progressing per iteration
+
+        \param tileIncrement the tile increment
+        */
+        void setTileIncrement(float32 tileIncrement);
+
+        /*! sets vorticity confinement force
+
+        \param vorticityConfinement the vorticity confinement force
+        */
+        void setVorticityConfinement(float32 vorticityConfinement);
+
+        /*! sets vortex check range
+
+        \param particles distance in indexes from vortex particle
+        */
+        void setVortexCheckRange(uint8 particles);
+
+        /*! sets the time step of one iteration
+
+        \param timeStep the time step in seconds
+        */
+        void setTimeStep(float32 timeStep);
+
+        /*! iterates all particles by one time step
+        */
+        void iterate();
+
+        /*! \returns positions on x axis
+        */
+        IGOR_INLINE const float32 *getPositionX() const;
+
+        /*! \returns positions on y axis
+        */
+        IGOR_INLINE const float32 *getPositionY() const;
+
+        /*! \returns positions on z axis
+        */
+        IGOR_INLINE const float32 *getPositionZ() const;
+
+        /*! \returns velocities on x axis
+        */
+        IGOR_INLINE const float32 *getVelocityX() const;
+
+        /*! \returns velocities on y axis
+        */
+        IGOR_INLINE const float32 *getVelocityY() const;
+
+        /*! \returns velocities on z axis
+        */
+        IGOR_INLINE const float32 *getVelocityZ() const;
+
+        /*! \returns life left of particles in seconds
+        */
+        IGOR_INLINE const float32 *getLifeLeft() const;
+
+        /*! \returns max age of particles in seconds
+        */
+        IGOR_INLINE const float32 *getMaxAge() const;
+
+        /*! \returns sizes of particles given at birth
+        */
+        IGOR_INLINE const float32 *getSize() const;
+
+        /*! \returns current size scales of particles
+        */
+        IGOR_INLINE const float32 *getSizeScale() const;
+
+        /*! \returns orientations of particles in rad
+        */
+        IGOR_INLINE const float32 *getOrientation() const;
+
+        /*! \returns tiling indices of particles
+        */
+        IGOR_INLINE const float32 *getTilingIndex() const;
+
+    private:
+        /*! vortex particle data
+        */
+        struct Vortex
+        {
+            /*! index of particle
+            */
+            uint32 _index;
+
+            /*! axis the vortex rotates around
+            */
+            iaVector3f _normal;
+
+            /*! torque of vortex
+            */
+            float32 _torque;
+
+            /*! range the vortex has an effect on other particles
+            */
+            float32 _range;
+        };
+
+        /*! x component of particle positions
+        */
+        std::vector<float32> _positionX;
+
+        /*! y component of particle positions
+        */
+        std::vector<float32> _positionY;
+
+        /*! z component of particle positions
+        */
+        std::vector<float32> _positionZ;
+
+        /*! x component of particle velocities
+        */
+        std::vector<float32> _velocityX;
+
+        /*! y component of particle velocities
+        */
+        std::vector<float32> _velocityY;
+
+        /*! z component of particle velocities
+        */
+        std::vector<float32> _velocityZ;
+
+        /*! life left of particles in seconds
+        */
+        std::vector<float32> _lifeLeft;
+
+        /*! max age of particles in seconds
+        */
+        std::vector<float32> _maxAge;
+
+        /*! lift of particles
+        */
+        std::vector<float32> _lift;
+
+        /*! size of particles given at birth
+        */
+        std::vector<float32> _size;
+
+        /*! current size scale of particles
+        */
+        std::vector<float32> _sizeScale;
+
+        /*! orientation angle of particles in rad
+        */
+        std::vector<float32> _orientation;
+
+        /*! orientation rate of particles in rad per iteration
+        */
+        std::vector<float32> _orientationRate;
+
+        /*! tiling index of particles
+        */
+        std::vector<float32> _tilingIndex;
+
+        /*! the vortex particles sorted by index. Only a small fraction of the particles are vortex particles
+        */
+        std::vector<Vortex> _vortices;
+
+        /*! baked size scale gradient
+        */
+        iParticleLookupTable<float32> _sizeScaleTable;
+
+        /*! baked torque factor gradient
+        */
+        iParticleLookupTable<float32> _torqueFactorTable;
+
+        /*! air drag factor
+        */
+        float32 _airDrag = 1.0f;
+
+        /*! tile increment per iteration
+        */
+        float32 _tileIncrement = 0.0f;
+
+        /*! vorticity confinement
+        */
+        float32 _vorticityConfinement = 0.05f;
+
+        /*! vortex check range
+        */
+        uint8 _vortexCheckRange = 20;
+
+        /*! time step per iteration in seconds
+        */
+        float32 _timeStep = 1.0f / 60.0f;
+
+        /*! applies impulses of given vortex to its neighbours
+
+        \param vortex the vortex to apply
+        */
+        void applyVortex(const Vortex &vortex);
+
+        /*! integrates living particles in given range
+
+        \param begin first particle index
+        \param end one after the last particle index
+        */
+        void integrate(uint32 begin, uint32 end);
+    };
+
+#include <igor/simulation/iParticlePool.inl>
+
+} // namespace igor
+
+#endif // __IGOR_PARTICLEPOOL__
@@ -0,0 +1,96 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename T>
+void iParticleLookupTable<T>::bake(const iaKeyFrameGraph<T> &gradient, const T &defaultValue)
+{
+    // one extra sample so interpolating the last sample does not need a special case
+    _values.resize(SAMPLES + 1);
+
+    for (uint32 i = 0; i < SAMPLES; ++i)
+    {
+        _values[i] = gradient.isEmpty() ? defaultValue : gradient.getValue(static_cast<float64>(i) / static_cast<float64>(SAMPLES - 1));
+    }
+
+    _values[SAMPLES] = _values[SAMPLES - 1];
+}
+
+template <typename T>
+IGOR_INLINE T iParticleLookupTable<T>::getValue(float32 normalizedAge) const
+{
+    const float32 position = std::min(std::max(normalizedAge, 0.0f), 1.0f) * static_cast<float32>(SAMPLES - 1);
+    const uint32 index = static_cast<uint32>(position);
+    return getValue(index, position - static_cast<float32>(index));
+}
+
+template <typename T>
+IGOR_INLINE T iParticleLookupTable<T>::getValue(uint32 index, float32 t) const
+{
+    return iaMath::lerp(_values[index], _values[index + 1], t);
+}
+
+IGOR_INLINE bool iParticlePool::isAlive(uint32 index) const
+{
+    return _lifeLeft[index] > 0.0f;
+}
+
+IGOR_INLINE const float32 * iParticlePool::getPositionX() const
+{
+    return _positionX.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getPositionY() const
+{
+    return _positionY.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getPositionZ() const
+{
+    return _positionZ.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getVelocityX() const
+{
+    return _velocityX.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getVelocityY() const
+{
+    return _velocityY.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getVelocityZ() const
+{
+    return _velocityZ.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getLifeLeft() const
+{
+    return _lifeLeft.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getMaxAge() const
+{
+    return _maxAge.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getSize() const
+{
+    return _size.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getSizeScale() const
+{
+    return _sizeScale.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getOrientation() const
+{
+    return _orientation.data();
+}
+
+IGOR_INLINE const float32 * iParticlePool::getTilingIndex() const
+{
+    return _tilingIndex.data();
+}
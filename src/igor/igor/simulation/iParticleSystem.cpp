@@ -7,7 +7,8 @@
 
 #include <iaux/data/iaKeyFrameGraph.h>
 #include <igor/system/iTimer.h>
-#include <igor/simulation/iParticleEmitter.h>
+#include <igor/threading/iTaskManager.h>
+#include <igor/threading/tasks/iTaskUpdateParticleSystem.h>
 
 #include <iaux/data/iaConvert.h>
 using namespace iaux;
@@ -22,10 +23,21 @@ namespace igor
     {
         _rand.setSeed(static_cast<uint32>(iaTime::getNow().getMicroseconds()));
         initDefaultGradients();
+
+        _particlePool.setTimeStep(1.0f / _simulationRate);
+        _particlePool.setAirDrag(_airDrag);
+        _particlePool.setTileIncrement(_tileIncrement);
+        _particlePool.setVorticityConfinement(_vorticityConfinement);
+        _particlePool.setVortexCheckRange(_vortexCheckRange);
     }
 
     iParticleSystem::~iParticleSystem()
     {
+        if (_updateTaskID != iTask::INVALID_TASK_ID &&
+            iTaskManager::isInstantiated())
+        {
+            iTaskManager::getInstance().waitForTasks({_updateTaskID});
+        }
     }
 
     const iaSphered &iParticleSystem::getBoundingSphere() const
@@ -66,6 +78,10 @@ namespace igor
         _torqueFactorGradient.setValue(0.1f, 1.0f);
         _torqueFactorGradient.setValue(0.9f, 1.0f);
         _torqueFactorGradient.setValue(1.0f, 0.0f);
+
+        _colorTable.bake(_colorGradient);
+        _particlePool.setSizeScaleGradient(_sizeScaleGradient);
+        _particlePool.setTorqueFactorGradient(_torqueFactorGradient);
     }
 
     void iParticleSystem::setVelocityOriented(bool velocityOriented)
@@ -80,7 +96,10 @@ namespace igor
 
     void iParticleSystem::setColorGradient(const iaKeyFrameGraphColor4f &colorGradient)
     {
+        waitForUpdate();
+
         _colorGradient = colorGradient;
+        _colorTable.bake(_colorGradient);
     }
 
     void iParticleSystem::getColorGradient(iaKeyFrameGraphColor4f &colorGradient) const
@@ -95,6 +114,8 @@ namespace igor
 
     void iParticleSystem::setEmissionGradient(const iaKeyFrameGraphf &emissionGradient)
     {
+        waitForUpdate();
+
         _emissionRateGradient = emissionGradient;
     }
 
@@ -105,6 +126,8 @@ namespace igor
 
     void iParticleSystem::setTextureTiling(uint8 columns, uint8 rows)
     {
+        waitForUpdate();
+
         con_assert(columns > 0 && rows > 0, "out of range");
 
         if (columns > 0 && rows > 0)
@@ -176,11 +199,16 @@ namespace igor
 
     void iParticleSystem::setVortexCheckRange(uint8 checkRange)
     {
+        waitForUpdate();
+
         _vortexCheckRange = checkRange;
+        _particlePool.setVortexCheckRange(_vortexCheckRange);
     }
 
     void iParticleSystem::start()
     {
+        waitForUpdate();
+
         _startTime = iTimer::getInstance().getTime();
         _playbackTime = _startTime;
         _running = true;
@@ -188,6 +216,8 @@ namespace igor
 
     void iParticleSystem::stop()
     {
+        waitForUpdate();
+
         _running = false;
     }
 
@@ -198,8 +228,10 @@ namespace igor
 
     void iParticleSystem::reset()
     {
+        waitForUpdate();
+
         _particlePool.resize(_maxParticleCount);
-        _particlePoolIndex = _particlePool.size() - 1;
+        _particlePoolIndex = _particlePool.getParticleCount() - 1;
 
         _mustReset = false;
         _particleCounter = 0;
@@ -209,6 +241,8 @@ namespace igor
 
     void iParticleSystem::setMaxParticleCount(uint16 max)
     {
+        waitForUpdate();
+
         con_assert(max > 0, "invalid particle count");
 
         if (_maxParticleCount == max)
@@ -228,6 +262,8 @@ namespace igor
 
     void iParticleSystem::setPeriodTime(float32 periodTime)
     {
+        waitForUpdate();
+
         _particleSystemPeriodTime = iaTime::fromSeconds(periodTime);
         _mustReset = true;
     }
@@ -239,6 +275,8 @@ namespace igor
 
     void iParticleSystem::setVortexTorque(float32 min, float32 max)
     {
+        waitForUpdate();
+
         _minVortexTorque = min;
         _maxVortexTorque = max;
         _mustReset = true;
@@ -246,6 +284,8 @@ namespace igor
 
     void iParticleSystem::setVortexRange(float32 min, float32 max)
     {
+        waitForUpdate();
+
         _minVortexRange = min;
         _maxVortexRange = max;
         _mustReset = true;
@@ -258,10 +298,10 @@ namespace igor
         iaVector3d velocity;
         emitter.calcRandomStart(position, velocity);
 
-        position = _particleSystemInvWorldMatrix * position;
+        position = _simulationInvWorldMatrix * position;
 
-        velocity = _particleSystemInvWorldMatrix * velocity;
-        velocity -= _particleSystemInvWorldMatrix._pos;
+        velocity = _simulationInvWorldMatrix * velocity;
+        velocity -= _simulationInvWorldMatrix._pos;
 
         float32 randomFactor = (_rand.getNext() % 1000 / 1000.0f);
 
@@ -317,6 +357,8 @@ namespace igor
 
     void iParticleSystem::setVortexToParticleRate(float32 rate)
     {
+        waitForUpdate();
+
         _vortexToParticleRate = rate;
         _mustReset = true;
     }
@@ -328,12 +370,16 @@ namespace igor
 
     void iParticleSystem::createParticles(uint32 particleCount, iParticleEmitter &emitter, float32 particleSystemTime)
     {
+        const int32 particlePoolSize = _particlePool.getParticleCount();
+        iParticle particle;
+
         for (uint32 i = 0; i < particleCount; ++i)
         {
-            resetParticle(_particlePool[_particlePoolIndex], emitter, particleSystemTime);
+            resetParticle(particle, emitter, particleSystemTime);
+            _particlePool.setParticle(_particlePoolIndex, particle);
 
             _particlePoolIndex--;
-            _particlePoolIndex = (_particlePoolIndex + _particlePool.size()) % _particlePool.size();
+            _particlePoolIndex = (_particlePoolIndex + particlePoolSize) % particlePoolSize;
         }
     }
 
@@ -344,6 +390,8 @@ namespace igor
 
     void iParticleSystem::setStartAgeGradient(const iaKeyFrameGraphVector2f &startAgeGradient)
     {
+        waitForUpdate();
+
         // TODO check if max age can be 0 or less
 
         _startAgeGradient = startAgeGradient;
@@ -357,7 +405,10 @@ namespace igor
 
     void iParticleSystem::setSizeScaleGradient(const iaKeyFrameGraphf &sizeScaleGradient)
     {
+        waitForUpdate();
+
         _sizeScaleGradient = sizeScaleGradient;
+        _particlePool.setSizeScaleGradient(_sizeScaleGradient);
         _mustReset = true;
     }
 
@@ -373,6 +424,8 @@ namespace igor
 
     void iParticleSystem::setLoop(bool loop)
     {
+        waitForUpdate();
+
         _loop = loop;
         _mustReset = true;
     }
@@ -384,133 +437,199 @@ namespace igor
 
     void iParticleSystem::iterateFrame()
     {
-        int32 index = 0;
-        float32 sizeScale = 0;
-        float32 torqueFactor = 0;
+        _particlePool.iterate();
+    }
+
+    void iParticleSystem::onUpdate(iParticleEmitter &emitter)
+    {
+        waitForUpdate();
 
-        for (int index = 0; index < _particlePool.size(); ++index)
+        if (_mustReset)
         {
-            auto &particle = _particlePool[index];
-            if (particle._lifeLeft <= 0)
-            {
-                particle._visible = false;
-                continue;
-            }
+            reset();
+        }
 
-            particle._tilingIndex += _tileIncrement;
+        if (!_running)
+        {
+            return;
+        }
 
-            const float32 normalizedAge = particle._lifeLeft / particle._maxAge;
+        _emitter.copyShape(emitter);
+        _simulationInvWorldMatrix = _particleSystemInvWorldMatrix;
 
-            sizeScale = _sizeScaleGradient.getValue(normalizedAge);
+        simulate(iTimer::getInstance().getTime());
+        applyUpdate();
+    }
 
-            particle._velocity[1] += particle._lift;
-            particle._velocity *= _airDrag;
-            particle._orientation += particle._orientationRate;
-            particle._sizeScale = sizeScale;
+    void iParticleSystem::startUpdate(const iParticleEmitter &emitter)
+    {
+        if (_updateTaskID != iTask::INVALID_TASK_ID)
+        {
+            return;
+        }
 
-            if (particle._torque != 0.0)
-            {
-                torqueFactor = _torqueFactorGradient.getValue(normalizedAge);
-
-                const int32 startIndex = index - _vortexCheckRange;
-                const int32 endIndex = index + _vortexCheckRange;
-
-                for (int32 i = startIndex; i < endIndex; ++i)
-                {
-                    int32 torqueIndex = (i + _particlePool.size()) % _particlePool.size();
-
-                    if (index == torqueIndex) // ignore your self
-                    {
-                        continue;
-                    }
-
-                    iaVector3f vortexAxis = particle._position - _particlePool[torqueIndex]._position;
-                    if (vortexAxis.length() > particle._vortexRange)
-                    {
-                        continue;
-                    }
-
-                    iaVector3f vortexTangent = vortexAxis % particle._normal;
-                    vortexTangent.normalize();
-                    vortexTangent *= (particle._vortexRange - vortexAxis.length()) / particle._vortexRange;
-                    vortexTangent *= particle._torque * torqueFactor;
-                    vortexAxis.normalize();
-                    vortexAxis *= _vorticityConfinement;
-                    vortexTangent += vortexAxis;
-
-                    _particlePool[torqueIndex]._velocity += vortexTangent * 0.001f; // TODO 0.001 ???
-                }
-            }
+        if (_mustReset)
+        {
+            reset();
+        }
+
+        if (!_running)
+        {
+            return;
+        }
+
+        _emitter.copyShape(emitter);
+        _simulationInvWorldMatrix = _particleSystemInvWorldMatrix;
 
-            particle._position += particle._velocity;
-            particle._lifeLeft -= 1.0f / _simulationRate;
+        const iaTime frameTime = iTimer::getInstance().getTime();
+
+        if (!iTaskManager::isInstantiated() ||
+            iTaskManager::getInstance().getRegularThreadCount() == 0)
+        {
+            simulate(frameTime);
+            applyUpdate();
+            return;
         }
+
+        _updateTaskID = iTaskManager::getInstance().addTask(new iTaskUpdateParticleSystem(this, frameTime));
     }
 
-    void iParticleSystem::onUpdate(iParticleEmitter &emitter)
+    bool iParticleSystem::finishUpdate()
     {
-        if (_mustReset)
+        if (_updateTaskID == iTask::INVALID_TASK_ID ||
+            !iTaskManager::getInstance().isTaskFinished(_updateTaskID))
         {
-            reset();
+            return false;
         }
 
-        if (_running)
+        _updateTaskID = iTask::INVALID_TASK_ID;
+        applyUpdate();
+
+        return true;
+    }
+
+    void iParticleSystem::waitForUpdate()
+    {
+        if (_updateTaskID == iTask::INVALID_TASK_ID)
         {
-            const iaTime frameTime = iTimer::getInstance().getTime();
-            const iaTime frameTick = iaTime::fromMilliseconds(IGOR_SECOND / _simulationRate);
-            
-            // ignore hickups
-            if (frameTime - _playbackTime > iaTime::fromMilliseconds(100))
-            {
-                _playbackTime = frameTime;
-            }
+            return;
+        }
 
-            iaTime particleSystemTime = _playbackTime - _startTime;
+        iTaskManager::getInstance().waitForTasks({_updateTaskID});
 
-            while (_playbackTime <= frameTime)
-            {
-                iterateFrame();
+        _updateTaskID = iTask::INVALID_TASK_ID;
+        applyUpdate();
+    }
 
-                float32 emissionRate = 0.0f;
-                emissionRate = _emissionRateGradient.getValue(particleSystemTime.getSeconds());
-                _emissionImpulseStack += emissionRate;
-                int32 createCount = static_cast<int32>(_emissionImpulseStack);
-                _emissionImpulseStack -= static_cast<float32>(createCount);
-                createParticles(createCount, emitter, particleSystemTime.getSeconds());
+    void iParticleSystem::simulate(const iaTime &frameTime)
+    {
+        const iaTime frameTick = iaTime::fromMilliseconds(IGOR_SECOND / _simulationRate);
 
-                _playbackTime += frameTick;
-                particleSystemTime += frameTick;
-            }
+        // ignore hickups
+        if (frameTime - _playbackTime > iaTime::fromMilliseconds(100))
+        {
+            _playbackTime = frameTime;
+        }
 
-            updateBuffer();
-            updateBoundings();
+        iaTime particleSystemTime = _playbackTime - _startTime;
 
-            if (particleSystemTime >= _particleSystemPeriodTime)
-            {
-                if (_loop)
-                {
-                    start();
-                }
-                else
-                {
-                    _finished = true;
-                    _running = false;
-                }
-            }
+        while (_playbackTime <= frameTime)
+        {
+            iterateFrame();
+
+            float32 emissionRate = 0.0f;
+            emissionRate = _emissionRateGradient.getValue(particleSystemTime.getSeconds());
+            _emissionImpulseStack += emissionRate;
+            int32 createCount = static_cast<int32>(_emissionImpulseStack);
+            _emissionImpulseStack -= static_cast<float32>(createCount);
+            createParticles(createCount, _emitter, particleSystemTime.getSeconds());
+
+            _playbackTime += frameTick;
+            particleSystemTime += frameTick;
+        }
+
+        updateBuffer();
+        updateBoundings();
+
+        _periodElapsed = particleSystemTime >= _particleSystemPeriodTime;
+    }
+
+    void iParticleSystem::applyUpdate()
+    {
+        _frontVertexData = 1 - _frontVertexData;
+        _uploadVertexData = true;
+
+        _boundingBox = _simulationBoundingBox;
+        _boundingSphere = _simulationBoundingSphere;
+
+        if (!_periodElapsed)
+        {
+            return;
+        }
+
+        _periodElapsed = false;
+
+        if (_loop)
+        {
+            start();
+        }
+        else
+        {
+            _finished = true;
+            _running = false;
         }
     }
 
     void iParticleSystem::updateBuffer()
     {
-        if (_createBuffers)
+        std::vector<iParticleVertex> &vertexData = _vertexData[1 - _frontVertexData];
+        vertexData.resize(_maxParticleCount * 4);
+
+        iParticleVertex *vertexBufferDataPtr = vertexData.data();
+
+        const uint32 particleCount = _particlePool.getParticleCount();
+        const float32 *positionX = _particlePool.getPositionX();
+        const float32 *positionY = _particlePool.getPositionY();
+        const float32 *positionZ = _particlePool.getPositionZ();
+        const float32 *velocityX = _particlePool.getVelocityX();
+        const float32 *velocityY = _particlePool.getVelocityY();
+        const float32 *velocityZ = _particlePool.getVelocityZ();
+        const float32 *lifeLeft = _particlePool.getLifeLeft();
+        const float32 *maxAge = _particlePool.getMaxAge();
+        const float32 *size = _particlePool.getSize();
+        const float32 *sizeScale = _particlePool.getSizeScale();
+        const float32 *orientation = _particlePool.getOrientation();
+        const float32 *tilingIndex = _particlePool.getTilingIndex();
+
+        for (uint32 i = 0; i < particleCount; ++i)
         {
-            if (_vertexBufferData != nullptr)
+            if (lifeLeft[i] <= 0.0f)
             {
-                delete[] _vertexBufferData;
+                continue;
             }
 
-            _vertexBufferData = new iParticleSystem::iParticleVertex[_maxParticleCount * 4];
+            const float32 normalizedAge = lifeLeft[i] / maxAge[i];
+            const float32 age = maxAge[i] - lifeLeft[i];
+
+            vertexBufferDataPtr->_position.set(positionX[i], positionY[i], positionZ[i]);
+            vertexBufferDataPtr->_color = _colorTable.getValue(normalizedAge);
+            vertexBufferDataPtr->_velocity.set(velocityX[i], velocityY[i], velocityZ[i]);
+            vertexBufferDataPtr->_lifeSizeAngleTilingIndex.set(
+                age,
+                size[i] * sizeScale[i],
+                orientation[i],
+                tilingIndex[i]);
+
+            vertexBufferDataPtr++;
+        }
+
+        _vertexCount[1 - _frontVertexData] = static_cast<uint32>(vertexBufferDataPtr - vertexData.data());
+    }
 
+    void iParticleSystem::updateVertexArray()
+    {
+        if (_createBuffers)
+        {
             _vertexBuffer = iVertexBuffer::create(_maxParticleCount * 4 * sizeof(iParticleVertex));
             _vertexBuffer->setLayout(
                 std::vector<iBufferLayoutEntry>{
@@ -523,35 +642,23 @@ namespace igor
             _vertexArray->addVertexBuffer(_vertexBuffer);
 
             _createBuffers = false;
+            _uploadVertexData = true;
         }
 
-        // update buffer data
-        iParticleVertex *vertexBufferDataPtr = _vertexBufferData;
-
-        for (const auto &particle : _particlePool)
+        if (!_uploadVertexData)
         {
-            if (particle._lifeLeft <= 0.0)
-            {
-                continue;
-            }
-
-            const float32 normalizedAge = particle._lifeLeft / particle._maxAge;
-            const float32 age = particle._maxAge - particle._lifeLeft;
-
-            vertexBufferDataPtr->_position = particle._position;
-            vertexBufferDataPtr->_color = _colorGradient.getValue(normalizedAge);
-            vertexBufferDataPtr->_velocity = particle._velocity;
-            vertexBufferDataPtr->_lifeSizeAngleTilingIndex.set(
-                age,
-                particle._size * particle._sizeScale,
-                particle._orientation,
-                particle._tilingIndex);
-
-            vertexBufferDataPtr++;
+            return;
         }
 
-        uint32 dataSize = (uint32)((uint8 *)vertexBufferDataPtr - (uint8 *)_vertexBufferData);
-        _vertexBuffer->setData(dataSize, _vertexBufferData);
+        // the front data might still be from before the particle count changed
+        const uint32 vertexCount = std::min(_vertexCount[_frontVertexData], static_cast<uint32>(_maxParticleCount) * 4);
+        _vertexBuffer->setData(vertexCount * sizeof(iParticleVertex), _vertexData[_frontVertexData].data());
+        _uploadVertexData = false;
+    }
+
+    uint32 iParticleSystem::getVisibleParticleCount() const
+    {
+        return _vertexCount[_frontVertexData];
     }
 
     iVertexArrayPtr iParticleSystem::getVertexArray() const
@@ -561,61 +668,42 @@ namespace igor
 
     void iParticleSystem::updateBoundings()
     {
-        // TODO
-        if (_particlePool.empty())
+        const uint32 particleCount = _particlePool.getParticleCount();
+        if (particleCount == 0)
         {
             return;
         }
 
-        iaVector3f minPos = _particlePool.front()._position;
-        iaVector3f maxPos = _particlePool.front()._position;
-        uint32 steps = std::min(_maxParticleCount / 20, 1);
-
-        for (int i = 0; i < _particlePool.size(); i += steps)
-        {
-            if (_particlePool[i]._position._x < minPos._x)
-            {
-                minPos._x = _particlePool[i]._position._x;
-            }
-
-            if (_particlePool[i]._position._y < minPos._y)
-            {
-                minPos._y = _particlePool[i]._position._y;
-            }
-
-            if (_particlePool[i]._position._z < minPos._z)
-            {
-                minPos._z = _particlePool[i]._position._z;
-            }
+        const float32 *positionX = _particlePool.getPositionX();
+        const float32 *positionY = _particlePool.getPositionY();
+        const float32 *positionZ = _particlePool.getPositionZ();
 
-            if (_particlePool[i]._position._x > maxPos._x)
-            {
-                maxPos._x = _particlePool[i]._position._x;
-            }
+        iaVector3f minPos(positionX[0], positionY[0], positionZ[0]);
+        iaVector3f maxPos = minPos;
 
-            if (_particlePool[i]._position._y > maxPos._y)
-            {
-                maxPos._y = _particlePool[i]._position._y;
-            }
-            if (_particlePool[i]._position._z > maxPos._z)
-            {
-                maxPos._z = _particlePool[i]._position._z;
-            }
+        for (uint32 i = 1; i < particleCount; ++i)
+        {
+            minPos._x = std::min(minPos._x, positionX[i]);
+            minPos._y = std::min(minPos._y, positionY[i]);
+            minPos._z = std::min(minPos._z, positionZ[i]);
+            maxPos._x = std::max(maxPos._x, positionX[i]);
+            maxPos._y = std::max(maxPos._y, positionY[i]);
+            maxPos._z = std::max(maxPos._z, positionZ[i]);
         }
 
         iaVector3d minPosd = minPos.convert<float64>();
         iaVector3d maxPosd = maxPos.convert<float64>();
 
-        _boundingBox._center = minPosd;
-        _boundingBox._center += maxPosd;
-        _boundingBox._center *= 0.5;
+        _simulationBoundingBox._center = minPosd;
+        _simulationBoundingBox._center += maxPosd;
+        _simulationBoundingBox._center *= 0.5;
 
-        _boundingBox._halfWidths = maxPosd;
-        _boundingBox._halfWidths -= minPosd;
-        _boundingBox._halfWidths *= 0.5;
+        _simulationBoundingBox._halfWidths = maxPosd;
+        _simulationBoundingBox._halfWidths -= minPosd;
+        _simulationBoundingBox._halfWidths *= 0.5;
 
-        _boundingSphere._center = _boundingBox._center;
-        _boundingSphere._radius = std::max(_boundingBox._halfWidths._x, std::max(_boundingBox._halfWidths._y, _boundingBox._halfWidths._z));
+        _simulationBoundingSphere._center = _simulationBoundingBox._center;
+        _simulationBoundingSphere._radius = std::max(_simulationBoundingBox._halfWidths._x, std::max(_simulationBoundingBox._halfWidths._y, _simulationBoundingBox._halfWidths._z));
     }
 
     float32 iParticleSystem::getSimulationRate()
@@ -625,6 +713,8 @@ namespace igor
 
     void iParticleSystem::setStartSizeGradient(const iaKeyFrameGraphVector2f &sizeGradient)
     {
+        waitForUpdate();
+
         _startSizeGradient = sizeGradient;
         _mustReset = true;
     }
@@ -636,6 +726,8 @@ namespace igor
 
     void iParticleSystem::setStartVelocityGradient(const iaKeyFrameGraphVector2f &velocityGradient)
     {
+        waitForUpdate();
+
         _startVelocityGradient = velocityGradient;
         _mustReset = true;
     }
@@ -647,6 +739,8 @@ namespace igor
 
     void iParticleSystem::setStartLiftGradient(const iaKeyFrameGraphVector2f &liftGradient)
     {
+        waitForUpdate();
+
         _startLiftGradient = liftGradient;
         _mustReset = true;
     }
@@ -658,7 +752,10 @@ namespace igor
 
     void iParticleSystem::setAirDrag(float32 airDrag)
     {
+        waitForUpdate();
+
         _airDrag = airDrag;
+        _particlePool.setAirDrag(_airDrag);
         _mustReset = true;
     }
 
@@ -669,6 +766,8 @@ namespace igor
 
     void iParticleSystem::setStartOrientationGradient(const iaKeyFrameGraphVector2f &orientationGradient)
     {
+        waitForUpdate();
+
         _startOrientationGradient = orientationGradient;
         _mustReset = true;
     }
@@ -680,6 +779,8 @@ namespace igor
 
     void iParticleSystem::setStartOrientationRateGradient(const iaKeyFrameGraphVector2f &orientationRateGradient)
     {
+        waitForUpdate();
+
         _startOrientationRateGradient = orientationRateGradient;
         _mustReset = true;
     }
@@ -691,13 +792,19 @@ namespace igor
 
     void iParticleSystem::setVorticityConfinement(float32 vc)
     {
+        waitForUpdate();
+
         _vorticityConfinement = vc;
+        _particlePool.setVorticityConfinement(_vorticityConfinement);
         _mustReset = true;
     }
 
     void iParticleSystem::setTileIncrement(float32 tileIncrement)
     {
+        waitForUpdate();
+
         _tileIncrement = tileIncrement;
+        _particlePool.setTileIncrement(_tileIncrement);
     }
 
     float32 iParticleSystem::getTileIncrement() const
@@ -31,6 +31,9 @@
 
 #include <iaux/data/iaKeyFrameGraph.h>
 #include <igor/data/iAABox.h>
+#include <igor/simulation/iParticlePool.h>
+#include <igor/simulation/iParticleEmitter.h>
+#include <igor/threading/tasks/iTask.h>
 #include <igor/renderer/buffers/iVertexArray.h>
 
 #include <iaux/data/iaSphere.h>
@@ -47,84 +50,21 @@ using namespace iaux;
 namespace igor
 {
 
-    class iParticleEmitter;
-
-    /*! single particle
-     */
-    struct IGOR_API iParticle
-    {
-        /*! position of particle
-         */
-        iaVector3f _position;
-
-        /*! velocity of particle
-         */
-        iaVector3f _velocity;
-
-        /*! life left of particle in seconds
-         */
-        float32 _lifeLeft = 0.0;
-
-        /*! max age of particle
-        */
-        float32 _maxAge = 0.0;        
-
-        /*! current lift value
-
-        depending on the coordinate system this is used in 
-        a positive value can be interpreted as lift or weight
-        */
-        float32 _lift = 0.0;
-
-        /*! size of the particle given at birth
-         */
-        float32 _size = 1.0;
-
-        /*! size scale changes during life time of particle
-         */
-        float32 _sizeScale = 1.0;
-
-        /*! orientation angle of particle in rad
-         */
-        float32 _orientation = 0.0;
-
-        /*! orientation / rotation rate in rad per frame
-         */
-        float32 _orientationRate = 0.0;
-
-        /*! if particle is actually visible
-         */
-        bool _visible = true;
-
-        /*! tiling index of this particle
-        */
-        float32 _tilingIndex = 0;
-
-        /*! if particle is a vortex particle it will rotate around this axis
-         */
-        iaVector3f _normal;
-
-        /*! the torque the vortex particle is rotating the other particles with
-
-        if value is zero it's not a vortex particle
-        */
-        float32 _torque = 0;
-
-        /*! the range the vortex has an effect on other particles
-         */
-        float32 _vortexRange = 0;
-    };
-
     /*! simulation of 3d particle systems
 
+    the simulation can run synchronously using onUpdate or on a worker of the task manager using startUpdate and
+    finishUpdate. Either way the simulation fills a back vertex buffer which gets swapped with the front vertex buffer
+    once the update is finished. So rendering always uses the result of the last finished update without locking
+
     \todo rotation of noise textures
-    \todo particle simulation should be parallel to rendering
     \todo maybe we put all particles together in one global particles pool. than we can sort them and we can have global effects like shadowing etc. on each other
     \todo would be nice to be able to show tiles sequencially and not just random aka animated texture
     */
     class IGOR_API iParticleSystem
     {
 
+        friend class iTaskUpdateParticleSystem;
+
     public:
         /*! init default values
          */
@@ -268,12 +208,45 @@ namespace igor
          */
         float32 getVortexToParticleRate() const;
 
-        /*! calculates next frame
+        /*! calculates next frame synchronously
 
         \param emitter the emitter to emitt particles from
         */
         void onUpdate(iParticleEmitter &emitter);
 
+        /*! starts calculating the next frame on a worker thread
+
+        does nothing if there is an update in progress already. Runs synchronously if the task manager has no
+        regular threads. Must be called from the main thread
+
+        \param emitter the emitter to emitt particles from. A snapshot of it is taken so it can change afterwards
+        */
+        void startUpdate(const iParticleEmitter &emitter);
+
+        /*! applies the result of the update started last if it is finished
+
+        Must be called from the main thread
+
+        \returns true if a result was applied
+        */
+        bool finishUpdate();
+
+        /*! waits for the update in progress to finish and applies its result
+
+        Must be called from the main thread
+        */
+        void waitForUpdate();
+
+        /*! uploads the front vertex buffer if it changed since the last upload
+
+        Must be called from the render thread
+        */
+        void updateVertexArray();
+
+        /*! \returns count of particles in front vertex buffer
+         */
+        uint32 getVisibleParticleCount() const;
+
         /*! sets vorticity confinement force
 
         \param vorticityConfinement the vorticity confinement force
@@ -540,6 +513,30 @@ namespace igor
          */
         iaMatrixd _particleSystemInvWorldMatrix;
 
+        /*! inverse of particle system coordinate system used by the update in progress
+         */
+        iaMatrixd _simulationInvWorldMatrix;
+
+        /*! snapshot of the emitter used by the update in progress
+         */
+        iParticleEmitter _emitter;
+
+        /*! id of the update task in progress
+         */
+        iTaskID _updateTaskID = iTask::INVALID_TASK_ID;
+
+        /*! set by the update if the period of the particle system elapsed
+         */
+        bool _periodElapsed = false;
+
+        /*! bounding box calculated by the update
+         */
+        iAABoxd _simulationBoundingBox;
+
+        /*! bounding sphere calculated by the update
+         */
+        iaSphered _simulationBoundingSphere;
+
         /*! works like a dirty flag. if true all is set to beginning
          */
         bool _mustReset = true;
@@ -656,7 +653,11 @@ namespace igor
 
         /*! particle pool
          */
-        std::vector<iParticle> _particlePool;
+        iParticlePool _particlePool;
+
+        /*! color gradient baked in to a lookup table
+         */
+        iParticleLookupTable<iaColor4f> _colorTable;
 
         /*! next particle in pool
         */
@@ -695,9 +696,21 @@ namespace igor
             iaVector4f _lifeSizeAngleTilingIndex;
         };
 
-        /*! vertex buffer data
+        /*! front and back vertex buffer data
+        */
+        std::vector<iParticleVertex> _vertexData[2];
+
+        /*! count of vertices in front and back vertex buffer data
+        */
+        uint32 _vertexCount[2] = {0, 0};
+
+        /*! index of the front vertex buffer data
         */
-        iParticleVertex *_vertexBufferData = nullptr;
+        uint32 _frontVertexData = 0;
+
+        /*! if true the front vertex buffer data needs to be uploaded
+        */
+        bool _uploadVertexData = false;
 
         /*! if true vertex buffer needs to be recreated
          */
@@ -707,11 +720,25 @@ namespace igor
          */
         void iterateFrame();
 
+        /*! simulates frames up to given time and fills back vertex buffer data
+
+        does not touch anything the main thread reads while an update is in progress
+
+        \param frameTime the time to simulate up to
+        */
+        void simulate(const iaTime &frameTime);
+
+        /*! swaps vertex buffer data and applies the other results of the last update
+
+        Must be called from the main thread
+        */
+        void applyUpdate();
+
         /*! update boundings
          */
         void updateBoundings();
 
-        /*! update buffers
+        /*! fills back vertex buffer data
          */
         void updateBuffer();
 
@@ -143,9 +143,8 @@ namespace igor
         iNodeManager::getInstance().onUpdate();
         IGOR_PROFILER_END(nodes);
 
-        IGOR_PROFILER_BEGIN(physics);
+        // profiles itself
         iPhysics::getInstance().handle();
-        IGOR_PROFILER_END(physics);
 
         draw();
     }
@@ -0,0 +1,329 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/terrain/data/iVoxelBlockCache.h>
+
+#include <iaux/data/iaSerializable.h>
+#include <iaux/system/iaDirectory.h>
+#include <iaux/system/iaFile.h>
+#include <iaux/system/iaConsole.h>
+using namespace iaux;
+
+#include <fstream>
+
+namespace igor
+{
+
+    /*! magic number at the beginning of every block file "IVBC"
+    */
+    static const uint32 VOXEL_BLOCK_FILE_MAGIC = 0x43425649;
+
+    /*! version of the block file format
+    */
+    static const uint8 VOXEL_BLOCK_FILE_VERSION = 1;
+
+    iVoxelBlockCache::iVoxelBlockCache(const iaString &directory, uint64 memoryBudget)
+        : _directory(directory), _memoryBudget(memoryBudget)
+    {
+        if (!iaDirectory::exists(_directory))
+        {
+            iaDirectory::makeDirectory(_directory);
+        }
+    }
+
+    iVoxelBlockCache::~iVoxelBlockCache()
+    {
+        clearMemory();
+    }
+
+    iaString iVoxelBlockCache::getFilename(const Key &key) const
+    {
+        return _directory + IGOR_PATHSEPARATOR + iaString::toString(key._lod) + IGOR_PATHSEPARATOR +
+               iaString::toString(key._positionInLOD._x) + "_" + iaString::toString(key._positionInLOD._y) + "_" + iaString::toString(key._positionInLOD._z) + ".voxels";
+    }
+
+    bool iVoxelBlockCache::load(uint32 lod, const iaVector3I &positionInLOD, iVoxelData &voxelData, bool &transition)
+    {
+        const Key key = {lod, positionInLOD};
+        const iVoxelStorage storage = voxelData.getStorage();
+
+        _mutex.lock();
+        auto iter = _entries.find(key);
+        if (iter != _entries.end())
+        {
+            Entry &entry = iter->second;
+            _lru.splice(_lru.begin(), _lru, entry._lruIter);
+
+            transition = entry._voxelData != nullptr;
+            if (transition)
+            {
+                entry._voxelData->getCopy(voxelData);
+                voxelData.setStorage(storage);
+            }
+
+            _memoryHits++;
+            _mutex.unlock();
+            return true;
+        }
+        _mutex.unlock();
+
+        std::unique_ptr<iVoxelData> cached = std::make_unique<iVoxelData>();
+        if (!readFile(key, *cached, transition))
+        {
+            _mutex.lock();
+            _misses++;
+            _mutex.unlock();
+            return false;
+        }
+
+        if (transition)
+        {
+            cached->getCopy(voxelData);
+            voxelData.setStorage(storage);
+        }
+        else
+        {
+            cached.reset();
+        }
+
+        _mutex.lock();
+        _diskHits++;
+        insert(key, std::move(cached));
+        _mutex.unlock();
+
+        return true;
+    }
+
+    void iVoxelBlockCache::store(uint32 lod, const iaVector3I &positionInLOD, iVoxelData &voxelData, bool transition)
+    {
+        const Key key = {lod, positionInLOD};
+
+        std::unique_ptr<iVoxelData> cached;
+        if (transition)
+        {
+            cached = std::make_unique<iVoxelData>();
+            voxelData.getCopy(*cached);
+            cached->setStorage(iVoxelStorage::RLE);
+        }
+
+        if (!writeFile(key, cached.get()))
+        {
+            con_err("can't write voxel block to \"" << getFilename(key) << "\"");
+        }
+
+        _mutex.lock();
+        insert(key, std::move(cached));
+        _mutex.unlock();
+    }
+
+    void iVoxelBlockCache::remove(uint32 lod, const iaVector3I &positionInLOD)
+    {
+        const Key key = {lod, positionInLOD};
+
+        _mutex.lock();
+        auto iter = _entries.find(key);
+        if (iter != _entries.end())
+        {
+            _memoryUsage -= iter->second._memoryUsage;
+            _lru.erase(iter->second._lruIter);
+            _entries.erase(iter);
+        }
+
+        iaFile::remove(getFilename(key));
+        _mutex.unlock();
+    }
+
+    void iVoxelBlockCache::insert(const Key &key, std::unique_ptr<iVoxelData> voxelData)
+    {
+        Entry &entry = _entries[key];
+
+        if (entry._memoryUsage == 0)
+        {
+            _lru.push_front(key);
+            entry._lruIter = _lru.begin();
+        }
+        else
+        {
+            _memoryUsage -= entry._memoryUsage;
+            _lru.splice(_lru.begin(), _lru, entry._lruIter);
+        }
+
+        entry._memoryUsage = sizeof(Entry) + sizeof(Key);
+        if (voxelData != nullptr)
+        {
+            entry._memoryUsage += voxelData->getMemoryUsage();
+        }
+
+        entry._voxelData = std::move(voxelData);
+        _memoryUsage += entry._memoryUsage;
+
+        evict();
+    }
+
+    void iVoxelBlockCache::evict()
+    {
+        // the most recent block stays even if it exceeds the budget on it's own
+        while (_memoryUsage > _memoryBudget && _lru.size() > 1)
+        {
+            auto iter = _entries.find(_lru.back());
+            con_assert(iter != _entries.end(), "inconsistent cache");
+
+            _memoryUsage -= iter->second._memoryUsage;
+            _entries.erase(iter);
+            _lru.pop_back();
+        }
+    }
+
+    void iVoxelBlockCache::clearMemory()
+    {
+        _mutex.lock();
+        _entries.clear();
+        _lru.clear();
+        _memoryUsage = 0;
+        _mutex.unlock();
+    }
+
+    bool iVoxelBlockCache::writeFile(const Key &key, const iVoxelData *voxelData) const
+    {
+        const iaString lodDirectory = _directory + IGOR_PATHSEPARATOR + iaString::toString(key._lod);
+
+        _mutex.lock();
+        if (!iaDirectory::exists(lodDirectory))
+        {
+            iaDirectory::makeDirectory(lodDirectory);
+        }
+        _mutex.unlock();
+
+        char temp[2048];
+        getFilename(key).getData(temp, 2048);
+
+        std::ofstream stream;
+        stream.open(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        if (!iaSerializable::writeUInt32(stream, VOXEL_BLOCK_FILE_MAGIC) ||
+            !iaSerializable::writeUInt8(stream, VOXEL_BLOCK_FILE_VERSION) ||
+            !iaSerializable::writeUInt8(stream, voxelData != nullptr ? 1 : 0))
+        {
+            return false;
+        }
+
+        if (voxelData != nullptr &&
+            !voxelData->write(stream))
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    bool iVoxelBlockCache::readFile(const Key &key, iVoxelData &voxelData, bool &transition) const
+    {
+        const iaString filename = getFilename(key);
+
+        char temp[2048];
+        filename.getData(temp, 2048);
+
+        std::ifstream stream;
+        stream.open(temp, std::ios::in | std::ios::binary);
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        uint32 magic = 0;
+        uint8 version = 0;
+        uint8 hasTransition = 0;
+
+        bool result = iaSerializable::readUInt32(stream, magic) &&
+                      iaSerializable::readUInt8(stream, version) &&
+                      iaSerializable::readUInt8(stream, hasTransition) &&
+                      magic == VOXEL_BLOCK_FILE_MAGIC &&
+                      version == VOXEL_BLOCK_FILE_VERSION;
+
+        transition = hasTransition != 0;
+
+        if (result && transition)
+        {
+            result = voxelData.read(stream);
+        }
+
+        if (!result)
+        {
+            // treat as not cached so the block gets generated and stored again
+            con_warn("invalid voxel block file \"" << filename << "\"");
+            stream.close();
+            iaFile::remove(filename);
+        }
+
+        return result;
+    }
+
+    void iVoxelBlockCache::setMemoryBudget(uint64 memoryBudget)
+    {
+        _mutex.lock();
+        _memoryBudget = memoryBudget;
+        evict();
+        _mutex.unlock();
+    }
+
+    uint64 iVoxelBlockCache::getMemoryBudget() const
+    {
+        return _memoryBudget;
+    }
+
+    uint64 iVoxelBlockCache::getMemoryUsage() const
+    {
+        _mutex.lock();
+        const uint64 result = _memoryUsage;
+        _mutex.unlock();
+
+        return result;
+    }
+
+    uint64 iVoxelBlockCache::getBlockCount() const
+    {
+        _mutex.lock();
+        const uint64 result = _entries.size();
+        _mutex.unlock();
+
+        return result;
+    }
+
+    const iaString &iVoxelBlockCache::getDirectory() const
+    {
+        return _directory;
+    }
+
+    uint64 iVoxelBlockCache::getMemoryHits() const
+    {
+        _mutex.lock();
+        const uint64 result = _memoryHits;
+        _mutex.unlock();
+
+        return result;
+    }
+
+    uint64 iVoxelBlockCache::getDiskHits() const
+    {
+        _mutex.lock();
+        const uint64 result = _diskHits;
+        _mutex.unlock();
+
+        return result;
+    }
+
+    uint64 iVoxelBlockCache::getMisses() const
+    {
+        _mutex.lock();
+        const uint64 result = _misses;
+        _mutex.unlock();
+
+        return result;
+    }
+
+} // namespace igor
@@ -0,0 +1,248 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_VOXELBLOCKCACHE__
+#define __IGOR_VOXELBLOCKCACHE__
+
+#include <igor/terrain/data/iVoxelData.h>
+#include <igor/terrain/data/iVoxelBlockMap.h>
+
+#include <iaux/data/iaString.h>
+#include <iaux/math/iaVector3.h>
+#include <iaux/system/iaMutex.h>
+using namespace iaux;
+
+#include <unordered_map>
+#include <list>
+#include <memory>
+
+namespace igor
+{
+
+    /*! persistent cache for generated voxel blocks
+
+    Blocks are addressed by lod and position in lod. Every stored block is written run length encoded to
+    <directory>/<lod>/<x>_<y>_<z>.voxels so revisits and restarts can load it instead of generating it again.
+    In addition the most recently used blocks are kept in memory up to a memory budget.
+
+    Blocks without air to solid transition are cached too. They only cost a few bytes and are the most common ones.
+
+    thread safe so it can be used from the voxel generation tasks
+    */
+    class IGOR_API iVoxelBlockCache
+    {
+
+    public:
+        /*! initializes cache
+
+        \param directory the directory to store the blocks in. Will be created if it does not exist
+        \param memoryBudget max memory in bytes used for blocks kept in memory
+        */
+        iVoxelBlockCache(const iaString &directory, uint64 memoryBudget = 64 * 1024 * 1024);
+
+        /*! releases blocks kept in memory
+        */
+        ~iVoxelBlockCache();
+
+        /*! loads block from cache
+
+        \param lod the level of detail of the block
+        \param positionInLOD position of the block in lod
+        \param[out] voxelData the destination voxel data. Keeps it's storage backend
+        \param[out] transition true if the block contains an air to solid transition. If not voxelData is untouched
+        \returns true if the block was in the cache
+        */
+        bool load(uint32 lod, const iaVector3I &positionInLOD, iVoxelData &voxelData, bool &transition);
+
+        /*! stores block in memory and on disk
+
+        \param lod the level of detail of the block
+        \param positionInLOD position of the block in lod
+        \param voxelData the voxel data to store. Ignored if there is no transition
+        \param transition true if the block contains an air to solid transition
+        */
+        void store(uint32 lod, const iaVector3I &positionInLOD, iVoxelData &voxelData, bool transition);
+
+        /*! removes block from memory and disk
+
+        \param lod the level of detail of the block
+        \param positionInLOD position of the block in lod
+        */
+        void remove(uint32 lod, const iaVector3I &positionInLOD);
+
+        /*! releases all blocks kept in memory. Blocks on disk stay untouched
+        */
+        void clearMemory();
+
+        /*! sets memory budget for blocks kept in memory
+
+        \param memoryBudget the budget in bytes
+        */
+        void setMemoryBudget(uint64 memoryBudget);
+
+        /*! \returns memory budget for blocks kept in memory in bytes
+        */
+        uint64 getMemoryBudget() const;
+
+        /*! \returns memory used by blocks kept in memory in bytes
+        */
+        uint64 getMemoryUsage() const;
+
+        /*! \returns count of blocks kept in memory
+        */
+        uint64 getBlockCount() const;
+
+        /*! \returns directory blocks are stored in
+        */
+        const iaString &getDirectory() const;
+
+        /*! \returns count of loads served from memory
+        */
+        uint64 getMemoryHits() const;
+
+        /*! \returns count of loads served from disk
+        */
+        uint64 getDiskHits() const;
+
+        /*! \returns count of loads that did not find the block
+        */
+        uint64 getMisses() const;
+
+    private:
+        /*! cache key
+        */
+        struct Key
+        {
+            uint32 _lod;
+            iaVector3I _positionInLOD;
+
+            bool operator==(const Key &other) const
+            {
+                return _lod == other._lod && _positionInLOD == other._positionInLOD;
+            }
+        };
+
+        /*! cache key hasher
+        */
+        class KeyHasher
+        {
+        public:
+            size_t operator()(const Key &key) const
+            {
+                // same position hash the lod maps use. The lod goes in to the top bits morton codes of realistic positions don't reach
+                return static_cast<size_t>(iVoxelBlockMap::calcHash(key._positionInLOD) ^ (static_cast<uint64>(key._lod) << 59));
+            }
+        };
+
+        /*! block kept in memory
+        */
+        struct Entry
+        {
+            /*! the voxel data in RLE storage. nullptr if there is no transition
+            */
+            std::unique_ptr<iVoxelData> _voxelData;
+
+            /*! memory used by this entry
+            */
+            uint64 _memoryUsage = 0;
+
+            /*! position in lru list
+            */
+            std::list<Key>::iterator _lruIter;
+        };
+
+        /*! the directory to store blocks in
+        */
+        iaString _directory;
+
+        /*! blocks kept in memory
+        */
+        std::unordered_map<Key, Entry, KeyHasher> _entries;
+
+        /*! keys of blocks kept in memory. Most recently used first
+        */
+        std::list<Key> _lru;
+
+        /*! memory budget in bytes
+        */
+        uint64 _memoryBudget = 0;
+
+        /*! memory used in bytes
+        */
+        uint64 _memoryUsage = 0;
+
+        /*! statistics
+        */
+        uint64 _memoryHits = 0;
+        uint64 _diskHits = 0;
+        uint64 _misses = 0;
+
+        /*! protects entries and statistics
+        */
+        mutable iaMutex _mutex;
+
+        /*! \returns filename of given block
+        */
+        iaString getFilename(const Key &key) const;
+
+        /*! adds or replaces block in memory and evicts least recently used blocks if above budget
+
+        \param key the block key
+        \param voxelData the voxel data in RLE storage or nullptr
+        */
+        void insert(const Key &key, std::unique_ptr<iVoxelData> voxelData);
+
+        /*! evicts least recently used blocks until memory usage is within budget
+        */
+        void evict();
+
+        /*! writes block to disk
+
+        \param key the block key
+        \param voxelData the voxel data or nullptr
+        \returns true if successful
+        */
+        bool writeFile(const Key &key, const iVoxelData *voxelData) const;
+
+        /*! reads block from disk
+
+        \param key the block key
+        \param[out] voxelData the voxel data. Only valid if there is a transition
+        \param[out] transition true if the block contains an air to solid transition
+        \returns true if successful
+        */
+        bool readFile(const Key &key, iVoxelData &voxelData, bool &transition) const;
+    };
+
+    /*! voxel block cache pointer definition
+    */
+    typedef std::shared_ptr<iVoxelBlockCache> iVoxelBlockCachePtr;
+
+} // namespace igor
+
+#endif // __IGOR_VOXELBLOCKCACHE__
@@ -0,0 +1,161 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/terrain/data/iVoxelBlockMap.h>
+
+#include <iaux/system/iaConsole.h>
+using namespace iaux;
+
+namespace igor
+{
+
+    /*! initial count of slots
+    */
+    static const uint64 VOXEL_BLOCK_MAP_MIN_SLOTS = 64;
+
+    iVoxelBlockMap::Iterator::Iterator(const Slot *slot, const Slot *end)
+        : _slot(slot), _end(end)
+    {
+        skipEmpty();
+    }
+
+    iVoxelBlock *iVoxelBlockMap::Iterator::operator*() const
+    {
+        return _slot->_block;
+    }
+
+    iVoxelBlockMap::Iterator &iVoxelBlockMap::Iterator::operator++()
+    {
+        ++_slot;
+        skipEmpty();
+        return *this;
+    }
+
+    bool iVoxelBlockMap::Iterator::operator!=(const Iterator &other) const
+    {
+        return _slot != other._slot;
+    }
+
+    void iVoxelBlockMap::Iterator::skipEmpty()
+    {
+        while (_slot != _end && _slot->_block == nullptr)
+        {
+            ++_slot;
+        }
+    }
+
+    iVoxelBlockMap::iVoxelBlockMap()
+    {
+        rehash(VOXEL_BLOCK_MAP_MIN_SLOTS);
+    }
+
+    void iVoxelBlockMap::insert(const iaVector3I &position, iVoxelBlock *block)
+    {
+        con_assert(block != nullptr, "zero pointer");
+
+        // keep load factor below 70%
+        if ((_size + 1) * 10 > _slots.size() * 7)
+        {
+            rehash(_slots.size() * 2);
+        }
+
+        uint64 index = calcSlot(position);
+        while (_slots[index]._block != nullptr)
+        {
+            if (_slots[index]._position == position)
+            {
+                _slots[index]._block = block;
+                return;
+            }
+
+            index = (index + 1) & _mask;
+        }
+
+        _slots[index]._position = position;
+        _slots[index]._block = block;
+        _size++;
+    }
+
+    bool iVoxelBlockMap::erase(const iaVector3I &position)
+    {
+        uint64 index = calcSlot(position);
+        while (true)
+        {
+            if (_slots[index]._block == nullptr)
+            {
+                return false;
+            }
+
+            if (_slots[index]._position == position)
+            {
+                break;
+            }
+
+            index = (index + 1) & _mask;
+        }
+
+        // backward shift deletion. Move every following block of the cluster that would not be found anymore in to the gap
+        uint64 gap = index;
+        uint64 next = (gap + 1) & _mask;
+        while (_slots[next]._block != nullptr)
+        {
+            const uint64 home = calcSlot(_slots[next]._position);
+
+            // distance from home to next must be at least the distance from gap to next
+            if (((next - home) & _mask) >= ((next - gap) & _mask))
+            {
+                _slots[gap] = _slots[next];
+                gap = next;
+            }
+
+            next = (next + 1) & _mask;
+        }
+
+        _slots[gap]._block = nullptr;
+        _size--;
+
+        return true;
+    }
+
+    void iVoxelBlockMap::clear()
+    {
+        _slots.clear();
+        _size = 0;
+        rehash(VOXEL_BLOCK_MAP_MIN_SLOTS);
+    }
+
+    uint64 iVoxelBlockMap::size() const
+    {
+        return _size;
+    }
+
+    iVoxelBlockMap::Iterator iVoxelBlockMap::begin() const
+    {
+        return Iterator(_slots.data(), _slots.data() + _slots.size());
+    }
+
+    iVoxelBlockMap::Iterator iVoxelBlockMap::end() const
+    {
+        return Iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size());
+    }
+
+    void iVoxelBlockMap::rehash(uint64 slotCount)
+    {
+        con_assert((slotCount & (slotCount - 1)) == 0, "slot count must be a power of two");
+
+        std::vector<Slot> oldSlots(slotCount);
+        oldSlots.swap(_slots);
+        _mask = slotCount - 1;
+        _size = 0;
+
+        for (const auto &slot : oldSlots)
+        {
+            if (slot._block != nullptr)
+            {
+                insert(slot._position, slot._block);
+            }
+        }
+    }
+
+} // namespace igor
@@ -0,0 +1,192 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_VOXELBLOCKMAP__
+#define __IGOR_VOXELBLOCKMAP__
+
+#include <igor/iDefines.h>
+
+#include <iaux/math/iaVector3.h>
+using namespace iaux;
+
+#include <vector>
+
+namespace igor
+{
+
+    struct iVoxelBlock;
+
+    /*! maps voxel block positions of one LOD to voxel blocks
+
+    open addressing hash map with linear probing. The slot is addressed by the morton code of the position so
+    neighbouring blocks end up in neighbouring slots and a dense region of blocks fills the table without collisions.
+    Removing blocks uses backward shift deletion so there are no tombstones.
+    */
+    class IGOR_API iVoxelBlockMap
+    {
+
+    public:
+        /*! slot of map
+        */
+        struct Slot
+        {
+            /*! position of block
+            */
+            iaVector3I _position;
+
+            /*! the block. nullptr if slot is empty
+            */
+            iVoxelBlock *_block = nullptr;
+        };
+
+        /*! iterates over all blocks in the map
+
+        any insert or erase invalidates the iterator
+        */
+        class Iterator
+        {
+
+        public:
+            /*! init iterator
+
+            \param slot current slot
+            \param end end of slots
+            */
+            Iterator(const Slot *slot, const Slot *end);
+
+            /*! \returns current block
+            */
+            iVoxelBlock *operator*() const;
+
+            /*! steps to next block
+            */
+            Iterator &operator++();
+
+            /*! \returns true if iterators are not equal
+            */
+            bool operator!=(const Iterator &other) const;
+
+        private:
+            /*! current slot
+            */
+            const Slot *_slot;
+
+            /*! end of slots
+            */
+            const Slot *_end;
+
+            /*! skips empty slots
+            */
+            void skipEmpty();
+        };
+
+        /*! init empty map
+        */
+        iVoxelBlockMap();
+
+        /*! \returns block at given position or nullptr if not found
+
+        \param position the position of the block
+        */
+        IGOR_INLINE iVoxelBlock *find(const iaVector3I &position) const;
+
+        /*! inserts block or replaces block at same position
+
+        \param position the position of the block
+        \param block the block (not nullptr)
+        */
+        void insert(const iaVector3I &position, iVoxelBlock *block);
+
+        /*! removes block
+
+        \param position the position of the block
+        \returns true if block was found
+        */
+        bool erase(const iaVector3I &position);
+
+        /*! removes all blocks
+        */
+        void clear();
+
+        /*! \returns count of blocks in map
+        */
+        uint64 size() const;
+
+        /*! \returns iterator to first block
+        */
+        Iterator begin() const;
+
+        /*! \returns iterator behind last block
+        */
+        Iterator end() const;
+
+        /*! \returns morton code of given position
+
+        interleaves the lower 21 bits of every component
+        */
+        IGOR_INLINE static uint64 calcMortonCode(const iaVector3I &position);
+
+        /*! \returns hash of given position
+
+        the morton code with the bits beyond 21 bits mixed in
+        */
+        IGOR_INLINE static uint64 calcHash(const iaVector3I &position);
+
+    private:
+        /*! the slots. Count is always a power of two
+        */
+        std::vector<Slot> _slots;
+
+        /*! count of slots minus one
+        */
+        uint64 _mask = 0;
+
+        /*! count of blocks
+        */
+        uint64 _size = 0;
+
+        /*! \returns the lower 21 bits of value spread out so there are two zero bits between each of them
+        */
+        IGOR_INLINE static uint64 spreadBits(uint64 value);
+
+        /*! \returns home slot of given position
+        */
+        IGOR_INLINE uint64 calcSlot(const iaVector3I &position) const;
+
+        /*! resizes the slots and reinserts all blocks
+
+        \param slotCount the new slot count (power of two)
+        */
+        void rehash(uint64 slotCount);
+    };
+
+#include <igor/terrain/data/iVoxelBlockMap.inl>
+
+} // namespace igor
+
+#endif // __IGOR_VOXELBLOCKMAP__
@@ -0,0 +1,54 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+IGOR_INLINE uint64 iVoxelBlockMap::spreadBits(uint64 value)
+{
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+}
+
+IGOR_INLINE uint64 iVoxelBlockMap::calcMortonCode(const iaVector3I &position)
+{
+    return spreadBits(static_cast<uint64>(position._x)) |
+           (spreadBits(static_cast<uint64>(position._y)) << 1) |
+           (spreadBits(static_cast<uint64>(position._z)) << 2);
+}
+
+IGOR_INLINE uint64 iVoxelBlockMap::calcHash(const iaVector3I &position)
+{
+    // positions beyond 21 bits still need to end up in different slots
+    const uint64 high = static_cast<uint64>((position._x >> 21) ^ ((position._y >> 21) << 21) ^ ((position._z >> 21) << 42));
+    return calcMortonCode(position) ^ (high * 0x9e3779b97f4a7c15ull);
+}
+
+IGOR_INLINE uint64 iVoxelBlockMap::calcSlot(const iaVector3I &position) const
+{
+    return calcHash(position) & _mask;
+}
+
+IGOR_INLINE iVoxelBlock *iVoxelBlockMap::find(const iaVector3I &position) const
+{
+    uint64 index = calcSlot(position);
+
+    while (true)
+    {
+        const Slot &slot = _slots[index];
+        if (slot._block == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (slot._position == position)
+        {
+            return slot._block;
+        }
+
+        index = (index + 1) & _mask;
+    }
+}
@@ -0,0 +1,71 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/terrain/data/iVoxelBlockPool.h>
+
+#include <iaux/system/iaConsole.h>
+using namespace iaux;
+
+namespace igor
+{
+
+    iVoxelBlockPool::~iVoxelBlockPool()
+    {
+        if (_blockCount != 0)
+        {
+            con_debug("voxel blocks still in use " << _blockCount);
+        }
+    }
+
+    iVoxelBlock *iVoxelBlockPool::create()
+    {
+        uint32 index;
+        if (!_freeSlots.empty())
+        {
+            index = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        else
+        {
+            index = _slotCount++;
+            if (index / CHUNK_SIZE >= _chunks.size())
+            {
+                _chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+            }
+        }
+
+        Slot &slot = _chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+        slot._block._id = (static_cast<uint64>(slot._generation) << 32) | index;
+        _blockCount++;
+
+        return &slot._block;
+    }
+
+    void iVoxelBlockPool::destroy(iVoxelBlock *voxelBlock)
+    {
+        con_assert(voxelBlock != nullptr, "zero pointer");
+        con_assert(get(voxelBlock->_id) == voxelBlock, "block not from this pool or already destroyed");
+
+        const uint32 index = static_cast<uint32>(voxelBlock->_id & 0xffffffff);
+        Slot &slot = _chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+
+        slot._block = iVoxelBlock();
+
+        // skip zero so ids never become invalid ids
+        slot._generation++;
+        if (slot._generation == 0)
+        {
+            slot._generation = 1;
+        }
+
+        _freeSlots.push_back(index);
+        _blockCount--;
+    }
+
+    uint64 iVoxelBlockPool::getBlockCount() const
+    {
+        return _blockCount;
+    }
+
+} // namespace igor
@@ -0,0 +1,119 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_VOXELBLOCKPOOL__
+#define __IGOR_VOXELBLOCKPOOL__
+
+#include <igor/terrain/data/iVoxelBlock.h>
+
+#include <vector>
+#include <memory>
+
+namespace igor
+{
+
+    /*! pool of voxel blocks and table to look them up by id
+
+    blocks are allocated in chunks and recycled so their addresses stay valid until they get destroyed.
+    A block id is a handle made of the slot index and a generation counter. Destroying a block increases the
+    generation so ids of destroyed blocks can still be passed to get and simply return nullptr.
+    */
+    class IGOR_API iVoxelBlockPool
+    {
+
+    public:
+        /*! does nothing
+        */
+        iVoxelBlockPool() = default;
+
+        /*! releases all blocks
+        */
+        ~iVoxelBlockPool();
+
+        /*! \returns new block with valid id and everything else default initialized
+        */
+        iVoxelBlock *create();
+
+        /*! returns block to pool
+
+        does not release the voxel data or voxel block info of the block
+
+        \param voxelBlock the block to destroy
+        */
+        void destroy(iVoxelBlock *voxelBlock);
+
+        /*! \returns block for given id or nullptr if id is invalid or block was destroyed
+
+        \param id the voxel block id
+        */
+        IGOR_INLINE iVoxelBlock *get(uint64 id) const;
+
+        /*! \returns count of blocks in use
+        */
+        uint64 getBlockCount() const;
+
+    private:
+        /*! count of blocks per chunk
+        */
+        static const uint32 CHUNK_SIZE = 256;
+
+        /*! slot of pool
+        */
+        struct Slot
+        {
+            /*! the block
+            */
+            iVoxelBlock _block;
+
+            /*! generation of this slot. Starts with one so no id will ever be iVoxelBlock::INVALID_VOXELBLOCKID
+            */
+            uint32 _generation = 1;
+        };
+
+        /*! the chunks of slots
+        */
+        std::vector<std::unique_ptr<Slot[]>> _chunks;
+
+        /*! indices of unused slots
+        */
+        std::vector<uint32> _freeSlots;
+
+        /*! count of slots handed out so far
+        */
+        uint32 _slotCount = 0;
+
+        /*! count of blocks in use
+        */
+        uint64 _blockCount = 0;
+    };
+
+#include <igor/terrain/data/iVoxelBlockPool.inl>
+
+} // namespace igor
+
+#endif // __IGOR_VOXELBLOCKPOOL__
@@ -0,0 +1,22 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+IGOR_INLINE iVoxelBlock *iVoxelBlockPool::get(uint64 id) const
+{
+    const uint32 index = static_cast<uint32>(id & 0xffffffff);
+    const uint32 generation = static_cast<uint32>(id >> 32);
+
+    if (index >= _slotCount)
+    {
+        return nullptr;
+    }
+
+    Slot &slot = _chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    if (slot._generation != generation)
+    {
+        return nullptr;
+    }
+
+    return &slot._block;
+}
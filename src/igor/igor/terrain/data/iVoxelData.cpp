@@ -5,8 +5,11 @@
 #include <igor/terrain/data/iVoxelBlock.h>
 
 #include <iaux/system/iaConsole.h>
+#include <iaux/data/iaSerializable.h>
 using namespace iaux;
 
+#include <algorithm>
+
 namespace igor
 {
 
@@ -22,17 +25,24 @@ namespace igor
             delete[] _data;
             _data = nullptr;
         }
+
+        std::vector<uint8>().swap(_denseDensity);
+        std::vector<uint8>().swap(_denseMaterial);
+
+        _hasData = false;
     }
 
     void iVoxelData::getCopy(iVoxelData &dst)
     {
         dst.freeMemory();
 
+        dst._storage = _storage;
         dst._clearValue = _clearValue;
         dst._depth = _depth;
         dst._height = _height;
         dst._width = _width;
         dst._nonSolidValue = _nonSolidValue;
+        dst._hasData = _hasData;
 
         if (_data != nullptr)
         {
@@ -43,6 +53,11 @@ namespace igor
                 dst._data[i]._material = _data[i]._material;
             }
         }
+
+        dst._denseDensity = _denseDensity;
+        dst._denseMaterial = _denseMaterial;
+        dst._uniformDensity = _uniformDensity;
+        dst._uniformMaterial = _uniformMaterial;
     }
 
     void iVoxelData::initData(int64 width, int64 height, int64 depth)
@@ -58,22 +73,386 @@ namespace igor
             _width = width;
             _height = height;
             _depth = depth;
+        }
 
-            _data = new iVoxelPole[_width * _depth];
-            for (int i = 0; i < _width * _depth; ++i)
+        if (_storage == iVoxelStorage::RLE)
+        {
+            if (_data == nullptr)
             {
-                _data[i]._density.setSize(static_cast<uint8>(_height), _clearValue);
-                _data[i]._material.setSize(static_cast<uint8>(_height), _clearValue);
+                _data = new iVoxelPole[_width * _depth];
+                for (int i = 0; i < _width * _depth; ++i)
+                {
+                    _data[i]._density.setSize(static_cast<uint8>(_height), _clearValue);
+                    _data[i]._material.setSize(static_cast<uint8>(_height), _clearValue);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < _width * _depth; ++i)
+                {
+                    _data[i]._density.clear(_clearValue);
+                    _data[i]._material.clear(_clearValue);
+                }
             }
         }
         else
         {
-            for (int i = 0; i < _width * _depth; ++i)
+            // keep the capacity for reuse but mark channels uniform
+            _denseDensity.clear();
+            _denseMaterial.clear();
+            _uniformDensity = _clearValue;
+            _uniformMaterial = _clearValue;
+        }
+
+        _hasData = true;
+    }
+
+    void iVoxelData::setStorage(iVoxelStorage storage)
+    {
+        if (_storage == storage)
+        {
+            return;
+        }
+
+        if (_hasData)
+        {
+            if (storage == iVoxelStorage::Dense)
+            {
+                convertToDense();
+            }
+            else
+            {
+                convertToRLE();
+            }
+        }
+
+        _storage = storage;
+    }
+
+    iVoxelStorage iVoxelData::getStorage() const
+    {
+        return _storage;
+    }
+
+    void iVoxelData::convertToDense()
+    {
+        con_assert(_data != nullptr, "zero pointer");
+
+        auto convertChannel = [this](std::vector<uint8> &dense, uint8 &uniformValue, iaIndexedRLE<uint8, uint8> iVoxelPole::*channel)
+        {
+            dense.clear();
+            uniformValue = (_data[0].*channel).getRun(0)._value;
+
+            bool uniform = true;
+            for (int64 i = 0; i < _width * _depth; ++i)
+            {
+                const iaIndexedRLE<uint8, uint8> &pole = _data[i].*channel;
+                if (pole.getRunCount() != 1 || pole.getRun(0)._value != uniformValue)
+                {
+                    uniform = false;
+                    break;
+                }
+            }
+
+            if (uniform)
+            {
+                return;
+            }
+
+            dense.resize(_width * _height * _depth);
+
+            for (int64 z = 0; z < _depth; ++z)
+            {
+                for (int64 x = 0; x < _width; ++x)
+                {
+                    const iaIndexedRLE<uint8, uint8> &pole = _data[z * _depth + x].*channel;
+                    uint8 *dst = &dense[getDenseIndex(x, 0, z)];
+
+                    int64 begin = 0;
+                    for (uint32 i = 0; i < pole.getRunCount(); ++i)
+                    {
+                        const auto &run = pole.getRun(i);
+                        std::fill(dst + begin, dst + run._end, run._value);
+                        begin = run._end;
+                    }
+                }
+            }
+        };
+
+        convertChannel(_denseDensity, _uniformDensity, &iVoxelPole::_density);
+        convertChannel(_denseMaterial, _uniformMaterial, &iVoxelPole::_material);
+
+        delete[] _data;
+        _data = nullptr;
+    }
+
+    void iVoxelData::convertToRLE()
+    {
+        con_assert(_data == nullptr, "data already present");
+
+        _data = new iVoxelPole[_width * _depth];
+
+        auto convertChannel = [this](const std::vector<uint8> &dense, uint8 uniformValue, iaIndexedRLE<uint8, uint8> iVoxelPole::*channel)
+        {
+            for (int64 z = 0; z < _depth; ++z)
             {
-                _data[i]._density.clear(_clearValue);
-                _data[i]._material.clear(_clearValue);
+                for (int64 x = 0; x < _width; ++x)
+                {
+                    iaIndexedRLE<uint8, uint8> &pole = _data[z * _depth + x].*channel;
+                    pole.setSize(static_cast<uint8>(_height), uniformValue);
+
+                    if (dense.empty())
+                    {
+                        continue;
+                    }
+
+                    const uint8 *src = &dense[getDenseIndex(x, 0, z)];
+
+                    int64 begin = 0;
+                    for (int64 y = 1; y <= _height; ++y)
+                    {
+                        if (y == _height || src[y] != src[begin])
+                        {
+                            if (src[begin] != uniformValue)
+                            {
+                                pole.setValue(static_cast<uint8>(begin), static_cast<uint8>(y - begin), src[begin]);
+                            }
+                            begin = y;
+                        }
+                    }
+                }
             }
+        };
+
+        convertChannel(_denseDensity, _uniformDensity, &iVoxelPole::_density);
+        convertChannel(_denseMaterial, _uniformMaterial, &iVoxelPole::_material);
+
+        std::vector<uint8>().swap(_denseDensity);
+        std::vector<uint8>().swap(_denseMaterial);
+    }
+
+    bool iVoxelData::isUniform() const
+    {
+        if (_storage == iVoxelStorage::Dense)
+        {
+            return _denseDensity.empty() && _denseMaterial.empty();
         }
+
+        if (_data == nullptr)
+        {
+            return true;
+        }
+
+        const uint8 density = _data[0]._density.getRun(0)._value;
+        const uint8 material = _data[0]._material.getRun(0)._value;
+
+        for (int64 i = 0; i < _width * _depth; ++i)
+        {
+            if (_data[i]._density.getRunCount() != 1 || _data[i]._density.getRun(0)._value != density ||
+                _data[i]._material.getRunCount() != 1 || _data[i]._material.getRun(0)._value != material)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    uint64 iVoxelData::getMemoryUsage() const
+    {
+        uint64 result = sizeof(iVoxelData);
+
+        if (_data != nullptr)
+        {
+            result += _width * _depth * sizeof(iVoxelPole);
+
+            for (int64 i = 0; i < _width * _depth; ++i)
+            {
+                result += (_data[i]._density.getRunCount() + _data[i]._material.getRunCount()) * sizeof(iaIndexedRLERun<uint8, uint8>);
+            }
+        }
+
+        result += _denseDensity.capacity() + _denseMaterial.capacity();
+
+        return result;
+    }
+
+    bool iVoxelData::write(std::ofstream &stream) const
+    {
+        if (!_hasData)
+        {
+            con_err("no data to write");
+            return false;
+        }
+
+        if (!iaSerializable::writeUInt16(stream, static_cast<uint16>(_width)) ||
+            !iaSerializable::writeUInt16(stream, static_cast<uint16>(_height)) ||
+            !iaSerializable::writeUInt16(stream, static_cast<uint16>(_depth)) ||
+            !iaSerializable::writeUInt8(stream, _clearValue))
+        {
+            return false;
+        }
+
+        std::vector<iaIndexedRLERun<uint8, uint8>> runs;
+        runs.reserve(_height);
+
+        auto writeChannel = [this, &stream, &runs](const std::vector<uint8> &dense, uint8 uniformValue, iaIndexedRLE<uint8, uint8> iVoxelPole::*channel) -> bool
+        {
+            for (int64 z = 0; z < _depth; ++z)
+            {
+                for (int64 x = 0; x < _width; ++x)
+                {
+                    runs.clear();
+
+                    if (_data != nullptr)
+                    {
+                        const iaIndexedRLE<uint8, uint8> &pole = _data[z * _depth + x].*channel;
+                        for (uint32 i = 0; i < pole.getRunCount(); ++i)
+                        {
+                            runs.push_back(pole.getRun(i));
+                        }
+                    }
+                    else if (dense.empty())
+                    {
+                        runs.push_back({static_cast<uint8>(_height), uniformValue});
+                    }
+                    else
+                    {
+                        const uint8 *src = &dense[getDenseIndex(x, 0, z)];
+                        for (int64 y = 1; y <= _height; ++y)
+                        {
+                            if (y == _height || src[y] != src[y - 1])
+                            {
+                                runs.push_back({static_cast<uint8>(y), src[y - 1]});
+                            }
+                        }
+                    }
+
+                    if (!iaSerializable::writeUInt8(stream, static_cast<uint8>(runs.size())))
+                    {
+                        return false;
+                    }
+
+                    for (const auto &run : runs)
+                    {
+                        if (!iaSerializable::writeUInt8(stream, run._end) ||
+                            !iaSerializable::writeUInt8(stream, run._value))
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        return writeChannel(_denseDensity, _uniformDensity, &iVoxelPole::_density) &&
+               writeChannel(_denseMaterial, _uniformMaterial, &iVoxelPole::_material);
+    }
+
+    bool iVoxelData::read(std::ifstream &stream)
+    {
+        uint16 width = 0;
+        uint16 height = 0;
+        uint16 depth = 0;
+        uint8 clearValue = 0;
+
+        if (!iaSerializable::readUInt16(stream, width) ||
+            !iaSerializable::readUInt16(stream, height) ||
+            !iaSerializable::readUInt16(stream, depth) ||
+            !iaSerializable::readUInt8(stream, clearValue))
+        {
+            return false;
+        }
+
+        if (width < 2 || height < 2 || depth < 2 || height > 255)
+        {
+            con_err("invalid voxel data dimensions " << width << "x" << height << "x" << depth);
+            return false;
+        }
+
+        // runs are read in to RLE storage and converted afterwards
+        const iVoxelStorage storage = _storage;
+        if (_storage != iVoxelStorage::RLE)
+        {
+            freeMemory();
+            _storage = iVoxelStorage::RLE;
+        }
+
+        _clearValue = clearValue;
+        initData(width, height, depth);
+
+        auto readChannel = [this, &stream](iaIndexedRLE<uint8, uint8> iVoxelPole::*channel) -> bool
+        {
+            for (int64 z = 0; z < _depth; ++z)
+            {
+                for (int64 x = 0; x < _width; ++x)
+                {
+                    iaIndexedRLE<uint8, uint8> &pole = _data[z * _depth + x].*channel;
+
+                    uint8 runCount = 0;
+                    if (!iaSerializable::readUInt8(stream, runCount) || runCount == 0)
+                    {
+                        return false;
+                    }
+
+                    uint8 begin = 0;
+                    for (uint8 i = 0; i < runCount; ++i)
+                    {
+                        uint8 end = 0;
+                        uint8 value = 0;
+                        if (!iaSerializable::readUInt8(stream, end) ||
+                            !iaSerializable::readUInt8(stream, value) ||
+                            end <= begin || end > _height)
+                        {
+                            return false;
+                        }
+
+                        if (value != _clearValue)
+                        {
+                            pole.setValue(begin, end - begin, value);
+                        }
+
+                        begin = end;
+                    }
+
+                    if (begin != _height)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        if (!readChannel(&iVoxelPole::_density) ||
+            !readChannel(&iVoxelPole::_material))
+        {
+            con_err("corrupt voxel data");
+            freeMemory();
+            _storage = storage;
+            return false;
+        }
+
+        setStorage(storage);
+        return true;
+    }
+
+    void iVoxelData::setDense(std::vector<uint8> &channel, uint8 uniformValue, int64 index, int64 count, uint8 value)
+    {
+        if (channel.empty())
+        {
+            if (value == uniformValue)
+            {
+                return;
+            }
+
+            channel.assign(_width * _height * _depth, uniformValue);
+        }
+
+        std::fill(channel.begin() + index, channel.begin() + index + count, value);
     }
 
     void iVoxelData::clear()
@@ -98,6 +477,13 @@ namespace igor
         con_assert(pos._x >= 0 && pos._x < _width, "out of range");
         con_assert(pos._y >= 0 && pos._y < _height, "out of range");
         con_assert(pos._z >= 0 && pos._z < _depth, "out of range");
+
+        if (_storage == iVoxelStorage::Dense)
+        {
+            setDense(_denseDensity, _uniformDensity, getDenseIndex(pos._x, pos._y, pos._z), height, density);
+            return;
+        }
+
         _data[pos._z * _depth + pos._x]._density.setValue(static_cast<uint8>(pos._y), static_cast<uint8>(height), density);
     }
 
@@ -302,18 +688,20 @@ namespace igor
         return false;
     }
 
-    iaRLE<uint8, uint8> &iVoxelData::getDensityPole(int64 xDir, int64 zDir)
+    iaIndexedRLE<uint8, uint8> &iVoxelData::getDensityPole(int64 xDir, int64 zDir)
     {
         con_assert(xDir >= 0 && xDir < _width, "out of range");
         con_assert(zDir >= 0 && zDir < _depth, "out of range");
+        con_assert(_storage == iVoxelStorage::RLE, "only available in RLE storage");
         con_assert(_data != nullptr, "zero pointer");
         return _data[zDir * _depth + xDir]._density;
     }
 
-    iaRLE<uint8, uint8> &iVoxelData::getMaterialPole(int64 xDir, int64 zDir)
+    iaIndexedRLE<uint8, uint8> &iVoxelData::getMaterialPole(int64 xDir, int64 zDir)
     {
         con_assert(xDir >= 0 && xDir < _width, "out of range");
         con_assert(zDir >= 0 && zDir < _depth, "out of range");
+        con_assert(_storage == iVoxelStorage::RLE, "only available in RLE storage");
         con_assert(_data != nullptr, "zero pointer");
         return _data[zDir * _depth + xDir]._material;
     }
@@ -323,6 +711,12 @@ namespace igor
         con_assert(pos._x >= 0 && pos._x < _width, "out of range");
         con_assert(pos._y >= 0 && pos._y < _height, "out of range");
         con_assert(pos._z >= 0 && pos._z < _depth, "out of range");
+        if (_storage == iVoxelStorage::Dense)
+        {
+            setDense(_denseDensity, _uniformDensity, getDenseIndex(pos._x, pos._y, pos._z), 1, density);
+            return;
+        }
+
         con_assert(_data != nullptr, "zero pointer");
         _data[pos._z * _depth + pos._x]._density.setValue(static_cast<uint8>(pos._y), density);
     }
@@ -332,6 +726,11 @@ namespace igor
         con_assert(pos._x >= 0 && pos._x < _width, "out of range");
         con_assert(pos._y >= 0 && pos._y < _height, "out of range");
         con_assert(pos._z >= 0 && pos._z < _depth, "out of range");
+        if (_storage == iVoxelStorage::Dense)
+        {
+            return _denseDensity.empty() ? _uniformDensity : _denseDensity[getDenseIndex(pos._x, pos._y, pos._z)];
+        }
+
         con_assert(_data != nullptr, "zero pointer");
         return _data[pos._z * _depth + pos._x]._density.getValue(static_cast<uint8>(pos._y));
     }
@@ -341,6 +740,12 @@ namespace igor
         con_assert(pos._x >= 0 && pos._x < _width, "out of range");
         con_assert(pos._y >= 0 && pos._y < _height, "out of range");
         con_assert(pos._z >= 0 && pos._z < _depth, "out of range");
+        if (_storage == iVoxelStorage::Dense)
+        {
+            setDense(_denseMaterial, _uniformMaterial, getDenseIndex(pos._x, pos._y, pos._z), 1, material);
+            return;
+        }
+
         con_assert(_data != nullptr, "zero pointer");
         _data[pos._z * _depth + pos._x]._material.setValue(static_cast<uint8>(pos._y), material);
     }
@@ -350,13 +755,18 @@ namespace igor
         con_assert(pos._x >= 0 && pos._x < _width, "out of range");
         con_assert(pos._y >= 0 && pos._y < _height, "out of range");
         con_assert(pos._z >= 0 && pos._z < _depth, "out of range");
+        if (_storage == iVoxelStorage::Dense)
+        {
+            return _denseMaterial.empty() ? _uniformMaterial : _denseMaterial[getDenseIndex(pos._x, pos._y, pos._z)];
+        }
+
         con_assert(_data != nullptr, "zero pointer");
         return _data[pos._z * _depth + pos._x]._material.getValue(static_cast<uint8>(pos._y));
     }
 
     bool iVoxelData::hasData() const
     {
-        return _data ? true : false;
+        return _hasData;
     }
 
     int64 iVoxelData::getWidth() const
@@ -374,4 +784,26 @@ namespace igor
         return _height;
     }
 
+    iVoxelPoleCursor::iVoxelPoleCursor(const iVoxelData &voxelData, int64 xDir, int64 zDir, int64 y)
+        : _index(y), _height(voxelData._height)
+    {
+        con_assert(xDir >= 0 && xDir < voxelData._width, "out of range");
+        con_assert(zDir >= 0 && zDir < voxelData._depth, "out of range");
+
+        if (voxelData._storage == iVoxelStorage::RLE)
+        {
+            con_assert(voxelData._data != nullptr, "zero pointer");
+            _rle = true;
+            _cursor = iaIndexedRLE<uint8, uint8>::Cursor(voxelData._data[zDir * voxelData._depth + xDir]._density, static_cast<uint8>(y));
+        }
+        else if (voxelData._denseDensity.empty())
+        {
+            _uniformValue = voxelData._uniformDensity;
+        }
+        else
+        {
+            _pole = &voxelData._denseDensity[voxelData.getDenseIndex(xDir, 0, zDir)];
+        }
+    }
+
 } // namespace igor
@@ -32,19 +32,35 @@
 #include <igor/iDefines.h>
 
 #include <iaux/data/iaString.h>
-#include <iaux/data/iaRLE.h>
+#include <iaux/data/iaIndexedRLE.h>
 #include <iaux/math/iaVector3.h>
 using namespace iaux;
 
 #include <vector>
+#include <fstream>
 
 namespace igor
 {
 
+    /*! storage backend of voxel data
+    */
+    enum class iVoxelStorage : uint8
+    {
+        /*! every pole (vertical line of voxels) is run length encoded. Small memory footprint but many small allocations
+        */
+        RLE,
+
+        /*! flat arrays with voxels of a pole next to each other. One allocation per channel and no allocation at all as long as a channel is uniform
+        */
+        Dense
+    };
+
+    /*! run length encoded density and material of a pole
+    */
     struct iVoxelPole
     {
-        iaRLE<uint8, uint8> _density;
-        iaRLE<uint8, uint8> _material;
+        iaIndexedRLE<uint8, uint8> _density;
+        iaIndexedRLE<uint8, uint8> _material;
     };
 
     /*!
@@ -76,8 +92,50 @@ namespace igor
         */
         void initData(int64 width, int64 height, int64 depth);
 
+        /*! copies voxel data including storage type to destination
+
+        \param dst the destination
+        */
         void getCopy(iVoxelData &dst);
 
+        /*! sets the storage backend
+
+        If there is data already it will be converted. Use this i.e. to convert to RLE before serialization
+
+        \param storage the storage backend to use
+        */
+        void setStorage(iVoxelStorage storage);
+
+        /*! \returns the storage backend in use
+        */
+        iVoxelStorage getStorage() const;
+
+        /*! \returns true if all voxels have the same density and the same material
+
+        in Dense storage no memory is allocated for uniform channels
+        */
+        bool isUniform() const;
+
+        /*! \returns approximate memory used by the voxel data in bytes (without allocator overhead)
+        */
+        uint64 getMemoryUsage() const;
+
+        /*! writes voxel data to stream
+
+        independent of the storage backend the data is written run length encoded
+
+        \param stream the destination stream
+        \returns true if successful
+        */
+        bool write(std::ofstream &stream) const;
+
+        /*! reads voxel data from stream and converts it to the storage backend in use
+
+        \param stream the source stream
+        \returns true if successful
+        */
+        bool read(std::ifstream &stream);
+
         /*! does same as initData but keeps the preset width height and depht
         */
         void clear();
@@ -110,8 +168,23 @@ namespace igor
         void setVoxelMaterial(iaVector3I pos, uint8 material);
         uint8 getVoxelMaterial(iaVector3I pos);
 
-        iaRLE<uint8, uint8> &getDensityPole(int64 xDir, int64 zDir);
-        iaRLE<uint8, uint8> &getMaterialPole(int64 xDir, int64 zDir);
+        /*! \returns density pole at given position
+
+        only available in RLE storage
+
+        \param xDir x position of pole
+        \param zDir z position of pole
+        */
+        iaIndexedRLE<uint8, uint8> &getDensityPole(int64 xDir, int64 zDir);
+
+        /*! \returns material pole at given position
+
+        only available in RLE storage
+
+        \param xDir x position of pole
+        \param zDir z position of pole
+        */
+        iaIndexedRLE<uint8, uint8> &getMaterialPole(int64 xDir, int64 zDir);
 
         /*! sets a line of voxels to a target density
 
@@ -147,10 +220,34 @@ namespace igor
         bool hasData() const;
 
     private:
-        /*! the data
+        /*! the storage in use
+        */
+        iVoxelStorage _storage = iVoxelStorage::RLE;
+
+        /*! the data in RLE storage
         */
         iVoxelPole *_data = nullptr;
 
+        /*! densities in dense storage. Empty if all densities are _uniformDensity
+        */
+        std::vector<uint8> _denseDensity;
+
+        /*! materials in dense storage. Empty if all materials are _uniformMaterial
+        */
+        std::vector<uint8> _denseMaterial;
+
+        /*! density of all voxels as long as _denseDensity is empty
+        */
+        uint8 _uniformDensity = 0;
+
+        /*! material of all voxels as long as _denseMaterial is empty
+        */
+        uint8 _uniformMaterial = 0;
+
+        /*! true if data was initialized
+        */
+        bool _hasData = false;
+
         int64 _width = 0;
         int64 _depth = 0;
         int64 _height = 0;
@@ -158,9 +255,90 @@ namespace igor
         uint8 _clearValue = 0;
         uint8 _nonSolidValue = 0;
 
+        /*! \returns index in dense arrays
+        */
+        IGOR_INLINE int64 getDenseIndex(int64 x, int64 y, int64 z) const;
+
+        /*! sets a range of a channel in dense storage and allocates the channel if needed
+
+        \param channel the channel to modify
+        \param uniformValue the uniform value of the channel
+        \param index start index
+        \param count count of voxels
+        \param value the value to set
+        */
+        void setDense(std::vector<uint8> &channel, uint8 uniformValue, int64 index, int64 count, uint8 value);
+
+        /*! converts RLE storage to dense storage
+        */
+        void convertToDense();
+
+        /*! converts dense storage to RLE storage
+        */
+        void convertToRLE();
+
+        /*! release memory
+        */
         void freeMemory();
+
+        friend class iVoxelPoleCursor;
+    };
+
+    /*! iterates bottom up through the densities of a pole independent of the storage backend
+    */
+    class IGOR_API iVoxelPoleCursor
+    {
+
+    public:
+        /*! creates invalid cursor
+        */
+        iVoxelPoleCursor() = default;
+
+        /*! creates cursor at given position
+
+        \param voxelData the voxel data to iterate
+        \param xDir x position of pole
+        \param zDir z position of pole
+        \param y start position within pole
+        */
+        iVoxelPoleCursor(const iVoxelData &voxelData, int64 xDir, int64 zDir, int64 y);
+
+        /*! moves cursor one voxel up
+        */
+        IGOR_INLINE void next();
+
+        /*! \returns density at cursor position or zero if out of range
+        */
+        IGOR_INLINE uint8 getValue() const;
+
+    private:
+        /*! cursor in RLE storage
+        */
+        iaIndexedRLE<uint8, uint8>::Cursor _cursor;
+
+        /*! pole in dense storage
+        */
+        const uint8 *_pole = nullptr;
+
+        /*! current position within pole
+        */
+        int64 _index = 0;
+
+        /*! height of pole
+        */
+        int64 _height = 0;
+
+        /*! density of uniform dense data
+        */
+        uint8 _uniformValue = 0;
+
+        /*! true if in RLE storage
+        */
+        bool _rle = false;
     };
 
+#include <igor/terrain/data/iVoxelData.inl>
+
 } // namespace igor
 
 #endif // __IGOR_VOXELDATACHUNK__
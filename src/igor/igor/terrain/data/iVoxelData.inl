@@ -0,0 +1,33 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+IGOR_INLINE int64 iVoxelData::getDenseIndex(int64 x, int64 y, int64 z) const
+{
+    return (z * _width + x) * _height + y;
+}
+
+IGOR_INLINE void iVoxelPoleCursor::next()
+{
+    _index++;
+
+    if (_rle)
+    {
+        _cursor.next();
+    }
+}
+
+IGOR_INLINE uint8 iVoxelPoleCursor::getValue() const
+{
+    if (_rle)
+    {
+        return _cursor.getValue();
+    }
+
+    if (_index >= _height)
+    {
+        return 0;
+    }
+
+    return _pole != nullptr ? _pole[_index] : _uniformValue;
+}
@@ -139,6 +139,26 @@ namespace igor
         return _material;
     }
 
+    void iVoxelTerrain::setVoxelStorage(iVoxelStorage storage)
+    {
+        _voxelStorage = storage;
+    }
+
+    iVoxelStorage iVoxelTerrain::getVoxelStorage() const
+    {
+        return _voxelStorage;
+    }
+
+    void iVoxelTerrain::setVoxelBlockCache(iVoxelBlockCachePtr voxelBlockCache)
+    {
+        _voxelBlockCache = voxelBlockCache;
+    }
+
+    iVoxelBlockCachePtr iVoxelTerrain::getVoxelBlockCache() const
+    {
+        return _voxelBlockCache;
+    }
+
     void iVoxelTerrain::setPhysicsMaterialID(uint64 materialID)
     {
         _physicsMaterialID = materialID;
@@ -172,12 +192,7 @@ namespace igor
 
     void iVoxelTerrain::init()
     {
-        std::unordered_map<iaVector3I, iVoxelBlock *, iVectorHasher, iVectorEqualFn> voxelBlocks;
-
-        for (int i = 0; i < _lowestLOD + 1; ++i)
-        {
-            _voxelBlocks.push_back(voxelBlocks);
-        }
+        _voxelBlocks.resize(_lowestLOD + 1);
 
         // set up terrain material
         iParameters param({ 
@@ -239,6 +254,7 @@ namespace igor
         }
 
         applyVoxelOperations();
+        storeModifiedBlocks();
 
         // apply all actions at once so they will be synced with next frame
         iNodeManager::getInstance().applyActionsAsync(_actionQueue);
@@ -315,13 +331,8 @@ namespace igor
                 for (int64 voxelBlockZ = min._z; voxelBlockZ <= max._z; ++voxelBlockZ)
                 {
                     voxelBlockPosition.set(voxelBlockX, voxelBlockY, voxelBlockZ);
-                    iVoxelBlock *voxelBlock = nullptr;
-                    auto blockIter = voxelBlocks.find(voxelBlockPosition);
-                    if (blockIter != voxelBlocks.end())
-                    {
-                        voxelBlock = (*blockIter).second;
-                    }
-                    else
+                    iVoxelBlock *voxelBlock = voxelBlocks.find(voxelBlockPosition);
+                    if (voxelBlock == nullptr)
                     {
                         voxelBlock = createVoxelBlock(_lowestLOD, voxelBlockPosition, 0);
                     }
@@ -336,14 +347,45 @@ namespace igor
     {
         auto &voxelBlocks = _voxelBlocks[_lowestLOD];
 
-        for (auto block : voxelBlocks)
+        for (iVoxelBlock *voxelBlock : voxelBlocks)
         {
-            update(block.second, observerPosition);
+            update(voxelBlock, observerPosition);
         }
 
-        for (auto block : voxelBlocks)
+        generateMeshes();
+
+        for (iVoxelBlock *voxelBlock : voxelBlocks)
         {
-            updateVisibility(block.second);
+            updateVisibility(voxelBlock);
+        }
+    }
+
+    void iVoxelTerrain::storeModifiedBlocks()
+    {
+        const iaTime now = iaTime::getNow();
+
+        if (_modifiedVoxelBlocks.empty() ||
+            now - _lastModifiedBlocksStore < iaTime::fromMilliseconds(MODIFIED_BLOCKS_STORE_INTERVAL))
+        {
+            return;
+        }
+
+        for (const uint64 voxelBlockID : _modifiedVoxelBlocks)
+        {
+            storeModifiedBlock(_voxelBlockPool.get(voxelBlockID));
+        }
+
+        _modifiedVoxelBlocks.clear();
+        _lastModifiedBlocksStore = now;
+    }
+
+    void iVoxelTerrain::storeModifiedBlock(iVoxelBlock *voxelBlock)
+    {
+        if (_voxelBlockCache != nullptr &&
+            voxelBlock != nullptr &&
+            voxelBlock->_voxelData != nullptr)
+        {
+            _voxelBlockCache->store(voxelBlock->_lod, voxelBlock->_positionInLOD, *voxelBlock->_voxelData, true);
         }
     }
 
@@ -384,9 +426,15 @@ namespace igor
             return false;
         }
 
+        // blocks already removed from the lod map don't get updated anymore so we poll the task here
         if (voxelBlock->_voxelGenerationTaskID != iTask::INVALID_TASK_ID)
         {
-            return false;
+            if (iTaskManager::getInstance().getTask(voxelBlock->_voxelGenerationTaskID) != nullptr)
+            {
+                return false;
+            }
+
+            voxelBlock->_voxelGenerationTaskID = iTask::INVALID_TASK_ID;
         }
 
         return true;
@@ -394,14 +442,14 @@ namespace igor
 
     void iVoxelTerrain::deleteBlock(iVoxelBlock *voxelBlock)
     {
-        auto parent = _voxelBlocksMap.find(voxelBlock->_parent);
-        if (parent != _voxelBlocksMap.end())
+        iVoxelBlock *parent = _voxelBlockPool.get(voxelBlock->_parent);
+        if (parent != nullptr)
         {
             for (int i = 0; i < 8; ++i)
             {
-                if ((*parent).second->_children[i] == voxelBlock->_id)
+                if (parent->_children[i] == voxelBlock->_id)
                 {
-                    (*parent).second->_children[i] = iVoxelBlock::INVALID_VOXELBLOCKID;
+                    parent->_children[i] = iVoxelBlock::INVALID_VOXELBLOCKID;
                 }
             }
         }
@@ -411,13 +459,14 @@ namespace igor
             destroyNodeAsync(voxelBlock->_transformNodeIDCurrent);
         }
 
-        auto block = _voxelBlocksMap.find(voxelBlock->_id);
-        if (block != _voxelBlocksMap.end())
+        // modifications must not get lost with the block
+        if (_modifiedVoxelBlocks.erase(voxelBlock->_id) != 0)
         {
-            _voxelBlocksMap.erase(block);
+            storeModifiedBlock(voxelBlock);
         }
 
-        /*if (voxelBlock->_voxelData != nullptr)
+        // ids of this block still stored in other blocks become invalid with this
+        if (voxelBlock->_voxelData != nullptr)
         {
             delete voxelBlock->_voxelData;
         }
@@ -427,7 +476,7 @@ namespace igor
             delete voxelBlock->_voxelBlockInfo;
         }
 
-        delete voxelBlock;*/
+        _voxelBlockPool.destroy(voxelBlock);
     }
 
     void iVoxelTerrain::setNeighboursDirty(iVoxelBlock *voxelBlock)
@@ -436,10 +485,10 @@ namespace igor
 
         for (int i = 0; i < 6; ++i)
         {
-            auto neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[i]);
-            if (neighbour != _voxelBlocksMap.end())
+            iVoxelBlock *neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[i]);
+            if (neighbour != nullptr)
             {
-                (*neighbour).second->_dirtyNeighbours = true;
+                neighbour->_dirtyNeighbours = true;
             }
             else
             {
@@ -452,7 +501,7 @@ namespace igor
     {
         con_assert(lod >= 0 && lod <= _lowestLOD, "lod out of range");
 
-        iVoxelBlock *result = new iVoxelBlock();
+        iVoxelBlock *result = _voxelBlockPool.create();
 
         result->_positionInLOD = positionInLOD;
         result->_positionInLOD += childOffsetPosition[childAdress];
@@ -471,9 +520,7 @@ namespace igor
             result->_neighbours[i] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
 
-        _voxelBlocks[lod][result->_positionInLOD] = result;
-        _voxelBlocksMap[_nextVoxelBlockID] = result;
-        result->_id = _nextVoxelBlockID++;
+        _voxelBlocks[lod].insert(result->_positionInLOD, result);
 
         return result;
     }
@@ -516,8 +563,21 @@ namespace igor
                 start._z = 0;
             }
 
-            auto voxelBlocksToDelete = _voxelBlocks[_lowestLOD];
             auto &voxelBlocks = _voxelBlocks[_lowestLOD];
+
+            // blocks outside of the discovery range get deleted
+            _outOfRangeBlocks.clear();
+            for (iVoxelBlock *voxelBlock : voxelBlocks)
+            {
+                const iaVector3I &position = voxelBlock->_positionInLOD;
+                if (position._x < start._x || position._x >= stop._x ||
+                    position._y < start._y || position._y >= stop._y ||
+                    position._z < start._z || position._z >= stop._z)
+                {
+                    _outOfRangeBlocks.push_back(voxelBlock);
+                }
+            }
+
             iaVector3I voxelBlockPosition;
 
             for (int64 voxelBlockX = start._x; voxelBlockX < stop._x; ++voxelBlockX)
@@ -528,26 +588,17 @@ namespace igor
                     {
                         voxelBlockPosition.set(voxelBlockX, voxelBlockY, voxelBlockZ);
 
-                        auto blockIter = voxelBlocks.find(voxelBlockPosition);
-                        if (blockIter == voxelBlocks.end())
+                        if (voxelBlocks.find(voxelBlockPosition) == nullptr)
                         {
                             createVoxelBlock(_lowestLOD, voxelBlockPosition, 0);
                         }
-                        else
-                        {
-                            auto blockToDeleteIter = voxelBlocksToDelete.find(voxelBlockPosition);
-                            if (blockToDeleteIter != voxelBlocksToDelete.end())
-                            {
-                                voxelBlocksToDelete.erase(blockToDeleteIter);
-                            }
-                        }
                     }
                 }
             }
 
-            for (auto iter : voxelBlocksToDelete)
+            for (iVoxelBlock *voxelBlock : _outOfRangeBlocks)
             {
-                collectBlocksToDelete(iter.second, _voxelBlocksToDelete);
+                collectBlocksToDelete(voxelBlock, _voxelBlocksToDelete);
             }
         }
     }
@@ -556,19 +607,16 @@ namespace igor
     {
         detachNeighbours(currentBlock);
 
-        auto foundBlock = _voxelBlocks[currentBlock->_lod].find(currentBlock->_positionInLOD);
-        if (foundBlock != _voxelBlocks[currentBlock->_lod].end())
+        if (_voxelBlocks[currentBlock->_lod].erase(currentBlock->_positionInLOD))
         {
-            _voxelBlocks[currentBlock->_lod].erase(foundBlock);
             dst.push_back(currentBlock);
 
             for (int i = 0; i < 8; ++i)
             {
-                auto child = _voxelBlocksMap.find(currentBlock->_children[i]);
-
-                if (child != _voxelBlocksMap.end())
+                iVoxelBlock *child = _voxelBlockPool.get(currentBlock->_children[i]);
+                if (child != nullptr)
                 {
-                    collectBlocksToDelete((*child).second, dst);
+                    collectBlocksToDelete(child, dst);
                 }
             }
         }
@@ -585,63 +633,63 @@ namespace igor
 
     void iVoxelTerrain::detachNeighbours(iVoxelBlock *voxelBlock)
     {
-        auto neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[0]);
-        if (neighbour != _voxelBlocksMap.end())
+        iVoxelBlock *neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[0]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[1] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[1] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[0] = iVoxelBlock::INVALID_VOXELBLOCKID;
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[1]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[1]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[0] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[0] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[1] = iVoxelBlock::INVALID_VOXELBLOCKID;
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[2]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[2]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[3] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[3] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[2] = iVoxelBlock::INVALID_VOXELBLOCKID;
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[3]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[3]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[2] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[2] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[3] = iVoxelBlock::INVALID_VOXELBLOCKID;
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[4]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[4]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[5] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[5] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[4] = iVoxelBlock::INVALID_VOXELBLOCKID;
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[5]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[5]);
+        if (neighbour != nullptr)
         {
-            (*neighbour).second->_neighbours[4] = iVoxelBlock::INVALID_VOXELBLOCKID;
+            neighbour->_neighbours[4] = iVoxelBlock::INVALID_VOXELBLOCKID;
         }
         voxelBlock->_neighbours[5] = iVoxelBlock::INVALID_VOXELBLOCKID;
     }
 
     void iVoxelTerrain::attachNeighbours(iVoxelBlock *voxelBlock)
     {
-        auto voxelBlocks = _voxelBlocks[voxelBlock->_lod];
+        const auto &voxelBlocks = _voxelBlocks[voxelBlock->_lod];
         iaVector3I neighbourPos;
 
         if (voxelBlock->_neighbours[0] == iVoxelBlock::INVALID_VOXELBLOCKID)
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._x += 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[0] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[1] = voxelBlock->_id;
+                voxelBlock->_neighbours[0] = neighbour->_id;
+                neighbour->_neighbours[1] = voxelBlock->_id;
             }
         }
 
@@ -649,11 +697,11 @@ namespace igor
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._x -= 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[1] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[0] = voxelBlock->_id;
+                voxelBlock->_neighbours[1] = neighbour->_id;
+                neighbour->_neighbours[0] = voxelBlock->_id;
             }
         }
 
@@ -661,11 +709,11 @@ namespace igor
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._y += 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[2] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[3] = voxelBlock->_id;
+                voxelBlock->_neighbours[2] = neighbour->_id;
+                neighbour->_neighbours[3] = voxelBlock->_id;
             }
         }
 
@@ -673,11 +721,11 @@ namespace igor
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._y -= 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[3] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[2] = voxelBlock->_id;
+                voxelBlock->_neighbours[3] = neighbour->_id;
+                neighbour->_neighbours[2] = voxelBlock->_id;
             }
         }
 
@@ -685,11 +733,11 @@ namespace igor
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._z += 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[4] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[5] = voxelBlock->_id;
+                voxelBlock->_neighbours[4] = neighbour->_id;
+                neighbour->_neighbours[5] = voxelBlock->_id;
             }
         }
 
@@ -697,11 +745,11 @@ namespace igor
         {
             neighbourPos = voxelBlock->_positionInLOD;
             neighbourPos._z -= 1;
-            auto neighbour = voxelBlocks.find(neighbourPos);
-            if (neighbour != voxelBlocks.end())
+            iVoxelBlock *neighbour = voxelBlocks.find(neighbourPos);
+            if (neighbour != nullptr)
             {
-                voxelBlock->_neighbours[5] = (*neighbour).second->_id;
-                (*neighbour).second->_neighbours[4] = voxelBlock->_id;
+                voxelBlock->_neighbours[5] = neighbour->_id;
+                neighbour->_neighbours[4] = voxelBlock->_id;
             }
         }
     }
@@ -714,6 +762,7 @@ namespace igor
             {
                 voxelBlock->_voxelData = new iVoxelData();
                 voxelBlock->_voxelData->setClearValue(0);
+                voxelBlock->_voxelData->setStorage(_voxelStorage);
                 voxelBlock->_voxelBlockInfo->_voxelData = voxelBlock->_voxelData;
                 voxelBlock->_voxelData->initData(voxelBlock->_voxelBlockInfo->_size, voxelBlock->_voxelBlockInfo->_size, voxelBlock->_voxelBlockInfo->_size);
 
@@ -755,7 +804,7 @@ namespace igor
 
             for (int i = 0; i < 8; ++i)
             {
-                iVoxelBlock *child = _voxelBlocksMap[voxelBlock->_children[i]];
+                iVoxelBlock *child = _voxelBlockPool.get(voxelBlock->_children[i]);
                 setInRange(child, childrenInRange);
             }
         }
@@ -780,6 +829,7 @@ namespace igor
             {
                 voxelBlock->_voxelData = new iVoxelData();
                 voxelBlock->_voxelData->setClearValue(0);
+                voxelBlock->_voxelData->setStorage(_voxelStorage);
 
                 voxelBlock->_voxelBlockInfo = new iVoxelBlockInfo();
                 voxelBlock->_voxelBlockInfo->_size = _voxelBlockSize + _voxelBlockOverlap;
@@ -791,7 +841,7 @@ namespace igor
                 // lower lods need higher priority to build
                 uint32 priority = _lowestLOD - voxelBlock->_lod + 1;
 
-                iTaskGenerateVoxels *task = new iTaskGenerateVoxels(voxelBlock->_voxelBlockInfo, priority, _generateVoxelsDelegate);
+                iTaskGenerateVoxels *task = new iTaskGenerateVoxels(voxelBlock->_voxelBlockInfo, priority, _generateVoxelsDelegate, _voxelBlockCache);
                 voxelBlock->_voxelGenerationTaskID = iTaskManager::getInstance().addTask(task);
             }
 
@@ -861,45 +911,45 @@ namespace igor
                             // |/    |/
                             // 3-----2
 
-                            _voxelBlocksMap[voxelBlock->_children[0]]->_neighbours[0] = voxelBlock->_children[1];
-                            _voxelBlocksMap[voxelBlock->_children[1]]->_neighbours[1] = voxelBlock->_children[0];
+                            _voxelBlockPool.get(voxelBlock->_children[0])->_neighbours[0] = voxelBlock->_children[1];
+                            _voxelBlockPool.get(voxelBlock->_children[1])->_neighbours[1] = voxelBlock->_children[0];
 
-                            _voxelBlocksMap[voxelBlock->_children[3]]->_neighbours[0] = voxelBlock->_children[2];
-                            _voxelBlocksMap[voxelBlock->_children[2]]->_neighbours[1] = voxelBlock->_children[3];
+                            _voxelBlockPool.get(voxelBlock->_children[3])->_neighbours[0] = voxelBlock->_children[2];
+                            _voxelBlockPool.get(voxelBlock->_children[2])->_neighbours[1] = voxelBlock->_children[3];
 
-                            _voxelBlocksMap[voxelBlock->_children[4]]->_neighbours[0] = voxelBlock->_children[4];
-                            _voxelBlocksMap[voxelBlock->_children[5]]->_neighbours[1] = voxelBlock->_children[5];
+                            _voxelBlockPool.get(voxelBlock->_children[4])->_neighbours[0] = voxelBlock->_children[4];
+                            _voxelBlockPool.get(voxelBlock->_children[5])->_neighbours[1] = voxelBlock->_children[5];
 
-                            _voxelBlocksMap[voxelBlock->_children[7]]->_neighbours[0] = voxelBlock->_children[6];
-                            _voxelBlocksMap[voxelBlock->_children[6]]->_neighbours[1] = voxelBlock->_children[7];
+                            _voxelBlockPool.get(voxelBlock->_children[7])->_neighbours[0] = voxelBlock->_children[6];
+                            _voxelBlockPool.get(voxelBlock->_children[6])->_neighbours[1] = voxelBlock->_children[7];
 
-                            _voxelBlocksMap[voxelBlock->_children[0]]->_neighbours[2] = voxelBlock->_children[4];
-                            _voxelBlocksMap[voxelBlock->_children[4]]->_neighbours[3] = voxelBlock->_children[0];
+                            _voxelBlockPool.get(voxelBlock->_children[0])->_neighbours[2] = voxelBlock->_children[4];
+                            _voxelBlockPool.get(voxelBlock->_children[4])->_neighbours[3] = voxelBlock->_children[0];
 
-                            _voxelBlocksMap[voxelBlock->_children[1]]->_neighbours[2] = voxelBlock->_children[5];
-                            _voxelBlocksMap[voxelBlock->_children[5]]->_neighbours[3] = voxelBlock->_children[1];
+                            _voxelBlockPool.get(voxelBlock->_children[1])->_neighbours[2] = voxelBlock->_children[5];
+                            _voxelBlockPool.get(voxelBlock->_children[5])->_neighbours[3] = voxelBlock->_children[1];
 
-                            _voxelBlocksMap[voxelBlock->_children[2]]->_neighbours[2] = voxelBlock->_children[6];
-                            _voxelBlocksMap[voxelBlock->_children[6]]->_neighbours[3] = voxelBlock->_children[2];
+                            _voxelBlockPool.get(voxelBlock->_children[2])->_neighbours[2] = voxelBlock->_children[6];
+                            _voxelBlockPool.get(voxelBlock->_children[6])->_neighbours[3] = voxelBlock->_children[2];
 
-                            _voxelBlocksMap[voxelBlock->_children[3]]->_neighbours[2] = voxelBlock->_children[7];
-                            _voxelBlocksMap[voxelBlock->_children[7]]->_neighbours[3] = voxelBlock->_children[3];
+                            _voxelBlockPool.get(voxelBlock->_children[3])->_neighbours[2] = voxelBlock->_children[7];
+                            _voxelBlockPool.get(voxelBlock->_children[7])->_neighbours[3] = voxelBlock->_children[3];
 
-                            _voxelBlocksMap[voxelBlock->_children[0]]->_neighbours[4] = voxelBlock->_children[3];
-                            _voxelBlocksMap[voxelBlock->_children[3]]->_neighbours[5] = voxelBlock->_children[0];
+                            _voxelBlockPool.get(voxelBlock->_children[0])->_neighbours[4] = voxelBlock->_children[3];
+                            _voxelBlockPool.get(voxelBlock->_children[3])->_neighbours[5] = voxelBlock->_children[0];
 
-                            _voxelBlocksMap[voxelBlock->_children[1]]->_neighbours[4] = voxelBlock->_children[2];
-                            _voxelBlocksMap[voxelBlock->_children[2]]->_neighbours[5] = voxelBlock->_children[1];
+                            _voxelBlockPool.get(voxelBlock->_children[1])->_neighbours[4] = voxelBlock->_children[2];
+                            _voxelBlockPool.get(voxelBlock->_children[2])->_neighbours[5] = voxelBlock->_children[1];
 
-                            _voxelBlocksMap[voxelBlock->_children[4]]->_neighbours[4] = voxelBlock->_children[7];
-                            _voxelBlocksMap[voxelBlock->_children[7]]->_neighbours[5] = voxelBlock->_children[4];
+                            _voxelBlockPool.get(voxelBlock->_children[4])->_neighbours[4] = voxelBlock->_children[7];
+                            _voxelBlockPool.get(voxelBlock->_children[7])->_neighbours[5] = voxelBlock->_children[4];
 
-                            _voxelBlocksMap[voxelBlock->_children[5]]->_neighbours[4] = voxelBlock->_children[6];
-                            _voxelBlocksMap[voxelBlock->_children[6]]->_neighbours[5] = voxelBlock->_children[5];
+                            _voxelBlockPool.get(voxelBlock->_children[5])->_neighbours[4] = voxelBlock->_children[6];
+                            _voxelBlockPool.get(voxelBlock->_children[6])->_neighbours[5] = voxelBlock->_children[5];
 
                             for (int i = 0; i < 8; ++i)
                             {
-                                attachNeighbours(_voxelBlocksMap[voxelBlock->_children[i]]);
+                                attachNeighbours(_voxelBlockPool.get(voxelBlock->_children[i]));
                             }
                         }
                     }
@@ -972,6 +1022,12 @@ namespace igor
 
                 voxelBlock->_dirty = true;
 
+                // persist modifications with the next batch
+                if (_voxelBlockCache != nullptr)
+                {
+                    _modifiedVoxelBlocks.insert(voxelBlock->_id);
+                }
+
                 if (voxelBlock->_children[0] != iVoxelBlock::INVALID_VOXELBLOCKID)
                 {
                     int64 lodFactor = static_cast<int64>(pow(2, voxelBlock->_lod - 1));
@@ -979,7 +1035,7 @@ namespace igor
 
                     for (int i = 0; i < 8; ++i)
                     {
-                        iVoxelBlock *child = _voxelBlocksMap[voxelBlock->_children[i]];
+                        iVoxelBlock *child = _voxelBlockPool.get(voxelBlock->_children[i]);
 
                         iAABoxI box;
                         box._halfWidths.set(halfVoxelBlockSize, halfVoxelBlockSize, halfVoxelBlockSize);
@@ -1024,7 +1080,7 @@ namespace igor
         {
             for (int i = 0; i < 8; ++i)
             {
-                iVoxelBlock *child = _voxelBlocksMap[voxelBlock->_children[i]];
+                iVoxelBlock *child = _voxelBlockPool.get(voxelBlock->_children[i]);
                 update(child, observerPosition);
             }
         }
@@ -1046,7 +1102,7 @@ namespace igor
             childrenVisible = true;
             for (int i = 0; i < 8; ++i)
             {
-                if (!updateVisibility(_voxelBlocksMap[voxelBlock->_children[i]]))
+                if (!updateVisibility(_voxelBlockPool.get(voxelBlock->_children[i])))
                 {
                     childrenVisible = false;
                 }
@@ -1056,7 +1112,7 @@ namespace igor
             {
                 for (int i = 0; i < 8; ++i)
                 {
-                    iVoxelBlock *child = _voxelBlocksMap[voxelBlock->_children[i]];
+                    iVoxelBlock *child = _voxelBlockPool.get(voxelBlock->_children[i]);
                     if (child->_modelNodeIDCurrent != iNode::INVALID_NODE_ID)
                     {
                         iNodeModel *modelNode = static_cast<iNodeModel *>(iNodeManager::getInstance().getNode(child->_modelNodeIDCurrent));
@@ -1130,10 +1186,10 @@ namespace igor
             return result;
         }
 
-        auto neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[0]);
-        if (neighbour != _voxelBlocksMap.end())
+        iVoxelBlock *neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[0]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_XPOSITIVE;
             }
@@ -1143,10 +1199,10 @@ namespace igor
             result |= HIGHER_NEIGHBOR_LOD_XPOSITIVE;
         }
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[1]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[1]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_XNEGATIVE;
             }
@@ -1156,10 +1212,10 @@ namespace igor
             result |= HIGHER_NEIGHBOR_LOD_XNEGATIVE;
         }
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[2]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[2]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_YPOSITIVE;
             }
@@ -1169,10 +1225,10 @@ namespace igor
             result |= HIGHER_NEIGHBOR_LOD_YPOSITIVE;
         }
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[3]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[3]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_YNEGATIVE;
             }
@@ -1182,10 +1238,10 @@ namespace igor
             result |= HIGHER_NEIGHBOR_LOD_YNEGATIVE;
         }
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[4]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[4]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_ZPOSITIVE;
             }
@@ -1195,10 +1251,10 @@ namespace igor
             result |= HIGHER_NEIGHBOR_LOD_ZPOSITIVE;
         }
 
-        neighbour = _voxelBlocksMap.find(voxelBlock->_neighbours[5]);
-        if (neighbour != _voxelBlocksMap.end())
+        neighbour = _voxelBlockPool.get(voxelBlock->_neighbours[5]);
+        if (neighbour != nullptr)
         {
-            if (!(*neighbour).second->_inRange)
+            if (!neighbour->_inRange)
             {
                 result |= HIGHER_NEIGHBOR_LOD_ZNEGATIVE;
             }
@@ -1215,63 +1271,11 @@ namespace igor
     {
         if (voxelBlock->_transformNodeIDQueued == iNode::INVALID_NODE_ID)
         {
-            if (voxelBlock->_voxelData != nullptr)
+            if (voxelBlock->_voxelData != nullptr &&
+                _voxelBlockPool.get(voxelBlock->_parent) != nullptr)
             {
-                auto parent = _voxelBlocksMap.find(voxelBlock->_parent);
-                if (parent != _voxelBlocksMap.end())
-                {
-                    iaString tileName = iaString::toString(voxelBlock->_positionInLOD._x);
-                    tileName += ":";
-                    tileName += iaString::toString(voxelBlock->_positionInLOD._y);
-                    tileName += ":";
-                    tileName += iaString::toString(voxelBlock->_positionInLOD._z);
-                    tileName += ":";
-                    tileName += iaString::toString(voxelBlock->_lod);
-                    tileName += ":";
-                    tileName += iaString::toString((uint32)voxelBlock->_mutationCounter++);
-
-                    iNodeTransform *transformNode = iNodeManager::getInstance().createNode<iNodeTransform>();
-                    iaVector3d transform = voxelBlock->_positionInLOD.convert<float64>();
-                    transform *= voxelBlock->_size;
-                    transformNode->translate(transform);
-
-                    iaVector3I voxelOffsetToNextLOD(childOffsetPosition[voxelBlock->_childAddress]);
-                    voxelOffsetToNextLOD *= 16;
-
-                    iVoxelData *voxelData = new iVoxelData();
-                    voxelBlock->_voxelData->getCopy(*voxelData);
-
-                    iVoxelData *voxelDataNextLOD = new iVoxelData();
-                    (*parent).second->_voxelData->getCopy(*voxelDataNextLOD);
-
-                    iParameters parameters({{IGOR_RESOURCE_PARAM_ALIAS, tileName},
-                                            {IGOR_RESOURCE_PARAM_TYPE, IGOR_RESOURCE_MODEL},
-                                            {IGOR_RESOURCE_PARAM_SUB_TYPE, "igor.vtg"},
-                                            {IGOR_RESOURCE_PARAM_CACHE_MODE, iResourceCacheMode::Free},
-                                            {IGOR_RESOURCE_PARAM_QUIET, true},
-                                            {IGOR_RESOURCE_PARAM_JOIN_VERTICES, true},
-                                            {IGOR_RESOURCE_PARAM_MATERIAL, _material},
-                                            {IGOR_RESOURCE_PARAM_GENERATE, true},
-                                            {"voxelOffsetToNextLOD", voxelOffsetToNextLOD},
-                                            {"voxelData", voxelData},
-                                            {"voxelDataNextLOD", voxelDataNextLOD},
-                                            {IGOR_RESOURCE_PARAM_LOD, voxelBlock->_lod},
-                                            {"neighboursLOD", voxelBlock->_neighboursLOD},
-                                            {IGOR_RESOURCE_PARAM_MATERIAL, _material},
-                                            {IGOR_RESOURCE_PARAM_PHYSICS_MATERIAL, _physicsMaterialID}});
-                    iModelPtr model = iResourceManager::getInstance().requestResource<iModel>(parameters);
-
-                    iNodeModel *modelNode = iNodeManager::getInstance().createNode<iNodeModel>();
-                    modelNode->setModel(model);
-
-                    transformNode->insertNode(modelNode);
-                    insertNodeAsync(_rootNode, transformNode);
-
-                    voxelBlock->_transformNodeIDQueued = transformNode->getID();
-                    voxelBlock->_modelNodeIDQueued = modelNode->getID();
-
-                    voxelBlock->_dirty = false;
-                }
+                // meshes get generated in one batch after all blocks are updated
+                _meshQueue.push_back(voxelBlock);
             }
         }
         else
@@ -1280,6 +1284,118 @@ namespace igor
         }
     }
 
+    void iVoxelTerrain::generateMeshes()
+    {
+        if (_meshQueue.empty())
+        {
+            return;
+        }
+
+        // without workers to spread the batch over the blocks get meshed one by one while their models load
+        if (!iVoxelTerrainMeshGenerator::isParallel())
+        {
+            for (auto voxelBlock : _meshQueue)
+            {
+                createMeshNodes(voxelBlock, nullptr, false);
+            }
+
+            _meshQueue.clear();
+            return;
+        }
+
+        _meshJobs.resize(_meshQueue.size());
+
+        for (size_t i = 0; i < _meshQueue.size(); ++i)
+        {
+            iVoxelBlock *voxelBlock = _meshQueue[i];
+            iVoxelMeshJob &job = _meshJobs[i];
+
+            iaVector3I voxelOffsetToNextLOD(childOffsetPosition[voxelBlock->_childAddress]);
+            voxelOffsetToNextLOD *= 16;
+
+            // voxel data is read directly here. No need for a copy because the batch is done before this update returns
+            job._voxelData = voxelBlock->_voxelData;
+            job._voxelDataNextLOD = _voxelBlockPool.get(voxelBlock->_parent)->_voxelData;
+            job._voxelOffsetToNextLOD = voxelOffsetToNextLOD;
+            job._lod = voxelBlock->_lod;
+            job._neighboursLOD = voxelBlock->_neighboursLOD;
+            job._mesh = nullptr;
+        }
+
+        iVoxelTerrainMeshGenerator::generateMeshes(_meshJobs);
+
+        for (size_t i = 0; i < _meshQueue.size(); ++i)
+        {
+            createMeshNodes(_meshQueue[i], _meshJobs[i]._mesh);
+            _meshJobs[i]._mesh = nullptr;
+        }
+
+        _meshQueue.clear();
+    }
+
+    void iVoxelTerrain::createMeshNodes(iVoxelBlock *voxelBlock, iMeshPtr mesh, bool meshGenerated)
+    {
+        iaString tileName = iaString::toString(voxelBlock->_positionInLOD._x);
+        tileName += ":";
+        tileName += iaString::toString(voxelBlock->_positionInLOD._y);
+        tileName += ":";
+        tileName += iaString::toString(voxelBlock->_positionInLOD._z);
+        tileName += ":";
+        tileName += iaString::toString(voxelBlock->_lod);
+        tileName += ":";
+        tileName += iaString::toString((uint32)voxelBlock->_mutationCounter++);
+
+        iNodeTransform *transformNode = iNodeManager::getInstance().createNode<iNodeTransform>();
+        iaVector3d transform = voxelBlock->_positionInLOD.convert<float64>();
+        transform *= voxelBlock->_size;
+        transformNode->translate(transform);
+
+        iParameters parameters({{IGOR_RESOURCE_PARAM_ALIAS, tileName},
+                                {IGOR_RESOURCE_PARAM_TYPE, IGOR_RESOURCE_MODEL},
+                                {IGOR_RESOURCE_PARAM_SUB_TYPE, "igor.vtg"},
+                                {IGOR_RESOURCE_PARAM_CACHE_MODE, iResourceCacheMode::Free},
+                                {IGOR_RESOURCE_PARAM_QUIET, true},
+                                {IGOR_RESOURCE_PARAM_JOIN_VERTICES, true},
+                                {IGOR_RESOURCE_PARAM_MATERIAL, _material},
+                                {IGOR_RESOURCE_PARAM_GENERATE, true},
+                                {IGOR_RESOURCE_PARAM_LOD, voxelBlock->_lod},
+                                {IGOR_RESOURCE_PARAM_PHYSICS_MATERIAL, _physicsMaterialID}});
+
+        if (meshGenerated)
+        {
+            parameters.setParameter("mesh", mesh);
+        }
+        else
+        {
+            iaVector3I voxelOffsetToNextLOD(childOffsetPosition[voxelBlock->_childAddress]);
+            voxelOffsetToNextLOD *= 16;
+
+            // the loader meshes later on so it needs copies of the voxel data
+            iVoxelData *voxelData = new iVoxelData();
+            voxelBlock->_voxelData->getCopy(*voxelData);
+
+            iVoxelData *voxelDataNextLOD = new iVoxelData();
+            _voxelBlockPool.get(voxelBlock->_parent)->_voxelData->getCopy(*voxelDataNextLOD);
+
+            parameters.setParameter("voxelOffsetToNextLOD", voxelOffsetToNextLOD);
+            parameters.setParameter("voxelData", voxelData);
+            parameters.setParameter("voxelDataNextLOD", voxelDataNextLOD);
+            parameters.setParameter("neighboursLOD", voxelBlock->_neighboursLOD);
+        }
+        iModelPtr model = iResourceManager::getInstance().requestResource<iModel>(parameters);
+
+        iNodeModel *modelNode = iNodeManager::getInstance().createNode<iNodeModel>();
+        modelNode->setModel(model);
+
+        transformNode->insertNode(modelNode);
+        insertNodeAsync(_rootNode, transformNode);
+
+        voxelBlock->_transformNodeIDQueued = transformNode->getID();
+        voxelBlock->_modelNodeIDQueued = modelNode->getID();
+
+        voxelBlock->_dirty = false;
+    }
+
     void iVoxelTerrain::finalizeMesh(iVoxelBlock *voxelBlock)
     {
         static int count = 0;
@@ -1307,12 +1423,9 @@ namespace igor
         iaVector3I voxelBlockPos(pos);
         voxelBlockPos /= _voxelBlockSize;
 
-        iVoxelBlock *block = nullptr;
-        const auto &voxelBlocksLOD0 = _voxelBlocks[0];
-        auto blockIter = voxelBlocksLOD0.find(voxelBlockPos);
-        if (blockIter != voxelBlocksLOD0.end())
+        iVoxelBlock *block = _voxelBlocks[0].find(voxelBlockPos);
+        if (block != nullptr)
         {
-            auto block = (*blockIter).second;
             if (block->_voxelData != nullptr &&
                 block->_voxelData->hasData())
             {
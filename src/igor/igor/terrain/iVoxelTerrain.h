@@ -37,6 +37,9 @@
 #include <igor/terrain/tasks/iTaskPropsOnVoxels.h>
 #include <igor/terrain/iVoxelTerrainMeshGenerator.h>
 #include <igor/terrain/data/iVoxelBlock.h>
+#include <igor/terrain/data/iVoxelBlockCache.h>
+#include <igor/terrain/data/iVoxelBlockMap.h>
+#include <igor/terrain/data/iVoxelBlockPool.h>
 
 #include <igor/terrain/operations/iVoxelOperation.h>
 #include <igor/data/iAABox.h>
@@ -46,6 +49,7 @@
 using namespace iaux;
 
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
 
 namespace igor
@@ -61,28 +65,6 @@ namespace igor
 
         friend class iTaskVoxelTerrain;
 
-        /*! voxel block address hasher
-        */
-        class iVectorHasher
-        {
-        public:
-            size_t operator()(iaVector3I const &key) const
-            {
-                return (key._x << 1) ^ (key._y << 2) ^ (key._z << 3);
-            }
-        };
-
-        /*! voxel block position comparison
-        */
-        class iVectorEqualFn
-        {
-        public:
-            bool operator()(iaVector3I const &t1, iaVector3I const &t2) const
-            {
-                return t1 == t2;
-            };
-        };
-
     public:
         /*! block qubic size
 
@@ -139,6 +121,31 @@ namespace igor
         */
         iMaterialPtr getMaterial() const;
 
+        /*! sets storage backend for voxel blocks created from now on
+
+        default is iVoxelStorage::RLE
+
+        \param storage the storage backend
+        */
+        void setVoxelStorage(iVoxelStorage storage);
+
+        /*! \returns storage backend of voxel blocks
+        */
+        iVoxelStorage getVoxelStorage() const;
+
+        /*! sets cache for voxel blocks
+
+        blocks found in the cache get loaded instead of generated. Generated and modified blocks get stored in it.
+        Must be set before blocks get generated. nullptr disables caching (default)
+
+        \param voxelBlockCache the voxel block cache
+        */
+        void setVoxelBlockCache(iVoxelBlockCachePtr voxelBlockCache);
+
+        /*! \returns cache for voxel blocks
+        */
+        iVoxelBlockCachePtr getVoxelBlockCache() const;
+
         /*! modifies voxel data by manipulating a box area
 
         \param box the defined box area to manipulate
@@ -177,6 +184,14 @@ namespace igor
         */
         uint32 _lowestLOD = 0;
 
+        /*! storage backend of voxel blocks
+        */
+        iVoxelStorage _voxelStorage = iVoxelStorage::RLE;
+
+        /*! optional cache for voxel blocks
+        */
+        iVoxelBlockCachePtr _voxelBlockCache;
+
         /*! voxel block discovery distance in blocks
         */
         int64 _voxelBlockDiscoveryDistance = 0;
@@ -213,26 +228,48 @@ namespace igor
         */
         std::vector<iNodeManager::iAction> _actionQueue;
 
-        /*! mutex to protect action queue
+        /*! blocks waiting for their mesh to be generated in the next batch
         */
-        iaMutex _mutexActionQueue;
+        std::vector<iVoxelBlock *> _meshQueue;
 
-        /*! the voxel data
+        /*! mesh jobs of the current batch. Kept to reuse the memory
         */
-        std::vector<std::unordered_map<iaVector3I, iVoxelBlock *, iVectorHasher, iVectorEqualFn>> _voxelBlocks;
+        std::vector<iVoxelMeshJob> _meshJobs;
 
-        /*! map of voxel block IDs to voxel blocks
+        /*! mutex to protect action queue
         */
-        std::map<uint64, iVoxelBlock *> _voxelBlocksMap;
+        iaMutex _mutexActionQueue;
+
+        /*! the voxel blocks per LOD by position
+        */
+        std::vector<iVoxelBlockMap> _voxelBlocks;
 
-        /*! next voxel block id
+        /*! owns all voxel blocks and maps voxel block IDs to voxel blocks
         */
-        uint64 _nextVoxelBlockID = 1;
+        iVoxelBlockPool _voxelBlockPool;
 
         /*! map of voxel blocks that have to be deleted
         */
         std::vector<iVoxelBlock *> _voxelBlocksToDelete;
 
+        /*! interval in milliseconds in which modified blocks get written to the voxel block cache
+        */
+        static const int64 MODIFIED_BLOCKS_STORE_INTERVAL = 1000;
+
+        /*! ids of blocks modified since they where last written to the voxel block cache
+
+        a block that gets modified many times in a row this way only gets copied and written once per interval
+        */
+        std::unordered_set<uint64> _modifiedVoxelBlocks;
+
+        /*! last time the modified blocks where written to the voxel block cache
+        */
+        iaTime _lastModifiedBlocksStore;
+
+        /*! blocks of lowest LOD found outside of discovery range. Only a member to keep the capacity
+        */
+        std::vector<iVoxelBlock *> _outOfRangeBlocks;
+
         /*! keep observer position since last discovery
         */
         iaVector3I _lastDiscoveryPosition;
@@ -262,6 +299,16 @@ namespace igor
 
         void deleteBlocks();
         void deleteBlock(iVoxelBlock *voxelBlock);
+
+        /*! writes modified blocks to the voxel block cache once the store interval passed
+        */
+        void storeModifiedBlocks();
+
+        /*! writes modified block to the voxel block cache
+
+        \param voxelBlock the block to write
+        */
+        void storeModifiedBlock(iVoxelBlock *voxelBlock);
         bool canBeDeleted(iVoxelBlock *voxelBlock);
 
         /*! discovers if there are unknown blocks of lowest LOD near by
@@ -302,6 +349,18 @@ namespace igor
         void updateMesh(iVoxelBlock *voxelBlock);
         void finalizeMesh(iVoxelBlock *voxelBlock);
 
+        /*! generates meshes of all blocks in the mesh queue as one parallel batch
+        */
+        void generateMeshes();
+
+        /*! creates model and transform node for a block
+
+        \param voxelBlock the block the mesh belongs to
+        \param mesh the mesh (can be empty)
+        \param meshGenerated if false the mesh gets generated from copies of the voxel data while the model loads
+        */
+        void createMeshNodes(iVoxelBlock *voxelBlock, iMeshPtr mesh, bool meshGenerated = true);
+
         void setNodeActiveAsync(iNodePtr node, bool active);
         void insertNodeAsync(iNodePtr src, iNodePtr dst);
         void removeNodeAsync(iNodePtr src, iNodePtr dst);
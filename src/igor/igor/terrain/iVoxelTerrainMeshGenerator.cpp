@@ -9,6 +9,12 @@
 
 #include <igor/scene/nodes/iNodeTransform.h>
 #include <igor/scene/nodes/iNodePhysics.h>
+#include <igor/threading/iTaskManager.h>
+
+#include <iaux/system/iaMutex.h>
+using namespace iaux;
+
+#include <memory>
 
 // uncomment next line for voxel terrain debug using no physics
 // #define DEBUG_VOXEL_TERRAIN_NO_PHYSICS
@@ -16,6 +22,41 @@
 namespace igor
 {
 
+    /*! contouring cubes not in use. They serve as scratch arenas and keep their buffers between blocks
+    */
+    static std::vector<std::unique_ptr<iContouringCubes>> s_contouringCubesPool;
+
+    /*! protects the pool
+    */
+    static iaMutex s_contouringCubesPoolMutex;
+
+    static std::unique_ptr<iContouringCubes> acquireContouringCubes()
+    {
+        std::unique_ptr<iContouringCubes> result;
+
+        s_contouringCubesPoolMutex.lock();
+        if (!s_contouringCubesPool.empty())
+        {
+            result = std::move(s_contouringCubesPool.back());
+            s_contouringCubesPool.pop_back();
+        }
+        s_contouringCubesPoolMutex.unlock();
+
+        if (result == nullptr)
+        {
+            result = std::make_unique<iContouringCubes>();
+        }
+
+        return result;
+    }
+
+    static void releaseContouringCubes(std::unique_ptr<iContouringCubes> contouringCubes)
+    {
+        s_contouringCubesPoolMutex.lock();
+        s_contouringCubesPool.push_back(std::move(contouringCubes));
+        s_contouringCubesPoolMutex.unlock();
+    }
+
     iVoxelTerrainMeshGenerator::iVoxelTerrainMeshGenerator()
     {
         _identifier = "igor.vtg";
@@ -28,6 +69,47 @@ namespace igor
         return static_cast<iModelDataIO *>(result);
     }
 
+    void iVoxelTerrainMeshGenerator::generateMesh(iContouringCubes &contouringCubes, iVoxelMeshJob &job)
+    {
+        con_assert(job._voxelData != nullptr, "zero pointer");
+
+        contouringCubes.setVoxelData(job._voxelData);
+        contouringCubes.setVoxelDataNextLOD(job._voxelDataNextLOD);
+        contouringCubes.setNextLODVoxelOffset(job._voxelOffsetToNextLOD);
+
+        job._mesh = contouringCubes.compile(iaVector3I(), iaVector3I(job._voxelData->getWidth(), job._voxelData->getHeight(), job._voxelData->getDepth()), job._lod, job._neighboursLOD);
+    }
+
+    void iVoxelTerrainMeshGenerator::generateMeshes(std::vector<iVoxelMeshJob> &jobs)
+    {
+        auto generate = [&jobs](uint64 begin, uint64 end)
+        {
+            std::unique_ptr<iContouringCubes> contouringCubes = acquireContouringCubes();
+
+            for (uint64 i = begin; i < end; ++i)
+            {
+                generateMesh(*contouringCubes, jobs[i]);
+            }
+
+            releaseContouringCubes(std::move(contouringCubes));
+        };
+
+        if (isParallel())
+        {
+            iTaskManager::getInstance().parallelFor(0, jobs.size(), generate, 1);
+        }
+        else
+        {
+            generate(0, jobs.size());
+        }
+    }
+
+    bool iVoxelTerrainMeshGenerator::isParallel()
+    {
+        return iTaskManager::isInstantiated() &&
+               iTaskManager::getInstance().getRegularThreadCount() > 1;
+    }
+
     IGOR_DISABLE_WARNING(4100)
     iNodePtr iVoxelTerrainMeshGenerator::importData(const iParameters &parameters)
     {
@@ -42,18 +124,29 @@ namespace igor
         const iaString sectionName = parameters.getParameter<iaString>("name", "");
         const uint64 physicsMaterialID = parameters.getParameter<uint64>(IGOR_RESOURCE_PARAM_PHYSICS_MATERIAL, 0);
 
-        const int64 width = voxelData->getWidth();
-        const int64 height = voxelData->getHeight();
-        const int64 depth = voxelData->getDepth();
-
         iNodePtr result = iNodeManager::getInstance().createNode<iNode>("group");
 
-        iContouringCubes contouringCubes;
-        contouringCubes.setVoxelData(voxelData);
-        contouringCubes.setVoxelDataNextLOD(voxelDataNextLOD);
-        contouringCubes.setNextLODVoxelOffset(voxelOffsetToNextLOD);
-
-        iMeshPtr mesh = contouringCubes.compile(iaVector3I(), iaVector3I(width, height, depth), lod, neighboursLOD);        
+        iMeshPtr mesh;
+        if (parameters.hasParameter("mesh"))
+        {
+            // already generated with generateMeshes
+            mesh = parameters.getParameter<iMeshPtr>("mesh", nullptr);
+        }
+        else
+        {
+            iVoxelMeshJob job;
+            job._voxelData = voxelData;
+            job._voxelDataNextLOD = voxelDataNextLOD;
+            job._voxelOffsetToNextLOD = voxelOffsetToNextLOD;
+            job._lod = lod;
+            job._neighboursLOD = neighboursLOD;
+
+            std::unique_ptr<iContouringCubes> contouringCubes = acquireContouringCubes();
+            generateMesh(*contouringCubes, job);
+            releaseContouringCubes(std::move(contouringCubes));
+
+            mesh = job._mesh;
+        }
 
         if (mesh.get() != nullptr)
         {
@@ -32,17 +32,49 @@
 #include <igor/resources/model/loader/iModelDataIO.h>
 #include <igor/resources/shader_material/iShaderMaterial.h>
 #include <igor/resources/material/iMaterial.h>
+#include <igor/resources/mesh/iMesh.h>
 
 #include <iaux/math/iaVector3.h>
 #include <iaux/math/iaRandomNumberGenerator.h>
 using namespace iaux;
 
+#include <vector>
+
 namespace igor
 {
     class iContouringCubes;
     class iVoxelData;
     class iMeshBuilder;
 
+    /*! input and output of a voxel block to be meshed in a batch
+    */
+    struct IGOR_API iVoxelMeshJob
+    {
+        /*! voxel data of the block to mesh
+        */
+        iVoxelData *_voxelData = nullptr;
+
+        /*! voxel data of the next (lower resolution) LOD
+        */
+        iVoxelData *_voxelDataNextLOD = nullptr;
+
+        /*! offset to next lod voxel data
+        */
+        iaVector3I _voxelOffsetToNextLOD;
+
+        /*! the lod of the block
+        */
+        uint32 _lod = 0;
+
+        /*! lod transition flags of the neighbours
+        */
+        uint8 _neighboursLOD = 0;
+
+        /*! the resulting mesh. Stays empty if there was no surface within the block
+        */
+        iMeshPtr _mesh;
+    };
+
     /*! voxel terrain mesh generator
      */
     class iVoxelTerrainMeshGenerator : public iModelDataIO
@@ -71,6 +103,30 @@ namespace igor
         \returns new instance
         */
         static iModelDataIO *createInstance();
+
+        /*! generates meshes for a batch of voxel blocks
+
+        The blocks are distributed over the regular task threads (if the task manager is running).
+        Every worker reuses a pooled iContouringCubes with all its buffers, so no scratch memory
+        gets allocated per block once the pool is warm.
+
+        \param[in,out] jobs the blocks to mesh. Results end up in iVoxelMeshJob::_mesh
+        */
+        static void generateMeshes(std::vector<iVoxelMeshJob> &jobs);
+
+        /*! \returns true if generateMeshes has more than one regular task thread to spread a batch over
+
+        with a single worker a batch is slower than meshing every block while loading its model
+        */
+        static bool isParallel();
+
+    private:
+        /*! generates mesh for a single job
+
+        \param contouringCubes the scratch contouring cubes to use
+        \param job the job to process
+        */
+        static void generateMesh(iContouringCubes &contouringCubes, iVoxelMeshJob &job);
     };
 
 } // namespace igor
@@ -4,17 +4,20 @@
 
 #include <igor/terrain/tasks/iTaskGenerateVoxels.h>
 
+#include <igor/terrain/data/iVoxelBlockCache.h>
+
 #include <iaux/system/iaConsole.h>
 using namespace iaux;
 
 namespace igor
 {
 
-    iTaskGenerateVoxels::iTaskGenerateVoxels(iVoxelBlockInfo *voxelBlockInfo, uint32 priority, iVoxelTerrainGenerateDelegate generateVoxelsDelegate)
+    iTaskGenerateVoxels::iTaskGenerateVoxels(iVoxelBlockInfo *voxelBlockInfo, uint32 priority, iVoxelTerrainGenerateDelegate generateVoxelsDelegate, iVoxelBlockCachePtr voxelBlockCache)
         : iTask(nullptr, priority, false)
     {
         _voxelBlockInfo = voxelBlockInfo;
         _generateVoxelsDelegate = generateVoxelsDelegate;
+        _voxelBlockCache = voxelBlockCache;
     }
 
     void iTaskGenerateVoxels::run()
@@ -25,7 +28,18 @@ namespace igor
         if (_voxelBlockInfo != nullptr &&
             _voxelBlockInfo->_voxelData != nullptr)
         {
+            if (_voxelBlockCache != nullptr &&
+                _voxelBlockCache->load(_voxelBlockInfo->_lod, _voxelBlockInfo->_positionInLOD, *_voxelBlockInfo->_voxelData, _voxelBlockInfo->_transition))
+            {
+                return;
+            }
+
             _generateVoxelsDelegate(_voxelBlockInfo);
+
+            if (_voxelBlockCache != nullptr)
+            {
+                _voxelBlockCache->store(_voxelBlockInfo->_lod, _voxelBlockInfo->_positionInLOD, *_voxelBlockInfo->_voxelData, _voxelBlockInfo->_transition);
+            }
         }
     }
 
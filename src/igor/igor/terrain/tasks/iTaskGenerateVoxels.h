@@ -30,6 +30,7 @@
 #define __IGOR_TASKGENERATEVOXELS__
 
 #include <igor/threading/tasks/iTask.h>
+#include <igor/terrain/data/iVoxelBlockCache.h>
 
 #include <iaux/data/iaSphere.h>
 #include <iaux/math/iaVector3.h>
@@ -92,9 +93,9 @@ namespace igor
         \param voxelBlockInfo the voxel block to generate the data for
         \param priority the priority to run this task with
         \param generateVoxelsDelegate the delegate to do the actual work
-        \param voxelDataGeneratedDelegate the delegate to be called after generating the voxels
+        \param voxelBlockCache optional cache to load the voxels from instead of generating them. Generated voxels get stored in it
         */
-        iTaskGenerateVoxels(iVoxelBlockInfo *voxelBlockInfo, uint32 priority, iVoxelTerrainGenerateDelegate generateVoxelsDelegate);
+        iTaskGenerateVoxels(iVoxelBlockInfo *voxelBlockInfo, uint32 priority, iVoxelTerrainGenerateDelegate generateVoxelsDelegate, iVoxelBlockCachePtr voxelBlockCache = nullptr);
 
         /*! does nothing
         */
@@ -113,6 +114,10 @@ namespace igor
         /*! the data to work with
         */
         iVoxelBlockInfo *_voxelBlockInfo = nullptr;
+
+        /*! the cache to load from and store to. Shared so it stays alive if the terrain replaces it while the task runs
+        */
+        iVoxelBlockCachePtr _voxelBlockCache;
     };
 } // namespace igor
 
@@ -0,0 +1,95 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/threading/iFixedStepThread.h>
+
+#include <iaux/system/iaConsole.h>
+
+#include <thread>
+
+namespace igor
+{
+
+    iFixedStepThread::iFixedStepThread(iFixedStepDelegate stepDelegate, float64 rate, uint32 maxCatchUpSteps)
+        : iaThread("iFixedStepThread"), _stepDelegate(stepDelegate), _maxCatchUpSteps(std::max(1u, maxCatchUpSteps))
+    {
+        con_assert(rate > 0.0, "invalid rate");
+
+        _timeDelta = iaTime::fromSeconds(1.0 / rate);
+    }
+
+    iFixedStepThread::~iFixedStepThread()
+    {
+        stop();
+    }
+
+    void iFixedStepThread::start()
+    {
+        con_assert(getState() == iaThreadState::Init && !_running, "fixed step thread can only be started once");
+
+        _running = true;
+        run(iThreadCallbackDelegate(this, &iFixedStepThread::stepLoop));
+    }
+
+    void iFixedStepThread::stop()
+    {
+        if (!_running.exchange(false))
+        {
+            return;
+        }
+
+        join();
+    }
+
+    bool iFixedStepThread::isRunning() const
+    {
+        return _running;
+    }
+
+    const iaTime &iFixedStepThread::getTimeDelta() const
+    {
+        return _timeDelta;
+    }
+
+    uint64 iFixedStepThread::getStepCount() const
+    {
+        return _stepCount;
+    }
+
+    uint64 iFixedStepThread::getDroppedStepCount() const
+    {
+        return _droppedStepCount;
+    }
+
+    void iFixedStepThread::stepLoop(iaThread *thread)
+    {
+        iaTime nextStep = iaTime::getNow();
+
+        while (_running.load(std::memory_order_relaxed))
+        {
+            const iaTime now = iaTime::getNow();
+
+            if (now < nextStep)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds((nextStep - now).getMicroseconds()));
+                continue;
+            }
+
+            // drop the backlog instead of trying to catch up with it
+            const iaTime maxBacklog = _timeDelta * static_cast<float64>(_maxCatchUpSteps);
+            if (now - nextStep > maxBacklog)
+            {
+                const uint64 dropped = static_cast<uint64>((now - nextStep).getMicroseconds() / _timeDelta.getMicroseconds());
+                _droppedStepCount += dropped;
+                nextStep += _timeDelta * static_cast<float64>(dropped);
+            }
+
+            _stepDelegate(nextStep, _timeDelta);
+            _stepCount++;
+
+            nextStep += _timeDelta;
+        }
+    }
+
+}; // namespace igor
@@ -0,0 +1,131 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_FIXEDSTEPTHREAD__
+#define __IGOR_FIXEDSTEPTHREAD__
+
+#include <igor/iDefines.h>
+
+#include <iaux/system/iaThread.h>
+#include <iaux/system/iaTime.h>
+using namespace iaux;
+
+#include <atomic>
+
+namespace igor
+{
+
+    /*! step delegate
+
+    first parameter is the time the step was scheduled for, second the time delta of one step
+    */
+    typedef iaDelegate<void, const iaTime &, const iaTime &> iFixedStepDelegate;
+
+    /*! thread that calls a delegate at a fixed rate independent of the frame rate
+
+    if a step takes longer than the time between two steps the following steps are done back to back until the
+    thread caught up again. If it falls behind by more than the maximum catch up steps the backlog gets dropped
+    so a hitch can not turn in to a spiral of catch up steps.
+
+    a fixed step thread can only be started once
+    */
+    class IGOR_API iFixedStepThread : public iaThread
+    {
+
+    public:
+        /*! init members
+
+        \param stepDelegate the delegate called every step
+        \param rate step rate in Hz
+        \param maxCatchUpSteps maximum steps done back to back before the backlog gets dropped
+        */
+        iFixedStepThread(iFixedStepDelegate stepDelegate, float64 rate, uint32 maxCatchUpSteps = 3);
+
+        /*! stops the thread if still running
+        */
+        ~iFixedStepThread();
+
+        /*! starts stepping
+        */
+        void start();
+
+        /*! stops stepping and waits for the current step to finish
+        */
+        void stop();
+
+        /*! \returns true if the thread is stepping
+        */
+        bool isRunning() const;
+
+        /*! \returns time delta between two steps
+        */
+        const iaTime &getTimeDelta() const;
+
+        /*! \returns amount of steps done so far
+        */
+        uint64 getStepCount() const;
+
+        /*! \returns amount of steps dropped because the thread fell to far behind
+        */
+        uint64 getDroppedStepCount() const;
+
+    private:
+        /*! the delegate called every step
+        */
+        iFixedStepDelegate _stepDelegate;
+
+        /*! time delta between two steps
+        */
+        iaTime _timeDelta;
+
+        /*! maximum steps done back to back
+        */
+        uint32 _maxCatchUpSteps;
+
+        /*! if true the thread keeps stepping
+        */
+        std::atomic<bool> _running = false;
+
+        /*! amount of steps done
+        */
+        std::atomic<uint64> _stepCount = 0;
+
+        /*! amount of steps dropped
+        */
+        std::atomic<uint64> _droppedStepCount = 0;
+
+        /*! the stepping loop
+
+        \param thread the thread it runs in
+        */
+        void stepLoop(iaThread *thread);
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_FIXEDSTEPTHREAD__
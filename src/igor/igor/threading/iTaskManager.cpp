@@ -9,15 +9,21 @@
 #include <igor/threading/tasks/iTask.h>
 #include <igor/system/iWindow.h>
 #include <igor/resources/config/iConfigReader.h>
+#include <igor/resources/profiler/iProfiler.h>
 
 #include <iaux/system/iaConsole.h>
+#include <iaux/system/iaClock.h>
 
 #include <thread>
 #include <chrono>
 
 namespace igor
 {
-    bool iTaskManager::_running = false;
+    std::atomic<bool> iTaskManager::_running = false;
+
+    /*! index of the regular thread we are in. -1 if we are not in a regular thread
+    */
+    static thread_local int32 _regularThreadIndex = -1;
 
     static int64 getThreadCountFromConfig()
     {
@@ -42,15 +48,47 @@ namespace igor
         return std::max(minThreads, maxThreads);
     }
 
+    static void getIdlePolicyFromConfig(iThreadIdlePolicy &policy, int64 &spinTime)
+    {
+        if (iConfigReader::getInstance().hasSetting("threadIdlePolicy"))
+        {
+            const iaString value = iConfigReader::getInstance().getValue("threadIdlePolicy");
+
+            if (value == "Spin")
+            {
+                policy = iThreadIdlePolicy::Spin;
+            }
+            else if (value == "Park")
+            {
+                policy = iThreadIdlePolicy::Park;
+            }
+            else if (value == "SpinThenPark")
+            {
+                policy = iThreadIdlePolicy::SpinThenPark;
+            }
+            else
+            {
+                con_warn("unknown thread idle policy \"" << value << "\"");
+            }
+        }
+
+        if (iConfigReader::getInstance().hasSetting("threadSpinTime"))
+        {
+            spinTime = iConfigReader::getInstance().getValueAsInt("threadSpinTime");
+        }
+    }
+
     iTaskManager::iTaskManager()
     {
         iTaskManager::_running = true;
 
+        iThreadIdlePolicy policy = _idlePolicy;
+        int64 spinTime = _idleSpinTime;
+        getIdlePolicyFromConfig(policy, spinTime);
+        setIdlePolicy(policy, iaTime::fromMicroseconds(spinTime));
+
         int32 numThreads = getThreadCountFromConfig();
-        for (int i = 0; i < numThreads; ++i)
-        {
-            createThread();
-        }
+        createThreads(numThreads);
 
         if (numThreads != 0)
         {
@@ -62,101 +100,95 @@ namespace igor
     {
         iTaskManager::_running = false;
 
-        flushIncomingTasks();
-
-        // clear all tasks left in render context queue
-        _mutexRenderContextTasks.lock();
-        for (auto task : _renderContextTasksQueued)
-        {
-            delete task;
-        }
-        _renderContextTasksQueued.clear();
-        _mutexRenderContextTasks.unlock();
+        wakeThreads(_regularParking, true);
+        wakeThreads(_renderContextParking, true);
 
-        // clear all tasks left in regular queue
-        _mutexRegularTasks.lock();
-        for (auto task : _regularTasksQueued)
+        // abort all running tasks
+        _mutexRenderContextThreads.lock();
+        for (auto &pair : _renderContextThreads)
         {
-            delete task;
+            pair.second._stopThread = true;
+            abortRunningTask(pair.second._currentTask);
         }
-        _regularTasksQueued.clear();
-        _mutexRegularTasks.unlock();
-
-        // than finish all task that are already running
-        con_debug("waiting for " << _renderContextTasksRunning.size() << " render context tasks to finish");
+        _mutexRenderContextThreads.unlock();
 
-        // first the render context tasks
-        _mutexRenderContextTasks.lock();
-        for (auto task : _renderContextTasksRunning)
+        for (auto context : _regularThreads)
         {
-            task->abort();
-
-            while (task->isRunning())
-            {
-                std::this_thread::yield();
-            }
-
-            delete task;
+            abortRunningTask(context->_currentTask);
         }
-        _renderContextTasksRunning.clear();
-        _mutexRenderContextTasks.unlock();
-
-        con_debug("waiting for " << _regularTasksRunning.size() << " regular tasks to finish");
-
-        // than the regular tasks
-        _mutexRegularTasks.lock();
-        for (auto task : _regularTasksRunning)
-        {
-            task->abort();
-
-            while (task->isRunning())
-            {
-                std::this_thread::yield();
-            }
 
-            delete task;
-        }
-        _regularTasksRunning.clear();
-        _mutexRegularTasks.unlock();
-
-        // now stop and kill all threads
+        // now stop and kill all threads. they will finish the task at hand first
         con_debug("waiting for " << _renderContextThreads.size() << " render context threads to join");
 
         // render context threads
         _mutexRenderContextThreads.lock();
-        auto threadIter = _renderContextThreads.begin();
-        while (_renderContextThreads.end() != threadIter)
+        for (auto &pair : _renderContextThreads)
         {
-            (*threadIter).second._stopThread = true;
-            (*threadIter).first->join();
-            delete (*threadIter).first;
-            threadIter++;
+            pair.first->join();
+            delete pair.first;
         }
         _renderContextThreads.clear();
         _mutexRenderContextThreads.unlock();
 
         con_debug("waiting for " << _regularThreads.size() << " regular threads to join");
 
-        // and regular threads
-        _mutexRegularThreads.lock();
-        for (auto thread : _regularThreads)
+        // and regular threads. all of them have to be joined before any queue goes away because they steal from each other
+        for (auto context : _regularThreads)
         {
-            thread->join();
-            delete thread;
+            context->_thread->join();
+        }
+
+        std::vector<iTask *> tasksLeft;
+        for (auto context : _regularThreads)
+        {
+            delete context->_thread;
+            context->_queue.clear(tasksLeft);
+            delete context;
         }
         _regularThreads.clear();
-        _mutexRegularThreads.unlock();
+
+        // delete all tasks left. that includes tasks in queues and tasks waiting for other tasks
+        _renderContextTasksQueued.clear(tasksLeft);
+
+        _mutexAllTasks.lock();
+        for (auto &pair : _allTasks)
+        {
+            delete pair.second;
+        }
+        _allTasks.clear();
+        _continuations.clear();
+        _mutexAllTasks.unlock();
 
         con_debug("threading done");
     }
 
     void iTaskManager::abortTask(iTaskID taskID)
     {
-        iTask *task = getTask(taskID);
+        _mutexAllTasks.lock();
+        auto iter = _allTasks.find(taskID);
+        if (iter != _allTasks.end())
+        {
+            iter->second->abort();
+        }
+        _mutexAllTasks.unlock();
+    }
+
+    void iTaskManager::abortRunningTask(const std::atomic<iTask *> &currentTask)
+    {
+        // a thread resets its current task before the task gets removed from the all tasks list and deleted.
+        // so reading it while holding the lock gives either nullptr or a task that is still alive
+        _mutexAllTasks.lock();
+        iTask *task = currentTask;
         if (task != nullptr)
         {
-            task->abort();
+            auto iter = _allTasks.find(task->getID());
+            if (iter != _allTasks.end() &&
+                iter->second == task)
+            {
+                task->abort();
+            }
         }
+        _mutexAllTasks.unlock();
     }
 
     uint32 iTaskManager::getRegularThreadCount() const
@@ -171,22 +203,29 @@ namespace igor
 
     uint32 iTaskManager::getQueuedRegularTaskCount() const
     {
-        return static_cast<uint32>(_regularTasksQueued.size());
+        uint32 result = 0;
+
+        for (auto context : _regularThreads)
+        {
+            result += context->_queue.getSize();
+        }
+
+        return result;
     }
 
     uint32 iTaskManager::getRunningRegularTaskCount() const
     {
-        return static_cast<uint32>(_regularTasksRunning.size());
+        return _regularTasksRunning;
     }
 
     uint32 iTaskManager::getQueuedRenderContextTaskCount() const
     {
-        return static_cast<uint32>(_renderContextTasksQueued.size());
+        return _renderContextTasksQueued.getSize();
     }
 
     uint32 iTaskManager::getRunningRenderContextTaskCount() const
     {
-        return static_cast<uint32>(_renderContextTasksRunning.size());
+        return _renderContextTasksRunning;
     }
 
     bool iTaskManager::isRunning()
@@ -237,11 +276,8 @@ namespace igor
         iRenderContextThread *workerThread = new iRenderContextThread(window);
         if (workerThread->isValid())
         {
-            ThreadContext context;
-            context._window = window;
-
             _mutexRenderContextThreads.lock();
-            _renderContextThreads[workerThread] = context;
+            _renderContextThreads[workerThread]._window = window;
             _mutexRenderContextThreads.unlock();
 
             workerThread->run(iThreadCallbackDelegate(this, &iTaskManager::workWithRenderContextTasks));
@@ -254,72 +290,50 @@ namespace igor
         }
     }
 
-    void iTaskManager::createThread()
+    void iTaskManager::createThreads(int32 numThreads)
     {
-        iThread *workerThread = new iThread();
-        workerThread->run(iThreadCallbackDelegate(this, &iTaskManager::workWithRegularTasks));
+        // all contexts must exist before the first thread starts stealing
+        for (int32 i = 0; i < numThreads; ++i)
+        {
+            RegularThreadContext *context = new RegularThreadContext();
+            context->_thread = new iThread();
+            _regularThreads.push_back(context);
+        }
 
-        _mutexRegularThreads.lock();
-        _regularThreads.push_back(workerThread);
-        _mutexRegularThreads.unlock();
+        for (auto context : _regularThreads)
+        {
+            context->_thread->run(iThreadCallbackDelegate(this, &iTaskManager::workWithRegularTasks));
+        }
     }
 
     void iTaskManager::killRenderContextThreads(iWindowPtr window)
     {
-        _mutexRenderContextTasks.lock();
-        for (auto task : _renderContextTasksQueued)
-        {
-            delete task;
-        }
-        _renderContextTasksQueued.clear();
+        // remove all queued render context tasks
+        std::vector<iTask *> tasksToDelete;
+        _renderContextTasksQueued.clear(tasksToDelete);
 
-        std::vector<iTaskID> removeFromAllTasks;
+        // tasks waiting for the removed tasks must not wait forever
+        std::vector<iTask *> readyTasks;
 
-        // stop running render context tasks
-        auto taskIter = _renderContextTasksRunning.begin();
-        while (taskIter != _renderContextTasksRunning.end())
+        _mutexAllTasks.lock();
+        for (auto task : tasksToDelete)
         {
-            if ((*taskIter)->_window == window &&
-                (*taskIter)->isRunning())
-            {
-                (*taskIter)->abort();
-
-                while ((*taskIter)->isRunning())
-                {
-                    std::this_thread::yield();
-                }
-
-                removeFromAllTasks.push_back((*taskIter)->getID());
-                taskIter = _renderContextTasksRunning.erase(taskIter);
-            }
-            else
-            {
-                taskIter++;
-            }
+            _allTasks.erase(task->getID());
+            releaseContinuations(task->getID(), readyTasks);
         }
-        _mutexRenderContextTasks.unlock();
+        _mutexAllTasks.unlock();
 
-        // remove stopped tasks from all task list
-        for (auto id : removeFromAllTasks)
+        for (auto task : tasksToDelete)
         {
-            _mutexAllTasks.lock();
-            auto iter = _allTasks.find(id);
-            if (iter != _allTasks.end())
-            {
-                _allTasks.erase(iter);
-            }
-            else
-            {
-                con_err("inconsistent data");
-            }
-            _mutexAllTasks.unlock();
+            delete task;
+        }
 
-            delete (*iter).second;
-            _tasksDone++;
-            _taskFinished(id);
+        for (auto task : readyTasks)
+        {
+            queueTask(task);
         }
 
-        // remove render context threads
+        // stop running render context tasks and remove their threads
         _mutexRenderContextThreads.lock();
         auto threadIter = _renderContextThreads.begin();
         while (_renderContextThreads.end() != threadIter)
@@ -327,6 +341,9 @@ namespace igor
             if ((*threadIter).second._window == window)
             {
                 (*threadIter).second._stopThread = true;
+                wakeThreads(_renderContextParking, true);
+                abortRunningTask((*threadIter).second._currentTask);
+
                 (*threadIter).first->join();
                 delete (*threadIter).first;
                 threadIter = _renderContextThreads.erase(threadIter);
@@ -341,87 +358,54 @@ namespace igor
 
     void iTaskManager::workWithRenderContextTasks(iaThread *thread)
     {
-        iTask *taskTodo = nullptr;
         ThreadContext *context = nullptr;
 
         // find the context we use in this thread
         _mutexRenderContextThreads.lock();
-        auto threadIter = _renderContextThreads.begin();
-        while (_renderContextThreads.end() != threadIter)
+        auto threadIter = _renderContextThreads.find(static_cast<iRenderContextThread *>(thread));
+        if (threadIter != _renderContextThreads.end())
         {
-            if ((*threadIter).first == thread)
-            {
-                context = &((*threadIter).second);
-                break;
-            }
-            ++threadIter;
+            context = &((*threadIter).second);
         }
         _mutexRenderContextThreads.unlock();
 
+        con_assert(context != nullptr, "inconsistent data");
+
+        int64 idleSince = 0;
+
         while (iTaskManager::isRunning() && !context->_stopThread)
         {
-            taskTodo = nullptr;
-
-            flushIncomingTasks();
+            iTask *taskTodo = nullptr;
+            const uint64 signal = _renderContextParking._signal;
 
-            _mutexRenderContextTasks.lock();
-            if (_renderContextTasksQueued.size())
+            for (uint32 bucket = 0; bucket < iTaskQueue::BUCKET_COUNT; ++bucket)
             {
-                taskTodo = (*_renderContextTasksQueued.begin());
-                _renderContextTasksQueued.pop_front();
-                _renderContextTasksRunning.push_back(taskTodo);
+                taskTodo = _renderContextTasksQueued.pop(bucket);
+                if (taskTodo != nullptr)
+                {
+                    break;
+                }
             }
-            _mutexRenderContextTasks.unlock();
 
-            if (taskTodo)
+            if (taskTodo != nullptr)
             {
+                stopIdle(idleSince);
+
+                context->_currentTask = taskTodo;
+                _renderContextTasksRunning++;
+
                 taskTodo->setWorldID(static_cast<iThread *>(thread)->getWorld());
                 taskTodo->run();
                 taskTodo->finishTask();
 
-                iTaskID idToDelete = iTask::INVALID_TASK_ID;
-
-                _mutexRenderContextTasks.lock();
-                std::list<iTask *>::iterator findIter = find(_renderContextTasksRunning.begin(), _renderContextTasksRunning.end(), taskTodo);
-                if (findIter != _renderContextTasksRunning.end())
-                {
-                    _renderContextTasksRunning.erase(findIter);
+                _renderContextTasksRunning--;
+                context->_currentTask = nullptr;
 
-                    if (taskTodo->isRepeating())
-                    {
-                        _renderContextTasksQueued.push_back(taskTodo);
-                    }
-                    else
-                    {
-                        idToDelete = taskTodo->getID();
-                    }
-                }
-                _mutexRenderContextTasks.unlock();
-
-                if (idToDelete != iTask::INVALID_TASK_ID)
-                {
-                    _mutexAllTasks.lock();
-                    auto iter = _allTasks.find(idToDelete);
-                    if (iter != _allTasks.end())
-                    {
-                        _allTasks.erase(iter);
-                    }
-                    else
-                    {
-                        con_err("inconsistent data");
-                    }
-                    _mutexAllTasks.unlock();
-
-                    delete taskTodo;
-                    _tasksDone++;
-                    _taskFinished(idToDelete);
-                }
-
-                taskTodo = nullptr;
+                retireTask(taskTodo, _renderContextTasksQueued);
             }
             else
             {
-                std::this_thread::yield();
+                idle(_renderContextParking, signal, idleSince, &context->_stopThread);
             }
         }
     }
@@ -431,119 +415,334 @@ namespace igor
         return _tasksDone;
     }
 
-    void iTaskManager::workWithRegularTasks(iaThread *thread)
+    iTask *iTaskManager::getNextRegularTask(uint32 threadIndex)
     {
-        iTask *taskTodo = nullptr;
+        const uint32 threadCount = static_cast<uint32>(_regularThreads.size());
+        iTaskQueue &ownQueue = _regularThreads[threadIndex]->_queue;
 
-        while (iTaskManager::isRunning())
+        for (uint32 bucket = 0; bucket < iTaskQueue::BUCKET_COUNT; ++bucket)
         {
-            taskTodo = nullptr;
-
-            flushIncomingTasks();
+            iTask *task = ownQueue.pop(bucket);
+            if (task != nullptr)
+            {
+                return task;
+            }
 
-            _mutexRegularTasks.lock();
-            if (_regularTasksQueued.size())
+            for (uint32 i = 1; i < threadCount; ++i)
             {
-                taskTodo = (*_regularTasksQueued.begin());
-                _regularTasksQueued.pop_front();
-                _regularTasksRunning.push_back(taskTodo);
+                task = _regularThreads[(threadIndex + i) % threadCount]->_queue.steal(bucket);
+                if (task != nullptr)
+                {
+                    return task;
+                }
             }
-            _mutexRegularTasks.unlock();
+        }
 
-            if (taskTodo != nullptr)
+        return nullptr;
+    }
+
+    void iTaskManager::runRegularTask(RegularThreadContext *context, iTask *task)
+    {
+        // a thread waiting for other tasks might run tasks nested
+        iTask *previousTask = context->_currentTask;
+
+        context->_currentTask = task;
+        _regularTasksRunning++;
+
+        task->setWorldID(context->_thread->getWorld());
+        {
+            IGOR_PROFILER_SCOPED(runTask);
+            task->run();
+        }
+        task->finishTask();
+
+        _regularTasksRunning--;
+        context->_currentTask = previousTask;
+
+        retireTask(task, context->_queue);
+    }
+
+    void iTaskManager::releaseContinuations(iTaskID taskID, std::vector<iTask *> &readyTasks)
+    {
+        auto iter = _continuations.find(taskID);
+        if (iter == _continuations.end())
+        {
+            return;
+        }
+
+        for (auto continuation : iter->second)
+        {
+            if (--continuation->_unfinishedDependencies == 0)
             {
-                taskTodo->setWorldID(static_cast<iThread *>(thread)->getWorld());
-                taskTodo->run();
-                taskTodo->finishTask();
+                readyTasks.push_back(continuation);
+            }
+        }
 
-                iTaskID idToDelete = iTask::INVALID_TASK_ID;
+        _continuations.erase(iter);
+    }
 
-                _mutexRegularTasks.lock();
-                std::list<iTask *>::iterator findIter = find(_regularTasksRunning.begin(), _regularTasksRunning.end(), taskTodo);
-                if (findIter != _regularTasksRunning.end())
+    void iTaskManager::retireTask(iTask *task, iTaskQueue &queue)
+    {
+        if (task->isRepeating())
+        {
+            queue.push(task);
+            return;
+        }
+
+        const iTaskID taskID = task->getID();
+        std::vector<iTask *> readyTasks;
+
+        _mutexAllTasks.lock();
+        if (_allTasks.erase(taskID) == 0)
+        {
+            con_err("inconsistent data");
+        }
+        releaseContinuations(taskID, readyTasks);
+        _mutexAllTasks.unlock();
+
+        for (auto readyTask : readyTasks)
+        {
+            queueTask(readyTask);
+        }
+
+        delete task;
+        _tasksDone++;
+        _taskFinished(taskID);
+    }
+
+    bool iTaskManager::isTaskFinished(iTaskID taskID)
+    {
+        _mutexAllTasks.lock();
+        const bool result = _allTasks.find(taskID) == _allTasks.end();
+        _mutexAllTasks.unlock();
+
+        return result;
+    }
+
+    void iTaskManager::waitForTasks(const std::vector<iTaskID> &taskIDs)
+    {
+        RegularThreadContext *context = nullptr;
+        if (_regularThreadIndex != -1)
+        {
+            context = _regularThreads[_regularThreadIndex];
+        }
+
+        for (auto taskID : taskIDs)
+        {
+            while (!isTaskFinished(taskID))
+            {
+                if (context == nullptr)
                 {
-                    _regularTasksRunning.erase(findIter);
+                    std::this_thread::yield();
+                    continue;
+                }
 
-                    if (taskTodo->isRepeating())
-                    {
-                        _regularTasksQueued.push_back(taskTodo);
-                    }
-                    else
-                    {
-                        idToDelete = taskTodo->getID();
-                    }
+                // help out instead of blocking a regular thread
+                iTask *task = getNextRegularTask(_regularThreadIndex);
+                if (task != nullptr)
+                {
+                    runRegularTask(context, task);
                 }
                 else
                 {
-                    con_err("inconsistent data");
+                    std::this_thread::yield();
                 }
-                _mutexRegularTasks.unlock();
+            }
+        }
+    }
 
-                if (idToDelete != iTask::INVALID_TASK_ID)
-                {
-                    _mutexAllTasks.lock();
-                    auto iter = _allTasks.find(idToDelete);
-                    if (iter != _allTasks.end())
-                    {
-                        _allTasks.erase(iter);
-                    }
-                    else
-                    {
-                        con_err("inconsistent data");
-                    }
-                    _mutexAllTasks.unlock();
+    void iTaskManager::workWithRegularTasks(iaThread *thread)
+    {
+        uint32 threadIndex = 0;
+        while (_regularThreads[threadIndex]->_thread != thread)
+        {
+            threadIndex++;
+        }
 
-                    delete taskTodo;
-                    _tasksDone++;
-                    _taskFinished(idToDelete);
-                }
+        _regularThreadIndex = threadIndex;
+        RegularThreadContext *context = _regularThreads[threadIndex];
+        int64 idleSince = 0;
+
+        while (iTaskManager::isRunning())
+        {
+            const uint64 signal = _regularParking._signal;
+            iTask *taskTodo = getNextRegularTask(threadIndex);
 
-                taskTodo = nullptr;
+            if (taskTodo != nullptr)
+            {
+                stopIdle(idleSince);
+                runRegularTask(context, taskTodo);
             }
             else
             {
-                std::this_thread::yield();
+                idle(_regularParking, signal, idleSince);
             }
         }
+
+        _regularThreadIndex = -1;
     }
 
-    void iTaskManager::flushIncomingTasks()
+    void iTaskManager::idle(ThreadParking &parking, uint64 signal, int64 &idleSince, const std::atomic<bool> *stopThread)
     {
-        _mutexIncomingTasks.lock();
-        std::list<iTask *> incoming = _tasksIncoming;
-        _tasksIncoming.clear();
-        _mutexIncomingTasks.unlock();
+        const int64 now = iaClock::getTimeMicroseconds();
+        if (idleSince == 0)
+        {
+            idleSince = now;
+        }
+
+        const iThreadIdlePolicy policy = _idlePolicy;
+        if (policy == iThreadIdlePolicy::Spin ||
+            (policy == iThreadIdlePolicy::SpinThenPark && now - idleSince < _idleSpinTime))
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        stopIdle(idleSince);
 
-        _mutexRegularThreads.lock();
-        const bool hasRegularThreads = !_regularThreads.empty();
-        _mutexRegularThreads.unlock();
+        std::unique_lock<std::mutex> lock(parking._mutex);
+        parking._parkedThreads++;
 
-        for (auto incomingTask : incoming)
+        // if the signal changed since the thread looked for tasks there is something new to do
+        if (parking._signal == signal &&
+            iTaskManager::isRunning() &&
+            (stopThread == nullptr || !(*stopThread)))
         {
-            if (hasRegularThreads &&
-                incomingTask->getContext() == iTaskContext::Default)
-            {
-                _mutexRegularTasks.lock();
-                _regularTasksQueued.push_back(incomingTask);
-                _mutexRegularTasks.unlock();
-            }
-            else
-            {
-                _mutexRenderContextTasks.lock();
-                _renderContextTasksQueued.push_back(incomingTask);
-                _mutexRenderContextTasks.unlock();
-            }
+            const int64 parkStart = iaClock::getTimeMicroseconds();
+            parking._condition.wait(lock);
+            _parkTime += iaClock::getTimeMicroseconds() - parkStart;
+            _wakeups++;
         }
 
-        _mutexRegularTasks.lock();
-        _regularTasksQueued.sort([](const iTask *a, const iTask *b)
-                                 { return a->_priority < b->_priority; });
-        _mutexRegularTasks.unlock();
+        parking._parkedThreads--;
+    }
 
-        _mutexRenderContextTasks.lock();
-        _renderContextTasksQueued.sort([](const iTask *a, const iTask *b)
-                                       { return a->_priority < b->_priority; });
-        _mutexRenderContextTasks.unlock();
+    void iTaskManager::stopIdle(int64 &idleSince)
+    {
+        if (idleSince != 0)
+        {
+            _spinTime += iaClock::getTimeMicroseconds() - idleSince;
+            idleSince = 0;
+        }
+    }
+
+    void iTaskManager::wakeThreads(ThreadParking &parking, bool all)
+    {
+        parking._signal++;
+
+        if (parking._parkedThreads == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(parking._mutex);
+        if (all)
+        {
+            parking._condition.notify_all();
+        }
+        else
+        {
+            parking._condition.notify_one();
+        }
+    }
+
+    void iTaskManager::setIdlePolicy(iThreadIdlePolicy policy, const iaTime &spinTime)
+    {
+        _idlePolicy = policy;
+        _idleSpinTime = spinTime.getMicroseconds();
+
+        // threads that are already parked need a chance to pick up the new policy
+        wakeThreads(_regularParking, true);
+        wakeThreads(_renderContextParking, true);
+    }
+
+    iThreadIdlePolicy iTaskManager::getIdlePolicy() const
+    {
+        return _idlePolicy;
+    }
+
+    iaTime iTaskManager::getIdleSpinTime() const
+    {
+        return iaTime::fromMicroseconds(_idleSpinTime);
+    }
+
+    uint64 iTaskManager::getWakeupCount() const
+    {
+        return _wakeups;
+    }
+
+    iaTime iTaskManager::getTotalParkTime() const
+    {
+        return iaTime::fromMicroseconds(_parkTime);
+    }
+
+    iaTime iTaskManager::getTotalSpinTime() const
+    {
+        return iaTime::fromMicroseconds(_spinTime);
+    }
+
+    uint64 iTaskManager::calcChunkSize(uint64 count, uint64 chunkSize) const
+    {
+        if (chunkSize != 0)
+        {
+            return chunkSize;
+        }
+
+        // a few chunks per thread (including the calling thread) to balance uneven work loads
+        static const uint64 chunksPerThread = 4;
+        const uint64 chunkCount = (static_cast<uint64>(_regularThreads.size()) + 1) * chunksPerThread;
+
+        return std::max(static_cast<uint64>(1), (count + chunkCount - 1) / chunkCount);
+    }
+
+    void iTaskManager::parallelFor(uint64 begin, uint64 end, const iParallelForFunction &function, uint64 chunkSize)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        iParallelForJobPtr job = std::make_shared<iParallelForJob>(begin, end, calcChunkSize(end - begin, chunkSize), function);
+
+        const uint64 helpers = std::min(static_cast<uint64>(_regularThreads.size()), job->getChunkCount() - 1);
+        for (uint64 i = 0; i < helpers; ++i)
+        {
+            addTask(new iTaskParallelFor(job));
+        }
+
+        // the calling thread helps and than waits for chunks still in progress
+        job->process();
+
+        while (!job->isDone())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    iTaskID iTaskManager::parallelForAsync(uint64 begin, uint64 end, const iParallelForFunction &function, uint64 chunkSize)
+    {
+        if (begin >= end)
+        {
+            return iTask::INVALID_TASK_ID;
+        }
+
+        iParallelForJobPtr job = std::make_shared<iParallelForJob>(begin, end, calcChunkSize(end - begin, chunkSize), function);
+
+        if (_regularThreads.empty())
+        {
+            job->process();
+            return iTask::INVALID_TASK_ID;
+        }
+
+        const uint64 helpers = std::min(static_cast<uint64>(_regularThreads.size()), job->getChunkCount());
+        std::vector<iTaskID> helperTasks;
+        for (uint64 i = 0; i < helpers; ++i)
+        {
+            helperTasks.push_back(addTask(new iTaskParallelFor(job)));
+        }
+
+        // finishes when all helpers are done and with that all chunks
+        return addTask(new iTaskParallelFor(job), helperTasks);
     }
 
     iTask *iTaskManager::getTask(iTaskID taskID)
@@ -562,6 +761,16 @@ namespace igor
     }
 
     iTaskID iTaskManager::addTask(iTask *task)
+    {
+        return addTask(task, std::vector<iTaskID>());
+    }
+
+    iTaskID iTaskManager::addContinuation(iTaskID taskID, iTask *continuation)
+    {
+        return addTask(continuation, {taskID});
+    }
+
+    iTaskID iTaskManager::addTask(iTask *task, const std::vector<iTaskID> &dependencies)
     {
         iTaskID result = iTask::INVALID_TASK_ID;
         con_assert(task != nullptr, "zero pointer");
@@ -576,22 +785,34 @@ namespace igor
             if (iter == _allTasks.end())
             {
                 _allTasks[task->getID()] = task;
+
+                task->_unfinishedDependencies = 0;
+                for (auto dependency : dependencies)
+                {
+                    if (dependency == task->getID() ||
+                        _allTasks.find(dependency) == _allTasks.end())
+                    {
+                        continue;
+                    }
+
+                    _continuations[dependency].push_back(task);
+                    task->_unfinishedDependencies++;
+                }
             }
             else
             {
                 alreadyInserted = true;
             }
+            const bool ready = task->_unfinishedDependencies == 0;
             _mutexAllTasks.unlock();
 
             if (alreadyInserted)
             {
                 con_warn("task already managed by task manager (id:" << task->getID() << ")");
             }
-            else
+            else if (ready)
             {
-                _mutexIncomingTasks.lock();
-                _tasksIncoming.push_back(task);
-                _mutexIncomingTasks.unlock();
+                queueTask(task);
             }
         }
         else
@@ -602,6 +823,32 @@ namespace igor
         return result;
     }
 
+    void iTaskManager::queueTask(iTask *task)
+    {
+        if (!_regularThreads.empty() &&
+            task->getContext() == iTaskContext::Default)
+        {
+            // keep tasks spawned by a regular thread local to that thread
+            uint32 threadIndex = 0;
+            if (_regularThreadIndex != -1)
+            {
+                threadIndex = _regularThreadIndex;
+            }
+            else
+            {
+                threadIndex = _nextRegularThread++ % _regularThreads.size();
+            }
+
+            _regularThreads[threadIndex]->_queue.push(task);
+            wakeThreads(_regularParking);
+        }
+        else
+        {
+            _renderContextTasksQueued.push(task);
+            wakeThreads(_renderContextParking);
+        }
+    }
+
     void iTaskManager::registerTaskFinishedDelegate(iTaskFinishedDelegate taskFinishedDelegate)
     {
         _taskFinished.add(taskFinishedDelegate);
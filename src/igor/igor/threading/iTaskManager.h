@@ -33,13 +33,19 @@
 #include <igor/threading/iThread.h>
 #include <igor/resources/module/iModule.h>
 #include <igor/threading/tasks/iTask.h>
+#include <igor/threading/iTaskQueue.h>
+#include <igor/threading/tasks/iTaskParallelFor.h>
 
 #include <iaux/system/iaEvent.h>
+#include <iaux/system/iaTime.h>
 using namespace iaux;
 
-#include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 namespace igor
 {
@@ -52,9 +58,21 @@ namespace igor
     */
     IGOR_EVENT_DEFINITION(iTaskFinished, void, iTaskID);
 
+    /*! defines what an idle thread does while waiting for tasks
+    */
+    enum class iThreadIdlePolicy
+    {
+        Spin,        //! keep spinning (yielding) until a task comes in
+        Park,        //! park the thread right away until woken by a new task
+        SpinThenPark //! spin for the spin time and park afterwards
+    };
+
     /*! manages tasks to be done in parallel
 
-    \todo there should be IDs for tasks so we can sefely kill tasks later by ID
+    Every regular thread owns a priority bucketed task queue. Threads work on their own queue first
+    and steal from the other threads queues when they run out of work. Tasks added from within a
+    regular thread end up in that thread's queue. Tasks added from anywhere else get distributed
+    round robin.
     */
     class IGOR_API iTaskManager : public iModule<iTaskManager>
     {
@@ -75,7 +93,49 @@ namespace igor
 
             /*! flag to control the render context thread
             */
-            bool _stopThread = false;
+            std::atomic<bool> _stopThread = false;
+
+            /*! the task currently running in this thread
+            */
+            std::atomic<iTask *> _currentTask = nullptr;
+        };
+
+        /*! data a regular thread works with
+        */
+        struct RegularThreadContext
+        {
+            /*! the thread
+            */
+            iThread *_thread = nullptr;
+
+            /*! the threads own task queue
+            */
+            iTaskQueue _queue;
+
+            /*! the task currently running in this thread
+            */
+            std::atomic<iTask *> _currentTask = nullptr;
+        };
+
+        /*! where idle threads get parked until new tasks come in
+        */
+        struct ThreadParking
+        {
+            /*! mutex to protect the condition
+            */
+            std::mutex _mutex;
+
+            /*! condition parked threads wait for
+            */
+            std::condition_variable _condition;
+
+            /*! amount of currently parked threads
+            */
+            std::atomic<uint32> _parkedThreads = 0;
+
+            /*! incremented every time a new task comes in
+            */
+            std::atomic<uint64> _signal = 0;
         };
 
     public:
@@ -88,6 +148,89 @@ namespace igor
         */
         iTaskID addTask(iTask *task);
 
+        /*! adds a task that will only be processed after all given tasks are finished
+
+        !!! ATTENTION task get's consumed and later deleted by task manager
+
+        ids of tasks that are already finished or unknown are ignored
+
+        \param task the task to be added
+        \param dependencies ids of the tasks that have to finish first
+        \returns the task's id
+        */
+        iTaskID addTask(iTask *task, const std::vector<iTaskID> &dependencies);
+
+        /*! adds a task that will be processed as soon as given task is finished
+
+        !!! ATTENTION task get's consumed and later deleted by task manager
+
+        \param taskID id of the task to continue
+        \param continuation the task to run after the other task finished
+        \returns the continuation's id
+        */
+        iTaskID addContinuation(iTaskID taskID, iTask *continuation);
+
+        /*! \returns true if given task is finished or was never added to the task manager
+
+        \param taskID id of the task to check
+        */
+        bool isTaskFinished(iTaskID taskID);
+
+        /*! blocks until all given tasks are finished
+
+        if called from within a regular thread this thread keeps processing other tasks while waiting
+
+        \param taskIDs the group of tasks to wait for
+        */
+        void waitForTasks(const std::vector<iTaskID> &taskIDs);
+
+        /*! calls function for chunks of given index range in parallel and returns when all chunks are done
+
+        the calling thread processes chunks too. without regular threads everything runs in the calling thread
+
+        \param begin first index of range
+        \param end index after last index of range
+        \param function the function to call for every chunk with the chunks range [begin, end)
+        \param chunkSize amount of indices per chunk. if zero the chunk size is chosen based on range and thread count
+        */
+        void parallelFor(uint64 begin, uint64 end, const iParallelForFunction &function, uint64 chunkSize = 0);
+
+        /*! calls function for chunks of given index range in parallel and returns right away
+
+        make sure everything the function refers to stays alive until the returned task is finished
+
+        \param begin first index of range
+        \param end index after last index of range
+        \param function the function to call for every chunk with the chunks range [begin, end)
+        \param chunkSize amount of indices per chunk. if zero the chunk size is chosen based on range and thread count
+        \returns id of a task that finishes after all chunks are done. use it with waitForTasks or addContinuation
+        */
+        iTaskID parallelForAsync(uint64 begin, uint64 end, const iParallelForFunction &function, uint64 chunkSize = 0);
+
+        /*! maps chunks of given index range to values in parallel and reduces them to a single value
+
+        partial results get reduced in chunk order so the result is deterministic for a given chunk size
+
+        \param begin first index of range
+        \param end index after last index of range
+        \param identity the identity value of the reduce operation
+        \param map function with signature T(uint64 begin, uint64 end) that produces the result of one chunk
+        \param reduce function with signature T(const T &a, const T &b) that combines two results
+        \param chunkSize amount of indices per chunk. if zero the chunk size is chosen based on range and thread count
+        \returns the reduced value
+        */
+        template <typename T, typename MapFunction, typename ReduceFunction>
+        T parallelReduce(uint64 begin, uint64 end, const T &identity, MapFunction map, ReduceFunction reduce, uint64 chunkSize = 0);
+
+        /*! \returns chunk size for a parallel for over given amount of indices
+
+        aims for a few chunks per thread so threads that finish early can pick up work from slower ones
+
+        \param count the amount of indices
+        \param chunkSize requested chunk size. if not zero it is returned unchanged
+        */
+        uint64 calcChunkSize(uint64 count, uint64 chunkSize = 0) const;
+
         /*! \returns task by id
 
         \param taskID the task ID to search for
@@ -132,6 +275,33 @@ namespace igor
         */
         uint64 getTaskDoneCount() const;
 
+        /*! sets what threads do while waiting for tasks
+
+        \param policy the idle policy
+        \param spinTime time threads spin before they get parked (only relevant for iThreadIdlePolicy::SpinThenPark)
+        */
+        void setIdlePolicy(iThreadIdlePolicy policy, const iaTime &spinTime = iaTime::fromMicroseconds(50));
+
+        /*! \returns the idle policy
+        */
+        iThreadIdlePolicy getIdlePolicy() const;
+
+        /*! \returns time threads spin before they get parked
+        */
+        iaTime getIdleSpinTime() const;
+
+        /*! \returns how often parked threads where woken up since program start
+        */
+        uint64 getWakeupCount() const;
+
+        /*! \returns accumulated time all threads spent parked since program start
+        */
+        iaTime getTotalParkTime() const;
+
+        /*! \returns accumulated time all threads spent spinning while waiting for tasks since program start
+        */
+        iaTime getTotalSpinTime() const;
+
         /*! registers delegate to task finished event
 
         \param taskFinishedDelegate the delegate to register
@@ -147,7 +317,7 @@ namespace igor
     private:
         /*! counts how many tasks where done
         */
-        uint64 _tasksDone = 0;
+        std::atomic<uint64> _tasksDone = 0;
 
         /*! task finished event
         */
@@ -155,31 +325,33 @@ namespace igor
 
         /*! if true the task manager is running
         */
-        static bool _running;
+        static std::atomic<bool> _running;
 
-        /*! incoming tasks
+        /*! list of all tasks
         */
-        std::list<iTask *> _tasksIncoming;
+        std::unordered_map<iTaskID, iTask *> _allTasks;
 
-        /*! mutex for incoming tasks
+        /*! mutex for all tasks list and continuations
         */
-        iaMutex _mutexIncomingTasks;
+        iaMutex _mutexAllTasks;
 
-        /*! list of all tasks
+        /*! tasks waiting for other tasks to finish. key is id of the task they wait for
         */
-        std::map<iTaskID, iTask *> _allTasks;
+        std::unordered_map<iTaskID, std::vector<iTask *>> _continuations;
+
+        /*! list of regular threads
 
-        /*! mutex for all tasks list
+        does not change after construction so it can be read without locking
         */
-        iaMutex _mutexAllTasks;
+        std::vector<RegularThreadContext *> _regularThreads;
 
-        /*! list of regular threads
+        /*! next regular thread to receive a task from outside the regular threads
         */
-        std::vector<iThread *> _regularThreads;
+        std::atomic<uint32> _nextRegularThread = 0;
 
-        /*! mutex for regular threads
+        /*! count of running regular tasks
         */
-        iaMutex _mutexRegularThreads;
+        std::atomic<uint32> _regularTasksRunning = 0;
 
         /*! list of render context threads
 
@@ -191,29 +363,65 @@ namespace igor
         */
         iaMutex _mutexRenderContextThreads;
 
-        /*! list of queued tasks
+        /*! queued tasks that need render context
+        */
+        iTaskQueue _renderContextTasksQueued;
+
+        /*! count of running tasks that need render context
         */
-        std::list<iTask *> _regularTasksQueued;
+        std::atomic<uint32> _renderContextTasksRunning = 0;
 
-        /*! list of running tasks
+        /*! parking for regular threads
         */
-        std::list<iTask *> _regularTasksRunning;
+        ThreadParking _regularParking;
 
-        /*! mutex for regular tasks
+        /*! parking for render context threads
         */
-        iaMutex _mutexRegularTasks;
+        ThreadParking _renderContextParking;
 
-        /*! list of queued tasks that need render context
+        /*! the idle policy
         */
-        std::list<iTask *> _renderContextTasksQueued;
+        std::atomic<iThreadIdlePolicy> _idlePolicy = iThreadIdlePolicy::SpinThenPark;
 
-        /*! list of running tasks that need render context
+        /*! spin time in microseconds
         */
-        std::list<iTask *> _renderContextTasksRunning;
+        std::atomic<int64> _idleSpinTime = 50;
+
+        /*! counts how often parked threads where woken up
+        */
+        std::atomic<uint64> _wakeups = 0;
+
+        /*! accumulated park time in microseconds
+        */
+        std::atomic<int64> _parkTime = 0;
+
+        /*! accumulated spin time in microseconds
+        */
+        std::atomic<int64> _spinTime = 0;
+
+        /*! called by threads that have nothing to do
+
+        depending on the idle policy the thread spins or get's parked until a new task comes in
 
-        /*! mutex for render context tasks
+        \param parking the parking to use
+        \param signal the parking signal read before the last attempt to get a task
+        \param[in,out] idleSince time in microseconds when the thread ran out of tasks. zero if it was not idle
+        \param stopThread optional flag that also wakes the thread
         */
-        iaMutex _mutexRenderContextTasks;
+        void idle(ThreadParking &parking, uint64 signal, int64 &idleSince, const std::atomic<bool> *stopThread = nullptr);
+
+        /*! ends spinning of a thread that found a task
+
+        \param[in,out] idleSince time in microseconds when the thread ran out of tasks. zero if it was not idle
+        */
+        void stopIdle(int64 &idleSince);
+
+        /*! wakes parked threads
+
+        \param parking the parking to wake threads from
+        \param all if true all threads get woken up otherwise only one
+        */
+        void wakeThreads(ThreadParking &parking, bool all = false);
 
         /*! the method a regular thread is launched with
 
@@ -227,6 +435,52 @@ namespace igor
         */
         void workWithRenderContextTasks(iaThread *thread);
 
+        /*! \returns next task for given regular thread to work on or nullptr if there is none
+
+        looks in the threads own queue first and than tries to steal from the other threads.
+        higher priorities always go first.
+
+        \param threadIndex index of the regular thread
+        */
+        iTask *getNextRegularTask(uint32 threadIndex);
+
+        /*! runs a task in given regular thread
+
+        \param context context of the regular thread
+        \param task the task to run
+        */
+        void runRegularTask(RegularThreadContext *context, iTask *task);
+
+        /*! puts task in to a queue so it can be processed
+
+        \param task the task to queue
+        */
+        void queueTask(iTask *task);
+
+        /*! releases tasks waiting for given task
+
+        must be called while holding _mutexAllTasks
+
+        \param taskID id of the finished task
+        \param[out] readyTasks tasks that have no unfinished dependencies left
+        */
+        void releaseContinuations(iTaskID taskID, std::vector<iTask *> &readyTasks);
+
+        /*! cleans up after a task was run
+
+        repeating tasks get queued again all other tasks get deleted
+
+        \param task the task that was run
+        \param queue the queue to add the task to in case it is repeating
+        */
+        void retireTask(iTask *task, iTaskQueue &queue);
+
+        /*! aborts the task a thread currently runs if it is still managed by the task manager
+
+        \param currentTask the current task of the thread
+        */
+        void abortRunningTask(const std::atomic<iTask *> &currentTask);
+
         /*! creates a number of render context threads for a specified window
 
         \param window the window the render contexts are connected with
@@ -246,13 +500,11 @@ namespace igor
         */
         void killRenderContextThreads(iWindowPtr window);
 
-        /*! creates a regular thread
-        */
-        void createThread();
+        /*! creates and starts regular threads
 
-        /*! flush incoming tasks queue to task list
-		*/
-        void flushIncomingTasks();
+        \param numThreads the amount of threads to create
+        */
+        void createThreads(int32 numThreads);
 
         /*! creates some regular threads and starts them
         */
@@ -263,6 +515,8 @@ namespace igor
         virtual ~iTaskManager();
     };
 
+#include <igor/threading/iTaskManager.inl>
+
 }; // namespace igor
 
 #endif // __IGOR_TASKMANAGER__
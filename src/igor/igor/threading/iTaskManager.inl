@@ -0,0 +1,28 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+template <typename T, typename MapFunction, typename ReduceFunction>
+T iTaskManager::parallelReduce(uint64 begin, uint64 end, const T &identity, MapFunction map, ReduceFunction reduce, uint64 chunkSize)
+{
+    if (begin >= end)
+    {
+        return identity;
+    }
+
+    chunkSize = calcChunkSize(end - begin, chunkSize);
+    std::vector<T> partialResults((end - begin + chunkSize - 1) / chunkSize, identity);
+
+    parallelFor(
+        begin, end, [&](uint64 chunkBegin, uint64 chunkEnd)
+        { partialResults[(chunkBegin - begin) / chunkSize] = map(chunkBegin, chunkEnd); },
+        chunkSize);
+
+    T result = identity;
+    for (const auto &partialResult : partialResults)
+    {
+        result = reduce(result, partialResult);
+    }
+
+    return result;
+}
@@ -0,0 +1,97 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/threading/iTaskQueue.h>
+
+namespace igor
+{
+
+    uint32 iTaskQueue::getBucket(uint32 priority)
+    {
+        // TASK_PRIORITY_MAX, TASK_PRIORITY_HIGH, TASK_PRIORITY_DEFAULT and TASK_PRIORITY_LOW all get a bucket of their own
+        return std::min(priority / iTask::TASK_PRIORITY_HIGH, BUCKET_COUNT - 1);
+    }
+
+    void iTaskQueue::push(iTask *task)
+    {
+        const uint32 bucket = getBucket(task->getPriority());
+
+        _mutex.lock();
+        _buckets[bucket].push_back(task);
+        _bucketSizes[bucket]++;
+        _mutex.unlock();
+    }
+
+    iTask *iTaskQueue::pop(uint32 bucket)
+    {
+        if (_bucketSizes[bucket] == 0)
+        {
+            return nullptr;
+        }
+
+        iTask *result = nullptr;
+
+        _mutex.lock();
+        if (!_buckets[bucket].empty())
+        {
+            result = _buckets[bucket].front();
+            _buckets[bucket].pop_front();
+            _bucketSizes[bucket]--;
+        }
+        _mutex.unlock();
+
+        return result;
+    }
+
+    iTask *iTaskQueue::steal(uint32 bucket)
+    {
+        if (_bucketSizes[bucket] == 0)
+        {
+            return nullptr;
+        }
+
+        iTask *result = nullptr;
+
+        _mutex.lock();
+        if (!_buckets[bucket].empty())
+        {
+            result = _buckets[bucket].back();
+            _buckets[bucket].pop_back();
+            _bucketSizes[bucket]--;
+        }
+        _mutex.unlock();
+
+        return result;
+    }
+
+    bool iTaskQueue::isEmpty(uint32 bucket) const
+    {
+        return _bucketSizes[bucket] == 0;
+    }
+
+    uint32 iTaskQueue::getSize() const
+    {
+        uint32 result = 0;
+
+        for (const auto &size : _bucketSizes)
+        {
+            result += size;
+        }
+
+        return result;
+    }
+
+    void iTaskQueue::clear(std::vector<iTask *> &tasks)
+    {
+        _mutex.lock();
+        for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+        {
+            tasks.insert(tasks.end(), _buckets[i].begin(), _buckets[i].end());
+            _buckets[i].clear();
+            _bucketSizes[i] = 0;
+        }
+        _mutex.unlock();
+    }
+
+}; // namespace igor
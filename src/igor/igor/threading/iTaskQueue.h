@@ -0,0 +1,125 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_TASKQUEUE__
+#define __IGOR_TASKQUEUE__
+
+#include <igor/threading/tasks/iTask.h>
+
+#include <iaux/system/iaMutex.h>
+using namespace iaux;
+
+#include <deque>
+#include <array>
+#include <vector>
+#include <atomic>
+
+namespace igor
+{
+
+    /*! priority bucketed task deque
+
+    Every worker thread of the task manager owns one of these. The owner pops from the front
+    while other workers steal from the back. Tasks are sorted in to buckets by priority so
+    there is no need to ever sort the queue.
+    */
+    class iTaskQueue
+    {
+
+    public:
+        /*! amount of priority buckets
+         */
+        static const uint32 BUCKET_COUNT = 5;
+
+        /*! does nothing
+         */
+        iTaskQueue() = default;
+
+        /*! does nothing
+         */
+        ~iTaskQueue() = default;
+
+        /*! \returns the bucket index for given priority
+
+        \param priority the given priority
+        */
+        static uint32 getBucket(uint32 priority);
+
+        /*! adds a task to the back of it's priority bucket
+
+        \param task the task to add
+        */
+        void push(iTask *task);
+
+        /*! \returns task from the front of given bucket or nullptr if empty
+
+        \param bucket the bucket to pop from
+        */
+        iTask *pop(uint32 bucket);
+
+        /*! \returns task from the back of given bucket or nullptr if empty
+
+        \param bucket the bucket to steal from
+        */
+        iTask *steal(uint32 bucket);
+
+        /*! \returns true if given bucket is empty
+
+        does not lock so the result might already be outdated when returned
+
+        \param bucket the bucket to check
+        */
+        bool isEmpty(uint32 bucket) const;
+
+        /*! \returns amount of tasks in queue
+         */
+        uint32 getSize() const;
+
+        /*! removes all tasks from queue and returns them
+
+        \param[out] tasks the removed tasks
+        */
+        void clear(std::vector<iTask *> &tasks);
+
+    private:
+        /*! the priority buckets
+         */
+        std::array<std::deque<iTask *>, BUCKET_COUNT> _buckets;
+
+        /*! amount of tasks per bucket. used for quick checks without locking
+         */
+        std::array<std::atomic<uint32>, BUCKET_COUNT> _bucketSizes = {};
+
+        /*! mutex to protect the buckets
+         */
+        iaMutex _mutex;
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_TASKQUEUE__
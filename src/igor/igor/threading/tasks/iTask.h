@@ -194,6 +194,12 @@ namespace igor
         /*! task context
         */
         iTaskContext _taskContext = iTaskContext::Default;
+
+        /*! amount of tasks that need to finish before this task can run
+
+        only accessed by the task manager while holding it's task list mutex
+        */
+        uint32 _unfinishedDependencies = 0;
     };
 
 }; // namespace igor
@@ -0,0 +1,54 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/threading/tasks/iTaskParallelFor.h>
+
+namespace igor
+{
+
+    iParallelForJob::iParallelForJob(uint64 begin, uint64 end, uint64 chunkSize, const iParallelForFunction &function)
+        : _begin(begin), _end(end), _chunkSize(std::max(chunkSize, static_cast<uint64>(1))), _function(function)
+    {
+        _chunkCount = end > begin ? (end - begin + _chunkSize - 1) / _chunkSize : 0;
+    }
+
+    void iParallelForJob::process()
+    {
+        while (true)
+        {
+            const uint64 chunk = _nextChunk++;
+            if (chunk >= _chunkCount)
+            {
+                break;
+            }
+
+            const uint64 chunkBegin = _begin + chunk * _chunkSize;
+            const uint64 chunkEnd = std::min(chunkBegin + _chunkSize, _end);
+            _function(chunkBegin, chunkEnd);
+
+            _chunksDone++;
+        }
+    }
+
+    bool iParallelForJob::isDone() const
+    {
+        return _chunksDone == _chunkCount;
+    }
+
+    uint64 iParallelForJob::getChunkCount() const
+    {
+        return _chunkCount;
+    }
+
+    iTaskParallelFor::iTaskParallelFor(iParallelForJobPtr job, uint32 priority)
+        : iTask(nullptr, priority), _job(job)
+    {
+    }
+
+    void iTaskParallelFor::run()
+    {
+        _job->process();
+    }
+
+}; // namespace igor
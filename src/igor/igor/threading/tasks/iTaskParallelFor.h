@@ -0,0 +1,142 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_TASKPARALLELFOR__
+#define __IGOR_TASKPARALLELFOR__
+
+#include <igor/threading/tasks/iTask.h>
+
+#include <functional>
+#include <memory>
+#include <atomic>
+
+namespace igor
+{
+
+    /*! function called by a parallel for for every chunk
+
+    first parameter is the begin and second the end of the chunks index range [begin, end)
+    */
+    typedef std::function<void(uint64, uint64)> iParallelForFunction;
+
+    /*! state of one parallel for shared between all threads working on it
+    */
+    class IGOR_API iParallelForJob
+    {
+
+    public:
+        /*! initializes the job
+
+        \param begin first index of range
+        \param end index after last index of range
+        \param chunkSize amount of indices processed in one go
+        \param function the function to call for every chunk
+        */
+        iParallelForJob(uint64 begin, uint64 end, uint64 chunkSize, const iParallelForFunction &function);
+
+        /*! does nothing
+        */
+        ~iParallelForJob() = default;
+
+        /*! processes chunks until there are none left to claim
+        */
+        void process();
+
+        /*! \returns true if all chunks where processed
+        */
+        bool isDone() const;
+
+        /*! \returns amount of chunks
+        */
+        uint64 getChunkCount() const;
+
+    private:
+        /*! first index of range
+        */
+        uint64 _begin = 0;
+
+        /*! index after last index of range
+        */
+        uint64 _end = 0;
+
+        /*! amount of indices processed in one go
+        */
+        uint64 _chunkSize = 1;
+
+        /*! amount of chunks
+        */
+        uint64 _chunkCount = 0;
+
+        /*! next chunk to claim
+        */
+        std::atomic<uint64> _nextChunk = 0;
+
+        /*! amount of chunks processed
+        */
+        std::atomic<uint64> _chunksDone = 0;
+
+        /*! the function to call for every chunk
+        */
+        iParallelForFunction _function;
+    };
+
+    /*! parallel for job pointer definition
+    */
+    typedef std::shared_ptr<iParallelForJob> iParallelForJobPtr;
+
+    /*! task that helps processing a parallel for job
+    */
+    class IGOR_API iTaskParallelFor : public iTask
+    {
+
+    public:
+        /*! initializes member variables
+
+        \param job the job to help with
+        \param priority the priority of this task
+        */
+        iTaskParallelFor(iParallelForJobPtr job, uint32 priority = iTask::TASK_PRIORITY_HIGH);
+
+        /*! does nothing
+         */
+        virtual ~iTaskParallelFor() = default;
+
+    protected:
+        /*! processes chunks of the job until there are none left
+         */
+        void run() override;
+
+    private:
+        /*! the job to help with
+        */
+        iParallelForJobPtr _job;
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_TASKPARALLELFOR__
@@ -0,0 +1,22 @@
+// Igor game engine
+// (c) Copyright 2012-2023 by Martin Loga
+// see copyright notice in corresponding header file
+
+#include <igor/threading/tasks/iTaskUpdateParticleSystem.h>
+
+#include <igor/simulation/iParticleSystem.h>
+
+namespace igor
+{
+
+    iTaskUpdateParticleSystem::iTaskUpdateParticleSystem(iParticleSystem *particleSystem, const iaTime &frameTime, uint32 priority)
+        : iTask(nullptr, priority, false, iTaskContext::Default), _particleSystem(particleSystem), _frameTime(frameTime)
+    {
+    }
+
+    void iTaskUpdateParticleSystem::run()
+    {
+        _particleSystem->simulate(_frameTime);
+    }
+
+}; // namespace igor
@@ -0,0 +1,77 @@
+//
+//   ______                                |\___/|  /\___/\
+//  /\__  _\                               )     (  )     (
+//  \/_/\ \/       __      ___    _ __    =\     /==\     /=
+//     \ \ \     /'_ `\   / __`\ /\`'__\    )   (    )   (
+//      \_\ \__ /\ \L\ \ /\ \L\ \\ \ \/    /     \   /   \
+//      /\_____\\ \____ \\ \____/ \ \_\   |       | /     \
+//  ____\/_____/_\/___L\ \\/___/___\/_/____\__  _/__\__ __/________________
+//                 /\____/                   ( (       ))
+//                 \_/__/  game engine        ) )     ((
+//                                           (_(       \)
+// (c) Copyright 2012-2023 by Martin Loga
+//
+// This library is free software; you can redistribute it and or modify it
+// under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see <http://www.gnu.org/licenses/>.
+//
+// contact: igorgameengine@protonmail.com
+
+#ifndef __IGOR_TASKUPDATEPARTICLESYSTEM__
+#define __IGOR_TASKUPDATEPARTICLESYSTEM__
+
+#include <igor/threading/tasks/iTask.h>
+
+#include <iaux/system/iaTime.h>
+using namespace iaux;
+
+namespace igor
+{
+
+    class iParticleSystem;
+
+    /*! simulates a particle system up to a given frame time and fills its back vertex buffer
+    */
+    class IGOR_API iTaskUpdateParticleSystem : public iTask
+    {
+
+    public:
+        /*! initializes member variables
+
+        \param particleSystem the particle system to update
+        \param frameTime the time to simulate up to
+        \param priority the priority of this task
+        */
+        iTaskUpdateParticleSystem(iParticleSystem *particleSystem, const iaTime &frameTime, uint32 priority = iTask::TASK_PRIORITY_HIGH);
+
+        /*! does nothing
+        */
+        virtual ~iTaskUpdateParticleSystem() = default;
+
+    protected:
+        /*! runs the simulation
+        */
+        void run() override;
+
+    private:
+        /*! the particle system to update
+        */
+        iParticleSystem *_particleSystem = nullptr;
+
+        /*! the time to simulate up to
+        */
+        iaTime _frameTime;
+    };
+
+}; // namespace igor
+
+#endif // __IGOR_TASKUPDATEPARTICLESYSTEM__
@@ -2,6 +2,7 @@
 #include <iaux/test/iaTest.h>
 
 #include <iaux/system/iaEvent.h>
+#include <iaux/system/iaTime.h>
 using namespace iaux;
 
 IGOR_EVENT_DEFINITION(SimpleVoid, int);
@@ -197,4 +198,95 @@ IAUX_TEST(EventTests, ClearEvent)
     auto values = event();
 
     IAUX_EXPECT_TRUE(values.empty());
-}
\ No newline at end of file
+}
+IGOR_EVENT_DEFINITION(Counting, void, int);
+
+static int countingSum = 0;
+
+void countingFunction(int value)
+{
+    countingSum += value;
+}
+
+class CountingClass
+{
+public:
+    void count(int value)
+    {
+        _sum += value;
+    }
+
+    int _sum = 0;
+};
+
+class ReentrantClass
+{
+public:
+    CountingEvent *_event = nullptr;
+    CountingClass _other;
+    int _calls = 0;
+
+    void onEvent(int)
+    {
+        _calls++;
+
+        // changes the delegates of the event that is currently executed
+        _event->remove(CountingDelegate(this, &ReentrantClass::onEvent));
+        _event->add(CountingDelegate(&_other, &CountingClass::count));
+    }
+};
+
+IAUX_TEST(EventTests, ReentrantAddRemove)
+{
+    CountingEvent event;
+    ReentrantClass reentrant;
+    reentrant._event = &event;
+
+    event.add(CountingDelegate(&reentrant, &ReentrantClass::onEvent));
+
+    // the running execution still sees the old list of delegates
+    event(1);
+    IAUX_EXPECT_EQUAL(reentrant._calls, 1);
+    IAUX_EXPECT_EQUAL(reentrant._other._sum, 0);
+
+    event(2);
+    IAUX_EXPECT_EQUAL(reentrant._calls, 1);
+    IAUX_EXPECT_EQUAL(reentrant._other._sum, 2);
+
+    event.remove(CountingDelegate(&reentrant._other, &CountingClass::count));
+    IAUX_EXPECT_FALSE(event.hasDelegates());
+}
+
+IAUX_BENCHMARK(EventTests, BenchmarkFire)
+{
+    static const int fires = 200000;
+    const int listenerCounts[] = {1, 10, 100};
+
+    for (const int listenerCount : listenerCounts)
+    {
+        CountingEvent event;
+        std::vector<CountingClass> listeners(listenerCount - 1);
+
+        event.add(CountingDelegate(countingFunction));
+        for (auto &listener : listeners)
+        {
+            event.add(CountingDelegate(&listener, &CountingClass::count));
+        }
+
+        countingSum = 0;
+        const iaTime start = iaTime::getNow();
+        for (int i = 0; i < fires; ++i)
+        {
+            event(1);
+        }
+        const iaTime duration = iaTime::getNow() - start;
+
+        IAUX_EXPECT_EQUAL(countingSum, fires);
+        for (const auto &listener : listeners)
+        {
+            IAUX_EXPECT_EQUAL(listener._sum, fires);
+        }
+
+        iaConsole::getInstance() << "listeners: " << listenerCount << " fires/sec: " << static_cast<uint64>(fires / (duration.getMilliseconds() / 1000.0)) << endl;
+    }
+}
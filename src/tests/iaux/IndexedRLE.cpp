@@ -0,0 +1,230 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <iaux/data/iaIndexedRLE.h>
+#include <iaux/data/iaRLE.h>
+using namespace iaux;
+
+typedef iaIndexedRLE<uint8, uint8> iaIndexedRLE88;
+
+IAUX_TEST(IndexedRLETests, Initial)
+{
+    iaIndexedRLE88 data(10);
+    iaIndexedRLE88 data2;
+
+    IAUX_EXPECT_EQUAL(data.getSize(), 10);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 1);
+    IAUX_EXPECT_EQUAL(data2.getSize(), 0);
+    IAUX_EXPECT_EQUAL(data2.getRunCount(), 0);
+}
+
+IAUX_TEST(IndexedRLETests, SetValue)
+{
+    iaIndexedRLE88 data(5);
+
+    data.setValue(2, 3);
+    data.setValue(4, 5);
+    data.setValue(1, 2);
+    data.setValue(3, 4);
+    data.setValue(0, 1);
+
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 5);
+    IAUX_EXPECT_EQUAL(data.getValue(0), 1);
+    IAUX_EXPECT_EQUAL(data.getValue(1), 2);
+    IAUX_EXPECT_EQUAL(data.getValue(2), 3);
+    IAUX_EXPECT_EQUAL(data.getValue(3), 4);
+    IAUX_EXPECT_EQUAL(data.getValue(4), 5);
+
+    data.clear(15);
+
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 1);
+    IAUX_EXPECT_EQUAL(data.getValue(4), 15);
+}
+
+IAUX_TEST(IndexedRLETests, SetValuesMergesRuns)
+{
+    iaIndexedRLE88 data(10);
+
+    data.setValue(2, 3, 42);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 3);
+    IAUX_EXPECT_EQUAL(data.getRun(0)._end, 2);
+    IAUX_EXPECT_EQUAL(data.getRun(1)._end, 5);
+    IAUX_EXPECT_EQUAL(data.getRun(1)._value, 42);
+
+    // joins the run in front
+    data.setValue(5, 2, 42);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 3);
+    IAUX_EXPECT_EQUAL(data.getRun(1)._end, 7);
+
+    // covers everything
+    data.setValue(0, 10, 0);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 1);
+
+    data.setValue(9, 1, 7);
+    data.setValue(0, 1, 7);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 3);
+
+    // closes gap between two runs of the same value
+    data.setValue(1, 8, 7);
+    IAUX_EXPECT_EQUAL(data.getRunCount(), 1);
+    IAUX_EXPECT_EQUAL(data.getValue(5), 7);
+}
+
+IAUX_TEST(IndexedRLETests, Cursor)
+{
+    iaIndexedRLE88 data(8);
+    data.setValue(2, 3, 1);
+    data.setValue(6, 2);
+
+    const uint8 expected[] = {0, 0, 1, 1, 1, 0, 2, 0};
+
+    iaIndexedRLE88::Cursor cursor(data);
+    for (int i = 0; i < 8; ++i)
+    {
+        IAUX_EXPECT_TRUE(cursor.isValid());
+        IAUX_EXPECT_EQUAL(cursor.getIndex(), i);
+        IAUX_EXPECT_EQUAL(cursor.getValue(), expected[i]);
+        cursor.next();
+    }
+
+    IAUX_EXPECT_FALSE(cursor.isValid());
+
+    cursor.seek(3);
+    IAUX_EXPECT_EQUAL(cursor.getValue(), 1);
+    IAUX_EXPECT_EQUAL(cursor.getRunEnd(), 5);
+}
+
+IAUX_TEST(IndexedRLETests, SameAsPlainArray)
+{
+    iaRandomNumberGenerator rand(42);
+
+    static const int size = 200;
+    iaIndexedRLE<uint8, uint8> data(size);
+    std::vector<uint8> reference(size, 0);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        const uint8 value = static_cast<uint8>(rand.getNextRange(4));
+        const int index = static_cast<int>(rand.getNextRange(size));
+        const int length = 1 + static_cast<int>(rand.getNextRange(std::min(20, size - index)));
+
+        data.setValue(static_cast<uint8>(index), static_cast<uint8>(length), value);
+        std::fill(reference.begin() + index, reference.begin() + index + length, value);
+
+        if (i % 50 == 0)
+        {
+            bool same = true;
+            iaIndexedRLE<uint8, uint8>::Cursor cursor(data);
+            for (int j = 0; j < size; ++j)
+            {
+                same &= data.getValue(static_cast<uint8>(j)) == reference[j];
+                same &= cursor.getValue() == reference[j];
+                cursor.next();
+            }
+
+            IAUX_EXPECT_TRUE(same);
+
+            // runs are always as few as possible
+            uint32 runs = 1;
+            for (int j = 1; j < size; ++j)
+            {
+                runs += reference[j] != reference[j - 1] ? 1 : 0;
+            }
+            IAUX_EXPECT_EQUAL(data.getRunCount(), runs);
+        }
+    }
+}
+
+/*! fills poles with some layers like a terrain would have
+ */
+template <typename TRLE>
+static void fillPoles(std::vector<TRLE> &poles, uint8 height)
+{
+    iaRandomNumberGenerator rand(1337);
+
+    for (auto &pole : poles)
+    {
+        pole.setSize(height, 0);
+
+        int y = 0;
+        while (y < height)
+        {
+            const int length = 1 + static_cast<int>(rand.getNextRange(6));
+            const int clampedLength = std::min(length, height - y);
+            pole.setValue(static_cast<uint8>(y), static_cast<uint8>(clampedLength), static_cast<uint8>(rand.getNextRange(255)));
+            y += clampedLength;
+        }
+    }
+}
+
+IAUX_BENCHMARK(IndexedRLETests, BenchmarkAgainstRLE)
+{
+    static const uint8 height = 250;
+    static const int poleCount = 32 * 32;
+    static const int passes = 5;
+
+    std::vector<iaRLE<uint8, uint8>> rlePoles(poleCount);
+    std::vector<iaIndexedRLE<uint8, uint8>> indexedPoles(poleCount);
+
+    iaTime start = iaTime::getNow();
+    fillPoles(rlePoles, height);
+    const iaTime rleFill = iaTime::getNow() - start;
+
+    start = iaTime::getNow();
+    fillPoles(indexedPoles, height);
+    const iaTime indexedFill = iaTime::getNow() - start;
+
+    // random access per voxel like getVoxelDensity
+    uint64 rleSum = 0;
+    start = iaTime::getNow();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (const auto &pole : rlePoles)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                rleSum += pole.getValue(static_cast<uint8>(y));
+            }
+        }
+    }
+    const iaTime rleScan = iaTime::getNow() - start;
+
+    uint64 indexedSum = 0;
+    start = iaTime::getNow();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (const auto &pole : indexedPoles)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                indexedSum += pole.getValue(static_cast<uint8>(y));
+            }
+        }
+    }
+    const iaTime indexedScan = iaTime::getNow() - start;
+
+    // pole scan like the contouring does it
+    uint64 cursorSum = 0;
+    start = iaTime::getNow();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (const auto &pole : indexedPoles)
+        {
+            for (iaIndexedRLE<uint8, uint8>::Cursor cursor(pole); cursor.isValid(); cursor.next())
+            {
+                cursorSum += cursor.getValue();
+            }
+        }
+    }
+    const iaTime cursorScan = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(rleSum, indexedSum);
+    IAUX_EXPECT_EQUAL(rleSum, cursorSum);
+
+    iaConsole::getInstance() << "poles: " << poleCount << " height: " << height
+                             << " fill iaRLE: " << rleFill << " iaIndexedRLE: " << indexedFill << endl;
+    iaConsole::getInstance() << "scan x" << passes << " iaRLE::getValue: " << rleScan << " iaIndexedRLE::getValue: " << indexedScan
+                             << " iaIndexedRLE::Cursor: " << cursorScan << endl;
+}
@@ -3,9 +3,13 @@
 
 #include <iaux/iaux.h>
 #include <iaux/data/iaString.h>
+#include <iaux/system/iaTime.h>
 using namespace iaux;
 
 #include <unordered_map>
+#include <string>
+#include <cstring>
+#include <cwchar>
 
 IAUX_TEST(StringTests, Initial)
 {
@@ -250,4 +254,268 @@ IAUX_TEST(StringTests, WildcardsToRegExMatches)
     IAUX_EXPECT_TRUE(iaString::matchRegex("anybar.foo", iaString::wildcardToRegex("*bar.*")));
     IAUX_EXPECT_TRUE(iaString::matchRegex("any_.bar.foo", iaString::wildcardToRegex("*bar.*")));
     IAUX_EXPECT_TRUE(iaString::matchRegex("lolNAbar.foo", iaString::wildcardToRegex("lol??bar.f*")));
-}
\ No newline at end of file
+}
+
+IAUX_TEST(StringTests, SmallAndLargeStrings)
+{
+    const iaString small(L'a', iaString::SSO_CAPACITY);
+    const iaString large(L'a', iaString::SSO_CAPACITY + 1);
+
+    IAUX_EXPECT_EQUAL(small.getLength(), iaString::SSO_CAPACITY);
+    IAUX_EXPECT_EQUAL(large.getLength(), iaString::SSO_CAPACITY + 1);
+    IAUX_EXPECT_TRUE(sizeof(iaString) <= 64);
+
+    iaString string(small);
+    string += L'a';
+    IAUX_EXPECT_EQUAL(string, large);
+
+    string = small;
+    IAUX_EXPECT_EQUAL(string, small);
+
+    iaString empty;
+    IAUX_EXPECT_TRUE(empty.getData() != nullptr);
+    IAUX_EXPECT_EQUAL(empty.getData()[0], 0);
+    IAUX_EXPECT_EQUAL(empty, iaString(""));
+}
+
+IAUX_TEST(StringTests, MoveAndSelfAppend)
+{
+    iaString large(L"this text is too long for the internal buffer");
+    const wchar_t *data = large.getData();
+
+    iaString moved(std::move(large));
+    IAUX_EXPECT_EQUAL(moved.getData(), data);
+    IAUX_EXPECT_TRUE(large.isEmpty());
+
+    iaString small(L"foo");
+    small = std::move(moved);
+    IAUX_EXPECT_EQUAL(small.getData(), data);
+    IAUX_EXPECT_TRUE(moved.isEmpty());
+
+    iaString twice(L"abc");
+    twice += twice;
+    twice += twice;
+    IAUX_EXPECT_EQUAL(twice, L"abcabcabcabc");
+
+    twice = twice.getData() + 3;
+    IAUX_EXPECT_EQUAL(twice, L"abcabcabc");
+}
+
+IAUX_TEST(StringTests, CachedHash)
+{
+    iaString string(L"FooBar");
+    const int64 hash = string.getHashValue();
+
+    IAUX_EXPECT_EQUAL(hash, static_cast<int64>(std::hash<std::wstring>()(std::wstring(L"FooBar"))));
+    IAUX_EXPECT_EQUAL(string.getHashValue(), hash);
+
+    string.toLower();
+    IAUX_EXPECT_NOT_EQUAL(string.getHashValue(), hash);
+    IAUX_EXPECT_EQUAL(string.getHashValue(), iaString(L"foobar").getHashValue());
+
+    string[0] = L'F';
+    string[3] = L'B';
+    IAUX_EXPECT_EQUAL(string.getHashValue(), hash);
+
+    string += L"!";
+    IAUX_EXPECT_NOT_EQUAL(string.getHashValue(), hash);
+
+    IAUX_EXPECT_EQUAL(iaString().getHashValue(), static_cast<int64>(std::hash<std::wstring>()(std::wstring())));
+}
+
+IAUX_TEST(StringTests, Split)
+{
+    std::vector<iaString> tokens;
+    iaString(L",a,,bc,").split(L',', tokens);
+    IAUX_EXPECT_EQUAL(tokens.size(), 2);
+    IAUX_EXPECT_EQUAL(tokens[0], L"a");
+    IAUX_EXPECT_EQUAL(tokens[1], L"bc");
+
+    tokens.clear();
+    iaString(L"a b;c").split(L" ;", tokens);
+    IAUX_EXPECT_EQUAL(tokens.size(), 3);
+    IAUX_EXPECT_EQUAL(tokens[2], L"c");
+
+    tokens.clear();
+    iaString(L",a,,bc,").split(L',', tokens, iaStringSplitMode::RetriveAllEmpties);
+    IAUX_EXPECT_EQUAL(tokens.size(), 4);
+    IAUX_EXPECT_TRUE(tokens[0].isEmpty());
+    IAUX_EXPECT_EQUAL(tokens[1], L"a");
+    IAUX_EXPECT_TRUE(tokens[2].isEmpty());
+    IAUX_EXPECT_EQUAL(tokens[3], L"bc");
+
+    tokens.clear();
+    iaString(L",,").split(L',', tokens, iaStringSplitMode::RetriveAllEmpties);
+    IAUX_EXPECT_EQUAL(tokens.size(), 2);
+}
+
+/*! mimics the previous implementation which allocated for every string
+ */
+class LegacyString
+{
+public:
+    LegacyString(const wchar_t *text)
+    {
+        set(text, static_cast<int64>(wcslen(text)));
+    }
+
+    LegacyString(const wchar_t *text, int64 length)
+    {
+        set(text, length);
+    }
+
+    LegacyString(const LegacyString &other)
+    {
+        set(other._data, other._charCount);
+    }
+
+    ~LegacyString()
+    {
+        delete[] _data;
+    }
+
+    void operator+=(const LegacyString &text)
+    {
+        wchar_t *temp = new wchar_t[_charCount + text._charCount + 1];
+        wmemcpy(temp, _data, _charCount);
+        wmemcpy(temp + _charCount, text._data, text._charCount);
+        _charCount += text._charCount;
+        temp[_charCount] = 0;
+        delete[] _data;
+        _data = temp;
+    }
+
+    int64 getHashValue() const
+    {
+        std::hash<std::wstring> hashFunc;
+        return static_cast<int64>(hashFunc(_data));
+    }
+
+    void split(wchar_t delimiter, std::vector<LegacyString> &tokens) const
+    {
+        int64 from = 0;
+        for (int64 i = 0; i <= _charCount; ++i)
+        {
+            if (i == _charCount || _data[i] == delimiter)
+            {
+                if (i > from)
+                {
+                    tokens.push_back(LegacyString(_data + from, i - from));
+                }
+                from = i + 1;
+            }
+        }
+    }
+
+private:
+    int64 _charCount = 0;
+    wchar_t *_data = nullptr;
+
+    void set(const wchar_t *text, int64 length)
+    {
+        _charCount = length;
+        _data = new wchar_t[_charCount + 1];
+        wmemcpy(_data, text, _charCount);
+        _data[_charCount] = 0;
+    }
+};
+
+static const int benchmarkIterations = 200000;
+static const wchar_t *benchmarkWords[] = {L"node", L"transform", L"physics", L"resource_alias_long_name", L"x"};
+static const wchar_t *benchmarkPath = L"root/scene/level/entity/component/transform/child/mesh";
+
+IAUX_BENCHMARK(StringTests, BenchmarkAgainstLegacy)
+{
+    int64 legacyCheck = 0;
+    int64 check = 0;
+
+    // construction
+    iaTime start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations; ++i)
+    {
+        LegacyString string(benchmarkWords[i % 5]);
+        LegacyString copy(string);
+        legacyCheck += copy.getHashValue() & 1;
+    }
+    const iaTime legacyConstruction = iaTime::getNow() - start;
+
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations; ++i)
+    {
+        iaString string(benchmarkWords[i % 5]);
+        iaString copy(string);
+        check += copy.getHashValue() & 1;
+    }
+    const iaTime construction = iaTime::getNow() - start;
+
+    // concatenation
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations / 100; ++i)
+    {
+        LegacyString string(L"");
+        for (int j = 0; j < 100; ++j)
+        {
+            string += LegacyString(benchmarkWords[j % 5]);
+        }
+        legacyCheck += string.getHashValue() & 1;
+    }
+    const iaTime legacyConcatenation = iaTime::getNow() - start;
+
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations / 100; ++i)
+    {
+        iaString string;
+        for (int j = 0; j < 100; ++j)
+        {
+            string += iaString(benchmarkWords[j % 5]);
+        }
+        check += string.getHashValue() & 1;
+    }
+    const iaTime concatenation = iaTime::getNow() - start;
+
+    // hashing a key over and over like a map lookup does
+    const LegacyString legacyKey(benchmarkPath);
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations; ++i)
+    {
+        legacyCheck += legacyKey.getHashValue() & 1;
+    }
+    const iaTime legacyHashing = iaTime::getNow() - start;
+
+    const iaString key(benchmarkPath);
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations; ++i)
+    {
+        check += key.getHashValue() & 1;
+    }
+    const iaTime hashing = iaTime::getNow() - start;
+
+    // split
+    uint64 legacyTokens = 0;
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations / 10; ++i)
+    {
+        std::vector<LegacyString> tokens;
+        legacyKey.split(L'/', tokens);
+        legacyTokens += tokens.size();
+    }
+    const iaTime legacySplit = iaTime::getNow() - start;
+
+    uint64 tokenCount = 0;
+    start = iaTime::getNow();
+    for (int i = 0; i < benchmarkIterations / 10; ++i)
+    {
+        std::vector<iaString> tokens;
+        key.split(L'/', tokens);
+        tokenCount += tokens.size();
+    }
+    const iaTime split = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(legacyCheck, check);
+    IAUX_EXPECT_EQUAL(legacyTokens, tokenCount);
+
+    iaConsole::getInstance() << "construction legacy: " << legacyConstruction << " now: " << construction << endl;
+    iaConsole::getInstance() << "concatenation legacy: " << legacyConcatenation << " now: " << concatenation << endl;
+    iaConsole::getInstance() << "hashing legacy: " << legacyHashing << " now: " << hashing << endl;
+    iaConsole::getInstance() << "split legacy: " << legacySplit << " now: " << split << endl;
+}
@@ -0,0 +1,100 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <iaux/data/iaStringID.h>
+using namespace iaux;
+
+#include <unordered_map>
+#include <thread>
+
+IAUX_TEST(StringIDTests, Empty)
+{
+    iaStringID empty;
+
+    IAUX_EXPECT_TRUE(empty.isEmpty());
+    IAUX_EXPECT_EQUAL(empty.getID(), 0);
+    IAUX_EXPECT_TRUE(empty.getString().isEmpty());
+    IAUX_EXPECT_TRUE(iaStringID("") == empty);
+}
+
+IAUX_TEST(StringIDTests, SameTextSameID)
+{
+    const iaStringID foo("foo");
+    const iaStringID bar(iaString("bar"));
+    const iaStringID foo2(iaString(L"foo"));
+
+    IAUX_EXPECT_FALSE(foo.isEmpty());
+    IAUX_EXPECT_EQUAL(foo.getID(), foo2.getID());
+    IAUX_EXPECT_NOT_EQUAL(foo.getID(), bar.getID());
+    IAUX_EXPECT_TRUE(foo == foo2);
+    IAUX_EXPECT_TRUE(foo != bar);
+    IAUX_EXPECT_EQUAL(foo.getString(), L"foo");
+    IAUX_EXPECT_EQUAL(bar.getString(), L"bar");
+}
+
+IAUX_TEST(StringIDTests, ConcurrentInterning)
+{
+    const uint32 countBefore = iaStringID::getInternedCount();
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<uint32>> ids(4);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t, &ids]()
+                             {
+                                 for (int i = 0; i < 3000; ++i)
+                                 {
+                                     ids[t].push_back(iaStringID(iaString("concurrent_") + iaString::toString(i)).getID());
+                                 } });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    IAUX_EXPECT_EQUAL(iaStringID::getInternedCount(), countBefore + 3000);
+    IAUX_EXPECT_TRUE(ids[0] == ids[1]);
+    IAUX_EXPECT_TRUE(ids[0] == ids[3]);
+    IAUX_EXPECT_EQUAL(iaStringID(iaString("concurrent_2999")).getString(), L"concurrent_2999");
+}
+
+IAUX_BENCHMARK(StringIDTests, BenchmarkMapLookup)
+{
+    static const int keyCount = 1000;
+    static const int lookups = 1000000;
+
+    std::vector<iaString> names;
+    std::vector<iaStringID> ids;
+    std::unordered_map<iaString, int> stringMap;
+    std::unordered_map<iaStringID, int> idMap;
+
+    for (int i = 0; i < keyCount; ++i)
+    {
+        names.push_back(iaString("resource/alias/") + iaString::toString(i));
+        ids.push_back(iaStringID(names.back()));
+        stringMap[names.back()] = i;
+        idMap[ids.back()] = i;
+    }
+
+    int64 stringSum = 0;
+    iaTime start = iaTime::getNow();
+    for (int i = 0; i < lookups; ++i)
+    {
+        stringSum += stringMap.find(names[i % keyCount])->second;
+    }
+    const iaTime stringDuration = iaTime::getNow() - start;
+
+    int64 idSum = 0;
+    start = iaTime::getNow();
+    for (int i = 0; i < lookups; ++i)
+    {
+        idSum += idMap.find(ids[i % keyCount])->second;
+    }
+    const iaTime idDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(stringSum, idSum);
+
+    iaConsole::getInstance() << "map lookups: " << lookups << " iaString key: " << stringDuration << " iaStringID key: " << idDuration << endl;
+}
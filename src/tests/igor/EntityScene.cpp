@@ -0,0 +1,173 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/entities/iEntitySystemModule.h>
+#include <igor/threading/iTaskManager.h>
+#include <igor/physics/iPhysics.h>
+#include <igor/resources/config/iConfigReader.h>
+using namespace igor;
+
+#include <fstream>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <cmath>
+
+static const char *entitySceneConfigFilename = "entitySceneTest.xml";
+
+struct ComponentA
+{
+    float64 _value = 0.0;
+};
+
+struct ComponentB
+{
+    float64 _value = 0.0;
+};
+
+class ReadASystem : public iEntitySystem
+{
+public:
+    ReadASystem()
+        : iEntitySystem("readA")
+    {
+        reads<ComponentA>();
+    }
+
+    void update(const iaTime &time, iEntityScenePtr scene) override {}
+};
+
+class WriteASystem : public iEntitySystem
+{
+public:
+    WriteASystem()
+        : iEntitySystem("writeA")
+    {
+        writes<ComponentA>();
+    }
+
+    void update(const iaTime &time, iEntityScenePtr scene) override {}
+};
+
+class ReadAWriteBSystem : public iEntitySystem
+{
+public:
+    ReadAWriteBSystem()
+        : iEntitySystem("readAWriteB")
+    {
+        reads<ComponentA>();
+        writes<ComponentB>();
+    }
+
+    void update(const iaTime &time, iEntityScenePtr scene) override {}
+};
+
+class ExclusiveSystem : public iEntitySystem
+{
+public:
+    ExclusiveSystem()
+        : iEntitySystem("exclusive")
+    {
+    }
+
+    void update(const iaTime &time, iEntityScenePtr scene) override {}
+};
+
+IAUX_TEST(EntitySceneTests, SystemConflicts)
+{
+    ReadASystem readA;
+    WriteASystem writeA;
+    ReadAWriteBSystem readAWriteB;
+    ExclusiveSystem exclusive;
+
+    IAUX_EXPECT_FALSE(readA.conflictsWith(readA));
+    IAUX_EXPECT_FALSE(readA.conflictsWith(readAWriteB));
+    IAUX_EXPECT_TRUE(readA.conflictsWith(writeA));
+    IAUX_EXPECT_TRUE(writeA.conflictsWith(readA));
+    IAUX_EXPECT_TRUE(writeA.conflictsWith(readAWriteB));
+    IAUX_EXPECT_TRUE(readAWriteB.conflictsWith(readAWriteB));
+
+    IAUX_EXPECT_TRUE(exclusive.isExclusive());
+    IAUX_EXPECT_FALSE(readA.isExclusive());
+    IAUX_EXPECT_TRUE(exclusive.conflictsWith(readA));
+    IAUX_EXPECT_TRUE(readA.conflictsWith(exclusive));
+}
+
+IAUX_TEST(EntitySceneTests, DefaultStages)
+{
+    iEntitySystemModule::create();
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+
+    // animation and behaviour are exclusive, velocity writes the transforms the others only read
+    const auto &timings = scene->getSystemTimings();
+    IAUX_EXPECT_EQUAL(timings.size(), 5);
+
+    const uint32 expectedStages[] = {0, 1, 2, 3, 3};
+    for (uint32 i = 0; i < timings.size(); ++i)
+    {
+        IAUX_EXPECT_EQUAL(timings[i]._stage, expectedStages[i]);
+        IAUX_EXPECT_FALSE(timings[i]._name.isEmpty());
+    }
+
+    IAUX_EXPECT_EQUAL(timings[3]._name, iaString("transform hierarchy"));
+    IAUX_EXPECT_EQUAL(timings[4]._name, iaString("quadtree"));
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+}
+
+IAUX_TEST(EntitySceneTests, ForEachChunk)
+{
+    const uint32 threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::ofstream file(entitySceneConfigFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"minThreads\" value=\"" << threadCount << "\" />\n";
+    file << "        <Setting name=\"maxThreads\" value=\"" << threadCount << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(entitySceneConfigFilename);
+    iPhysics::create();
+    iTaskManager::create();
+    iEntitySystemModule::create();
+
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+
+    static const uint64 count = 100000;
+    std::vector<iaVector3d> positions(count);
+    std::vector<iaVector3d> velocities(count, iaVector3d(1.0, 0.5, 0.0));
+
+    auto move = [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i < end; ++i)
+        {
+            for (int step = 0; step < 10; ++step)
+            {
+                positions[i] += velocities[i];
+                positions[i]._x = std::fmod(positions[i]._x, 1000.0);
+            }
+        }
+    };
+
+    scene->setMultithreadingEnabled(false);
+    scene->forEachChunk(count, move);
+
+    scene->setMultithreadingEnabled(true);
+    scene->forEachChunk(count, move);
+
+    IAUX_EXPECT_NEAR(positions[0]._y, 10.0, 0.0001);
+    IAUX_EXPECT_NEAR(positions[count - 1]._y, 10.0, 0.0001);
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+    iTaskManager::destroy();
+    iPhysics::destroy();
+    iConfigReader::destroy();
+    std::remove(entitySceneConfigFilename);
+}
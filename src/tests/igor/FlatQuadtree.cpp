@@ -0,0 +1,278 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/data/iQuadtree.h>
+#include <igor/data/iFlatQuadtree.h>
+using namespace igor;
+
+#include <algorithm>
+
+static const iaRectanglef testRect1(-100, -100, 200, 200);
+static const iaRectanglef testRect2(20, 0, 50, 50);
+static const iaCirclef testCircle1(20, 10, 15);
+
+typedef iFlatQuadtree<float32, int> iFlatQuadtreeTest;
+
+IAUX_TEST(FlatQuadtreeTests, EmptyTree)
+{
+    iFlatQuadtreeTest tree(testRect1);
+
+    IAUX_EXPECT_EQUAL(tree.getRootBox().getX(), testRect1.getX());
+    IAUX_EXPECT_EQUAL(tree.getRootBox().getY(), testRect1.getY());
+    IAUX_EXPECT_EQUAL(tree.getRootBox().getWidth(), testRect1.getWidth());
+    IAUX_EXPECT_EQUAL(tree.getRootBox().getHeight(), testRect1.getHeight());
+
+    IAUX_EXPECT_TRUE(tree.isLeaf(tree.getRoot()));
+    IAUX_EXPECT_TRUE(tree.getNode(tree.getRoot())._objects.empty());
+    IAUX_EXPECT_EQUAL(tree.getNode(tree.getRoot())._parent, iFlatQuadtreeTest::INVALID_INDEX);
+    IAUX_EXPECT_EQUAL(tree.getObjectCount(), 0);
+    IAUX_EXPECT_EQUAL(tree.getNodeCount(), 1);
+}
+
+IAUX_TEST(FlatQuadtreeTests, AddObjectsAndClear)
+{
+    iFlatQuadtreeTest tree(testRect1, 3);
+
+    tree.insert(iaCirclef(10, 10, 10), 1);
+    tree.insert(iaCirclef(40, 10, 10), 2);
+
+    IAUX_EXPECT_TRUE(tree.isLeaf(tree.getRoot()));
+    IAUX_EXPECT_EQUAL(tree.getNode(tree.getRoot())._objects.size(), 2);
+
+    tree.insert(iaCirclef(60, 10, 10), 3);
+    tree.insert(iaCirclef(90, 10, 10), 4);
+
+    IAUX_EXPECT_FALSE(tree.isLeaf(tree.getRoot()));
+    IAUX_EXPECT_EQUAL(tree.getNode(tree.getRoot())._objects.size(), 0);
+
+    const uint32 child3 = tree.getNode(tree.getRoot())._firstChild + 3;
+    IAUX_EXPECT_FALSE(tree.isLeaf(child3));
+
+    const uint32 firstGrandChild = tree.getNode(child3)._firstChild;
+    IAUX_EXPECT_EQUAL(tree.getNode(firstGrandChild + 0)._objects.size(), 2);
+    IAUX_EXPECT_EQUAL(tree.getNode(firstGrandChild + 1)._objects.size(), 2);
+    IAUX_EXPECT_TRUE(tree.getNode(firstGrandChild + 2)._objects.empty());
+    IAUX_EXPECT_TRUE(tree.getNode(firstGrandChild + 3)._objects.empty());
+
+    tree.clear();
+
+    IAUX_EXPECT_TRUE(tree.isLeaf(tree.getRoot()));
+    IAUX_EXPECT_TRUE(tree.getNode(tree.getRoot())._objects.empty());
+    IAUX_EXPECT_EQUAL(tree.getObjectCount(), 0);
+    IAUX_EXPECT_EQUAL(tree.getNodeCount(), 1);
+}
+
+IAUX_TEST(FlatQuadtreeTests, AddObjectsAndRemove)
+{
+    iFlatQuadtreeTest tree(testRect1, 3);
+
+    tree.insert(iaCirclef(10, 10, 10), 1);
+    tree.insert(iaCirclef(40, 10, 10), 2);
+    iQuadtreeObjectID object3 = tree.insert(iaCirclef(60, 10, 10), 3);
+    tree.insert(iaCirclef(90, 10, 10), 4);
+
+    tree.remove(object3);
+    IAUX_EXPECT_EQUAL(tree.getObjectCount(), 3);
+
+    std::vector<iQuadtreeObjectID> objects;
+    tree.query(testRect1, objects);
+    IAUX_EXPECT_EQUAL(objects.size(), 3);
+
+    // freed slot gets reused
+    IAUX_EXPECT_EQUAL(tree.insert(iaCirclef(60, 10, 10), 5), object3);
+    IAUX_EXPECT_EQUAL(tree.getUserData(object3), 5);
+}
+
+IAUX_TEST(FlatQuadtreeTests, AddObjectsAndQueryRectangle)
+{
+    iFlatQuadtreeTest tree(testRect1, 3);
+
+    tree.insert(iaCirclef(10, 10, 5), 1);
+    tree.insert(iaCirclef(40, 10, 10), 2);
+    tree.insert(iaCirclef(60, 10, 10), 3);
+    tree.insert(iaCirclef(90, 10, 10), 4);
+
+    std::vector<int> found;
+    tree.query(testRect2, [&](iQuadtreeObjectID objectID, const iFlatQuadtreeTest::Object &object)
+               { found.push_back(object._userData); });
+
+    IAUX_EXPECT_EQUAL(found.size(), 2);
+    std::sort(found.begin(), found.end());
+    IAUX_EXPECT_EQUAL(found[0], 2);
+    IAUX_EXPECT_EQUAL(found[1], 3);
+}
+
+IAUX_TEST(FlatQuadtreeTests, AddObjectsAndQueryCircle)
+{
+    iFlatQuadtreeTest tree(testRect1, 3);
+
+    tree.insert(iaCirclef(10, 10, 10), 1);
+    tree.insert(iaCirclef(30, 10, 10), 2);
+    tree.insert(iaCirclef(60, 10, 10), 3);
+    tree.insert(iaCirclef(90, 10, 10), 4);
+
+    std::vector<int> found;
+    tree.query(testCircle1, [&](iQuadtreeObjectID objectID, const iFlatQuadtreeTest::Object &object)
+               { found.push_back(object._userData); });
+
+    IAUX_EXPECT_EQUAL(found.size(), 2);
+    std::sort(found.begin(), found.end());
+    IAUX_EXPECT_EQUAL(found[0], 1);
+    IAUX_EXPECT_EQUAL(found[1], 2);
+}
+
+IAUX_TEST(FlatQuadtreeTests, MoveObjects)
+{
+    iFlatQuadtreeTest tree(testRect1, 3);
+
+    tree.insert(iaCirclef(10, 10, 10), 1);
+    iQuadtreeObjectID object2 = tree.insert(iaCirclef(30, 10, 10), 2);
+    iQuadtreeObjectID object3 = tree.insert(iaCirclef(60, 10, 10), 3);
+    tree.insert(iaCirclef(90, 10, 10), 4);
+
+    tree.update(object2, iaVector2f(50, 50));
+    tree.update(object3, iaVector2f(25, 12));
+
+    std::vector<int> found;
+    tree.query(testCircle1, [&](iQuadtreeObjectID objectID, const iFlatQuadtreeTest::Object &object)
+               { found.push_back(object._userData); });
+
+    IAUX_EXPECT_EQUAL(found.size(), 2);
+    std::sort(found.begin(), found.end());
+    IAUX_EXPECT_EQUAL(found[0], 1);
+    IAUX_EXPECT_EQUAL(found[1], 3);
+}
+
+static const iaRectangled benchmarkRect(0, 0, 10000, 10000);
+static const uint32 benchmarkObjectCount = 50000;
+static const uint32 benchmarkFrames = 10;
+
+IAUX_TEST(FlatQuadtreeTests, SameResultsAsQuadtree)
+{
+    iaRandomNumberGenerator rand(42);
+
+    iQuadtreed tree(benchmarkRect);
+    iFlatQuadtree<float64, uint32> flatTree(benchmarkRect);
+
+    std::vector<iQuadtreed::ObjectPtr> objects;
+    std::vector<iQuadtreeObjectID> objectIDs;
+
+    for (uint32 i = 0; i < 5000; ++i)
+    {
+        const iaCircled circle(rand.getNextFloatRange(0.0, 9999.0), rand.getNextFloatRange(0.0, 9999.0), rand.getNextFloatRange(1.0, 20.0));
+
+        objects.push_back(std::make_shared<iQuadtreed::Object>(circle, i));
+        tree.insert(objects.back());
+        objectIDs.push_back(flatTree.insert(circle, i));
+    }
+
+    for (uint32 i = 0; i < 5000; i += 3)
+    {
+        const iaVector2d position(rand.getNextFloatRange(0.0, 9999.0), rand.getNextFloatRange(0.0, 9999.0));
+        tree.update(objects[i], position);
+        flatTree.update(objectIDs[i], position);
+    }
+
+    for (uint32 i = 0; i < 100; ++i)
+    {
+        const iaCircled circle(rand.getNextFloatRange(0.0, 9999.0), rand.getNextFloatRange(0.0, 9999.0), 200.0);
+
+        iQuadtreed::Objects found;
+        tree.query(circle, found);
+
+        std::vector<uint32> expected;
+        for (const auto &object : found)
+        {
+            expected.push_back(std::any_cast<uint32>(object->_userData));
+        }
+
+        std::vector<uint32> result;
+        flatTree.query(circle, [&](iQuadtreeObjectID objectID, const iFlatQuadtree<float64, uint32>::Object &object)
+                       { result.push_back(object._userData); });
+
+        std::sort(expected.begin(), expected.end());
+        std::sort(result.begin(), result.end());
+        IAUX_EXPECT_TRUE(expected == result);
+    }
+}
+
+IAUX_BENCHMARK(FlatQuadtreeTests, BenchmarkAgainstQuadtree)
+{
+    iaRandomNumberGenerator rand(1337);
+
+    std::vector<iaCircled> circles;
+    for (uint32 i = 0; i < benchmarkObjectCount; ++i)
+    {
+        circles.emplace_back(rand.getNextFloatRange(0.0, 9999.0), rand.getNextFloatRange(0.0, 9999.0), 5.0);
+    }
+
+    // quadtree
+    uint64 quadtreeHits = 0;
+    iaTime start = iaTime::getNow();
+    {
+        iQuadtreed tree(benchmarkRect);
+        std::vector<iQuadtreed::ObjectPtr> objects;
+
+        for (uint32 i = 0; i < benchmarkObjectCount; ++i)
+        {
+            objects.push_back(std::make_shared<iQuadtreed::Object>(circles[i], i));
+            tree.insert(objects.back());
+        }
+
+        iQuadtreed::Objects found;
+        for (uint32 frame = 0; frame < benchmarkFrames; ++frame)
+        {
+            for (uint32 i = 0; i < benchmarkObjectCount; ++i)
+            {
+                iaCircled circle = objects[i]->_circle;
+                circle._center._x = std::fmod(circle._center._x + 3.0, 9999.0);
+                tree.update(objects[i], circle._center);
+
+                circle._radius *= 10.0;
+                found.clear();
+                tree.query(circle, found);
+
+                for (const auto &object : found)
+                {
+                    quadtreeHits += std::any_cast<uint32>(object->_userData) != i ? 1 : 0;
+                }
+            }
+        }
+    }
+    const iaTime quadtreeDuration = iaTime::getNow() - start;
+
+    // flat quadtree
+    uint64 flatQuadtreeHits = 0;
+    start = iaTime::getNow();
+    {
+        iFlatQuadtree<float64, uint32> tree(benchmarkRect);
+        std::vector<iQuadtreeObjectID> objectIDs;
+
+        for (uint32 i = 0; i < benchmarkObjectCount; ++i)
+        {
+            objectIDs.push_back(tree.insert(circles[i], i));
+        }
+
+        for (uint32 frame = 0; frame < benchmarkFrames; ++frame)
+        {
+            for (uint32 i = 0; i < benchmarkObjectCount; ++i)
+            {
+                iaCircled circle = tree.getObject(objectIDs[i])._circle;
+                circle._center._x = std::fmod(circle._center._x + 3.0, 9999.0);
+                tree.update(objectIDs[i], circle._center);
+
+                circle._radius *= 10.0;
+                tree.query(circle, [&](iQuadtreeObjectID objectID, const iFlatQuadtree<float64, uint32>::Object &object)
+                           { flatQuadtreeHits += object._userData != i ? 1 : 0; });
+            }
+        }
+    }
+    const iaTime flatQuadtreeDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(quadtreeHits, flatQuadtreeHits);
+
+    iaConsole::getInstance() << "objects: " << benchmarkObjectCount << " frames: " << benchmarkFrames
+                             << " iQuadtree: " << quadtreeDuration << " iFlatQuadtree: " << flatQuadtreeDuration << endl;
+}
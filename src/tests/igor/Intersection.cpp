@@ -43,6 +43,19 @@ IAUX_TEST(IntersectionTests, CircleRectangleContains)
     IAUX_EXPECT_TRUE(iIntersection::contains(rectangle, circle5));
 }
 
+IAUX_TEST(IntersectionTests, CircleCircleIntersects)
+{
+    iaCircled circle1(0, 0, 10);
+    iaCircled circle2(19, 0, 10);
+    iaCircled circle3(0, 21, 10);
+    iaCircled circle4(3, 4, 1);
+
+    IAUX_EXPECT_TRUE(iIntersection::intersects(circle1, circle2));
+    IAUX_EXPECT_FALSE(iIntersection::intersects(circle1, circle3));
+    IAUX_EXPECT_TRUE(iIntersection::intersects(circle1, circle4));
+    IAUX_EXPECT_FALSE(iIntersection::intersects(circle2, circle3));
+}
+
 IAUX_TEST(IntersectionTests, SphereInFrontOfPlane)
 {
     iaSphered sphere1(iaVector3d(-20, 0, 0), 1);
@@ -0,0 +1,200 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/data/iOctree.h>
+#include <igor/data/iIntersection.h>
+using namespace igor;
+
+#include <algorithm>
+#include <cmath>
+
+static const iAACubed octreeBox(iaVector3d(0, 0, 0), 10000.0);
+static const uint64 benchmarkVolumeCount = 100000;
+static const uint32 benchmarkFrames = 20;
+
+static iFrustumd createFrustum(const iaVector3d &eye, const iaVector3d &coi)
+{
+    iaMatrixd projection;
+    projection.perspective(60.0, 4.0 / 3.0, 1.0, 5000.0);
+
+    iaMatrixd camera;
+    camera.lookAt(eye, coi, iaVector3d(0, 1, 0));
+    camera.invert();
+
+    projection *= camera;
+    return iFrustumd(projection);
+}
+
+static void *toUserData(uint64 index)
+{
+    return reinterpret_cast<void *>(index + 1);
+}
+
+static std::vector<void *> bruteForce(const std::vector<iaSphered> &spheres, const std::vector<bool> &alive, const iFrustumd &frustum)
+{
+    std::vector<void *> result;
+    for (uint64 i = 0; i < spheres.size(); ++i)
+    {
+        if (alive[i] && iIntersection::intersects(spheres[i], frustum))
+        {
+            result.push_back(toUserData(i));
+        }
+    }
+
+    return result;
+}
+
+static std::vector<void *> sorted(std::vector<void *> values)
+{
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+IAUX_TEST(OctreeTests, InsertAndFilterSphere)
+{
+    iOctree octree(octreeBox, 1.0, 4, 1);
+
+    octree.insert(toUserData(0), iaSphered(iaVector3d(10, 10, 10), 1));
+    octree.insert(toUserData(1), iaSphered(iaVector3d(20, 10, 10), 1));
+    octree.insert(toUserData(2), iaSphered(iaVector3d(-500, 10, 10), 1));
+    octree.insert(toUserData(3), iaSphered(iaVector3d(500, 500, 500), 1));
+    octree.insert(toUserData(4), iaSphered(iaVector3d(15, 12, 10), 1));
+
+    octree.addFilter(iaSphered(iaVector3d(15, 10, 10), 10));
+    octree.filter();
+
+    const auto result = sorted(octree.getResult());
+    IAUX_EXPECT_EQUAL(result.size(), 3);
+    IAUX_EXPECT_EQUAL(result[0], toUserData(0));
+    IAUX_EXPECT_EQUAL(result[1], toUserData(1));
+    IAUX_EXPECT_EQUAL(result[2], toUserData(4));
+
+    octree.remove(toUserData(1));
+    octree.update(toUserData(3), iaSphered(iaVector3d(12, 10, 10), 1));
+    octree.filter();
+
+    const auto result2 = sorted(octree.getResult());
+    IAUX_EXPECT_EQUAL(result2.size(), 3);
+    IAUX_EXPECT_EQUAL(result2[0], toUserData(0));
+    IAUX_EXPECT_EQUAL(result2[1], toUserData(3));
+    IAUX_EXPECT_EQUAL(result2[2], toUserData(4));
+
+    // removed user data must not come back with a late update
+    IAUX_EXPECT_FALSE(octree.updateExisting(toUserData(1), iaSphered(iaVector3d(20, 10, 10), 1)));
+    IAUX_EXPECT_TRUE(octree.updateExisting(toUserData(0), iaSphered(iaVector3d(11, 10, 10), 1)));
+    octree.filter();
+    IAUX_EXPECT_EQUAL(octree.getResult().size(), 3);
+}
+
+IAUX_TEST(OctreeTests, FrustumSameResultsAsBruteForce)
+{
+    iaRandomNumberGenerator rand(42);
+
+    iOctree octree(octreeBox, 10.0, 8, 2);
+    std::vector<iaSphered> spheres;
+    std::vector<bool> alive;
+
+    for (uint64 i = 0; i < 20000; ++i)
+    {
+        spheres.emplace_back(iaVector3d(rand.getNextFloatRange(-5000.0, 5000.0), rand.getNextFloatRange(-5000.0, 5000.0), rand.getNextFloatRange(-5000.0, 5000.0)), rand.getNextFloatRange(1.0, 50.0));
+        alive.push_back(true);
+        octree.insert(toUserData(i), spheres.back());
+    }
+
+    // remove some and move some to force splits and merges
+    for (uint64 i = 0; i < spheres.size(); i += 3)
+    {
+        octree.remove(toUserData(i));
+        alive[i] = false;
+    }
+
+    for (uint64 i = 1; i < spheres.size(); i += 5)
+    {
+        // update would add removed objects again
+        if (!alive[i])
+        {
+            continue;
+        }
+
+        spheres[i]._center = iaVector3d(rand.getNextFloatRange(-1000.0, 1000.0), rand.getNextFloatRange(-1000.0, 1000.0), rand.getNextFloatRange(-1000.0, 1000.0));
+        octree.update(toUserData(i), spheres[i]);
+    }
+
+    for (uint32 i = 0; i < 20; ++i)
+    {
+        const iaVector3d eye(rand.getNextFloatRange(-3000.0, 3000.0), rand.getNextFloatRange(-3000.0, 3000.0), rand.getNextFloatRange(-3000.0, 3000.0));
+        const iaVector3d coi(rand.getNextFloatRange(-3000.0, 3000.0), rand.getNextFloatRange(-3000.0, 3000.0), rand.getNextFloatRange(-3000.0, 3000.0));
+        const iFrustumd frustum = createFrustum(eye, coi);
+
+        const auto expected = sorted(bruteForce(spheres, alive, frustum));
+
+        octree.filter(frustum);
+        const bool sameAsBruteForce = expected == sorted(octree.getResult());
+        IAUX_EXPECT_TRUE(sameAsBruteForce);
+
+        std::vector<void *> result;
+        octree.filter(frustum, result);
+        const bool outputSameAsBruteForce = expected == sorted(result);
+        IAUX_EXPECT_TRUE(outputSameAsBruteForce);
+
+        octree.clearFilter();
+        octree.addFilter(frustum);
+        octree.filter();
+        const bool filterSetSameAsBruteForce = expected == sorted(octree.getResult());
+        IAUX_EXPECT_TRUE(filterSetSameAsBruteForce);
+    }
+}
+
+IAUX_BENCHMARK(OctreeTests, BenchmarkFrustumCulling)
+{
+    iaRandomNumberGenerator rand(1337);
+
+    iOctree octree(octreeBox, 10.0, 8, 2);
+    std::vector<iaSphered> spheres;
+    std::vector<bool> alive(benchmarkVolumeCount, true);
+
+    for (uint64 i = 0; i < benchmarkVolumeCount; ++i)
+    {
+        spheres.emplace_back(iaVector3d(rand.getNextFloatRange(-5000.0, 5000.0), rand.getNextFloatRange(-5000.0, 5000.0), rand.getNextFloatRange(-5000.0, 5000.0)), rand.getNextFloatRange(1.0, 20.0));
+    }
+
+    iaTime start = iaTime::getNow();
+    for (uint64 i = 0; i < benchmarkVolumeCount; ++i)
+    {
+        octree.insert(toUserData(i), spheres[i]);
+    }
+    const iaTime insertDuration = iaTime::getNow() - start;
+
+    std::vector<iFrustumd> frustums;
+    for (uint32 frame = 0; frame < benchmarkFrames; ++frame)
+    {
+        const float64 angle = frame * 0.3;
+        frustums.push_back(createFrustum(iaVector3d(0, 0, 0), iaVector3d(std::sin(angle), 0.2, std::cos(angle))));
+    }
+
+    uint64 bruteForceVisible = 0;
+    start = iaTime::getNow();
+    for (const auto &frustum : frustums)
+    {
+        bruteForceVisible += bruteForce(spheres, alive, frustum).size();
+    }
+    const iaTime bruteForceDuration = iaTime::getNow() - start;
+
+    uint64 octreeVisible = 0;
+    start = iaTime::getNow();
+    for (const auto &frustum : frustums)
+    {
+        octree.filter(frustum);
+        octreeVisible += octree.getResult().size();
+    }
+    const iaTime octreeDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(octreeVisible, bruteForceVisible);
+
+    iaConsole::getInstance() << "volumes: " << benchmarkVolumeCount << " frames: " << benchmarkFrames
+                             << " visible/frame: " << octreeVisible / benchmarkFrames
+                             << " insert: " << insertDuration
+                             << " brute force: " << bruteForceDuration << " iOctree: " << octreeDuration << endl;
+}
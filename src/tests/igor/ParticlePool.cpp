@@ -0,0 +1,327 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/simulation/iParticlePool.h>
+using namespace igor;
+
+#include <cmath>
+
+static const float32 simulationRate = 60.0f;
+static const uint32 benchmarkFrames = 600;
+
+/*! particle system settings relevant for the simulation
+ */
+struct ParticleConfig
+{
+    const char *_name;
+    uint16 _maxParticleCount;
+    float32 _emissionRate;
+    float32 _airDrag;
+    iaVector2f _startLift;
+    iaVector2f _startVelocity;
+    iaVector2f _startAge;
+    iaVector2f _startOrientationRate;
+    float32 _tileIncrement;
+    float32 _vortexToParticleRate;
+    iaVector2f _vortexTorque;
+    iaVector2f _vortexRange;
+    uint8 _vortexCheckRange;
+    float32 _vorticityConfinement;
+    iaKeyFrameGraphf _sizeScaleGradient;
+};
+
+/*! configurations similar to the ones of the particles example
+ */
+static std::vector<ParticleConfig> createConfigs()
+{
+    std::vector<ParticleConfig> result;
+
+    iaKeyFrameGraphf constant;
+    constant.setValue(0.0f, 1.0f);
+
+    iaKeyFrameGraphf growing;
+    growing.setValue(0.0f, 6.0f);
+    growing.setValue(1.0f, 1.0f);
+
+    iaKeyFrameGraphf pulsing;
+    pulsing.setValue(0.0f, 0.0f);
+    pulsing.setValue(0.2f, 1.5f);
+    pulsing.setValue(0.5f, 0.5f);
+    pulsing.setValue(1.0f, 2.0f);
+
+    result.push_back({"smoke", 1000, 2.0f, 0.985f, iaVector2f(0.0002f, 0.0005f), iaVector2f(0.01f, 0.02f), iaVector2f(5.0f, 8.0f), iaVector2f(-0.01f, 0.01f), 0.0f, 0.1f, iaVector2f(0.2f, 0.5f), iaVector2f(10.0f, 20.0f), 20, 0.05f, growing});
+    result.push_back({"fire", 2000, 10.0f, 0.97f, iaVector2f(0.002f, 0.004f), iaVector2f(0.04f, 0.1f), iaVector2f(1.0f, 1.5f), iaVector2f(-0.05f, 0.05f), 0.25f, 0.0f, iaVector2f(), iaVector2f(), 20, 0.05f, pulsing});
+    result.push_back({"fontain", 4000, 20.0f, 0.99f, iaVector2f(-0.004f, -0.003f), iaVector2f(0.2f, 0.3f), iaVector2f(3.0f, 4.0f), iaVector2f(), 0.0f, 0.0f, iaVector2f(), iaVector2f(), 20, 0.05f, constant});
+    result.push_back({"magic", 3000, 8.0f, 0.99f, iaVector2f(0.0f, 0.0f), iaVector2f(0.02f, 0.05f), iaVector2f(4.0f, 6.0f), iaVector2f(), 0.1f, 0.2f, iaVector2f(0.5f, 0.7f), iaVector2f(20.0f, 40.0f), 20, 0.05f, pulsing});
+    result.push_back({"waves", 20000, 60.0f, 1.0f, iaVector2f(0.0f, 0.0f), iaVector2f(0.05f, 0.05f), iaVector2f(5.0f, 5.0f), iaVector2f(), 0.0f, 0.0f, iaVector2f(), iaVector2f(), 20, 0.05f, constant});
+
+    return result;
+}
+
+/*! creates particles the same way iParticleSystem::resetParticle does
+ */
+static iParticle createParticle(const ParticleConfig &config, iaRandomNumberGenerator &rand, uint64 &particleCounter)
+{
+    iParticle particle;
+
+    iaVector3f direction(rand.getNextFloatRange(-1.0, 1.0), rand.getNextFloatRange(0.2, 1.0), rand.getNextFloatRange(-1.0, 1.0));
+    direction.normalize();
+
+    const float32 randomFactor = rand.getNext() % 1000 / 1000.0f;
+
+    particle._position.set(rand.getNextFloatRange(-2.0, 2.0), 0.0f, rand.getNextFloatRange(-2.0, 2.0));
+    particle._velocity = direction * (config._startVelocity._x + randomFactor * (config._startVelocity._y - config._startVelocity._x));
+    particle._lift = config._startLift._x + (1 - randomFactor) * (config._startLift._y - config._startLift._x);
+    particle._size = 0.1f + randomFactor * 0.2f;
+    particle._maxAge = config._startAge._x + randomFactor * (config._startAge._y - config._startAge._x);
+    particle._lifeLeft = particle._maxAge;
+    particle._orientationRate = config._startOrientationRate._x + randomFactor * (config._startOrientationRate._y - config._startOrientationRate._x);
+    particle._tilingIndex = static_cast<float32>(rand.getNext() % 4);
+
+    if (config._vortexToParticleRate != 0.0 &&
+        particleCounter == static_cast<uint64>((1.0f - config._vortexToParticleRate) * 100.0f))
+    {
+        particle._normal.set(rand.getNext() % 100 / 100.0f - 0.5f, rand.getNext() % 100 / 100.0f - 0.5f, rand.getNext() % 100 / 100.0f - 0.5f);
+        particle._normal.normalize();
+        particle._torque = config._vortexTorque._x + (rand.getNext() % 100 / 100.0f) * (config._vortexTorque._y - config._vortexTorque._x);
+        particle._vortexRange = config._vortexRange._x + (rand.getNext() % 100 / 100.0f) * (config._vortexRange._y - config._vortexRange._x);
+        particleCounter = 0;
+    }
+    else
+    {
+        particle._torque = 0.0;
+        particleCounter++;
+    }
+
+    return particle;
+}
+
+/*! mimics how iParticleSystem::iterateFrame used to simulate an array of particles
+ */
+static void iterateLegacy(std::vector<iParticle> &particles, const ParticleConfig &config, const iaKeyFrameGraphf &torqueFactorGradient)
+{
+    const int32 count = static_cast<int32>(particles.size());
+    for (int32 index = 0; index < count; ++index)
+    {
+        auto &particle = particles[index];
+        if (particle._lifeLeft <= 0)
+        {
+            particle._visible = false;
+            continue;
+        }
+
+        particle._tilingIndex += config._tileIncrement;
+
+        const float32 normalizedAge = particle._lifeLeft / particle._maxAge;
+
+        particle._velocity[1] += particle._lift;
+        particle._velocity *= config._airDrag;
+        particle._orientation += particle._orientationRate;
+        particle._sizeScale = config._sizeScaleGradient.getValue(normalizedAge);
+
+        if (particle._torque != 0.0)
+        {
+            const float32 torqueFactor = torqueFactorGradient.getValue(normalizedAge);
+
+            const int32 startIndex = index - config._vortexCheckRange;
+            const int32 endIndex = index + config._vortexCheckRange;
+
+            for (int32 i = startIndex; i < endIndex; ++i)
+            {
+                int32 torqueIndex = (i + count) % count;
+
+                if (index == torqueIndex)
+                {
+                    continue;
+                }
+
+                iaVector3f vortexAxis = particle._position - particles[torqueIndex]._position;
+                if (vortexAxis.length() > particle._vortexRange)
+                {
+                    continue;
+                }
+
+                iaVector3f vortexTangent = vortexAxis % particle._normal;
+                vortexTangent.normalize();
+                vortexTangent *= (particle._vortexRange - vortexAxis.length()) / particle._vortexRange;
+                vortexTangent *= particle._torque * torqueFactor;
+                vortexAxis.normalize();
+                vortexAxis *= config._vorticityConfinement;
+                vortexTangent += vortexAxis;
+
+                particles[torqueIndex]._velocity += vortexTangent * 0.001f; // same as the pool's vortex velocity scale
+            }
+        }
+
+        particle._position += particle._velocity;
+        particle._lifeLeft -= 1.0f / simulationRate;
+    }
+}
+
+static iaKeyFrameGraphf createTorqueFactorGradient()
+{
+    iaKeyFrameGraphf result;
+    result.setValue(0.0f, 0.0f);
+    result.setValue(0.1f, 1.0f);
+    result.setValue(0.9f, 1.0f);
+    result.setValue(1.0f, 0.0f);
+    return result;
+}
+
+static void setupPool(iParticlePool &pool, const ParticleConfig &config)
+{
+    pool.resize(config._maxParticleCount);
+    pool.setTimeStep(1.0f / simulationRate);
+    pool.setAirDrag(config._airDrag);
+    pool.setTileIncrement(config._tileIncrement);
+    pool.setVorticityConfinement(config._vorticityConfinement);
+    pool.setVortexCheckRange(config._vortexCheckRange);
+    pool.setSizeScaleGradient(config._sizeScaleGradient);
+    pool.setTorqueFactorGradient(createTorqueFactorGradient());
+}
+
+/*! runs legacy and pool side by side and calls compare after every frame
+ */
+template <typename Compare>
+static void simulate(const ParticleConfig &config, uint32 frames, Compare compare, iaTime &legacyDuration, iaTime &poolDuration, uint64 &iteratedParticles)
+{
+    const iaKeyFrameGraphf torqueFactorGradient = createTorqueFactorGradient();
+
+    std::vector<iParticle> legacy(config._maxParticleCount);
+    iParticlePool pool;
+    setupPool(pool, config);
+
+    iaRandomNumberGenerator rand(1337);
+    uint64 particleCounter = 0;
+    int32 poolIndex = config._maxParticleCount - 1;
+    float32 emissionImpulseStack = 0.0f;
+
+    for (uint32 frame = 0; frame < frames; ++frame)
+    {
+        for (uint32 i = 0; i < config._maxParticleCount; ++i)
+        {
+            iteratedParticles += pool.isAlive(i) ? 1 : 0;
+        }
+
+        iaTime start = iaTime::getNow();
+        iterateLegacy(legacy, config, torqueFactorGradient);
+        legacyDuration += iaTime::getNow() - start;
+
+        start = iaTime::getNow();
+        pool.iterate();
+        poolDuration += iaTime::getNow() - start;
+
+        compare(legacy, pool);
+
+        emissionImpulseStack += config._emissionRate;
+        const int32 createCount = static_cast<int32>(emissionImpulseStack);
+        emissionImpulseStack -= static_cast<float32>(createCount);
+
+        for (int32 i = 0; i < createCount; ++i)
+        {
+            const iParticle particle = createParticle(config, rand, particleCounter);
+            legacy[poolIndex] = particle;
+            pool.setParticle(poolIndex, particle);
+
+            poolIndex = (poolIndex - 1 + config._maxParticleCount) % config._maxParticleCount;
+        }
+    }
+}
+
+IAUX_TEST(ParticlePoolTests, SetAndGetParticle)
+{
+    iParticlePool pool;
+    pool.resize(10);
+
+    for (uint32 i = 0; i < pool.getParticleCount(); ++i)
+    {
+        IAUX_EXPECT_FALSE(pool.isAlive(i));
+    }
+
+    iParticle particle;
+    particle._position.set(1, 2, 3);
+    particle._velocity.set(4, 5, 6);
+    particle._lifeLeft = 2.0f;
+    particle._maxAge = 3.0f;
+    particle._size = 0.5f;
+    particle._torque = 0.7f;
+    particle._vortexRange = 12.0f;
+    particle._normal.set(0, 1, 0);
+    pool.setParticle(3, particle);
+
+    iParticle result;
+    pool.getParticle(3, result);
+    IAUX_EXPECT_TRUE(pool.isAlive(3));
+    IAUX_EXPECT_TRUE(result._visible);
+    IAUX_EXPECT_EQUAL(result._position, particle._position);
+    IAUX_EXPECT_EQUAL(result._velocity, particle._velocity);
+    IAUX_EXPECT_EQUAL(result._maxAge, 3.0f);
+    IAUX_EXPECT_EQUAL(result._size, 0.5f);
+    IAUX_EXPECT_EQUAL(result._torque, 0.7f);
+    IAUX_EXPECT_EQUAL(result._vortexRange, 12.0f);
+
+    // overwriting a vortex particle with a regular one removes the vortex
+    particle._torque = 0.0f;
+    pool.setParticle(3, particle);
+    pool.getParticle(3, result);
+    IAUX_EXPECT_EQUAL(result._torque, 0.0f);
+
+    // growing keeps living particles
+    pool.resize(20);
+    IAUX_EXPECT_TRUE(pool.isAlive(3));
+    IAUX_EXPECT_FALSE(pool.isAlive(15));
+}
+
+IAUX_TEST(ParticlePoolTests, SameAsLegacy)
+{
+    for (const auto &config : createConfigs())
+    {
+        // vortices get applied to all neighbours before integration so results are close but not the same
+        const float32 epsilon = 0.001f;
+        const float32 sizeScaleEpsilon = 0.01f;
+
+        uint32 mismatches = 0;
+        iaTime legacyDuration;
+        iaTime poolDuration;
+        uint64 iteratedParticles = 0;
+
+        simulate(config, 300, [&](const std::vector<iParticle> &legacy, const iParticlePool &pool)
+                 {
+                    iParticle particle;
+                    for (uint32 i = 0; i < legacy.size(); ++i)
+                    {
+                        pool.getParticle(i, particle);
+                        if (particle._visible != (legacy[i]._lifeLeft > 0.0f) ||
+                            std::abs(particle._lifeLeft - legacy[i]._lifeLeft) > 0.0001f ||
+                            (particle._position - legacy[i]._position).length() > epsilon ||
+                            std::abs(particle._orientation - legacy[i]._orientation) > 0.0001f ||
+                            std::abs(particle._tilingIndex - legacy[i]._tilingIndex) > 0.0001f ||
+                            (particle._visible && std::abs(particle._sizeScale - legacy[i]._sizeScale) > sizeScaleEpsilon))
+                        {
+                            mismatches++;
+                        }
+                    } },
+                 legacyDuration, poolDuration, iteratedParticles);
+
+        IAUX_EXPECT_GREATER_THEN(iteratedParticles, 0);
+        IAUX_EXPECT_EQUAL(mismatches, 0);
+    }
+}
+
+IAUX_BENCHMARK(ParticlePoolTests, BenchmarkParticlesPerMillisecond)
+{
+    for (const auto &config : createConfigs())
+    {
+        iaTime legacyDuration;
+        iaTime poolDuration;
+        uint64 iteratedParticles = 0;
+
+        simulate(config, benchmarkFrames, [](const std::vector<iParticle> &, const iParticlePool &) {}, legacyDuration, poolDuration, iteratedParticles);
+
+        iaConsole::getInstance() << config._name << " max particles: " << config._maxParticleCount << " frames: " << benchmarkFrames
+                                 << " legacy particles/ms: " << static_cast<uint64>(iteratedParticles / std::max(legacyDuration.getMilliseconds(), 0.001))
+                                 << " pool particles/ms: " << static_cast<uint64>(iteratedParticles / std::max(poolDuration.getMilliseconds(), 0.001)) << endl;
+    }
+}
@@ -0,0 +1,213 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/simulation/iParticleSystem.h>
+#include <igor/simulation/iParticleEmitter.h>
+#include <igor/system/iTimer.h>
+#include <igor/threading/iTaskManager.h>
+#include <igor/physics/iPhysics.h>
+#include <igor/resources/config/iConfigReader.h>
+using namespace igor;
+
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+static const char *particleSystemConfigFilename = "particleSystemUpdateTest.xml";
+static const uint32 particleSystemCount = 32;
+static const uint32 frameCount = 30;
+
+static void startTaskManager(uint32 threadCount)
+{
+    std::ofstream file(particleSystemConfigFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"minThreads\" value=\"" << threadCount << "\" />\n";
+    file << "        <Setting name=\"maxThreads\" value=\"" << threadCount << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(particleSystemConfigFilename);
+    iPhysics::create();
+    iTaskManager::create();
+    iTimer::create();
+}
+
+static void stopTaskManager()
+{
+    iTimer::destroy();
+    iTaskManager::destroy();
+    iPhysics::destroy();
+    iConfigReader::destroy();
+    std::remove(particleSystemConfigFilename);
+}
+
+/*! advances the timer the way a frame of the application would
+ */
+static void nextFrame()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    iTimer::getInstance().start();
+}
+
+/*! sets up a smoke like particle system similar to the particle example
+ */
+static void setup(iParticleSystem &particleSystem, iParticleEmitter &emitter, bool loop)
+{
+    emitter.setType(iEmitterType::Disc);
+    emitter.setSize(2.0f);
+
+    iaKeyFrameGraphf emission;
+    emission.setValue(0.0f, 2000.0f / iParticleSystem::getSimulationRate());
+    particleSystem.setEmissionGradient(emission);
+
+    iaKeyFrameGraphVector2f velocity;
+    velocity.setValue(0.0f, iaVector2f(0.02f, 0.04f));
+    particleSystem.setStartVelocityGradient(velocity);
+
+    iaKeyFrameGraphVector2f lift;
+    lift.setValue(0.0f, iaVector2f(0.0002f, 0.0005f));
+    particleSystem.setStartLiftGradient(lift);
+
+    particleSystem.setMaxParticleCount(5000);
+    particleSystem.setVortexToParticleRate(0.01f);
+    particleSystem.setLoop(loop);
+    particleSystem.setPeriodTime(loop ? 10.0f : 0.2f);
+    particleSystem.start();
+}
+
+IAUX_TEST(ParticleSystemUpdateTests, AsyncUpdate)
+{
+    startTaskManager(2);
+
+    {
+        iParticleSystem particleSystem;
+        iParticleEmitter emitter;
+        setup(particleSystem, emitter, true);
+
+        particleSystem.startUpdate(emitter);
+        // nothing was applied yet so there is nothing to render
+        IAUX_EXPECT_EQUAL(particleSystem.getVisibleParticleCount(), 0);
+
+        for (uint32 i = 0; i < 5; ++i)
+        {
+            nextFrame();
+            particleSystem.waitForUpdate();
+            particleSystem.startUpdate(emitter);
+        }
+
+        particleSystem.waitForUpdate();
+        IAUX_EXPECT_GREATER_THEN(particleSystem.getVisibleParticleCount(), 0);
+        IAUX_EXPECT_GREATER_THEN(particleSystem.getBoundingSphere()._radius, 0.0);
+        IAUX_EXPECT_FALSE(particleSystem.finishUpdate());
+
+        // changing the configuration while an update is in progress waits for it
+        particleSystem.startUpdate(emitter);
+        particleSystem.setAirDrag(0.9f);
+        IAUX_EXPECT_FALSE(particleSystem.finishUpdate());
+    }
+
+    {
+        iParticleSystem particleSystem;
+        iParticleEmitter emitter;
+        setup(particleSystem, emitter, false);
+
+        for (uint32 i = 0; i < 20 && !particleSystem.isFinished(); ++i)
+        {
+            nextFrame();
+            particleSystem.waitForUpdate();
+            particleSystem.startUpdate(emitter);
+        }
+
+        particleSystem.waitForUpdate();
+        IAUX_EXPECT_TRUE(particleSystem.isFinished());
+        IAUX_EXPECT_FALSE(particleSystem.isRunning());
+    }
+
+    // systems that get destroyed while updating
+    {
+        iParticleSystem particleSystem;
+        iParticleEmitter emitter;
+        setup(particleSystem, emitter, true);
+        nextFrame();
+        particleSystem.startUpdate(emitter);
+    }
+
+    stopTaskManager();
+}
+
+IAUX_BENCHMARK(ParticleSystemUpdateTests, BenchmarkMainThreadTime)
+{
+    const uint32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        startTaskManager(threadCount);
+
+        std::vector<std::unique_ptr<iParticleSystem>> particleSystems;
+        std::vector<iParticleEmitter> emitters(particleSystemCount);
+        for (uint32 i = 0; i < particleSystemCount; ++i)
+        {
+            particleSystems.push_back(std::make_unique<iParticleSystem>());
+            setup(*particleSystems.back(), emitters[i], true);
+        }
+
+        // synchronous update like before
+        iaTime syncDuration;
+        uint64 syncParticles = 0;
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            nextFrame();
+
+            const iaTime start = iaTime::getNow();
+            for (uint32 i = 0; i < particleSystemCount; ++i)
+            {
+                particleSystems[i]->onUpdate(emitters[i]);
+            }
+            syncDuration += iaTime::getNow() - start;
+        }
+
+        for (const auto &particleSystem : particleSystems)
+        {
+            syncParticles += particleSystem->getVisibleParticleCount();
+        }
+
+        // asynchronous update. Only what the main thread spends in finishing and starting updates counts
+        iaTime asyncDuration;
+        uint64 asyncParticles = 0;
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            nextFrame();
+
+            const iaTime start = iaTime::getNow();
+            for (uint32 i = 0; i < particleSystemCount; ++i)
+            {
+                particleSystems[i]->finishUpdate();
+                particleSystems[i]->startUpdate(emitters[i]);
+            }
+            asyncDuration += iaTime::getNow() - start;
+        }
+
+        for (const auto &particleSystem : particleSystems)
+        {
+            particleSystem->waitForUpdate();
+            asyncParticles += particleSystem->getVisibleParticleCount();
+        }
+
+        IAUX_EXPECT_GREATER_THEN(syncParticles, 0);
+        IAUX_EXPECT_GREATER_THEN(asyncParticles, 0);
+
+        iaConsole::getInstance() << "threads: " << threadCount << " particle systems: " << particleSystemCount << " frames: " << frameCount
+                                 << " main thread sync: " << syncDuration << " async: " << asyncDuration
+                                 << " particles sync: " << syncParticles << " async: " << asyncParticles << endl;
+
+        particleSystems.clear();
+        stopTaskManager();
+    }
+}
@@ -0,0 +1,183 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/generation/iPerlinNoise.h>
+using namespace igor;
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const iaVector3d noiseOrigin(-13.37, 0.25, 100.5);
+static const iaVector3d noiseStep(0.05, 0.07, 0.03);
+static const iaVector3I noiseSize(37, 9, 5);
+static const int64 noiseOctaves = 3;
+static const iNoiseType noiseTypes[] = {iNoiseType::Perlin, iNoiseType::Simplex, iNoiseType::Value};
+
+static const char *getTypeName(iNoiseType type)
+{
+    switch (type)
+    {
+    case iNoiseType::Simplex:
+        return "simplex";
+    case iNoiseType::Value:
+        return "value";
+    case iNoiseType::Perlin:
+    default:
+        return "perlin";
+    }
+}
+
+static iaVector3d getGridPosition(int64 x, int64 y, int64 z)
+{
+    return iaVector3d(noiseOrigin._x + static_cast<float64>(x) * noiseStep._x,
+                      noiseOrigin._y + static_cast<float64>(y) * noiseStep._y,
+                      noiseOrigin._z + static_cast<float64>(z) * noiseStep._z);
+}
+
+/*! \returns biggest difference between batch and single evaluation of given values
+ */
+template <typename T>
+static float64 compareWithSingle(iPerlinNoise &noise, const std::vector<T> &values, const iaVector3I &size, iNoiseType type)
+{
+    float64 result = 0.0;
+
+    for (int64 z = 0; z < size._z; ++z)
+    {
+        for (int64 y = 0; y < size._y; ++y)
+        {
+            for (int64 x = 0; x < size._x; ++x)
+            {
+                const float64 expected = noise.getValue(getGridPosition(x, y, z), noiseOctaves, 0.5, type);
+                const float64 value = values[(z * size._y + y) * size._x + x];
+                result = std::max(result, std::abs(expected - value));
+            }
+        }
+    }
+
+    return result;
+}
+
+IAUX_TEST(PerlinNoiseTests, OctavesDefaultToPerlin)
+{
+    iPerlinNoise noise;
+    noise.generateBase(42);
+
+    const iaVector3d pos(12.3, -4.5, 6.7);
+    IAUX_EXPECT_EQUAL(noise.getValue(pos, noiseOctaves), noise.getValue(pos, noiseOctaves, 0.5, iNoiseType::Perlin));
+    IAUX_EXPECT_EQUAL(noise.getValue(pos), noise.getValue(pos, iNoiseType::Perlin));
+}
+
+IAUX_TEST(PerlinNoiseTests, BatchSameAsSingle)
+{
+    iPerlinNoise noise;
+    noise.generateBase(42);
+
+    for (const iNoiseType type : noiseTypes)
+    {
+        std::vector<float64> values(noiseSize._x * noiseSize._y * noiseSize._z, -1.0);
+        noise.getValues(values.data(), noiseOrigin, noiseStep, noiseSize, noiseOctaves, 0.5, type);
+
+        IAUX_EXPECT_NEAR(compareWithSingle(noise, values, noiseSize, type), 0.0, 0.000000000001);
+
+        // like the single evaluation perlin and value noise only stay in range for positive coordinates
+        noise.getValues(values.data(), iaVector3d(3.0, 7.0, 11.0), noiseStep * 10.0, noiseSize, noiseOctaves, 0.5, type);
+
+        const auto range = std::minmax_element(values.begin(), values.end());
+        IAUX_EXPECT_TRUE(*range.first >= 0.0);
+        IAUX_EXPECT_TRUE(*range.second <= 1.0);
+        IAUX_EXPECT_TRUE(*range.first < *range.second);
+    }
+}
+
+IAUX_TEST(PerlinNoiseTests, BatchFloat32)
+{
+    iPerlinNoise noise;
+    noise.generateBase(42);
+
+    const iaVector3f origin(noiseOrigin._x, noiseOrigin._y, noiseOrigin._z);
+    const iaVector3f step(noiseStep._x, noiseStep._y, noiseStep._z);
+
+    for (const iNoiseType type : noiseTypes)
+    {
+        std::vector<float32> values(noiseSize._x * noiseSize._y * noiseSize._z, -1.0f);
+        noise.getValues(values.data(), origin, step, noiseSize, noiseOctaves, 0.5, type);
+
+        IAUX_EXPECT_NEAR(compareWithSingle(noise, values, noiseSize, type), 0.0, 0.001);
+    }
+}
+
+IAUX_TEST(PerlinNoiseTests, Batch2D)
+{
+    iPerlinNoise noise;
+    noise.generateBase(42);
+
+    const iaVector3I size(noiseSize._x, 1, noiseSize._z);
+
+    for (const iNoiseType type : noiseTypes)
+    {
+        std::vector<float64> values(size._x * size._z, -1.0);
+        noise.getValues(values.data(), noiseOrigin, noiseStep, size, noiseOctaves, 0.5, type);
+
+        IAUX_EXPECT_NEAR(compareWithSingle(noise, values, size, type), 0.0, 0.000000000001);
+    }
+
+    // nothing to do for an empty grid
+    float64 untouched = -1.0;
+    noise.getValues(&untouched, noiseOrigin, noiseStep, iaVector3I(0, 4, 4));
+    IAUX_EXPECT_EQUAL(untouched, -1.0);
+}
+
+IAUX_BENCHMARK(PerlinNoiseTests, BenchmarkSamplesPerSecond)
+{
+    iPerlinNoise noise;
+    noise.generateBase(1337);
+
+    // one voxel block like the voxel examples generate
+    const iaVector3I size(64, 64, 64);
+    const int64 count = size._x * size._y * size._z;
+    const iaVector3d step(0.05, 0.05, 0.05);
+    const iaVector3f stepf(0.05f, 0.05f, 0.05f);
+
+    auto samplesPerSecond = [count](const iaTime &duration)
+    {
+        return static_cast<uint64>(count / (std::max(duration.getMilliseconds(), 0.001) / 1000.0));
+    };
+
+    std::vector<float64> values(count);
+    std::vector<float32> valuesf(count);
+
+    for (const iNoiseType type : noiseTypes)
+    {
+        iaTime start = iaTime::getNow();
+        for (int64 z = 0; z < size._z; ++z)
+        {
+            for (int64 y = 0; y < size._y; ++y)
+            {
+                for (int64 x = 0; x < size._x; ++x)
+                {
+                    values[(z * size._y + y) * size._x + x] = noise.getValue(iaVector3d(x * step._x, y * step._y, z * step._z), noiseOctaves, 0.5, type);
+                }
+            }
+        }
+        const iaTime scalarDuration = iaTime::getNow() - start;
+        const float64 checksum = values[count / 2];
+
+        start = iaTime::getNow();
+        noise.getValues(values.data(), iaVector3d(), step, size, noiseOctaves, 0.5, type);
+        const iaTime batchDuration = iaTime::getNow() - start;
+
+        start = iaTime::getNow();
+        noise.getValues(valuesf.data(), iaVector3f(), stepf, size, noiseOctaves, 0.5, type);
+        const iaTime batchFloat32Duration = iaTime::getNow() - start;
+
+        IAUX_EXPECT_NEAR(values[count / 2], checksum, 0.000000000001);
+        IAUX_EXPECT_NEAR(valuesf[count / 2], checksum, 0.001);
+
+        iaConsole::getInstance() << getTypeName(type) << " samples: " << count << " octaves: " << noiseOctaves
+                                 << " scalar samples/sec: " << samplesPerSecond(scalarDuration)
+                                 << " batch: " << samplesPerSecond(batchDuration)
+                                 << " batch float32: " << samplesPerSecond(batchFloat32Duration) << endl;
+    }
+}
@@ -0,0 +1,292 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/system/iaFile.h>
+
+#include <igor/physics/iPhysics.h>
+#include <igor/physics/iPhysicsCollision.h>
+#include <igor/physics/iPhysicsCollisionCache.h>
+#include <igor/resources/config/iConfigReader.h>
+#include <igor/resources/mesh/iMesh.h>
+using namespace igor;
+
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <vector>
+
+static const char *collisionCacheConfigFilename = "collisionCacheTest.xml";
+static const char *collisionCacheDirectory = "collisionCacheTest";
+
+/*! creates a height field like terrain mesh with size * size quads
+ */
+static iMeshPtr createGridMesh(uint32 size, float32 height)
+{
+    std::vector<float32> vertices;
+    for (uint32 z = 0; z <= size; ++z)
+    {
+        for (uint32 x = 0; x <= size; ++x)
+        {
+            vertices.push_back(static_cast<float32>(x));
+            vertices.push_back(((x + z) % 3) * height);
+            vertices.push_back(static_cast<float32>(z));
+        }
+    }
+
+    std::vector<uint32> indices;
+    for (uint32 z = 0; z < size; ++z)
+    {
+        for (uint32 x = 0; x < size; ++x)
+        {
+            const uint32 index = z * (size + 1) + x;
+            indices.insert(indices.end(), {index, index + size + 1, index + 1});
+            indices.insert(indices.end(), {index + 1, index + size + 1, index + size + 2});
+        }
+    }
+
+    iBufferLayout layout;
+    layout.addElement({iShaderDataType::Float3});
+
+    iMeshPtr mesh = iMesh::create();
+    mesh->setData(indices.data(), static_cast<uint32>(indices.size() * sizeof(uint32)),
+                  vertices.data(), static_cast<uint32>(vertices.size() * sizeof(float32)), layout, true);
+    return mesh;
+}
+
+/*! creates a mesh of one triangle per three vertices
+ */
+static iMeshPtr createTriangleMesh(const std::vector<float32> &vertices)
+{
+    std::vector<uint32> indices;
+    for (uint32 i = 0; i < vertices.size() / 3; ++i)
+    {
+        indices.push_back(i);
+    }
+
+    iBufferLayout layout;
+    layout.addElement({iShaderDataType::Float3});
+
+    iMeshPtr mesh = iMesh::create();
+    mesh->setData(indices.data(), static_cast<uint32>(indices.size() * sizeof(uint32)),
+                  vertices.data(), static_cast<uint32>(vertices.size() * sizeof(float32)), layout, true);
+    return mesh;
+}
+
+/*! \returns key with given hash
+ */
+static iPhysicsCollisionCacheKey makeKey(uint64 hash)
+{
+    iPhysicsCollisionCacheKey key;
+    key._hash = hash;
+    key._hash2 = hash;
+    return key;
+}
+
+static void removeCacheFile(const iPhysicsCollisionCache &cache, const iPhysicsCollisionCacheKey &key)
+{
+    iaFile::remove(cache.getFilename(key));
+}
+
+IAUX_TEST(PhysicsCollisionCacheTests, MeshKey)
+{
+    iMeshPtr mesh = createGridMesh(4, 0.5f);
+    const iPhysicsCollisionCacheKey key = iPhysicsCollisionCache::calcKey(mesh, 0);
+
+    IAUX_EXPECT_TRUE(key == iPhysicsCollisionCache::calcKey(mesh, 0));
+    IAUX_EXPECT_TRUE(key == iPhysicsCollisionCache::calcKey(createGridMesh(4, 0.5f), 0));
+    IAUX_EXPECT_NOT_EQUAL(key._hash, key._hash2);
+
+    // anything the collision gets build from changes the hashes
+    const iPhysicsCollisionCacheKey otherKeys[] = {iPhysicsCollisionCache::calcKey(mesh, 1),
+                                                   iPhysicsCollisionCache::calcKey(createGridMesh(4, 0.25f), 0),
+                                                   iPhysicsCollisionCache::calcKey(createGridMesh(5, 0.5f), 0)};
+    for (const auto &otherKey : otherKeys)
+    {
+        IAUX_EXPECT_NOT_EQUAL(key._hash, otherKey._hash);
+        IAUX_EXPECT_NOT_EQUAL(key._hash2, otherKey._hash2);
+    }
+}
+
+IAUX_TEST(PhysicsCollisionCacheTests, MeshKeySignFlips)
+{
+    // flipping the sign of two floats flips the highest bit of two 64 bit words
+    const iPhysicsCollisionCacheKey key = iPhysicsCollisionCache::calcKey(createTriangleMesh({1, 2, 3, 4, 5, 6, 7, 8, 9}), 0);
+    const iPhysicsCollisionCacheKey flippedKey = iPhysicsCollisionCache::calcKey(createTriangleMesh({1, -2, 3, -4, 5, 6, 7, 8, 9}), 0);
+
+    IAUX_EXPECT_NOT_EQUAL(key._hash, flippedKey._hash);
+    IAUX_EXPECT_NOT_EQUAL(key._hash2, flippedKey._hash2);
+}
+
+IAUX_TEST(PhysicsCollisionCacheTests, DirectoryRoundTrip)
+{
+    iPhysicsCollisionCache cache;
+    const iPhysicsCollisionCacheKey key = iPhysicsCollisionCache::calcKey(createGridMesh(4, 0.5f), 0);
+    const std::vector<uint8> data = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<uint8> result;
+
+    // without directory nothing gets stored
+    IAUX_EXPECT_FALSE(cache.write(key, data));
+    IAUX_EXPECT_FALSE(cache.read(key, result));
+
+    cache.setDirectory(collisionCacheDirectory);
+    removeCacheFile(cache, key);
+
+    IAUX_EXPECT_FALSE(cache.read(key, result));
+    IAUX_EXPECT_TRUE(cache.write(key, data));
+    IAUX_EXPECT_TRUE(cache.read(key, result));
+    IAUX_EXPECT_TRUE(result == data);
+
+    IAUX_EXPECT_EQUAL(cache.getDirectoryHits(), 1);
+    IAUX_EXPECT_EQUAL(cache.getMisses(), 2);
+
+    // a file with the same hash but different second hash or sizes is not accepted
+    iPhysicsCollisionCacheKey sameHashKey = key;
+    sameHashKey._hash2++;
+    IAUX_EXPECT_FALSE(cache.read(sameHashKey, result));
+
+    sameHashKey = key;
+    sameHashKey._vertexDataSize++;
+    IAUX_EXPECT_FALSE(cache.read(sameHashKey, result));
+
+    // neither is a file of a different hash
+    iPhysicsCollisionCacheKey otherKey = key;
+    otherKey._hash++;
+    iaFile(cache.getFilename(key)).rename(cache.getFilename(otherKey), true);
+    IAUX_EXPECT_FALSE(cache.read(otherKey, result));
+
+    // nor a truncated one
+    char filename[1024];
+    cache.getFilename(key).getData(filename, 1024);
+    std::ofstream file(filename, std::ios::binary);
+    file.write("IGCC", 4);
+    file.close();
+    IAUX_EXPECT_FALSE(cache.read(key, result));
+
+    removeCacheFile(cache, key);
+    removeCacheFile(cache, otherKey);
+    std::filesystem::remove_all(collisionCacheDirectory);
+}
+
+IAUX_TEST(PhysicsCollisionCacheTests, LeastRecentlyUsed)
+{
+    iPhysicsCollisionCache cache;
+    cache.setMaxShapeCount(2);
+
+    int a = 0;
+    int b = 0;
+    int c = 0;
+
+    IAUX_EXPECT_TRUE(cache.addShape(makeKey(1), 0, &a));
+    IAUX_EXPECT_TRUE(cache.addShape(makeKey(2), 0, &b));
+    IAUX_EXPECT_FALSE(cache.addShape(makeKey(2), 0, &c));
+    IAUX_EXPECT_EQUAL(cache.evictShape(), nullptr);
+
+    // using the first one makes the second one the least recently used
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(1), 0), &a);
+    IAUX_EXPECT_TRUE(cache.addShape(makeKey(3), 0, &c));
+    IAUX_EXPECT_EQUAL(cache.getShapeCount(), 3);
+    IAUX_EXPECT_EQUAL(cache.evictShape(), &b);
+    IAUX_EXPECT_EQUAL(cache.evictShape(), nullptr);
+
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(2), 0), nullptr);
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(3), 0), &c);
+    IAUX_EXPECT_EQUAL(cache.getMemoryHits(), 2);
+
+    cache.setMaxShapeCount(0);
+    IAUX_EXPECT_EQUAL(cache.evictShape(), &a);
+    IAUX_EXPECT_EQUAL(cache.evictShape(), &c);
+    IAUX_EXPECT_EQUAL(cache.getShapeCount(), 0);
+}
+
+IAUX_TEST(PhysicsCollisionCacheTests, ShapesPerWorld)
+{
+    iPhysicsCollisionCache cache;
+
+    int a = 0;
+    int b = 0;
+    int c = 0;
+
+    // same content in different worlds needs different shapes
+    IAUX_EXPECT_TRUE(cache.addShape(makeKey(1), 1, &a));
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(1), 2), nullptr);
+    IAUX_EXPECT_TRUE(cache.addShape(makeKey(1), 2, &b));
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(1), 1), &a);
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(1), 2), &b);
+
+    // same hash but different content is a different shape
+    iPhysicsCollisionCacheKey sameHashKey = makeKey(1);
+    sameHashKey._hash2++;
+    IAUX_EXPECT_EQUAL(cache.getShape(sameHashKey, 1), nullptr);
+    IAUX_EXPECT_TRUE(cache.addShape(sameHashKey, 1, &c));
+
+    // destroying a world evicts all its shapes
+    IAUX_EXPECT_EQUAL(cache.evictShape(1), &c);
+    IAUX_EXPECT_EQUAL(cache.evictShape(1), &a);
+    IAUX_EXPECT_EQUAL(cache.evictShape(1), nullptr);
+    IAUX_EXPECT_EQUAL(cache.getShapeCount(), 1);
+    IAUX_EXPECT_EQUAL(cache.getShape(makeKey(1), 2), &b);
+}
+
+IAUX_BENCHMARK(PhysicsCollisionCacheTests, BenchmarkColdVsWarm)
+{
+    const uint32 meshCount = 8;
+    const uint32 meshSize = 64;
+
+    std::ofstream file(collisionCacheConfigFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"collisionCache\" value=\"" << collisionCacheDirectory << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(collisionCacheConfigFilename);
+    iPhysics::create();
+
+    iPhysics &physics = iPhysics::getInstance();
+    const iPhysicsCollisionCache &cache = physics.getCollisionCache();
+    IAUX_EXPECT_EQUAL(physics.getCollisionCacheDirectory(), iaString(collisionCacheDirectory));
+
+    std::vector<iMeshPtr> meshes;
+    for (uint32 i = 0; i < meshCount; ++i)
+    {
+        meshes.push_back(createGridMesh(meshSize, 0.5f + i));
+        removeCacheFile(cache, iPhysicsCollisionCache::calcKey(meshes.back(), 0));
+    }
+
+    auto load = [&]()
+    {
+        const iaTime start = iaTime::getNow();
+        for (auto &mesh : meshes)
+        {
+            physics.destroyCollision(physics.createMesh(mesh, 0, iaMatrixd()));
+        }
+        return iaTime::getNow() - start;
+    };
+
+    // cold: build every shape from scratch and serialize it
+    const iaTime coldDuration = load();
+    IAUX_EXPECT_EQUAL(cache.getMisses(), meshCount);
+
+    // warm: shapes are shared from memory
+    const iaTime memoryDuration = load();
+    IAUX_EXPECT_EQUAL(cache.getMemoryHits(), meshCount);
+
+    // warm: shapes come from the cache directory like after a restart
+    physics.setCollisionCacheSize(0);
+    physics.setCollisionCacheSize(meshCount);
+    const iaTime directoryDuration = load();
+    IAUX_EXPECT_EQUAL(cache.getDirectoryHits(), meshCount);
+    IAUX_EXPECT_EQUAL(cache.getMisses(), meshCount);
+
+    iaConsole::getInstance() << "meshes: " << meshCount << " triangles: " << meshSize * meshSize * 2
+                             << " cold: " << coldDuration << " warm from directory: " << directoryDuration << " warm from memory: " << memoryDuration << endl;
+
+    iPhysics::destroy();
+    iConfigReader::destroy();
+
+    std::filesystem::remove_all(collisionCacheDirectory);
+    std::remove(collisionCacheConfigFilename);
+}
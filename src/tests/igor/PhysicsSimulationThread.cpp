@@ -0,0 +1,289 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/physics/iPhysicsStateBuffer.h>
+#include <igor/threading/iFixedStepThread.h>
+using namespace igor;
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static const float64 simulationRate = 120.0;
+static const float64 bodySpeed = 10.0;
+static const uint32 frameCount = 60;
+static const iaTime startTime = iaTime::getNow();
+
+/*! frame times of a 60Hz application with a hitch every 10 frames
+ */
+static iaTime getFrameTime(uint32 frame)
+{
+    return iaTime::fromMilliseconds(frame % 10 == 9 ? 100.0 : 16.0);
+}
+
+/*! pretends to do the work of a simulation step
+ */
+static void simulate()
+{
+    const iaTime end = iaTime::getNow() + iaTime::fromMilliseconds(1.0);
+    while (iaTime::getNow() < end)
+    {
+    }
+}
+
+/*! timing of the steps
+ */
+struct StepStatistics
+{
+    uint64 _steps = 0;
+    float64 _meanInterval = 0.0;
+    float64 _intervalDeviation = 0.0;
+    float64 _maxInterval = 0.0;
+};
+
+static StepStatistics calcStatistics(const std::vector<iaTime> &stepTimes)
+{
+    StepStatistics result;
+    result._steps = stepTimes.size();
+
+    if (stepTimes.size() < 2)
+    {
+        return result;
+    }
+
+    std::vector<float64> intervals;
+    for (size_t i = 1; i < stepTimes.size(); ++i)
+    {
+        intervals.push_back((stepTimes[i] - stepTimes[i - 1]).getMilliseconds());
+    }
+
+    for (const float64 interval : intervals)
+    {
+        result._meanInterval += interval;
+        result._maxInterval = std::max(result._maxInterval, interval);
+    }
+    result._meanInterval /= static_cast<float64>(intervals.size());
+
+    for (const float64 interval : intervals)
+    {
+        result._intervalDeviation += (interval - result._meanInterval) * (interval - result._meanInterval);
+    }
+    result._intervalDeviation = std::sqrt(result._intervalDeviation / static_cast<float64>(intervals.size()));
+
+    return result;
+}
+
+/*! a body moving along the x axis with constant speed
+ */
+static void writeState(iPhysicsState &state, const iaTime &time, uint64 step)
+{
+    state._time = time;
+    state._step = step;
+
+    iaMatrixd matrix;
+    matrix._pos.set((time - startTime).getSeconds() * bodySpeed, 0.0, 0.0);
+    state._bodies.push_back({7, matrix});
+    state._bodies.push_back({3, iaMatrixd()});
+}
+
+/*! stands in for the physics simulation stepped by the simulation thread
+ */
+class Simulation
+{
+public:
+    iPhysicsStateBuffer _buffer;
+    std::vector<iaTime> _stepTimes;
+    uint64 _step = 0;
+
+    void onStep(const iaTime &time, const iaTime &timeDelta)
+    {
+        simulate();
+        _stepTimes.push_back(iaTime::getNow());
+        writeState(_buffer.getBackState(), time + timeDelta, ++_step);
+        _buffer.publish();
+    }
+};
+
+IAUX_TEST(PhysicsSimulationThreadTests, StateBufferHandOver)
+{
+    iPhysicsStateBuffer buffer;
+    IAUX_EXPECT_FALSE(buffer.fetch());
+
+    writeState(buffer.getBackState(), iaTime::fromMilliseconds(10.0), 1);
+    buffer.publish();
+    IAUX_EXPECT_TRUE(buffer.getBackState()._bodies.empty());
+
+    IAUX_EXPECT_TRUE(buffer.fetch());
+    IAUX_EXPECT_FALSE(buffer.fetch());
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._step, 1);
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._bodies.size(), 2);
+
+    // published states are sorted by body id
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._bodies[0]._bodyID, 3);
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._bodies[1]._bodyID, 7);
+
+    // states the reader did not fetch in time get replaced by newer ones
+    writeState(buffer.getBackState(), iaTime::fromMilliseconds(20.0), 2);
+    buffer.publish();
+    writeState(buffer.getBackState(), iaTime::fromMilliseconds(30.0), 3);
+    buffer.publish();
+
+    IAUX_EXPECT_TRUE(buffer.fetch());
+    IAUX_EXPECT_EQUAL(buffer.getPreviousState()._step, 1);
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._step, 3);
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._bodies.size(), 2);
+
+    IAUX_EXPECT_NEAR(buffer.getInterpolation(iaTime::fromMilliseconds(5.0)), 0.0, 0.000001);
+    IAUX_EXPECT_NEAR(buffer.getInterpolation(iaTime::fromMilliseconds(15.0)), 0.25, 0.000001);
+    IAUX_EXPECT_NEAR(buffer.getInterpolation(iaTime::fromMilliseconds(50.0)), 1.0, 0.000001);
+
+    // bodies that only moved in a state the reader did not fetch are still in the newer state
+    iaMatrixd matrix;
+    matrix._pos.set(1.0, 0.0, 0.0);
+    buffer.getBackState()._bodies.push_back({5, matrix});
+    buffer.getBackState()._bodies.push_back({7, matrix});
+    buffer.publish();
+
+    matrix._pos.set(2.0, 0.0, 0.0);
+    buffer.getBackState()._bodies.push_back({7, matrix});
+    buffer.getBackState()._step = 5;
+    buffer.publish();
+
+    IAUX_EXPECT_TRUE(buffer.fetch());
+    const iPhysicsState &merged = buffer.getCurrentState();
+    IAUX_EXPECT_EQUAL(merged._step, 5);
+    IAUX_EXPECT_EQUAL(merged._bodies.size(), 2);
+    IAUX_EXPECT_EQUAL(merged._bodies[0]._bodyID, 5);
+    IAUX_EXPECT_NEAR(merged._bodies[0]._matrix._pos._x, 1.0, 0.000001);
+    IAUX_EXPECT_EQUAL(merged._bodies[1]._bodyID, 7);
+    IAUX_EXPECT_NEAR(merged._bodies[1]._matrix._pos._x, 2.0, 0.000001);
+
+    // once fetched nothing gets carried over
+    buffer.getBackState()._bodies.push_back({3, matrix});
+    buffer.publish();
+    IAUX_EXPECT_TRUE(buffer.fetch());
+    IAUX_EXPECT_EQUAL(buffer.getCurrentState()._bodies.size(), 1);
+}
+
+IAUX_TEST(PhysicsSimulationThreadTests, FixedStepThread)
+{
+    Simulation simulation;
+    iFixedStepThread thread(iFixedStepDelegate(&simulation, &Simulation::onStep), simulationRate);
+    IAUX_EXPECT_FALSE(thread.isRunning());
+    thread.start();
+    IAUX_EXPECT_TRUE(thread.isRunning());
+    IAUX_EXPECT_EQUAL(thread.getTimeDelta().getMicroseconds(), iaTime::fromSeconds(1.0 / simulationRate).getMicroseconds());
+
+    uint64 lastStep = 0;
+    for (uint32 frame = 0; frame < 5; ++frame)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        simulation._buffer.fetch();
+        IAUX_EXPECT_TRUE(simulation._buffer.getCurrentState()._step >= lastStep);
+        lastStep = simulation._buffer.getCurrentState()._step;
+    }
+
+    thread.stop();
+    IAUX_EXPECT_FALSE(thread.isRunning());
+    IAUX_EXPECT_GREATER_THEN(lastStep, 0);
+    IAUX_EXPECT_EQUAL(thread.getStepCount(), simulation._stepTimes.size());
+}
+
+IAUX_BENCHMARK(PhysicsSimulationThreadTests, BenchmarkStepStability)
+{
+    const iaTime timeDelta = iaTime::fromSeconds(1.0 / simulationRate);
+
+    // stepping on the main thread the way iPhysics::handle does it by default
+    std::vector<iaTime> mainThreadSteps;
+    iaTime lastTime = iaTime::getNow();
+    iaTime mainThreadDuration;
+
+    for (uint32 frame = 0; frame < frameCount; ++frame)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(getFrameTime(frame).getMicroseconds()));
+
+        const iaTime start = iaTime::getNow();
+        uint32 updateCount = 0;
+        while (lastTime + timeDelta < start &&
+               updateCount < 3)
+        {
+            simulate();
+            mainThreadSteps.push_back(iaTime::getNow());
+            lastTime += timeDelta;
+            updateCount++;
+        }
+        mainThreadDuration += iaTime::getNow() - start;
+    }
+
+    // stepping on a dedicated thread and interpolating between the last two states every frame
+    Simulation simulation;
+    iPhysicsStateBuffer &buffer = simulation._buffer;
+
+    iFixedStepThread thread(iFixedStepDelegate(&simulation, &Simulation::onStep), simulationRate);
+    IAUX_EXPECT_FALSE(thread.isRunning());
+    thread.start();
+    IAUX_EXPECT_TRUE(thread.isRunning());
+    IAUX_EXPECT_EQUAL(thread.getTimeDelta().getMicroseconds(), timeDelta.getMicroseconds());
+
+    const iaTime threadStart = iaTime::getNow();
+    iaTime threadDuration;
+    float64 lastPosition = -1.0;
+    float64 maxPositionError = 0.0;
+    uint32 backwards = 0;
+    uint64 lastStep = 0;
+
+    for (uint32 frame = 0; frame < frameCount; ++frame)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(getFrameTime(frame).getMicroseconds()));
+
+        const iaTime start = iaTime::getNow();
+        buffer.fetch();
+
+        const iPhysicsState &previous = buffer.getPreviousState();
+        const iPhysicsState &current = buffer.getCurrentState();
+        IAUX_EXPECT_TRUE(current._step >= lastStep);
+        lastStep = current._step;
+
+        if (current._bodies.empty() || previous._bodies.empty())
+        {
+            continue;
+        }
+
+        const iaTime renderTime = start - timeDelta;
+        const float64 t = buffer.getInterpolation(renderTime);
+        const float64 position = previous._bodies[1]._matrix._pos._x + (current._bodies[1]._matrix._pos._x - previous._bodies[1]._matrix._pos._x) * t;
+        threadDuration += iaTime::getNow() - start;
+
+        if (position < lastPosition)
+        {
+            backwards++;
+        }
+        lastPosition = position;
+
+        if (renderTime >= previous._time && renderTime <= current._time)
+        {
+            maxPositionError = std::max(maxPositionError, std::abs(position - (renderTime - startTime).getSeconds() * bodySpeed));
+        }
+    }
+
+    const iaTime threadElapsed = iaTime::getNow() - threadStart;
+    thread.stop();
+    IAUX_EXPECT_FALSE(thread.isRunning());
+
+    const StepStatistics mainThreadStatistics = calcStatistics(mainThreadSteps);
+    const StepStatistics threadStatistics = calcStatistics(simulation._stepTimes);
+
+    IAUX_EXPECT_EQUAL(thread.getStepCount(), simulation._stepTimes.size());
+    IAUX_EXPECT_GREATER_THEN(simulation._stepTimes.size(), threadElapsed.getSeconds() * simulationRate * 0.5);
+    IAUX_EXPECT_EQUAL(backwards, 0);
+    IAUX_EXPECT_NEAR(maxPositionError, 0.0, 0.000001);
+
+    iaConsole::getInstance() << "rate: " << simulationRate << "Hz frames: " << frameCount
+                             << " main thread steps: " << mainThreadStatistics._steps << " interval: " << mainThreadStatistics._meanInterval << "ms +/- " << mainThreadStatistics._intervalDeviation << "ms max: " << mainThreadStatistics._maxInterval << "ms"
+                             << " main thread time: " << mainThreadDuration << endl;
+    iaConsole::getInstance() << "rate: " << simulationRate << "Hz frames: " << frameCount
+                             << " thread steps: " << threadStatistics._steps << " interval: " << threadStatistics._meanInterval << "ms +/- " << threadStatistics._intervalDeviation << "ms max: " << threadStatistics._maxInterval << "ms"
+                             << " dropped: " << thread.getDroppedStepCount() << " main thread time: " << threadDuration << endl;
+}
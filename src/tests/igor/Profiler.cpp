@@ -0,0 +1,154 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/resources/profiler/iProfiler.h>
+using namespace igor;
+
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+
+static const char *traceFilename = "profilerTest.json";
+static const uint32 benchmarkSectionCount = 1000000;
+
+IAUX_TEST(ProfilerTests, CompileTimeSectionIDs)
+{
+    constexpr iProfilerSectionID id = IGOR_PROFILER_SECTION_ID(render);
+
+    IAUX_EXPECT_EQUAL(id, iProfiler::calcSectionID("render"));
+    IAUX_EXPECT_NOT_EQUAL(id, iProfiler::calcSectionID("physics"));
+}
+
+IAUX_TEST(ProfilerTests, NestedSectionsMerged)
+{
+    iProfiler::nextFrame();
+
+    IGOR_PROFILER_BEGIN(testOuter);
+    {
+        IGOR_PROFILER_SCOPED(testInner);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    IGOR_PROFILER_END(testOuter);
+
+    const int32 frame = iProfiler::getCurrentFrameIndex();
+    iProfiler::nextFrame();
+
+    iProfilerSectionDataPtr outer = iProfiler::getSectionData(IGOR_PROFILER_SECTION_ID(testOuter));
+    iProfilerSectionDataPtr inner = iProfiler::getSectionData(IGOR_PROFILER_SECTION_ID(testInner));
+
+    IAUX_EXPECT_TRUE(outer != nullptr);
+    IAUX_EXPECT_TRUE(inner != nullptr);
+    IAUX_EXPECT_TRUE(outer->_name == "testOuter");
+    IAUX_EXPECT_EQUAL(outer->_depth, 0);
+    IAUX_EXPECT_EQUAL(inner->_depth, 1);
+    IAUX_EXPECT_GREATER_THEN(inner->_values[frame].getMicroseconds(), 1000);
+    IAUX_EXPECT_TRUE(outer->_values[frame] >= inner->_values[frame]);
+
+    // the next frame starts empty
+    IAUX_EXPECT_EQUAL(outer->_values[iProfiler::getCurrentFrameIndex()].getMicroseconds(), 0);
+}
+
+IAUX_TEST(ProfilerTests, WorkerThreadsAndTraceExport)
+{
+    iProfiler::nextFrame();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([]()
+                             {
+                                 for (int j = 0; j < 100; ++j)
+                                 {
+                                     IGOR_PROFILER_SCOPED(testWorker);
+                                 } });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    iProfiler::nextFrame();
+
+    iProfilerSectionDataPtr worker = iProfiler::getSectionData(IGOR_PROFILER_SECTION_ID(testWorker));
+    IAUX_EXPECT_TRUE(worker != nullptr);
+    IAUX_EXPECT_NOT_EQUAL(worker->_threadIndex, iProfiler::getFrameThreadIndex());
+    IAUX_EXPECT_EQUAL(iProfiler::getDroppedEventCount(), 0);
+
+    IAUX_EXPECT_TRUE(iProfiler::exportChromeTrace(traceFilename));
+
+    std::ifstream file(traceFilename);
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    std::remove(traceFilename);
+
+    const std::string json = content.str();
+    uint32 workerEvents = 0;
+    for (size_t pos = json.find("\"testWorker\""); pos != std::string::npos; pos = json.find("\"testWorker\"", pos + 1))
+    {
+        workerEvents++;
+    }
+
+    IAUX_EXPECT_EQUAL(json.find("{\"traceEvents\":["), 0);
+    IAUX_EXPECT_EQUAL(workerEvents, 400);
+}
+
+/*! mimics how the profiler used to look up sections by name
+ */
+struct LegacySection
+{
+    iaTime _value;
+    iaTime _beginTime;
+};
+
+static std::unordered_map<int64, LegacySection> legacySections;
+
+static void legacyBegin(const iaString &sectionName)
+{
+    LegacySection &section = legacySections[sectionName.getHashValue()];
+    section._beginTime = iaTime::getNow();
+}
+
+static void legacyEnd(const iaString &sectionName)
+{
+    const iaTime now = iaTime::getNow();
+    LegacySection &section = legacySections[sectionName.getHashValue()];
+    section._value += now - section._beginTime;
+}
+
+IAUX_BENCHMARK(ProfilerTests, BenchmarkSectionOverhead)
+{
+    iaTime start = iaTime::getNow();
+    for (uint32 i = 0; i < benchmarkSectionCount; ++i)
+    {
+        legacyBegin("benchmark");
+        legacyEnd("benchmark");
+    }
+    const iaTime legacyDuration = iaTime::getNow() - start;
+
+    iProfiler::nextFrame();
+
+    start = iaTime::getNow();
+    for (uint32 i = 0; i < benchmarkSectionCount; ++i)
+    {
+        IGOR_PROFILER_BEGIN(benchmark);
+        IGOR_PROFILER_END(benchmark);
+
+        // merge like a frame would do so the buffer does not overflow
+        if (i % 1000 == 999)
+        {
+            iProfiler::nextFrame();
+        }
+    }
+    const iaTime profilerDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(iProfiler::getDroppedEventCount(), 0);
+
+    iaConsole::getInstance() << "sections: " << benchmarkSectionCount
+                             << " name lookup: " << legacyDuration.getMicroseconds() * 1000 / benchmarkSectionCount << "ns/section"
+                             << " ring buffer incl. merge: " << profilerDuration.getMicroseconds() * 1000 / benchmarkSectionCount << "ns/section" << endl;
+}
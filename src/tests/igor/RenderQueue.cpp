@@ -0,0 +1,302 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/renderer/iRenderQueue.h>
+using namespace igor;
+
+#include <algorithm>
+
+IAUX_TEST(RenderQueueTests, SortKeyOrder)
+{
+    iRenderSortKeyGenerator generator;
+    int materialA = 0;
+    int materialB = 0;
+    int mesh = 0;
+
+    const iRenderSortKey late = generator.makeKey(300, &materialA, &mesh, nullptr);
+    const iRenderSortKey early = generator.makeKey(100, &materialB, &mesh, nullptr);
+    const iRenderSortKey materialAKey = generator.makeKey(200, &materialA, nullptr, nullptr);
+    const iRenderSortKey materialBKey = generator.makeKey(200, &materialB, nullptr, nullptr);
+
+    IAUX_EXPECT_LESS_THEN(early, late);
+    IAUX_EXPECT_LESS_THEN(materialAKey, materialBKey);
+    IAUX_EXPECT_LESS_THEN(materialBKey, late);
+    IAUX_EXPECT_EQUAL(generator.makeKey(200, &materialA, nullptr, nullptr), materialAKey);
+}
+
+IAUX_TEST(RenderQueueTests, IncrementalUpdate)
+{
+    iRenderQueue<int> queue;
+
+    queue.beginFrame();
+    queue.submit(1, 30, nullptr, nullptr, nullptr);
+    queue.submit(2, 10, nullptr, nullptr, nullptr);
+    queue.submit(3, 20, nullptr, nullptr, nullptr);
+    queue.submit(2, 10, nullptr, nullptr, nullptr);
+    queue.endFrame();
+
+    IAUX_EXPECT_EQUAL(queue.size(), 3);
+    IAUX_EXPECT_EQUAL(queue.getItem(0), 2);
+    IAUX_EXPECT_EQUAL(queue.getItem(1), 3);
+    IAUX_EXPECT_EQUAL(queue.getItem(2), 1);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 1);
+
+    // 3 becomes invisible, 4 becomes visible
+    queue.beginFrame();
+    queue.submit(1, 30, nullptr, nullptr, nullptr);
+    queue.submit(2, 10, nullptr, nullptr, nullptr);
+    queue.submit(4, 15, nullptr, nullptr, nullptr);
+    queue.endFrame();
+
+    IAUX_EXPECT_EQUAL(queue.size(), 3);
+    IAUX_EXPECT_EQUAL(queue.getItem(0), 2);
+    IAUX_EXPECT_EQUAL(queue.getItem(1), 4);
+    IAUX_EXPECT_EQUAL(queue.getItem(2), 1);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 2);
+
+    // key of 1 changes
+    queue.beginFrame();
+    queue.submit(1, 5, nullptr, nullptr, nullptr);
+    queue.submit(2, 10, nullptr, nullptr, nullptr);
+    queue.submit(4, 15, nullptr, nullptr, nullptr);
+    queue.endFrame();
+
+    IAUX_EXPECT_EQUAL(queue.getItem(0), 1);
+    IAUX_EXPECT_EQUAL(queue.getItem(1), 2);
+    IAUX_EXPECT_EQUAL(queue.getItem(2), 4);
+    IAUX_EXPECT_LESS_THEN(queue.getKey(0), queue.getKey(1));
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 3);
+
+    queue.beginFrame();
+    queue.endFrame();
+    IAUX_EXPECT_EQUAL(queue.size(), 0);
+}
+
+IAUX_TEST(RenderQueueTests, MergeOrSortAll)
+{
+    iRenderQueue<int> queue;
+
+    auto submitAll = [&](int count, int changedItem, int changedOrder)
+    {
+        queue.beginFrame();
+        for (int i = 0; i < count; ++i)
+        {
+            queue.submit(i, i == changedItem ? changedOrder : i + 1, nullptr, nullptr, nullptr);
+        }
+        queue.endFrame();
+
+        for (uint32 i = 1; i < queue.size(); ++i)
+        {
+            IAUX_EXPECT_TRUE(queue.getKey(i - 1) <= queue.getKey(i));
+        }
+    };
+
+    submitAll(100, -1, 0);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 1);
+
+    // a few new items and changed keys get merged in
+    submitAll(101, 50, 0);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 1);
+    IAUX_EXPECT_EQUAL(queue.getItem(0), 50);
+    IAUX_EXPECT_EQUAL(queue.getItem(100), 100);
+
+    submitAll(101, -1, 0);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 1);
+    IAUX_EXPECT_EQUAL(queue.getItem(50), 50);
+
+    // many new items lead to sorting everything
+    submitAll(200, -1, 0);
+    IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 2);
+    IAUX_EXPECT_EQUAL(queue.size(), 200);
+    IAUX_EXPECT_EQUAL(queue.getItem(199), 199);
+}
+
+IAUX_TEST(RenderQueueTests, ReleaseIDs)
+{
+    iRenderQueue<int> queue;
+    std::vector<int> meshes(1000);
+
+    // every frame the meshes get replaced like voxel terrain does it
+    for (uint32 frame = 0; frame < 100; ++frame)
+    {
+        queue.beginFrame();
+        for (int i = 0; i < 10; ++i)
+        {
+            queue.submit(i, 10, nullptr, &meshes[(frame * 10 + i) % meshes.size()], nullptr);
+        }
+        queue.endFrame();
+    }
+
+    IAUX_EXPECT_EQUAL(queue.size(), 10);
+    IAUX_EXPECT_EQUAL(queue.getKeyGenerator().getIDCount(), 10);
+
+    // freed ids get reused so they stay small
+    for (uint32 i = 0; i < queue.size(); ++i)
+    {
+        const uint64 meshID = (queue.getKey(i) >> 20) & 0xfffff;
+        IAUX_EXPECT_LESS_THEN(meshID, 21);
+    }
+
+    queue.beginFrame();
+    queue.endFrame();
+    IAUX_EXPECT_EQUAL(queue.getKeyGenerator().getIDCount(), 0);
+}
+
+struct BenchmarkNode
+{
+    uint32 _order;
+    uint32 _material;
+    uint32 _mesh;
+    uint32 _texture;
+};
+
+/*! mimics how iRenderEngine used to rebuild its material groups every frame
+ */
+struct LegacyMaterialGroup
+{
+    uint32 _material;
+    uint32 _order;
+    std::vector<const BenchmarkNode *> _renderNodes;
+    std::unordered_map<uint32, uint32> _instancing;
+};
+
+static bool isVisible(uint32 index, uint32 frame, uint32 count)
+{
+    // a band of 10% of the nodes is not visible and moves a bit every frame
+    const uint32 bandStart = (frame * count / 100) % count;
+    const uint32 offset = (index + count - bandStart) % count;
+    return offset >= count / 10;
+}
+
+IAUX_BENCHMARK(RenderQueueTests, BenchmarkQueueBuild)
+{
+    static const uint32 frames = 10;
+    const uint32 nodeCounts[] = {10000, 50000, 100000};
+    const uint32 materialCounts[] = {64, 1024};
+
+    for (const uint32 materialCount : materialCounts)
+    {
+        for (const uint32 nodeCount : nodeCounts)
+        {
+            std::vector<BenchmarkNode> nodes(nodeCount);
+            for (uint32 i = 0; i < nodeCount; ++i)
+            {
+                const uint32 material = (i * 7919) % materialCount;
+                nodes[i] = {100 + (material % 3) * 100, material, (i * 104729) % 512, (i * 31) % 128};
+            }
+
+            // rebuild every frame
+            uint64 legacyDrawn = 0;
+            iaTime start = iaTime::getNow();
+            {
+                std::vector<LegacyMaterialGroup> materialGroups;
+
+                for (uint32 frame = 0; frame < frames; ++frame)
+                {
+                    auto iter = materialGroups.begin();
+                    while (iter != materialGroups.end())
+                    {
+                        if (iter->_renderNodes.empty())
+                        {
+                            iter = materialGroups.erase(iter);
+                            continue;
+                        }
+
+                        iter++;
+                    }
+
+                    for (uint32 i = 0; i < nodeCount; ++i)
+                    {
+                        if (!isVisible(i, frame, nodeCount))
+                        {
+                            continue;
+                        }
+
+                        const BenchmarkNode &node = nodes[i];
+                        auto groupIter = std::find_if(materialGroups.begin(), materialGroups.end(),
+                                                      [&node](const LegacyMaterialGroup &materialGroup)
+                                                      { return materialGroup._material == node._material; });
+
+                        if (groupIter != materialGroups.end())
+                        {
+                            groupIter->_renderNodes.push_back(&node);
+                        }
+                        else
+                        {
+                            materialGroups.push_back({node._material, node._order, {&node}, {{node._mesh, 1}}});
+                        }
+                    }
+
+                    std::sort(materialGroups.begin(), materialGroups.end(), [](const LegacyMaterialGroup a, const LegacyMaterialGroup b) -> bool
+                              { return a._order < b._order; });
+
+                    for (auto &materialGroup : materialGroups)
+                    {
+                        legacyDrawn += materialGroup._renderNodes.size();
+                        materialGroup._renderNodes.clear();
+                    }
+                }
+            }
+            const iaTime legacyDuration = iaTime::getNow() - start;
+
+            // persistent queue
+            uint64 queueDrawn = 0;
+            iaTime queueDuration;
+            iaTime firstFrameDuration;
+            start = iaTime::getNow();
+            {
+                iRenderQueue<const BenchmarkNode *> queue;
+
+                for (uint32 frame = 0; frame < frames; ++frame)
+                {
+                    queue.beginFrame();
+
+                    for (uint32 i = 0; i < nodeCount; ++i)
+                    {
+                        if (!isVisible(i, frame, nodeCount))
+                        {
+                            continue;
+                        }
+
+                        // use the indices as fake resource pointers
+                        const BenchmarkNode &node = nodes[i];
+                        queue.submit(&node, node._order, &nodes[node._material], &nodes[node._mesh], &nodes[node._texture]);
+                    }
+
+                    queue.endFrame();
+
+                    if (frame == 0)
+                    {
+                        firstFrameDuration = iaTime::getNow() - start;
+                    }
+
+                    for (uint32 i = 0; i < queue.size(); ++i)
+                    {
+                        queueDrawn++;
+                    }
+                }
+
+                queueDuration = iaTime::getNow() - start;
+
+                // only the first frame sorts everything
+                IAUX_EXPECT_EQUAL(queue.getFullSortCount(), 1);
+                for (uint32 i = 1; i < queue.size(); ++i)
+                {
+                    IAUX_EXPECT_TRUE(queue.getKey(i - 1) <= queue.getKey(i));
+                    IAUX_EXPECT_TRUE(queue.getItem(i - 1)->_order <= queue.getItem(i)->_order);
+                }
+            }
+
+            IAUX_EXPECT_EQUAL(legacyDrawn, queueDrawn);
+
+            // the queue pays for sorting everything once, after that it only merges in what changed
+            const float64 legacyPerFrame = legacyDuration.getMilliseconds() / frames;
+            const float64 queuePerFrame = (queueDuration - firstFrameDuration).getMilliseconds() / (frames - 1);
+
+            iaConsole::getInstance() << "render nodes: " << nodeCount << " materials: " << materialCount << " frames: " << frames
+                                     << " rebuild: " << legacyDuration << " persistent queue: " << queueDuration << " (first frame " << firstFrameDuration << ")"
+                                     << " per frame rebuild: " << legacyPerFrame << "ms persistent queue: " << queuePerFrame << "ms" << endl;
+        }
+    }
+}
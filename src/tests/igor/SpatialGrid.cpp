@@ -0,0 +1,187 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/data/iQuadtree.h>
+#include <igor/data/iSpatialGrid.h>
+using namespace igor;
+
+#include <algorithm>
+#include <set>
+
+typedef iSpatialGrid<float64, uint32> iSpatialGridTest;
+
+static const iaRectangled gridRect(0, 0, 1000, 1000);
+
+static void fillRandom(iSpatialGridTest &grid, std::vector<iaCircled> &circles, uint32 count, float64 maxRadius)
+{
+    iaRandomNumberGenerator rand(42);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        circles.emplace_back(rand.getNextFloatRange(0.0, 999.0), rand.getNextFloatRange(0.0, 999.0), rand.getNextFloatRange(1.0, maxRadius));
+        grid.add(circles.back(), i);
+    }
+
+    grid.build();
+}
+
+IAUX_TEST(SpatialGridTests, QueryCircle)
+{
+    iSpatialGridTest grid(gridRect, 20.0);
+    std::vector<iaCircled> circles;
+    fillRandom(grid, circles, 2000, 10.0);
+
+    IAUX_EXPECT_EQUAL(grid.getEntryCount(), 2000);
+    IAUX_EXPECT_EQUAL(grid.getCellCount(), 2500);
+
+    const iaCircled queryCircle(500, 500, 60);
+
+    std::vector<uint32> expected;
+    for (uint32 i = 0; i < circles.size(); ++i)
+    {
+        if (iIntersection::intersects(circles[i], queryCircle))
+        {
+            expected.push_back(i);
+        }
+    }
+
+    std::vector<uint32> result;
+    grid.query(queryCircle, result);
+    std::sort(result.begin(), result.end());
+
+    IAUX_EXPECT_TRUE(expected == result);
+}
+
+IAUX_TEST(SpatialGridTests, QueryPairs)
+{
+    iSpatialGridTest grid(gridRect, 20.0);
+    std::vector<iaCircled> circles;
+    fillRandom(grid, circles, 2000, 10.0);
+
+    std::set<std::pair<uint32, uint32>> expected;
+    for (uint32 a = 0; a < circles.size(); ++a)
+    {
+        for (uint32 b = a + 1; b < circles.size(); ++b)
+        {
+            const float64 radii = (circles[a]._radius + circles[b]._radius) * 1.1;
+            if (circles[a]._center.distance2(circles[b]._center) <= radii * radii)
+            {
+                expected.emplace(a, b);
+            }
+        }
+    }
+
+    std::vector<std::pair<uint32, uint32>> pairs;
+    grid.queryPairs(pairs, 1.1);
+    IAUX_EXPECT_EQUAL(pairs.size(), expected.size());
+    const std::set<std::pair<uint32, uint32>> result(pairs.begin(), pairs.end());
+    IAUX_EXPECT_TRUE(result == expected);
+
+    // split in cell ranges like a parallel for would do
+    uint64 pairCount = 0;
+    const uint32 chunkSize = 333;
+    for (uint32 cell = 0; cell < grid.getCellCount(); cell += chunkSize)
+    {
+        grid.queryPairs(cell, cell + chunkSize, [&](uint32 a, uint32 b)
+                        { pairCount++; },
+                        1.1);
+    }
+
+    IAUX_EXPECT_EQUAL(pairCount, expected.size());
+
+    // touching circles overlap like in iIntersection::intersects
+    iSpatialGridTest touching(gridRect, 20.0);
+    touching.add(iaCircled(0.0, 0.0, 10.0), 0);
+    touching.add(iaCircled(20.0, 0.0, 10.0), 1);
+    touching.build();
+
+    pairs.clear();
+    touching.queryPairs(pairs);
+    IAUX_EXPECT_EQUAL(pairs.size(), 1);
+}
+
+IAUX_TEST(SpatialGridTests, QueryNearest)
+{
+    iSpatialGridTest grid(gridRect, 20.0);
+    std::vector<iaCircled> circles;
+    fillRandom(grid, circles, 2000, 10.0);
+
+    const iaVector2d position(123, 456);
+
+    std::vector<std::pair<float64, uint32>> expected;
+    for (uint32 i = 0; i < circles.size(); ++i)
+    {
+        expected.emplace_back(position.distance2(circles[i]._center), i);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<uint32> result;
+    grid.queryNearest(position, 8, result);
+
+    IAUX_EXPECT_EQUAL(result.size(), 8);
+    for (uint32 i = 0; i < result.size(); ++i)
+    {
+        IAUX_EXPECT_EQUAL(result[i], expected[i].second);
+    }
+}
+
+IAUX_BENCHMARK(SpatialGridTests, BenchmarkNeighbourQueries)
+{
+    static const uint32 count = 100000;
+    static const iaRectangled rect(0, 0, 20000, 20000);
+
+    iaRandomNumberGenerator rand(1337);
+    std::vector<iaCircled> circles;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        circles.emplace_back(rand.getNextFloatRange(0.0, 19999.0), rand.getNextFloatRange(0.0, 19999.0), 10.0);
+    }
+
+    // one query per object like iVelocitySystem used to do
+    iQuadtreed tree(rect);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        tree.insert(std::make_shared<iQuadtreed::Object>(circles[i], i));
+    }
+
+    uint64 perObjectPairs = 0;
+    iaTime start = iaTime::getNow();
+    iQuadtreed::Objects objects;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        objects.clear();
+        tree.query(circles[i], objects);
+        perObjectPairs += objects.size() - 1;
+    }
+    const iaTime perObjectDuration = iaTime::getNow() - start;
+
+    // batch pairs on quadtree
+    uint64 quadtreePairs = 0;
+    start = iaTime::getNow();
+    tree.queryPairs([&](const iQuadtreed::ObjectPtr &a, const iQuadtreed::ObjectPtr &b)
+                    { quadtreePairs++; });
+    const iaTime quadtreeDuration = iaTime::getNow() - start;
+
+    // rebuild grid and batch pairs
+    uint64 gridPairs = 0;
+    start = iaTime::getNow();
+    iSpatialGridTest grid(rect, 40.0);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        grid.add(circles[i], i);
+    }
+    grid.build();
+    grid.queryPairs([&](uint32 a, uint32 b)
+                    { gridPairs++; });
+    const iaTime gridDuration = iaTime::getNow() - start;
+
+    // every pair shows up twice in per object queries. those only visit nodes the query circle touches and
+    // miss objects that reach in to it from a neighbouring node so they can find less
+    IAUX_EXPECT_LESS_THEN(perObjectPairs, quadtreePairs * 2 + 1);
+    IAUX_EXPECT_EQUAL(gridPairs, quadtreePairs);
+
+    iaConsole::getInstance() << "objects: " << count << " per object queries: " << perObjectDuration
+                             << " quadtree pairs: " << quadtreeDuration << " grid build+pairs: " << gridDuration << endl;
+}
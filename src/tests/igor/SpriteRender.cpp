@@ -0,0 +1,240 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/entities/iEntitySystemModule.h>
+#include <igor/entities/iEntity.h>
+#include <igor/entities/systems/iSpriteRenderSystem.h>
+#include <igor/entities/systems/iTransformHierarchySystem.h>
+#include <igor/entities/systems/iQuadtreeSystem.h>
+using namespace igor;
+
+#include <algorithm>
+#include <set>
+
+static const float64 playfieldSize = 1000.0;
+static const iaRectangled viewRectangle(300.0, 400.0, 200.0, 150.0);
+
+/*! creates sprites all over the playfield. some have a body, some are children and some are inactive
+
+\param bodiesOnly if true all sprites have a body and none is a child
+ */
+static std::vector<iEntity> createSprites(iEntityScenePtr scene, uint32 count, bool bodiesOnly = false)
+{
+    iaRandomNumberGenerator rand(1337);
+    std::vector<iEntity> entities;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        iEntity entity = scene->createEntity("sprite", i % 17 != 0);
+        entity.addComponent<iTransformComponent>({iaVector3d(rand.getNextFloatRange(0.0, playfieldSize), rand.getNextFloatRange(0.0, playfieldSize), 0.0),
+                                                  iaVector3d(0.0, 0.0, rand.getNextFloatRange(0.0, 6.0)), iaVector3d(1.0, 1.0, 1.0)});
+
+        iSpriteRendererComponent spriteRender;
+        spriteRender._size.set(rand.getNextFloatRange(1.0, 20.0), rand.getNextFloatRange(1.0, 20.0));
+        spriteRender._zIndex = static_cast<int32>(rand.getNextRange(5));
+        entity.addComponent<iSpriteRendererComponent>(spriteRender);
+
+        if (i % 2 == 0 || bodiesOnly)
+        {
+            entity.addComponent<iBody2DComponent>({});
+        }
+        else if (i % 5 == 0 && !entities.empty())
+        {
+            entity.setParent(entities[rand.getNextRange(entities.size())].getID());
+        }
+
+        entities.push_back(entity);
+    }
+
+    return entities;
+}
+
+static void update(iEntityScenePtr scene)
+{
+    iTransformHierarchySystem transformSystem;
+    transformSystem.update(iaTime(), scene);
+
+    iQuadtreeSystem quadtreeSystem;
+    quadtreeSystem.update(iaTime(), scene);
+}
+
+/*! \returns true if the world bounds of given sprite intersect with given rectangle
+ */
+static bool isVisible(iEntity &entity, const iaRectangled &rectangle)
+{
+    const iaMatrixd &matrix = entity.getComponent<iTransformComponent>()._worldMatrix;
+    const iaVector2d &size = entity.getComponent<iSpriteRendererComponent>()._size;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const float64 x = (i & 1) ? 0.5 : -0.5;
+        const float64 y = (i & 2) ? 0.5 : -0.5;
+        const iaVector3d corner = matrix._pos + matrix._right * (x * size._x) + matrix._top * (y * size._y);
+
+        if (corner._x >= rectangle._x && corner._x <= rectangle.getRight() &&
+            corner._y >= rectangle._y && corner._y <= rectangle.getBottom())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+IAUX_TEST(SpriteRenderTests, Culling)
+{
+    const iSpatialPartitionType types[] = {iSpatialPartitionType::Quadtree, iSpatialPartitionType::Grid};
+
+    for (const iSpatialPartitionType type : types)
+    {
+        iEntitySystemModule::create();
+        iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+        scene->initializeQuadtree(iaRectangled(0.0, 0.0, playfieldSize, playfieldSize), 8, 16, type);
+
+        std::vector<iEntity> entities = createSprites(scene, iSpriteRenderSystem::CULL_LIMIT);
+        update(scene);
+
+        iSpriteRenderSystem system;
+        system.cull(scene, viewRectangle);
+
+        const auto &visible = system.getVisibleEntities();
+        const std::set<iEntityID> visibleSet(visible.begin(), visible.end());
+        IAUX_EXPECT_EQUAL(visibleSet.size(), visible.size());
+        IAUX_EXPECT_GREATER_THEN(visible.size(), 0);
+        IAUX_EXPECT_LESS_THEN(visible.size(), entities.size() / 4);
+
+        // nothing that touches the view is missing and nothing inactive is in
+        uint32 missing = 0;
+        uint32 inactive = 0;
+        for (auto &entity : entities)
+        {
+            const bool found = visibleSet.find(entity.getID()) != visibleSet.end();
+
+            if (!entity.isActive())
+            {
+                inactive += found ? 1 : 0;
+                continue;
+            }
+
+            if (isVisible(entity, viewRectangle) && !found)
+            {
+                missing++;
+            }
+        }
+
+        IAUX_EXPECT_EQUAL(missing, 0);
+        IAUX_EXPECT_EQUAL(inactive, 0);
+
+        // rendered in z order
+        for (size_t i = 1; i < visible.size(); ++i)
+        {
+            IAUX_EXPECT_TRUE(scene->getComponent<iSpriteRendererComponent>(visible[i - 1])._zIndex <= scene->getComponent<iSpriteRendererComponent>(visible[i])._zIndex);
+        }
+
+        // without culling all active sprites are visible
+        system.cull(scene, viewRectangle, false);
+        IAUX_EXPECT_EQUAL(system.getVisibleEntities().size(), std::count_if(entities.begin(), entities.end(), [](const iEntity &entity)
+                                                                            { return entity.isActive(); }));
+
+        scene = nullptr;
+        iEntitySystemModule::destroy();
+    }
+}
+
+IAUX_TEST(SpriteRenderTests, NoCullingBelowLimit)
+{
+    iEntitySystemModule::create();
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+    scene->initializeQuadtree(iaRectangled(0.0, 0.0, playfieldSize, playfieldSize));
+
+    std::vector<iEntity> entities = createSprites(scene, iSpriteRenderSystem::CULL_LIMIT / 2);
+    update(scene);
+
+    iSpriteRenderSystem system;
+    system.cull(scene, viewRectangle);
+    IAUX_EXPECT_EQUAL(system.getVisibleEntities().size(), std::count_if(entities.begin(), entities.end(), [](const iEntity &entity)
+                                                                        { return entity.isActive(); }));
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+}
+
+IAUX_TEST(SpriteRenderTests, SortOnlyOnChange)
+{
+    iEntitySystemModule::create();
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+    scene->initializeQuadtree(iaRectangled(0.0, 0.0, playfieldSize, playfieldSize));
+
+    std::vector<iEntity> entities = createSprites(scene, 100);
+    update(scene);
+
+    iSpriteRenderSystem system;
+    system.cull(scene, viewRectangle, false);
+    IAUX_EXPECT_EQUAL(system.getSortCount(), 1);
+
+    system.cull(scene, viewRectangle, false);
+    system.cull(scene, viewRectangle, false);
+    IAUX_EXPECT_EQUAL(system.getSortCount(), 1);
+
+    // changing the z index directly gets noticed as well
+    const iEntityID lastID = system.getVisibleEntities().back();
+    scene->getComponent<iSpriteRendererComponent>(lastID)._zIndex = -1;
+    system.cull(scene, viewRectangle, false);
+    IAUX_EXPECT_EQUAL(system.getSortCount(), 2);
+    IAUX_EXPECT_EQUAL(system.getVisibleEntities().front(), lastID);
+
+    iEntity(lastID, scene).setZIndex(10);
+    system.cull(scene, viewRectangle, false);
+    IAUX_EXPECT_EQUAL(system.getSortCount(), 3);
+    IAUX_EXPECT_EQUAL(system.getVisibleEntities().back(), lastID);
+
+    // a z index that keeps the order needs no sort
+    iEntity(lastID, scene).setZIndex(11);
+    system.cull(scene, viewRectangle, false);
+    IAUX_EXPECT_EQUAL(system.getSortCount(), 3);
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+}
+
+IAUX_BENCHMARK(SpriteRenderTests, BenchmarkCull)
+{
+    const std::pair<uint32, bool> configs[] = {{1000, false}, {1000, true}, {10000, false}, {10000, true}, {100000, false}, {100000, true}};
+    const uint32 frameCount = 10;
+
+    for (const auto &[spriteCount, bodiesOnly] : configs)
+    {
+        iEntitySystemModule::create();
+        iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+        scene->initializeQuadtree(iaRectangled(0.0, 0.0, playfieldSize, playfieldSize));
+
+        std::vector<iEntity> entities = createSprites(scene, spriteCount, bodiesOnly);
+        update(scene);
+
+        iSpriteRenderSystem system;
+        system.cull(scene, viewRectangle);
+
+        iaTime allDuration;
+        iaTime culledDuration;
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            iaTime start = iaTime::getNow();
+            system.cull(scene, viewRectangle, false);
+            allDuration += iaTime::getNow() - start;
+
+            start = iaTime::getNow();
+            system.cull(scene, viewRectangle);
+            culledDuration += iaTime::getNow() - start;
+        }
+
+        IAUX_EXPECT_EQUAL(system.getSortCount(), 1);
+
+        iaConsole::getInstance() << "sprites: " << spriteCount << (bodiesOnly ? " (all with body)" : " (half with body)") << " visible: " << system.getVisibleEntities().size() << " frames: " << frameCount
+                                 << " without culling: " << allDuration << " with culling: " << culledDuration << endl;
+
+        scene = nullptr;
+        iEntitySystemModule::destroy();
+    }
+}
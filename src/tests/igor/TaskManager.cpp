@@ -0,0 +1,317 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/threading/iTaskManager.h>
+#include <igor/physics/iPhysics.h>
+#include <igor/resources/config/iConfigReader.h>
+using namespace igor;
+
+#include <fstream>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+static const char *configFilename = "taskManagerTest.xml";
+static const uint64 benchmarkTaskCount = 20000;
+
+static std::atomic<uint64> taskCounter;
+
+class CountingTask : public iTask
+{
+public:
+    CountingTask(uint32 priority)
+        : iTask(nullptr, priority)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        // some busy work to make the task not completely trivial
+        float64 value = 1.0;
+        for (int i = 0; i < 200; ++i)
+        {
+            value = value * 1.0001 + 0.5;
+        }
+
+        if (value > 0.0)
+        {
+            taskCounter++;
+        }
+    }
+};
+
+static void startTaskManager(uint32 threadCount)
+{
+    std::ofstream file(configFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"minThreads\" value=\"" << threadCount << "\" />\n";
+    file << "        <Setting name=\"maxThreads\" value=\"" << threadCount << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(configFilename);
+    iPhysics::create();
+    iTaskManager::create();
+}
+
+static void stopTaskManager()
+{
+    iTaskManager::destroy();
+    iPhysics::destroy();
+    iConfigReader::destroy();
+    std::remove(configFilename);
+}
+
+static void waitForTasks(uint64 count)
+{
+    while (iTaskManager::getInstance().getTaskDoneCount() < count)
+    {
+        std::this_thread::yield();
+    }
+}
+
+IAUX_TEST(TaskManagerTests, RunAllTasks)
+{
+    startTaskManager(4);
+    taskCounter = 0;
+
+    IAUX_EXPECT_EQUAL(iTaskManager::getInstance().getRegularThreadCount(), 4);
+
+    const uint32 priorities[] = {iTask::TASK_PRIORITY_MAX, iTask::TASK_PRIORITY_HIGH, iTask::TASK_PRIORITY_DEFAULT, iTask::TASK_PRIORITY_LOW};
+    for (uint64 i = 0; i < 1000; ++i)
+    {
+        iTaskManager::getInstance().addTask(new CountingTask(priorities[i % 4]));
+    }
+
+    waitForTasks(1000);
+
+    IAUX_EXPECT_EQUAL(taskCounter, 1000);
+    IAUX_EXPECT_EQUAL(iTaskManager::getInstance().getQueuedRegularTaskCount(), 0);
+
+    stopTaskManager();
+}
+
+IAUX_BENCHMARK(TaskManagerTests, BenchmarkThroughputPerThreadCount)
+{
+    const uint32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        startTaskManager(threadCount);
+        taskCounter = 0;
+
+        const iaTime start = iaTime::getNow();
+
+        for (uint64 i = 0; i < benchmarkTaskCount; ++i)
+        {
+            iTaskManager::getInstance().addTask(new CountingTask(iTask::TASK_PRIORITY_DEFAULT));
+        }
+
+        waitForTasks(benchmarkTaskCount);
+
+        const iaTime duration = iaTime::getNow() - start;
+        IAUX_EXPECT_EQUAL(taskCounter, benchmarkTaskCount);
+
+        iaConsole::getInstance() << "threads: " << threadCount << " tasks/sec: " << static_cast<uint64>(benchmarkTaskCount / (duration.getMilliseconds() / 1000.0)) << endl;
+
+        stopTaskManager();
+    }
+}
+
+IAUX_TEST(TaskManagerTests, IdleThreadsGetParked)
+{
+    startTaskManager(4);
+    taskCounter = 0;
+
+    iTaskManager::getInstance().setIdlePolicy(iThreadIdlePolicy::Park);
+    IAUX_EXPECT_TRUE(iTaskManager::getInstance().getIdlePolicy() == iThreadIdlePolicy::Park);
+
+    // give the threads some time to get parked
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const uint64 wakeups = iTaskManager::getInstance().getWakeupCount();
+
+    for (uint64 i = 0; i < 100; ++i)
+    {
+        iTaskManager::getInstance().addTask(new CountingTask(iTask::TASK_PRIORITY_DEFAULT));
+    }
+
+    waitForTasks(100);
+
+    IAUX_EXPECT_EQUAL(taskCounter, 100);
+    IAUX_EXPECT_GREATER_THEN(iTaskManager::getInstance().getWakeupCount(), wakeups);
+    IAUX_EXPECT_GREATER_THEN(iTaskManager::getInstance().getTotalParkTime().getMicroseconds(), 0);
+
+    stopTaskManager();
+}
+
+static std::vector<int> executionOrder;
+static iaMutex executionOrderMutex;
+
+class RecordingTask : public iTask
+{
+public:
+    RecordingTask(int value)
+        : iTask(nullptr, iTask::TASK_PRIORITY_DEFAULT), _value(value)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        // give dependent tasks a chance to run too early
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        executionOrderMutex.lock();
+        executionOrder.push_back(_value);
+        executionOrderMutex.unlock();
+    }
+
+private:
+    int _value;
+};
+
+IAUX_TEST(TaskManagerTests, Continuations)
+{
+    startTaskManager(4);
+    executionOrder.clear();
+
+    iTaskID first = iTaskManager::getInstance().addTask(new RecordingTask(1));
+    iTaskID second = iTaskManager::getInstance().addContinuation(first, new RecordingTask(2));
+    iTaskID third = iTaskManager::getInstance().addContinuation(second, new RecordingTask(3));
+
+    iTaskManager::getInstance().waitForTasks({third});
+
+    IAUX_EXPECT_TRUE(iTaskManager::getInstance().isTaskFinished(first));
+    IAUX_EXPECT_TRUE(iTaskManager::getInstance().isTaskFinished(second));
+    IAUX_EXPECT_EQUAL(executionOrder.size(), 3);
+    IAUX_EXPECT_EQUAL(executionOrder[0], 1);
+    IAUX_EXPECT_EQUAL(executionOrder[1], 2);
+    IAUX_EXPECT_EQUAL(executionOrder[2], 3);
+
+    stopTaskManager();
+}
+
+IAUX_TEST(TaskManagerTests, JoinGroup)
+{
+    startTaskManager(4);
+    executionOrder.clear();
+
+    std::vector<iTaskID> group;
+    for (int i = 0; i < 10; ++i)
+    {
+        group.push_back(iTaskManager::getInstance().addTask(new RecordingTask(1)));
+    }
+
+    iTaskID join = iTaskManager::getInstance().addTask(new RecordingTask(2), group);
+    iTaskManager::getInstance().waitForTasks({join});
+
+    IAUX_EXPECT_EQUAL(executionOrder.size(), 11);
+    IAUX_EXPECT_EQUAL(executionOrder.back(), 2);
+
+    stopTaskManager();
+}
+
+static float64 syntheticWork(uint64 index)
+{
+    float64 value = static_cast<float64>(index);
+    for (int i = 0; i < 20; ++i)
+    {
+        value = std::sqrt(value * value + 1.0) * 0.999;
+    }
+
+    return value;
+}
+
+IAUX_TEST(TaskManagerTests, ParallelFor)
+{
+    startTaskManager(4);
+
+    static const uint64 count = 10000;
+    std::vector<float64> serialResult(count);
+    std::vector<float64> parallelResult(count);
+
+    for (uint64 i = 0; i < count; ++i)
+    {
+        serialResult[i] = syntheticWork(i);
+    }
+
+    iTaskManager::getInstance().parallelFor(0, count, [&](uint64 begin, uint64 end)
+                                            {
+                                                for (uint64 i = begin; i < end; ++i)
+                                                {
+                                                    parallelResult[i] = syntheticWork(i);
+                                                } });
+
+    IAUX_EXPECT_TRUE(serialResult == parallelResult);
+
+    stopTaskManager();
+}
+
+IAUX_BENCHMARK(TaskManagerTests, BenchmarkParallelFor)
+{
+    startTaskManager(std::max(1u, std::thread::hardware_concurrency()));
+
+    static const uint64 count = 1000000;
+    std::vector<float64> serialResult(count);
+    std::vector<float64> parallelResult(count);
+
+    iaTime start = iaTime::getNow();
+    for (uint64 i = 0; i < count; ++i)
+    {
+        serialResult[i] = syntheticWork(i);
+    }
+    const iaTime serialDuration = iaTime::getNow() - start;
+
+    start = iaTime::getNow();
+    iTaskManager::getInstance().parallelFor(0, count, [&](uint64 begin, uint64 end)
+                                            {
+                                                for (uint64 i = begin; i < end; ++i)
+                                                {
+                                                    parallelResult[i] = syntheticWork(i);
+                                                } });
+    const iaTime parallelDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_TRUE(serialResult == parallelResult);
+
+    iaConsole::getInstance() << "threads: " << iTaskManager::getInstance().getRegularThreadCount()
+                             << " serial: " << serialDuration << " parallel: " << parallelDuration << endl;
+
+    stopTaskManager();
+}
+
+IAUX_TEST(TaskManagerTests, ParallelReduce)
+{
+    startTaskManager(4);
+
+    const uint64 sum = iTaskManager::getInstance().parallelReduce(
+        1, 100001, static_cast<uint64>(0), [](uint64 begin, uint64 end)
+        {
+            uint64 result = 0;
+            for (uint64 i = begin; i < end; ++i)
+            {
+                result += i;
+            }
+            return result; },
+        [](uint64 a, uint64 b)
+        { return a + b; });
+
+    IAUX_EXPECT_EQUAL(sum, 5000050000ull);
+
+    std::atomic<uint64> counter = 0;
+    iTaskID taskID = iTaskManager::getInstance().parallelForAsync(0, 1000, [&](uint64 begin, uint64 end)
+                                                                  { counter += end - begin; },
+                                                                  10);
+    iTaskManager::getInstance().waitForTasks({taskID});
+    IAUX_EXPECT_EQUAL(counter, 1000);
+
+    stopTaskManager();
+}
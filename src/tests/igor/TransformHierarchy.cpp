@@ -0,0 +1,263 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/entities/iEntitySystemModule.h>
+#include <igor/entities/iEntity.h>
+#include <igor/entities/systems/iTransformHierarchySystem.h>
+#include <igor/threading/iTaskManager.h>
+#include <igor/physics/iPhysics.h>
+#include <igor/resources/config/iConfigReader.h>
+using namespace igor;
+
+#include <fstream>
+#include <cstdio>
+#include <thread>
+
+static const char *transformHierarchyConfigFilename = "transformHierarchyTest.xml";
+static const uint32 staticEntityCount = 100000;
+static const uint32 movingParentCount = 1000;
+static const uint32 childrenPerParent = 9;
+static const uint32 frameCount = 10;
+
+/*! \returns world matrix of given entity calculated from scratch
+ */
+static iaMatrixd calcWorldMatrix(iEntityScenePtr scene, iEntityID entityID)
+{
+    const iTransformComponent &transform = scene->getComponent<iTransformComponent>(entityID);
+
+    iaMatrixd result;
+    result.translate(transform._position);
+    result.rotate(transform._orientation);
+    result.scale(transform._scale);
+
+    const iHierarchyComponent *hierarchy = scene->tryGetComponent<iHierarchyComponent>(entityID);
+    if (hierarchy != nullptr &&
+        hierarchy->_parent != IGOR_INVALID_ENTITY_ID)
+    {
+        iaMatrixd parentMatrix = calcWorldMatrix(scene, hierarchy->_parent);
+        parentMatrix *= result;
+        return parentMatrix;
+    }
+
+    return result;
+}
+
+static bool sameMatrix(const iaMatrixd &a, const iaMatrixd &b)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        if (std::abs(a[i] - b[i]) > 0.000001)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool sameAsFullUpdate(iEntityScenePtr scene, std::vector<iEntity> &entities)
+{
+    for (auto &entity : entities)
+    {
+        if (!sameMatrix(entity.getComponent<iTransformComponent>()._worldMatrix, calcWorldMatrix(scene, entity.getID())))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static iEntity createTransformEntity(iEntityScenePtr scene, const iaVector3d &position)
+{
+    iEntity entity = scene->createEntity();
+    entity.addComponent<iTransformComponent>({position, iaVector3d(0.0, 0.0, 0.1), iaVector3d(1.0, 1.0, 1.0)});
+    return entity;
+}
+
+IAUX_TEST(TransformHierarchyTests, Generations)
+{
+    iEntitySystemModule::create();
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+
+    iEntity a = createTransformEntity(scene, iaVector3d(1.0, 0.0, 0.0));
+    iEntity b = createTransformEntity(scene, iaVector3d(0.0, 1.0, 0.0));
+    iEntity c = createTransformEntity(scene, iaVector3d(0.0, 0.0, 1.0));
+    iEntity d = createTransformEntity(scene, iaVector3d(1.0, 1.0, 0.0));
+
+    const uint64 version = scene->getHierarchyVersion();
+
+    // build the chain bottom up so descendants have to be updated
+    c.setParent(b.getID());
+    d.setParent(c.getID());
+    b.setParent(a.getID());
+
+    IAUX_EXPECT_GREATER_THEN(scene->getHierarchyVersion(), version);
+    IAUX_EXPECT_EQUAL(a.getComponent<iHierarchyComponent>()._generation, 0);
+    IAUX_EXPECT_EQUAL(b.getComponent<iHierarchyComponent>()._generation, 1);
+    IAUX_EXPECT_EQUAL(c.getComponent<iHierarchyComponent>()._generation, 2);
+    IAUX_EXPECT_EQUAL(d.getComponent<iHierarchyComponent>()._generation, 3);
+
+    c.setParent(IGOR_INVALID_ENTITY_ID);
+    IAUX_EXPECT_EQUAL(b.getComponent<iHierarchyComponent>()._generation, 1);
+    IAUX_EXPECT_EQUAL(c.getComponent<iHierarchyComponent>()._generation, 0);
+    IAUX_EXPECT_EQUAL(d.getComponent<iHierarchyComponent>()._generation, 1);
+    IAUX_EXPECT_EQUAL(b.getComponent<iHierarchyComponent>()._childCount, 0);
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+}
+
+IAUX_TEST(TransformHierarchyTests, SameAsFullUpdate)
+{
+    iEntitySystemModule::create();
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+    iTransformHierarchySystem system;
+
+    std::vector<iEntity> entities;
+    for (uint32 i = 0; i < 20; ++i)
+    {
+        entities.push_back(createTransformEntity(scene, iaVector3d(i, i * 0.5, 0.0)));
+
+        // every fourth one is a child of the one before
+        if (i % 4 != 0)
+        {
+            entities.back().setParent(entities[i - 1].getID());
+        }
+    }
+
+    system.update(iaTime(), scene);
+    IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, entities));
+
+    // nothing changed
+    system.update(iaTime(), scene);
+    IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, entities));
+
+    // moving a parent moves its descendants
+    entities[4].getComponent<iTransformComponent>()._position.set(10.0, 0.0, 3.0);
+    entities[9].getComponent<iTransformComponent>()._orientation.set(0.0, 1.0, 0.0);
+    entities[13].getComponent<iTransformComponent>()._scale.set(2.0, 2.0, 2.0);
+    system.update(iaTime(), scene);
+    IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, entities));
+
+    // reparenting without moving anything
+    entities[6].setParent(entities[17].getID());
+    entities[8].setParent(IGOR_INVALID_ENTITY_ID);
+    system.update(iaTime(), scene);
+    IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, entities));
+
+    // new child of a static parent
+    entities.push_back(createTransformEntity(scene, iaVector3d(0.0, 5.0, 0.0)));
+    entities.back().setParent(entities[0].getID());
+    system.update(iaTime(), scene);
+    IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, entities));
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+}
+
+IAUX_BENCHMARK(TransformHierarchyTests, BenchmarkStaticVsMoving)
+{
+    const uint32 threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::ofstream file(transformHierarchyConfigFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"minThreads\" value=\"" << threadCount << "\" />\n";
+    file << "        <Setting name=\"maxThreads\" value=\"" << threadCount << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(transformHierarchyConfigFilename);
+    iPhysics::create();
+    iTaskManager::create();
+    iEntitySystemModule::create();
+
+    iEntityScenePtr scene = iEntitySystemModule::getInstance().createScene();
+
+    std::vector<iEntity> entities;
+    for (uint32 i = 0; i < staticEntityCount; ++i)
+    {
+        entities.push_back(createTransformEntity(scene, iaVector3d(i % 1000, i / 1000, 0.0)));
+    }
+
+    std::vector<iEntity> movingParents;
+    for (uint32 i = 0; i < movingParentCount; ++i)
+    {
+        movingParents.push_back(createTransformEntity(scene, iaVector3d(i, 0.0, 10.0)));
+        entities.push_back(movingParents.back());
+
+        for (uint32 c = 0; c < childrenPerParent; ++c)
+        {
+            entities.push_back(createTransformEntity(scene, iaVector3d(c, 1.0, 0.0)));
+            entities.back().setParent(movingParents.back().getID());
+        }
+    }
+
+    auto move = [&](uint32 frame)
+    {
+        for (auto &parent : movingParents)
+        {
+            parent.getComponent<iTransformComponent>()._position._z = frame;
+        }
+    };
+
+    // everything gets recalculated every frame the way it was before
+    auto forceAll = [&]()
+    {
+        for (auto &entity : entities)
+        {
+            entity.getComponent<iTransformComponent>()._dirty = true;
+        }
+    };
+
+    const bool multithreadingModes[] = {false, true};
+
+    for (const bool multithreading : multithreadingModes)
+    {
+        scene->setMultithreadingEnabled(multithreading);
+
+        iTransformHierarchySystem fullSystem;
+        iaTime fullDuration;
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            move(frame);
+            forceAll();
+
+            const iaTime start = iaTime::getNow();
+            fullSystem.update(iaTime(), scene);
+            fullDuration += iaTime::getNow() - start;
+        }
+
+        iTransformHierarchySystem system;
+        system.update(iaTime(), scene);
+
+        iaTime incrementalDuration;
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            move(frame + frameCount);
+
+            const iaTime start = iaTime::getNow();
+            system.update(iaTime(), scene);
+            incrementalDuration += iaTime::getNow() - start;
+        }
+
+        IAUX_EXPECT_TRUE(sameAsFullUpdate(scene, movingParents));
+        IAUX_EXPECT_NEAR(entities.back().getComponent<iTransformComponent>()._worldMatrix._pos._z, movingParents.back().getComponent<iTransformComponent>()._position._z, 0.000001);
+
+        iaConsole::getInstance() << "threads: " << (multithreading ? iTaskManager::getInstance().getRegularThreadCount() : 0)
+                                 << " static: " << staticEntityCount << " moving: " << movingParentCount * (childrenPerParent + 1) << " frames: " << frameCount
+                                 << " full: " << fullDuration << " incremental: " << incrementalDuration << endl;
+    }
+
+    scene = nullptr;
+    iEntitySystemModule::destroy();
+    iTaskManager::destroy();
+    iPhysics::destroy();
+    iConfigReader::destroy();
+    std::remove(transformHierarchyConfigFilename);
+}
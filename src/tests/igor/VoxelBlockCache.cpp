@@ -0,0 +1,271 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/terrain/data/iVoxelBlockCache.h>
+#include <igor/generation/iPerlinNoise.h>
+using namespace igor;
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+static const char *voxelBlockCacheDirectory = "voxelBlockCacheTest";
+static const int64 blockSize = 34;
+static const uint32 benchmarkBlockCount = 64;
+
+/*! generates a noise based block the way the voxel examples do
+ */
+static bool generate(iPerlinNoise &perlinNoise, const iaVector3I &positionInLOD, iVoxelData &data)
+{
+    data.initData(blockSize, blockSize, blockSize);
+
+    bool transition = false;
+    for (int64 z = 0; z < blockSize; ++z)
+    {
+        for (int64 x = 0; x < blockSize; ++x)
+        {
+            for (int64 y = 0; y < blockSize; ++y)
+            {
+                const iaVector3d pos(positionInLOD._x * 32 + x, positionInLOD._y * 32 + y, positionInLOD._z * 32 + z);
+                const float64 ground = 20.0 + perlinNoise.getValue(iaVector3d(pos._x * 0.02, 0.0, pos._z * 0.02), 3) * 30.0;
+                const float64 cave = perlinNoise.getValue(iaVector3d(pos._x * 0.05, pos._y * 0.05, pos._z * 0.05), 4);
+
+                float64 density = ground - pos._y;
+                if (cave > 0.6)
+                {
+                    density = 0.6 - cave;
+                }
+
+                if (density > 0.0)
+                {
+                    data.setVoxelDensity(iaVector3I(x, y, z), static_cast<uint8>(std::min(density, 1.0) * 254.0) + 1);
+                    data.setVoxelMaterial(iaVector3I(x, y, z), pos._y < 10 ? 2 : 1);
+                    transition = true;
+                }
+            }
+        }
+    }
+
+    return transition;
+}
+
+static bool sameVoxels(iVoxelData &a, iVoxelData &b)
+{
+    for (int64 z = 0; z < blockSize; ++z)
+    {
+        for (int64 y = 0; y < blockSize; ++y)
+        {
+            for (int64 x = 0; x < blockSize; ++x)
+            {
+                if (a.getVoxelDensity(iaVector3I(x, y, z)) != b.getVoxelDensity(iaVector3I(x, y, z)) ||
+                    a.getVoxelMaterial(iaVector3I(x, y, z)) != b.getVoxelMaterial(iaVector3I(x, y, z)))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+IAUX_TEST(VoxelBlockCacheTests, StoreAndLoad)
+{
+    iPerlinNoise perlinNoise;
+    perlinNoise.generateBase(1337);
+
+    iVoxelData generated;
+    IAUX_EXPECT_TRUE(generate(perlinNoise, iaVector3I(1, 0, -2), generated));
+
+    {
+        iVoxelBlockCache cache(voxelBlockCacheDirectory);
+        cache.store(0, iaVector3I(1, 0, -2), generated, true);
+        cache.store(0, iaVector3I(1, 5, -2), generated, false);
+
+        iVoxelData loaded;
+        bool transition = false;
+        IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(1, 0, -2), loaded, transition));
+        IAUX_EXPECT_TRUE(transition);
+        IAUX_EXPECT_TRUE(sameVoxels(generated, loaded));
+        IAUX_EXPECT_EQUAL(cache.getMemoryHits(), 1);
+
+        IAUX_EXPECT_FALSE(cache.load(1, iaVector3I(1, 0, -2), loaded, transition));
+        IAUX_EXPECT_EQUAL(cache.getMisses(), 1);
+    }
+
+    // a new cache on the same directory behaves like a restart
+    {
+        iVoxelBlockCache cache(voxelBlockCacheDirectory);
+
+        iVoxelData loaded;
+        loaded.setStorage(iVoxelStorage::Dense);
+        bool transition = false;
+        IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(1, 0, -2), loaded, transition));
+        IAUX_EXPECT_TRUE(transition);
+        IAUX_EXPECT_TRUE(loaded.getStorage() == iVoxelStorage::Dense);
+        IAUX_EXPECT_TRUE(sameVoxels(generated, loaded));
+
+        transition = true;
+        IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(1, 5, -2), loaded, transition));
+        IAUX_EXPECT_FALSE(transition);
+
+        IAUX_EXPECT_EQUAL(cache.getDiskHits(), 2);
+
+        // modifications replace the stored block
+        loaded.setVoxelPole(iaVector3I(3, 0, 3), blockSize, 0);
+        cache.store(0, iaVector3I(1, 0, -2), loaded, true);
+        cache.clearMemory();
+
+        iVoxelData modified;
+        IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(1, 0, -2), modified, transition));
+        IAUX_EXPECT_TRUE(sameVoxels(loaded, modified));
+        IAUX_EXPECT_EQUAL(modified.getVoxelDensity(iaVector3I(3, 0, 3)), 0);
+
+        cache.remove(0, iaVector3I(1, 0, -2));
+        IAUX_EXPECT_FALSE(cache.load(0, iaVector3I(1, 0, -2), modified, transition));
+    }
+
+    std::filesystem::remove_all(voxelBlockCacheDirectory);
+}
+
+IAUX_TEST(VoxelBlockCacheTests, MemoryBudget)
+{
+    iPerlinNoise perlinNoise;
+    perlinNoise.generateBase(1337);
+
+    iVoxelData generated;
+    generate(perlinNoise, iaVector3I(0, 0, 0), generated);
+
+    const uint64 budget = generated.getMemoryUsage() * 3;
+    iVoxelBlockCache cache(voxelBlockCacheDirectory, budget);
+
+    for (int64 i = 0; i < 10; ++i)
+    {
+        cache.store(0, iaVector3I(i, 0, 0), generated, true);
+        IAUX_EXPECT_LESS_THEN(cache.getMemoryUsage(), budget + 1);
+    }
+
+    IAUX_EXPECT_LESS_THEN(cache.getBlockCount(), 10);
+    IAUX_EXPECT_GREATER_THEN(cache.getBlockCount(), 0);
+
+    // most recent block is in memory, the first one got evicted but is still on disk
+    iVoxelData loaded;
+    bool transition = false;
+    IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(9, 0, 0), loaded, transition));
+    IAUX_EXPECT_EQUAL(cache.getMemoryHits(), 1);
+    IAUX_EXPECT_TRUE(cache.load(0, iaVector3I(0, 0, 0), loaded, transition));
+    IAUX_EXPECT_EQUAL(cache.getDiskHits(), 1);
+    IAUX_EXPECT_TRUE(sameVoxels(generated, loaded));
+
+    cache.setMemoryBudget(0);
+    IAUX_EXPECT_EQUAL(cache.getBlockCount(), 1);
+
+    std::filesystem::remove_all(voxelBlockCacheDirectory);
+}
+
+IAUX_TEST(VoxelBlockCacheTests, CorruptFile)
+{
+    {
+        iVoxelBlockCache cache(voxelBlockCacheDirectory);
+
+        iVoxelData data;
+        data.initData(blockSize, blockSize, blockSize);
+        data.setVoxelDensity(iaVector3I(1, 1, 1), 128);
+        cache.store(2, iaVector3I(0, 0, 0), data, true);
+    }
+
+    const std::filesystem::path filename = std::filesystem::path(voxelBlockCacheDirectory) / "2" / "0_0_0.voxels";
+    IAUX_EXPECT_TRUE(std::filesystem::exists(filename));
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) / 2);
+
+    {
+        iVoxelBlockCache cache(voxelBlockCacheDirectory);
+
+        iVoxelData data;
+        bool transition = false;
+        IAUX_EXPECT_FALSE(cache.load(2, iaVector3I(0, 0, 0), data, transition));
+        IAUX_EXPECT_FALSE(std::filesystem::exists(filename));
+    }
+
+    std::filesystem::remove_all(voxelBlockCacheDirectory);
+}
+
+IAUX_BENCHMARK(VoxelBlockCacheTests, BenchmarkGenerateVsCache)
+{
+    iPerlinNoise perlinNoise;
+    perlinNoise.generateBase(42);
+
+    std::vector<iaVector3I> positions;
+    for (int64 i = 0; i < benchmarkBlockCount; ++i)
+    {
+        positions.emplace_back(i % 8, i / 32, (i / 8) % 4);
+    }
+
+    std::vector<iVoxelData> blocks(benchmarkBlockCount);
+    std::vector<bool> transitions(benchmarkBlockCount);
+
+    iaTime start = iaTime::getNow();
+    for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+    {
+        transitions[i] = generate(perlinNoise, positions[i], blocks[i]);
+    }
+    const iaTime generateDuration = iaTime::getNow() - start;
+
+    iaTime storeDuration;
+    {
+        iVoxelBlockCache cache(voxelBlockCacheDirectory);
+
+        start = iaTime::getNow();
+        for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+        {
+            cache.store(0, positions[i], blocks[i], transitions[i]);
+        }
+        storeDuration = iaTime::getNow() - start;
+    }
+
+    uint64 diskSize = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(voxelBlockCacheDirectory))
+    {
+        if (entry.is_regular_file())
+        {
+            diskSize += entry.file_size();
+        }
+    }
+
+    // restart
+    iVoxelBlockCache cache(voxelBlockCacheDirectory);
+    std::vector<iVoxelData> loaded(benchmarkBlockCount);
+    bool transition = false;
+
+    start = iaTime::getNow();
+    for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+    {
+        cache.load(0, positions[i], loaded[i], transition);
+    }
+    const iaTime diskDuration = iaTime::getNow() - start;
+
+    start = iaTime::getNow();
+    for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+    {
+        cache.load(0, positions[i], loaded[i], transition);
+    }
+    const iaTime memoryDuration = iaTime::getNow() - start;
+
+    IAUX_EXPECT_EQUAL(cache.getDiskHits(), benchmarkBlockCount);
+    IAUX_EXPECT_EQUAL(cache.getMemoryHits(), benchmarkBlockCount);
+
+    for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+    {
+        if (transitions[i])
+        {
+            IAUX_EXPECT_TRUE(sameVoxels(blocks[i], loaded[i]));
+        }
+    }
+
+    iaConsole::getInstance() << "blocks: " << benchmarkBlockCount << " size: " << blockSize << " on disk: " << diskSize / 1024 << "kB"
+                             << " generate: " << generateDuration << " store: " << storeDuration
+                             << " load from disk: " << diskDuration << " load from memory: " << memoryDuration << endl;
+
+    std::filesystem::remove_all(voxelBlockCacheDirectory);
+}
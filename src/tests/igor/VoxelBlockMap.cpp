@@ -0,0 +1,483 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/terrain/data/iVoxelBlockMap.h>
+#include <igor/terrain/data/iVoxelBlockPool.h>
+using namespace igor;
+
+#include <unordered_map>
+#include <map>
+
+static const int64 walkDiscoveryDistance = 5;
+static const uint32 walkSteps = 40;
+
+IAUX_TEST(VoxelBlockMapTests, MortonCode)
+{
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(0, 0, 0)), 0);
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(1, 0, 0)), 1);
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(0, 1, 0)), 2);
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(0, 0, 1)), 4);
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(3, 3, 3)), 63);
+    IAUX_EXPECT_EQUAL(iVoxelBlockMap::calcMortonCode(iaVector3I(2, 0, 0)), 8);
+}
+
+IAUX_TEST(VoxelBlockMapTests, SameAsUnorderedMap)
+{
+    iaRandomNumberGenerator rand(42);
+
+    struct Hasher
+    {
+        size_t operator()(const iaVector3I &key) const
+        {
+            return key._x * 73856093 ^ key._y * 19349663 ^ key._z * 83492791;
+        }
+    };
+
+    std::vector<iVoxelBlock> blocks(1000);
+    std::unordered_map<iaVector3I, iVoxelBlock *, Hasher> reference;
+    iVoxelBlockMap map;
+
+    for (uint32 i = 0; i < 20000; ++i)
+    {
+        // small range to get a lot of replacements and erases. Some far away to use more than 21 bits
+        iaVector3I position(rand.getNextRange(24) - 12, rand.getNextRange(24), rand.getNextRange(24) - 12);
+        if (i % 7 == 0)
+        {
+            position._x += 1 << 22;
+        }
+
+        if (rand.getNextRange(3) == 0)
+        {
+            IAUX_EXPECT_EQUAL(map.erase(position), reference.erase(position) == 1);
+        }
+        else
+        {
+            iVoxelBlock *block = &blocks[rand.getNextRange(1000)];
+            map.insert(position, block);
+            reference[position] = block;
+        }
+    }
+
+    IAUX_EXPECT_EQUAL(map.size(), reference.size());
+
+    for (const auto &pair : reference)
+    {
+        IAUX_EXPECT_EQUAL(map.find(pair.first), pair.second);
+    }
+
+    uint64 count = 0;
+    for (iVoxelBlock *block : map)
+    {
+        IAUX_EXPECT_TRUE(block != nullptr);
+        count++;
+    }
+    IAUX_EXPECT_EQUAL(count, reference.size());
+
+    IAUX_EXPECT_EQUAL(map.find(iaVector3I(100, 100, 100)), nullptr);
+
+    map.clear();
+    IAUX_EXPECT_EQUAL(map.size(), 0);
+    IAUX_EXPECT_EQUAL(map.find(reference.begin()->first), nullptr);
+}
+
+IAUX_TEST(VoxelBlockMapTests, PoolHandles)
+{
+    iVoxelBlockPool pool;
+
+    iVoxelBlock *a = pool.create();
+    iVoxelBlock *b = pool.create();
+    IAUX_EXPECT_NOT_EQUAL(a->_id, iVoxelBlock::INVALID_VOXELBLOCKID);
+    IAUX_EXPECT_NOT_EQUAL(a->_id, b->_id);
+    IAUX_EXPECT_EQUAL(pool.get(a->_id), a);
+    IAUX_EXPECT_EQUAL(pool.get(b->_id), b);
+    IAUX_EXPECT_EQUAL(pool.get(iVoxelBlock::INVALID_VOXELBLOCKID), nullptr);
+    IAUX_EXPECT_EQUAL(pool.getBlockCount(), 2);
+
+    a->_lod = 3;
+    const uint64 staleID = a->_id;
+    pool.destroy(a);
+    IAUX_EXPECT_EQUAL(pool.get(staleID), nullptr);
+    IAUX_EXPECT_EQUAL(pool.getBlockCount(), 1);
+
+    // slot gets recycled with a new id
+    iVoxelBlock *c = pool.create();
+    IAUX_EXPECT_EQUAL(c, a);
+    IAUX_EXPECT_NOT_EQUAL(c->_id, staleID);
+    IAUX_EXPECT_EQUAL(c->_lod, 0);
+    IAUX_EXPECT_EQUAL(pool.get(staleID), nullptr);
+    IAUX_EXPECT_EQUAL(pool.get(c->_id), c);
+
+    // addresses stay valid while the pool grows
+    std::vector<iVoxelBlock *> blocks;
+    for (int i = 0; i < 1000; ++i)
+    {
+        blocks.push_back(pool.create());
+    }
+    IAUX_EXPECT_EQUAL(pool.get(b->_id), b);
+    IAUX_EXPECT_EQUAL(pool.get(blocks[10]->_id), blocks[10]);
+
+    for (auto block : blocks)
+    {
+        pool.destroy(block);
+    }
+    pool.destroy(b);
+    pool.destroy(c);
+    IAUX_EXPECT_EQUAL(pool.getBlockCount(), 0);
+}
+
+static const iaVector3I walkChildOffsets[8] = {
+    iaVector3I(0, 0, 0), iaVector3I(1, 0, 0), iaVector3I(1, 0, 1), iaVector3I(0, 0, 1),
+    iaVector3I(0, 1, 0), iaVector3I(1, 1, 0), iaVector3I(1, 1, 1), iaVector3I(0, 1, 1)};
+
+static const iaVector3I walkNeighbourOffsets[6] = {
+    iaVector3I(1, 0, 0), iaVector3I(-1, 0, 0), iaVector3I(0, 1, 0), iaVector3I(0, -1, 0), iaVector3I(0, 0, 1), iaVector3I(0, 0, -1)};
+
+/*! mimics how iVoxelTerrain used to store blocks
+ */
+class LegacyBlockStorage
+{
+public:
+    class iVectorHasher
+    {
+    public:
+        size_t operator()(iaVector3I const &key) const
+        {
+            return (key._x << 1) ^ (key._y << 2) ^ (key._z << 3);
+        }
+    };
+
+    typedef std::unordered_map<iaVector3I, iVoxelBlock *, iVectorHasher> PositionMap;
+
+    std::vector<PositionMap> _voxelBlocks = std::vector<PositionMap>(2);
+    std::map<uint64, iVoxelBlock *> _voxelBlocksMap;
+    uint64 _nextVoxelBlockID = 1;
+
+    ~LegacyBlockStorage()
+    {
+        for (auto pair : _voxelBlocksMap)
+        {
+            delete pair.second;
+        }
+    }
+
+    iVoxelBlock *create(uint32 lod, const iaVector3I &position)
+    {
+        iVoxelBlock *result = new iVoxelBlock();
+        result->_lod = lod;
+        result->_positionInLOD = position;
+        _voxelBlocks[lod][position] = result;
+        _voxelBlocksMap[_nextVoxelBlockID] = result;
+        result->_id = _nextVoxelBlockID++;
+        return result;
+    }
+
+    void destroy(iVoxelBlock *block)
+    {
+        _voxelBlocksMap.erase(block->_id);
+        delete block;
+    }
+
+    iVoxelBlock *get(uint64 id)
+    {
+        auto iter = _voxelBlocksMap.find(id);
+        return iter != _voxelBlocksMap.end() ? iter->second : nullptr;
+    }
+
+    iVoxelBlock *find(uint32 lod, const iaVector3I &position)
+    {
+        auto iter = _voxelBlocks[lod].find(position);
+        return iter != _voxelBlocks[lod].end() ? iter->second : nullptr;
+    }
+
+    bool erase(uint32 lod, const iaVector3I &position)
+    {
+        return _voxelBlocks[lod].erase(position) == 1;
+    }
+
+    void collectOutOfRange(const iaVector3I &start, const iaVector3I &stop, std::vector<iVoxelBlock *> &dst)
+    {
+        // copy all and remove the ones in range like discoverBlocks did
+        PositionMap toDelete = _voxelBlocks[1];
+        iaVector3I position;
+        for (int64 x = start._x; x < stop._x; ++x)
+        {
+            for (int64 y = start._y; y < stop._y; ++y)
+            {
+                for (int64 z = start._z; z < stop._z; ++z)
+                {
+                    position.set(x, y, z);
+                    toDelete.erase(position);
+                }
+            }
+        }
+
+        for (auto pair : toDelete)
+        {
+            dst.push_back(pair.second);
+        }
+    }
+
+    template <typename F>
+    void forEachLowest(F f)
+    {
+        for (auto pair : _voxelBlocks[1])
+        {
+            f(pair.second);
+        }
+    }
+};
+
+/*! same interface with iVoxelBlockMap and iVoxelBlockPool
+ */
+class BlockStorage
+{
+public:
+    std::vector<iVoxelBlockMap> _voxelBlocks = std::vector<iVoxelBlockMap>(2);
+    iVoxelBlockPool _pool;
+
+    ~BlockStorage()
+    {
+        for (auto &voxelBlocks : _voxelBlocks)
+        {
+            std::vector<iVoxelBlock *> blocks;
+            for (iVoxelBlock *block : voxelBlocks)
+            {
+                blocks.push_back(block);
+            }
+
+            for (auto block : blocks)
+            {
+                _pool.destroy(block);
+            }
+        }
+    }
+
+    iVoxelBlock *create(uint32 lod, const iaVector3I &position)
+    {
+        iVoxelBlock *result = _pool.create();
+        result->_lod = lod;
+        result->_positionInLOD = position;
+        _voxelBlocks[lod].insert(position, result);
+        return result;
+    }
+
+    void destroy(iVoxelBlock *block)
+    {
+        _pool.destroy(block);
+    }
+
+    iVoxelBlock *get(uint64 id)
+    {
+        return _pool.get(id);
+    }
+
+    iVoxelBlock *find(uint32 lod, const iaVector3I &position)
+    {
+        return _voxelBlocks[lod].find(position);
+    }
+
+    bool erase(uint32 lod, const iaVector3I &position)
+    {
+        return _voxelBlocks[lod].erase(position);
+    }
+
+    void collectOutOfRange(const iaVector3I &start, const iaVector3I &stop, std::vector<iVoxelBlock *> &dst)
+    {
+        for (iVoxelBlock *block : _voxelBlocks[1])
+        {
+            const iaVector3I &position = block->_positionInLOD;
+            if (position._x < start._x || position._x >= stop._x ||
+                position._y < start._y || position._y >= stop._y ||
+                position._z < start._z || position._z >= stop._z)
+            {
+                dst.push_back(block);
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachLowest(F f)
+    {
+        for (iVoxelBlock *block : _voxelBlocks[1])
+        {
+            f(block);
+        }
+    }
+};
+
+/*! walks an observer through a two LOD terrain the way iVoxelTerrain discovers, links, updates and deletes blocks
+
+\returns checksum of neighbours found during the update passes
+*/
+template <typename Storage>
+static uint64 walk(Storage &storage, iaTime &discoveryDuration, iaTime &updateDuration, uint64 &maxBlocks)
+{
+    uint64 result = 0;
+
+    auto attachNeighbours = [&storage](iVoxelBlock *block)
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            if (block->_neighbours[i] != iVoxelBlock::INVALID_VOXELBLOCKID)
+            {
+                continue;
+            }
+
+            iVoxelBlock *neighbour = storage.find(block->_lod, block->_positionInLOD + walkNeighbourOffsets[i]);
+            if (neighbour != nullptr)
+            {
+                block->_neighbours[i] = neighbour->_id;
+                neighbour->_neighbours[i ^ 1] = block->_id;
+            }
+        }
+    };
+
+    auto initBlock = [](iVoxelBlock *block)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            block->_children[i] = iVoxelBlock::INVALID_VOXELBLOCKID;
+        }
+
+        for (int i = 0; i < 6; ++i)
+        {
+            block->_neighbours[i] = iVoxelBlock::INVALID_VOXELBLOCKID;
+        }
+    };
+
+    std::vector<iVoxelBlock *> outOfRange;
+    std::vector<iVoxelBlock *> toDelete;
+
+    for (uint32 step = 0; step < walkSteps; ++step)
+    {
+        const iaVector3I center(1000 + step, 1000 + step / 3, 1000);
+        const iaVector3I start(center._x - walkDiscoveryDistance, center._y - walkDiscoveryDistance, center._z - walkDiscoveryDistance);
+        const iaVector3I stop(center._x + walkDiscoveryDistance + 1, center._y + walkDiscoveryDistance + 1, center._z + walkDiscoveryDistance + 1);
+
+        iaTime startTime = iaTime::getNow();
+
+        outOfRange.clear();
+        storage.collectOutOfRange(start, stop, outOfRange);
+
+        iaVector3I position;
+        for (int64 x = start._x; x < stop._x; ++x)
+        {
+            for (int64 y = start._y; y < stop._y; ++y)
+            {
+                for (int64 z = start._z; z < stop._z; ++z)
+                {
+                    position.set(x, y, z);
+                    if (storage.find(1, position) != nullptr)
+                    {
+                        continue;
+                    }
+
+                    iVoxelBlock *parent = storage.create(1, position);
+                    initBlock(parent);
+                    attachNeighbours(parent);
+
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        iVoxelBlock *child = storage.create(0, position * 2 + walkChildOffsets[i]);
+                        initBlock(child);
+                        child->_parent = parent->_id;
+                        parent->_children[i] = child->_id;
+                    }
+
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        attachNeighbours(storage.get(parent->_children[i]));
+                    }
+                }
+            }
+        }
+
+        toDelete.clear();
+        for (iVoxelBlock *parent : outOfRange)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                iVoxelBlock *child = storage.get(parent->_children[i]);
+                if (child != nullptr)
+                {
+                    toDelete.push_back(child);
+                }
+            }
+            toDelete.push_back(parent);
+        }
+
+        for (iVoxelBlock *block : toDelete)
+        {
+            for (int i = 0; i < 6; ++i)
+            {
+                iVoxelBlock *neighbour = storage.get(block->_neighbours[i]);
+                if (neighbour != nullptr)
+                {
+                    neighbour->_neighbours[i ^ 1] = iVoxelBlock::INVALID_VOXELBLOCKID;
+                }
+            }
+
+            storage.erase(block->_lod, block->_positionInLOD);
+            storage.destroy(block);
+        }
+
+        discoveryDuration += iaTime::getNow() - startTime;
+
+        // update pass. Visit children by id and check the neighbours for LOD transitions
+        startTime = iaTime::getNow();
+        uint64 blocks = 0;
+        storage.forEachLowest([&](iVoxelBlock *parent)
+                              {
+                                  blocks++;
+                                  for (int i = 0; i < 8; ++i)
+                                  {
+                                      iVoxelBlock *child = storage.get(parent->_children[i]);
+                                      blocks++;
+                                      for (int n = 0; n < 6; ++n)
+                                      {
+                                          result += storage.get(child->_neighbours[n]) != nullptr ? 1 : 0;
+                                      }
+                                  }
+
+                                  for (int n = 0; n < 6; ++n)
+                                  {
+                                      result += storage.get(parent->_neighbours[n]) != nullptr ? 1 : 0;
+                                  } });
+        updateDuration += iaTime::getNow() - startTime;
+
+        maxBlocks = std::max(maxBlocks, blocks);
+    }
+
+    return result;
+}
+
+IAUX_BENCHMARK(VoxelBlockMapTests, BenchmarkObserverWalk)
+{
+    iaTime legacyDiscovery;
+    iaTime legacyUpdate;
+    uint64 legacyBlocks = 0;
+    uint64 legacyChecksum = 0;
+    {
+        LegacyBlockStorage storage;
+        legacyChecksum = walk(storage, legacyDiscovery, legacyUpdate, legacyBlocks);
+    }
+
+    iaTime discovery;
+    iaTime update;
+    uint64 blocks = 0;
+    uint64 checksum = 0;
+    {
+        BlockStorage storage;
+        checksum = walk(storage, discovery, update, blocks);
+    }
+
+    IAUX_EXPECT_EQUAL(checksum, legacyChecksum);
+    IAUX_EXPECT_EQUAL(blocks, legacyBlocks);
+    IAUX_EXPECT_GREATER_THEN(blocks, 10000);
+
+    iaConsole::getInstance() << "blocks: " << blocks << " steps: " << walkSteps
+                             << " legacy discovery: " << legacyDiscovery << " update: " << legacyUpdate
+                             << " iVoxelBlockMap/iVoxelBlockPool discovery: " << discovery << " update: " << update << endl;
+}
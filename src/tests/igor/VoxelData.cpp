@@ -0,0 +1,293 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+#include <iaux/math/iaRandomNumberGenerator.h>
+
+#include <igor/terrain/data/iVoxelData.h>
+using namespace igor;
+
+#include <algorithm>
+#include <cmath>
+
+static const int64 blockSize = 34;
+static const uint32 benchmarkBlockCount = 64;
+
+/*! generates a rolling hills terrain with some caves similar to what the voxel examples do
+ */
+static void generate(iVoxelData &data, uint32 seed)
+{
+    data.initData(blockSize, blockSize, blockSize);
+
+    for (int64 z = 0; z < blockSize; ++z)
+    {
+        for (int64 x = 0; x < blockSize; ++x)
+        {
+            const float64 height = 12.0 + 6.0 * std::sin((x + seed * 7) * 0.2) + 5.0 * std::cos((z + seed * 3) * 0.15);
+
+            for (int64 y = 0; y < blockSize; ++y)
+            {
+                const float64 density = height - y;
+                if (density <= 0.0)
+                {
+                    continue;
+                }
+
+                // carve a cave
+                if (y > 4 && y < 8 && (x + z + seed) % 11 < 3)
+                {
+                    continue;
+                }
+
+                data.setVoxelDensity(iaVector3I(x, y, z), density >= 1.0 ? 255 : static_cast<uint8>(density * 254.0) + 1);
+                data.setVoxelMaterial(iaVector3I(x, y, z), y < 6 ? 2 : 1);
+            }
+        }
+    }
+}
+
+/*! modifies the data the way iVoxelOperationSphere and iVoxelOperationBox do
+ */
+static void modify(iVoxelData &data, iaRandomNumberGenerator &rand)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        const int64 cx = rand.getNextRange(blockSize);
+        const int64 cy = rand.getNextRange(blockSize);
+        const int64 cz = rand.getNextRange(blockSize);
+        const int64 radius = 5;
+        const uint8 density = i % 2 ? 255 : 0;
+
+        for (int64 z = std::max<int64>(0, cz - radius); z < std::min<int64>(blockSize, cz + radius); ++z)
+        {
+            for (int64 y = std::max<int64>(0, cy - radius); y < std::min<int64>(blockSize, cy + radius); ++y)
+            {
+                for (int64 x = std::max<int64>(0, cx - radius); x < std::min<int64>(blockSize, cx + radius); ++x)
+                {
+                    if ((x - cx) * (x - cx) + (y - cy) * (y - cy) + (z - cz) * (z - cz) <= radius * radius)
+                    {
+                        data.setVoxelDensity(iaVector3I(x, y, z), density);
+                    }
+                }
+            }
+        }
+    }
+
+    data.setVoxelPole(iaVector3I(3, 2, 3), 10, 128);
+}
+
+/*! walks the data with 3x3 pole cursors the same way iContouringCubes does and counts the cells on the surface
+ */
+static uint64 scanSurface(const iVoxelData &data)
+{
+    uint64 result = 0;
+    iVoxelPoleCursor cursors[9];
+    uint8 density[27];
+
+    for (int64 z = 0; z < data.getDepth() - 2; ++z)
+    {
+        for (int64 x = 0; x < data.getWidth() - 2; ++x)
+        {
+            for (int i = 0; i < 9; ++i)
+            {
+                cursors[i] = iVoxelPoleCursor(data, x + i % 3, z + i / 3, 0);
+                density[i + 18] = cursors[i].getValue();
+            }
+
+            for (int64 y = 0; y < data.getHeight() - 1; ++y)
+            {
+                bool inside = false;
+                bool outside = false;
+
+                for (int i = 0; i < 9; ++i)
+                {
+                    density[i + 9] = density[i + 18];
+                    cursors[i].next();
+                    density[i + 18] = cursors[i].getValue();
+
+                    inside |= density[i + 9] > 0 || density[i + 18] > 0;
+                    outside |= density[i + 9] == 0 || density[i + 18] == 0;
+                }
+
+                if (inside && outside)
+                {
+                    result++;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static bool sameVoxels(iVoxelData &a, iVoxelData &b)
+{
+    for (int64 z = 0; z < blockSize; ++z)
+    {
+        for (int64 y = 0; y < blockSize; ++y)
+        {
+            for (int64 x = 0; x < blockSize; ++x)
+            {
+                if (a.getVoxelDensity(iaVector3I(x, y, z)) != b.getVoxelDensity(iaVector3I(x, y, z)) ||
+                    a.getVoxelMaterial(iaVector3I(x, y, z)) != b.getVoxelMaterial(iaVector3I(x, y, z)))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+IAUX_TEST(VoxelDataTests, DenseSameAsRLE)
+{
+    iVoxelData rle;
+    iVoxelData dense;
+    dense.setStorage(iVoxelStorage::Dense);
+
+    generate(rle, 1);
+    generate(dense, 1);
+
+    iaRandomNumberGenerator rand1(42);
+    iaRandomNumberGenerator rand2(42);
+    modify(rle, rand1);
+    modify(dense, rand2);
+
+    IAUX_EXPECT_TRUE(rle.getStorage() == iVoxelStorage::RLE);
+    IAUX_EXPECT_TRUE(dense.getStorage() == iVoxelStorage::Dense);
+    IAUX_EXPECT_TRUE(sameVoxels(rle, dense));
+    IAUX_EXPECT_EQUAL(scanSurface(rle), scanSurface(dense));
+    IAUX_EXPECT_GREATER_THEN(scanSurface(dense), 0);
+}
+
+IAUX_TEST(VoxelDataTests, ConvertStorage)
+{
+    iVoxelData rle;
+    generate(rle, 2);
+
+    iVoxelData converted;
+    rle.getCopy(converted);
+    IAUX_EXPECT_TRUE(converted.getStorage() == iVoxelStorage::RLE);
+
+    converted.setStorage(iVoxelStorage::Dense);
+    IAUX_EXPECT_TRUE(converted.getStorage() == iVoxelStorage::Dense);
+    IAUX_EXPECT_TRUE(sameVoxels(rle, converted));
+
+    iaRandomNumberGenerator rand(1);
+    modify(converted, rand);
+
+    iVoxelData copy;
+    converted.getCopy(copy);
+    IAUX_EXPECT_TRUE(copy.getStorage() == iVoxelStorage::Dense);
+    IAUX_EXPECT_TRUE(sameVoxels(copy, converted));
+
+    // back to RLE must be as compact as if it was generated in RLE
+    converted.setStorage(iVoxelStorage::RLE);
+    IAUX_EXPECT_TRUE(sameVoxels(copy, converted));
+
+    iVoxelData reference;
+    generate(reference, 2);
+    iaRandomNumberGenerator rand2(1);
+    modify(reference, rand2);
+    IAUX_EXPECT_TRUE(sameVoxels(reference, converted));
+
+    for (int64 z = 0; z < blockSize; ++z)
+    {
+        for (int64 x = 0; x < blockSize; ++x)
+        {
+            IAUX_EXPECT_EQUAL(converted.getDensityPole(x, z).getRunCount(), reference.getDensityPole(x, z).getRunCount());
+            IAUX_EXPECT_EQUAL(converted.getMaterialPole(x, z).getRunCount(), reference.getMaterialPole(x, z).getRunCount());
+        }
+    }
+}
+
+IAUX_TEST(VoxelDataTests, UniformDense)
+{
+    iVoxelData data;
+    data.setStorage(iVoxelStorage::Dense);
+    IAUX_EXPECT_FALSE(data.hasData());
+
+    data.initData(blockSize, blockSize, blockSize);
+    IAUX_EXPECT_TRUE(data.hasData());
+    IAUX_EXPECT_TRUE(data.isUniform());
+
+    const uint64 uniformMemory = data.getMemoryUsage();
+
+    // writing the value all voxels have already does not allocate
+    data.setVoxelDensity(iaVector3I(1, 2, 3), 0);
+    data.setVoxelPole(iaVector3I(4, 0, 4), blockSize, 0);
+    IAUX_EXPECT_TRUE(data.isUniform());
+    IAUX_EXPECT_EQUAL(data.getMemoryUsage(), uniformMemory);
+
+    data.setVoxelDensity(iaVector3I(1, 2, 3), 200);
+    IAUX_EXPECT_FALSE(data.isUniform());
+    IAUX_EXPECT_EQUAL(data.getVoxelDensity(iaVector3I(1, 2, 3)), 200);
+    IAUX_EXPECT_EQUAL(data.getVoxelDensity(iaVector3I(1, 3, 3)), 0);
+    IAUX_EXPECT_GREATER_THEN(data.getMemoryUsage(), uniformMemory);
+
+    // a uniform RLE block stays uniform when converted
+    iVoxelData solid;
+    solid.setClearValue(255);
+    solid.initData(blockSize, blockSize, blockSize);
+    IAUX_EXPECT_TRUE(solid.isUniform());
+
+    solid.setStorage(iVoxelStorage::Dense);
+    IAUX_EXPECT_TRUE(solid.isUniform());
+    IAUX_EXPECT_EQUAL(solid.getVoxelDensity(iaVector3I(5, 5, 5)), 255);
+
+    iVoxelPoleCursor cursor(solid, 0, 0, 0);
+    IAUX_EXPECT_EQUAL(cursor.getValue(), 255);
+    cursor.next();
+    IAUX_EXPECT_EQUAL(cursor.getValue(), 255);
+}
+
+IAUX_BENCHMARK(VoxelDataTests, BenchmarkStorage)
+{
+    const iVoxelStorage storages[] = {iVoxelStorage::RLE, iVoxelStorage::Dense};
+    const char *storageNames[] = {"RLE", "Dense"};
+
+    uint64 surfaceCells[2] = {0, 0};
+
+    for (int s = 0; s < 2; ++s)
+    {
+        std::vector<iVoxelData> blocks(benchmarkBlockCount);
+        for (auto &block : blocks)
+        {
+            block.setStorage(storages[s]);
+        }
+
+        iaTime start = iaTime::getNow();
+        for (uint32 i = 0; i < benchmarkBlockCount; ++i)
+        {
+            generate(blocks[i], i);
+        }
+        const iaTime generateDuration = iaTime::getNow() - start;
+
+        iaRandomNumberGenerator rand(1337);
+        start = iaTime::getNow();
+        for (auto &block : blocks)
+        {
+            modify(block, rand);
+        }
+        const iaTime modifyDuration = iaTime::getNow() - start;
+
+        start = iaTime::getNow();
+        for (const auto &block : blocks)
+        {
+            surfaceCells[s] += scanSurface(block);
+        }
+        const iaTime meshDuration = iaTime::getNow() - start;
+
+        uint64 memory = 0;
+        for (const auto &block : blocks)
+        {
+            memory += block.getMemoryUsage();
+        }
+
+        iaConsole::getInstance() << storageNames[s] << " blocks: " << benchmarkBlockCount << " size: " << blockSize
+                                 << " memory: " << memory / 1024 << "kB"
+                                 << " generate: " << generateDuration << " modify: " << modifyDuration << " mesh scan: " << meshDuration << endl;
+    }
+
+    IAUX_EXPECT_EQUAL(surfaceCells[0], surfaceCells[1]);
+}
@@ -0,0 +1,200 @@
+#include <iaux/iaux.h>
+#include <iaux/test/iaTest.h>
+#include <iaux/system/iaTime.h>
+
+#include <igor/terrain/iVoxelTerrainMeshGenerator.h>
+#include <igor/terrain/data/iVoxelData.h>
+#include <igor/generation/iContouringCubes.h>
+#include <igor/generation/iPerlinNoise.h>
+#include <igor/threading/iTaskManager.h>
+#include <igor/physics/iPhysics.h>
+#include <igor/resources/config/iConfigReader.h>
+using namespace igor;
+
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+static const char *voxelMeshingConfigFilename = "voxelMeshingTest.xml";
+static const int64 voxelBlockSize = 32;
+static const int64 voxelBlockOverlap = 2;
+static const iaVector3I worldSize(4, 2, 4);
+static const uint32 worldSeed = 1337;
+
+/*! generates a fixed seed world of voxel blocks the way the voxel examples do
+ */
+static std::vector<std::unique_ptr<iVoxelData>> generateWorld()
+{
+    iPerlinNoise perlinNoise;
+    perlinNoise.generateBase(worldSeed);
+
+    const int64 size = voxelBlockSize + voxelBlockOverlap;
+
+    std::vector<std::unique_ptr<iVoxelData>> result;
+
+    for (int64 bz = 0; bz < worldSize._z; ++bz)
+    {
+        for (int64 by = 0; by < worldSize._y; ++by)
+        {
+            for (int64 bx = 0; bx < worldSize._x; ++bx)
+            {
+                std::unique_ptr<iVoxelData> voxelData = std::make_unique<iVoxelData>();
+                voxelData->initData(size, size, size);
+
+                for (int64 z = 0; z < size; ++z)
+                {
+                    for (int64 x = 0; x < size; ++x)
+                    {
+                        for (int64 y = 0; y < size; ++y)
+                        {
+                            const iaVector3d pos(bx * voxelBlockSize + x, by * voxelBlockSize + y, bz * voxelBlockSize + z);
+                            const float64 ground = 20.0 + perlinNoise.getValue(iaVector3d(pos._x * 0.02, 0.0, pos._z * 0.02), 3) * 30.0;
+                            const float64 cave = perlinNoise.getValue(iaVector3d(pos._x * 0.05, pos._y * 0.05, pos._z * 0.05), 2);
+
+                            float64 density = ground - pos._y;
+                            if (cave > 0.6)
+                            {
+                                density = 0.6 - cave;
+                            }
+
+                            if (density > 0.0)
+                            {
+                                voxelData->setVoxelDensity(iaVector3I(x, y, z), static_cast<uint8>(std::min(density, 1.0) * 254.0) + 1);
+                            }
+                        }
+                    }
+                }
+
+                result.push_back(std::move(voxelData));
+            }
+        }
+    }
+
+    return result;
+}
+
+static std::vector<iVoxelMeshJob> createJobs(const std::vector<std::unique_ptr<iVoxelData>> &world)
+{
+    std::vector<iVoxelMeshJob> result(world.size());
+    for (uint32 i = 0; i < world.size(); ++i)
+    {
+        result[i]._voxelData = world[i].get();
+    }
+
+    return result;
+}
+
+static uint64 countTriangles(const std::vector<iVoxelMeshJob> &jobs)
+{
+    uint64 result = 0;
+    for (const auto &job : jobs)
+    {
+        if (job._mesh != nullptr)
+        {
+            result += job._mesh->getTrianglesCount();
+        }
+    }
+
+    return result;
+}
+
+/*! mimics how meshes were generated before. One iContouringCubes per block one block after the other
+ */
+static void generateMeshesLegacy(std::vector<iVoxelMeshJob> &jobs)
+{
+    for (auto &job : jobs)
+    {
+        iContouringCubes contouringCubes;
+        contouringCubes.setVoxelData(job._voxelData);
+        job._mesh = contouringCubes.compile(iaVector3I(), iaVector3I(job._voxelData->getWidth(), job._voxelData->getHeight(), job._voxelData->getDepth()), job._lod, job._neighboursLOD);
+    }
+}
+
+static void startTaskManager(uint32 threadCount)
+{
+    std::ofstream file(voxelMeshingConfigFilename);
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<Igor>\n";
+    file << "    <Config>\n";
+    file << "        <Setting name=\"minThreads\" value=\"" << threadCount << "\" />\n";
+    file << "        <Setting name=\"maxThreads\" value=\"" << threadCount << "\" />\n";
+    file << "    </Config>\n";
+    file << "</Igor>\n";
+    file.close();
+
+    iConfigReader::create();
+    iConfigReader::getInstance().readConfiguration(voxelMeshingConfigFilename);
+    iPhysics::create();
+    iTaskManager::create();
+}
+
+static void stopTaskManager()
+{
+    iTaskManager::destroy();
+    iPhysics::destroy();
+    iConfigReader::destroy();
+    std::remove(voxelMeshingConfigFilename);
+}
+
+IAUX_TEST(VoxelMeshingTests, BatchSameAsSingle)
+{
+    const auto world = generateWorld();
+
+    std::vector<iVoxelMeshJob> legacyJobs = createJobs(world);
+    generateMeshesLegacy(legacyJobs);
+
+    // run twice so the second batch runs on warm scratch buffers
+    for (int run = 0; run < 2; ++run)
+    {
+        std::vector<iVoxelMeshJob> jobs = createJobs(world);
+        iVoxelTerrainMeshGenerator::generateMeshes(jobs);
+
+        IAUX_EXPECT_GREATER_THEN(countTriangles(jobs), 0);
+        IAUX_EXPECT_EQUAL(countTriangles(jobs), countTriangles(legacyJobs));
+
+        for (uint32 i = 0; i < jobs.size(); ++i)
+        {
+            IAUX_EXPECT_EQUAL(jobs[i]._mesh == nullptr, legacyJobs[i]._mesh == nullptr);
+            if (jobs[i]._mesh != nullptr && legacyJobs[i]._mesh != nullptr)
+            {
+                IAUX_EXPECT_EQUAL(jobs[i]._mesh->getVertexCount(), legacyJobs[i]._mesh->getVertexCount());
+                IAUX_EXPECT_EQUAL(jobs[i]._mesh->getIndexCount(), legacyJobs[i]._mesh->getIndexCount());
+            }
+        }
+    }
+}
+
+IAUX_BENCHMARK(VoxelMeshingTests, BenchmarkBlocksPerSecond)
+{
+    const auto world = generateWorld();
+    const uint32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<iVoxelMeshJob> legacyJobs = createJobs(world);
+    iaTime start = iaTime::getNow();
+    generateMeshesLegacy(legacyJobs);
+    const iaTime legacyDuration = iaTime::getNow() - start;
+
+    iaConsole::getInstance() << "blocks: " << world.size() << " legacy serial blocks/sec: " << static_cast<uint64>(world.size() / (legacyDuration.getMilliseconds() / 1000.0)) << endl;
+
+    for (uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        startTaskManager(threadCount);
+
+        // warm up the scratch pool
+        std::vector<iVoxelMeshJob> jobs = createJobs(world);
+        iVoxelTerrainMeshGenerator::generateMeshes(jobs);
+
+        jobs = createJobs(world);
+        start = iaTime::getNow();
+        iVoxelTerrainMeshGenerator::generateMeshes(jobs);
+        const iaTime duration = iaTime::getNow() - start;
+
+        IAUX_EXPECT_EQUAL(countTriangles(jobs), countTriangles(legacyJobs));
+
+        iaConsole::getInstance() << "threads: " << threadCount << " batched blocks/sec: " << static_cast<uint64>(world.size() / (duration.getMilliseconds() / 1000.0)) << endl;
+
+        stopTaskManager();
+    }
+}
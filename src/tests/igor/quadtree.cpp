@@ -184,5 +184,82 @@ IAUX_TEST(QuadtreeTests, MoveObjects)
 
     IAUX_EXPECT_TRUE(std::any_cast<int>(objects[0]->_userData) == 1 || std::any_cast<int>(objects[0]->_userData) == 3);
     IAUX_EXPECT_TRUE(std::any_cast<int>(objects[1]->_userData) == 1 || std::any_cast<int>(objects[1]->_userData) == 3);
+}
+
+IAUX_TEST(QuadtreeTests, QueryPairs)
+{
+    iQuadtreef tree(testRect1, 3);
+
+    auto object1 = std::make_shared<iQuadtreef::Object>(iaCirclef(10, 10, 10), 1);
+    auto object2 = std::make_shared<iQuadtreef::Object>(iaCirclef(25, 10, 10), 2);
+    auto object3 = std::make_shared<iQuadtreef::Object>(iaCirclef(60, 10, 10), 3);
+    auto object4 = std::make_shared<iQuadtreef::Object>(iaCirclef(75, 10, 10), 4);
+    auto object5 = std::make_shared<iQuadtreef::Object>(iaCirclef(-50, -50, 10), 5);
+
+    tree.insert(object1);
+    tree.insert(object2);
+    tree.insert(object3);
+    tree.insert(object4);
+    tree.insert(object5);
+
+    iQuadtreef::ObjectPairs pairs;
+    tree.queryPairs(pairs);
+
+    IAUX_EXPECT_EQUAL(pairs.size(), 2);
+
+    for (const auto &pair : pairs)
+    {
+        const int a = std::min(std::any_cast<int>(pair.first->_userData), std::any_cast<int>(pair.second->_userData));
+        const int b = std::max(std::any_cast<int>(pair.first->_userData), std::any_cast<int>(pair.second->_userData));
+        IAUX_EXPECT_TRUE((a == 1 && b == 2) || (a == 3 && b == 4));
+    }
+
+    // with scaled radii 2 and 3 overlap too
+    pairs.clear();
+    tree.queryPairs(pairs, 1.8f);
+    IAUX_EXPECT_EQUAL(pairs.size(), 3);
+
+    // split in leaf ranges like a parallel for would do
+    uint32 pairCount = 0;
+    for (uint32 leaf = 0; leaf < tree.getLeafCount(); ++leaf)
+    {
+        tree.queryPairs(leaf, leaf + 1, [&](const iQuadtreef::ObjectPtr &objectA, const iQuadtreef::ObjectPtr &objectB)
+                        { pairCount++; },
+                        1.8f);
+    }
+
+    IAUX_EXPECT_EQUAL(pairCount, 3);
+
+    // touching circles overlap like in iIntersection::intersects
+    auto object6 = std::make_shared<iQuadtreef::Object>(iaCirclef(-30, -50, 10), 6);
+    tree.insert(object6);
+
+    pairs.clear();
+    tree.queryPairs(pairs);
+    IAUX_EXPECT_EQUAL(pairs.size(), 3);
+}
 
-}
\ No newline at end of file
+IAUX_TEST(QuadtreeTests, QueryNearest)
+{
+    iQuadtreef tree(testRect1, 3);
+
+    auto object1 = std::make_shared<iQuadtreef::Object>(iaCirclef(10, 10, 1), 1);
+    auto object2 = std::make_shared<iQuadtreef::Object>(iaCirclef(30, 10, 1), 2);
+    auto object3 = std::make_shared<iQuadtreef::Object>(iaCirclef(60, 10, 1), 3);
+    auto object4 = std::make_shared<iQuadtreef::Object>(iaCirclef(90, 10, 1), 4);
+    auto object5 = std::make_shared<iQuadtreef::Object>(iaCirclef(-50, -50, 1), 5);
+
+    tree.insert(object1);
+    tree.insert(object2);
+    tree.insert(object3);
+    tree.insert(object4);
+    tree.insert(object5);
+
+    iQuadtreef::Objects objects;
+    tree.queryNearest(iaVector2f(55, 10), 3, objects);
+
+    IAUX_EXPECT_EQUAL(objects.size(), 3);
+    IAUX_EXPECT_EQUAL(std::any_cast<int>(objects[0]->_userData), 3);
+    IAUX_EXPECT_EQUAL(std::any_cast<int>(objects[1]->_userData), 2);
+    IAUX_EXPECT_EQUAL(std::any_cast<int>(objects[2]->_userData), 4);
+}